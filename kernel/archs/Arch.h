@@ -20,12 +20,25 @@ void arch_save_context(Task *task);
 
 void arch_load_context(Task *task);
 
+void arch_load_tls(Task *task);
+
 void arch_task_go(Task *task);
 
 size_t arch_debug_write(const void *buffer, size_t size);
 
 TimeStamp arch_get_time();
 
+// Nanoseconds since boot, never goes backward.
+uint64_t arch_get_monotonic_time();
+
+// Have the timer interrupt fire once at the deadline, in nanoseconds since
+// boot, instead of periodically. False when the timer can only tick.
+bool arch_timer_arm(uint64_t deadline);
+
+// What userspace needs to turn the cycle counter into nanoseconds since boot,
+// false when there is no usable cycle counter.
+bool arch_clock_calibration(uint64_t *cycles_at_boot, uint64_t *nanoseconds_per_cycle);
+
 NO_RETURN void arch_reboot();
 
 NO_RETURN void arch_shutdown();
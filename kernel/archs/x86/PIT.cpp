@@ -1,6 +1,14 @@
 #include "archs/x86/PIT.h"
 #include "archs/x86/IOPort.h"
 
+// The PIT counts at 1.193182MHz.
+#define PIT_NANOSECONDS_PER_COUNT 838
+
+// Shorter delays would have the timer fire again before the scheduler is done.
+#define PIT_ONESHOT_MIN_COUNT 60
+
+#define PIT_ONESHOT_MAX_COUNT 0xFFFF
+
 void pit_initialize(int frequency)
 {
     uint16_t divisor = 1193182 / frequency;
@@ -9,3 +17,23 @@ void pit_initialize(int frequency)
     out8(0x40, divisor & 0xFF);
     out8(0x40, (divisor >> 8) & 0xFF);
 }
+
+void pit_oneshot(uint64_t nanoseconds)
+{
+    uint32_t count = PIT_ONESHOT_MAX_COUNT;
+
+    if (nanoseconds < (uint64_t)PIT_ONESHOT_MAX_COUNT * PIT_NANOSECONDS_PER_COUNT)
+    {
+        count = (uint32_t)nanoseconds / PIT_NANOSECONDS_PER_COUNT;
+    }
+
+    if (count < PIT_ONESHOT_MIN_COUNT)
+    {
+        count = PIT_ONESHOT_MIN_COUNT;
+    }
+
+    // Channel 0, low then high byte, mode 0: interrupt on terminal count.
+    out8(0x43, 0x30);
+    out8(0x40, count & 0xFF);
+    out8(0x40, (count >> 8) & 0xFF);
+}
@@ -3,3 +3,7 @@
 #include <libsystem/Common.h>
 
 void pit_initialize(int frequency);
+
+// Fires IRQ0 once after the given delay, clamped to what the PIT can count,
+// and stops the periodic mode set up by pit_initialize().
+void pit_oneshot(uint64_t nanoseconds);
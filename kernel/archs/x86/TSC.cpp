@@ -0,0 +1,78 @@
+#include <abi/Clock.h>
+#include <libsystem/Logger.h>
+
+#include "archs/x86/CPUID.h"
+#include "archs/x86/IOPort.h"
+#include "archs/x86/TSC.h"
+
+#define TSC_CALIBRATION_MS 10
+
+static uint64_t _frequency = 0;
+static uint64_t _boot = 0;
+
+// Nanoseconds per cycle as a 32.32 fixed point number, keeps divisions out of
+// the hot path and 64 bit divisions out of the 32 bit kernel.
+static uint64_t _scale = 0;
+
+void tsc_initialize()
+{
+    if (!(cpuid_get_feature_EDX() & CPUID_FEAT_EDX_TSC))
+    {
+        logger_warn("No time stamp counter, falling back on the PIT");
+        return;
+    }
+
+    // Channel 2 is gated through the keyboard controller port and, unlike the
+    // others, its output can be read back: count down for a known time and
+    // see how many cycles went by.
+    out8(0x61, (in8(0x61) & ~0x02) | 0x01);
+
+    uint16_t count = 1193182 / (1000 / TSC_CALIBRATION_MS);
+
+    out8(0x43, 0xB0);
+    out8(0x42, count & 0xFF);
+    out8(0x42, (count >> 8) & 0xFF);
+
+    uint8_t gate = in8(0x61) & ~0x01;
+    out8(0x61, gate);
+    out8(0x61, gate | 0x01);
+
+    uint64_t start = rdtsc();
+
+    while (!(in8(0x61) & 0x20))
+    {
+    }
+
+    uint64_t end = rdtsc();
+
+    _frequency = (end - start) * (1000 / TSC_CALIBRATION_MS);
+    _scale = (1000000000ull << 32) / _frequency;
+    _boot = end;
+
+    logger_info("Time stamp counter running at %dMHz", (int)(_frequency / 1000000));
+}
+
+bool tsc_available()
+{
+    return _frequency != 0;
+}
+
+uint64_t tsc_frequency()
+{
+    return _frequency;
+}
+
+uint64_t tsc_at_boot()
+{
+    return _boot;
+}
+
+uint64_t tsc_scale()
+{
+    return _scale;
+}
+
+uint64_t tsc_nanoseconds()
+{
+    return clock_cycles_to_nanoseconds(rdtsc() - _boot, _scale);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+static inline uint64_t rdtsc()
+{
+    uint32_t low, high;
+    asm volatile("rdtsc"
+                 : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
+// Measures the frequency of the time stamp counter against the PIT, has to
+// run before the PIT is programmed for the scheduler since it borrows it.
+void tsc_initialize();
+
+bool tsc_available();
+
+uint64_t tsc_frequency();
+
+uint64_t tsc_at_boot();
+
+// Nanoseconds per cycle, 32.32 fixed point.
+uint64_t tsc_scale();
+
+uint64_t tsc_nanoseconds();
@@ -45,6 +45,7 @@ void gdt_initialize()
     gdt[3] = {0, 0xffffffff, GDT_PRESENT | GDT_READWRITE | GDT_USER | GDT_EXECUTABLE, GDT_FLAGS};
     gdt[4] = {0, 0xffffffff, GDT_PRESENT | GDT_READWRITE | GDT_USER, GDT_FLAGS};
     gdt[5] = {&tss, GDT_TSS_PRESENT | GDT_ACCESSED | GDT_EXECUTABLE | GDT_USER, TSS_FLAGS};
+    gdt[6] = {0, 0xffffffff, GDT_PRESENT | GDT_READWRITE | GDT_USER, GDT_FLAGS};
 
     gdt_flush((uint32_t)&gdt_descriptor);
 }
@@ -53,3 +54,11 @@ void set_kernel_stack(uint32_t stack)
 {
     tss.esp0 = stack;
 }
+
+void set_user_tls(uint32_t base)
+{
+    // Picked up the next time gs is loaded, when returning to userspace.
+    gdt[6].base0_15 = base & 0xffff;
+    gdt[6].base16_23 = (base >> 16) & 0xff;
+    gdt[6].base24_31 = (base >> 24) & 0xff;
+}
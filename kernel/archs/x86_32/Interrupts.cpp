@@ -4,8 +4,10 @@
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Syscalls.h"
+#include "kernel/tasking/Task-Memory.h"
 
 #include "archs/x86/PIC.h"
 #include "archs/x86_32/Interrupts.h"
@@ -46,8 +48,49 @@ static const char *_exception_messages[32] = {
     "Reserved",
 };
 
+static void interrupts_profile(InterruptStackFrame &stackframe)
+{
+    ProfilerContext context = {};
+
+    if (stackframe.cs == 0x1B)
+    {
+        context.user_ip = stackframe.eip;
+        context.user_fp = stackframe.ebp;
+    }
+    else
+    {
+        context.kernel_ip = stackframe.eip;
+        context.kernel_fp = stackframe.ebp;
+
+        // User tasks running kernel code came in through the frame at the top of their kernel stack.
+        Task *task = scheduler_running();
+
+        if (task && (task->_flags & TASK_USER))
+        {
+            auto user_stackframe = reinterpret_cast<UserInterruptStackFrame *>(
+                (uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE - sizeof(UserInterruptStackFrame));
+
+            if (user_stackframe->cs == 0x1B)
+            {
+                context.user_ip = user_stackframe->eip;
+                context.user_fp = user_stackframe->ebp;
+            }
+        }
+    }
+
+    profiler_sample(context);
+}
+
 extern "C" uint32_t interrupts_handler(uintptr_t esp, InterruptStackFrame stackframe)
 {
+    // Pages of memory objects are committed on first touch. This has to come
+    // first since the kernel may fault on user memory with interrupts retained.
+    if (stackframe.intno == 14 && !(stackframe.err & 1) &&
+        task_memory_fault(scheduler_running(), CR2()) == SUCCESS)
+    {
+        return esp;
+    }
+
     ASSERT_INTERRUPTS_NOT_RETAINED();
 
     if (stackframe.intno < 32)
@@ -88,12 +131,24 @@ extern "C" uint32_t interrupts_handler(uintptr_t esp, InterruptStackFrame stackf
 
         if (irq == 0)
         {
+            if (profiler_enabled())
+            {
+                interrupts_profile(stackframe);
+            }
+
             system_tick();
             esp = schedule(esp);
         }
         else
         {
             dispatcher_dispatch(irq);
+
+            // The timer might not fire for a while, the dispatcher has to get
+            // a chance to run now.
+            if (scheduler_is_idle())
+            {
+                esp = schedule(esp);
+            }
         }
 
         interrupts_enable_holding();
@@ -114,7 +114,7 @@ Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr
         PageTableEntry &page_table_entry = page_table->entries[page_table_index];
 
         page_table_entry.Present = 1;
-        page_table_entry.Write = 1;
+        page_table_entry.Write = !(flags & MEMORY_READ_ONLY);
         page_table_entry.User = flags & MEMORY_USER;
         page_table_entry.PageFrameNumber = (physical_range.base() + offset) >> 12;
     }
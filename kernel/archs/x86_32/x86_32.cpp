@@ -8,6 +8,7 @@
 #include "archs/x86/PIC.h"
 #include "archs/x86/PIT.h"
 #include "archs/x86/RTC.h"
+#include "archs/x86/TSC.h"
 #include "archs/x86_32/ACPI.h"
 #include "archs/x86_32/GDT.h"
 #include "archs/x86_32/IDT.h"
@@ -38,6 +39,12 @@ void arch_load_context(Task *task)
 {
     fpu_load_context(task);
     set_kernel_stack((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
+    arch_load_tls(task);
+}
+
+void arch_load_tls(Task *task)
+{
+    set_user_tls(task->tls_base);
 }
 
 void arch_task_go(Task *task)
@@ -58,7 +65,7 @@ void arch_task_go(Task *task)
         stackframe.ds = 0x23;
         stackframe.es = 0x23;
         stackframe.fs = 0x23;
-        stackframe.gs = 0x23;
+        stackframe.gs = 0x33; // Thread local storage
         stackframe.ss = 0x23;
 
         task_kernel_stack_push(task, &stackframe, sizeof(UserInterruptStackFrame));
@@ -85,6 +92,45 @@ size_t arch_debug_write(const void *buffer, size_t size) { return com_write(COM1
 
 TimeStamp arch_get_time() { return rtc_now(); }
 
+uint64_t arch_get_monotonic_time()
+{
+    if (tsc_available())
+    {
+        return tsc_nanoseconds();
+    }
+
+    return system_get_timer_interrupts() * 1000000ull;
+}
+
+bool arch_timer_arm(uint64_t deadline)
+{
+    // Without the time stamp counter the timer interrupts are the clock, they
+    // have to keep coming at a fixed rate.
+    if (!tsc_available())
+    {
+        return false;
+    }
+
+    uint64_t now = tsc_nanoseconds();
+
+    pit_oneshot(deadline > now ? deadline - now : 0);
+
+    return true;
+}
+
+bool arch_clock_calibration(uint64_t *cycles_at_boot, uint64_t *nanoseconds_per_cycle)
+{
+    if (!tsc_available())
+    {
+        return false;
+    }
+
+    *cycles_at_boot = tsc_at_boot();
+    *nanoseconds_per_cycle = tsc_scale();
+
+    return true;
+}
+
 extern "C" void arch_main(void *info, uint32_t magic)
 {
     __plug_initialize();
@@ -107,6 +153,7 @@ extern "C" void arch_main(void *info, uint32_t magic)
     idt_initialize();
     pic_initialize();
     fpu_initialize();
+    tsc_initialize();
     pit_initialize(1000);
 
     Acpi::initialize(handover);
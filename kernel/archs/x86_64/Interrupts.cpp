@@ -3,8 +3,10 @@
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Syscalls.h"
+#include "kernel/tasking/Task-Memory.h"
 
 #include "archs/x86/PIC.h"
 
@@ -46,10 +48,51 @@ static const char *_exception_messages[32] = {
     "Reserved",
 };
 
+static void interrupts_profile(InterruptStackFrame *stackframe)
+{
+    ProfilerContext context = {};
+
+    if (stackframe->cs == 0x1B)
+    {
+        context.user_ip = stackframe->rip;
+        context.user_fp = stackframe->rbp;
+    }
+    else
+    {
+        context.kernel_ip = stackframe->rip;
+        context.kernel_fp = stackframe->rbp;
+
+        // User tasks running kernel code came in through the frame at the top of their kernel stack.
+        Task *task = scheduler_running();
+
+        if (task && (task->_flags & TASK_USER))
+        {
+            auto user_stackframe = reinterpret_cast<InterruptStackFrame *>(
+                (uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE - sizeof(InterruptStackFrame));
+
+            if (user_stackframe->cs == 0x1B)
+            {
+                context.user_ip = user_stackframe->rip;
+                context.user_fp = user_stackframe->rbp;
+            }
+        }
+    }
+
+    profiler_sample(context);
+}
+
 extern "C" uint64_t interrupts_handler(uintptr_t rsp)
 {
     InterruptStackFrame *stackframe = reinterpret_cast<InterruptStackFrame *>(rsp);
 
+    // Pages of memory objects are committed on first touch. This has to come
+    // first since the kernel may fault on user memory with interrupts retained.
+    if (stackframe->intno == 14 && !(stackframe->err & 1) &&
+        task_memory_fault(scheduler_running(), CR2()) == SUCCESS)
+    {
+        return rsp;
+    }
+
     if (stackframe->intno < 32)
     {
         if (stackframe->cs == 0x1B)
@@ -87,12 +130,24 @@ extern "C" uint64_t interrupts_handler(uintptr_t rsp)
 
         if (irq == 0)
         {
+            if (profiler_enabled())
+            {
+                interrupts_profile(stackframe);
+            }
+
             system_tick();
             rsp = schedule(rsp);
         }
         else
         {
             dispatcher_dispatch(irq);
+
+            // The timer might not fire for a while, the dispatcher has to get
+            // a chance to run now.
+            if (scheduler_is_idle())
+            {
+                rsp = schedule(rsp);
+            }
         }
 
         interrupts_enable_holding();
@@ -174,7 +174,7 @@ Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr
         auto pml1_entry = &pml1->entries[pml1_index(address)];
 
         pml1_entry->present = 1;
-        pml1_entry->writable = 1;
+        pml1_entry->writable = !(flags & MEMORY_READ_ONLY);
         pml1_entry->user = flags & MEMORY_USER;
         pml1_entry->physical_address = (physical_range.base() + i * ARCH_PAGE_SIZE) / ARCH_PAGE_SIZE;
     }
@@ -16,6 +16,7 @@
 #include "archs/x86/PIC.h"
 #include "archs/x86/PIT.h"
 #include "archs/x86/RTC.h"
+#include "archs/x86/TSC.h"
 
 #include "archs/x86_64/GDT.h"
 #include "archs/x86_64/IDT.h"
@@ -44,6 +45,7 @@ extern "C" void arch_main(void *info, uint32_t magic)
     idt_initialize();
     pic_initialize();
     fpu_initialize();
+    tsc_initialize();
     pit_initialize(1000);
 
     system_main(handover);
@@ -74,6 +76,12 @@ void arch_load_context(Task *task)
 {
     fpu_load_context(task);
     set_kernel_stack((uint64_t)task->kernel_stack + PROCESS_STACK_SIZE);
+    arch_load_tls(task);
+}
+
+void arch_load_tls(Task *task)
+{
+    wrmsr(MSR_FS_BASE, task->tls_base & 0xffffffff, task->tls_base >> 32);
 }
 
 void arch_task_go(Task *task)
@@ -120,6 +128,45 @@ TimeStamp arch_get_time()
     return rtc_now();
 }
 
+uint64_t arch_get_monotonic_time()
+{
+    if (tsc_available())
+    {
+        return tsc_nanoseconds();
+    }
+
+    return system_get_timer_interrupts() * 1000000ull;
+}
+
+bool arch_timer_arm(uint64_t deadline)
+{
+    // Without the time stamp counter the timer interrupts are the clock, they
+    // have to keep coming at a fixed rate.
+    if (!tsc_available())
+    {
+        return false;
+    }
+
+    uint64_t now = tsc_nanoseconds();
+
+    pit_oneshot(deadline > now ? deadline - now : 0);
+
+    return true;
+}
+
+bool arch_clock_calibration(uint64_t *cycles_at_boot, uint64_t *nanoseconds_per_cycle)
+{
+    if (!tsc_available())
+    {
+        return false;
+    }
+
+    *cycles_at_boot = tsc_at_boot();
+    *nanoseconds_per_cycle = tsc_scale();
+
+    return true;
+}
+
 NO_RETURN void arch_reboot()
 {
     logger_warn("STUB %s", __func__);
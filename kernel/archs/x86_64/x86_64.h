@@ -9,3 +9,12 @@ static inline uint64_t RBP()
                  : "=r"(r));
     return r;
 }
+
+#define MSR_FS_BASE 0xC0000100
+
+static inline void wrmsr(uint32_t msr, uint32_t lo, uint32_t hi)
+{
+    asm volatile("wrmsr"
+                 :
+                 : "a"(lo), "d"(hi), "c"(msr));
+}
@@ -25,7 +25,6 @@ KERNEL_LIBRARIES_SOURCES = \
 	$(wildcard userspace/libraries/libsystem/process/*.cpp) \
 	$(wildcard userspace/libraries/libsystem/utils/*.cpp) \
 	$(wildcard userspace/libraries/libsystem/core/*.cpp) \
-	$(wildcard userspace/libraries/libsystem/thread/*.cpp) \
 	$(wildcard userspace/libraries/libsystem/system/*.cpp) \
 
 KERNEL_BINARY = $(BUILDROOT)/kernel.bin
@@ -16,7 +16,9 @@
     __ENTRY(CONSOLE, console)         \
     __ENTRY(ZERO, zero)               \
     __ENTRY(SOUND, sound)             \
-    __ENTRY(PCSPEAKER, speaker)
+    __ENTRY(PCSPEAKER, speaker)       \
+    __ENTRY(PROFILER, profiler)       \
+    __ENTRY(TRACE, trace)
 
 enum class DeviceClass : uint8_t
 {
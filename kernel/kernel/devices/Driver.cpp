@@ -14,7 +14,9 @@
 #include "ps2/LegacyKeyboard.h"
 #include "ps2/LegacyMouse.h"
 #include "unix/UnixNull.h"
+#include "unix/UnixProfiler.h"
 #include "unix/UnixRandom.h"
+#include "unix/UnixTrace.h"
 #include "unix/UnixZero.h"
 #include "virtio/VirtioBlock.h"
 #include "virtio/VirtioConsole.h"
@@ -61,6 +63,8 @@ void driver_initialize()
     _matchers->push_back(new UNIXDeviceMatcher<UnixNull>{"Unix Null Device", UNIX_NULL});
     _matchers->push_back(new UNIXDeviceMatcher<UnixRandom>{"Unix Random Device", UNIX_RANDOM});
     _matchers->push_back(new UNIXDeviceMatcher<UnixZero>{"Unix Zero Device", UNIX_ZERO});
+    _matchers->push_back(new UNIXDeviceMatcher<UnixProfiler>{"Unix Profiler Device", UNIX_PROFILER});
+    _matchers->push_back(new UNIXDeviceMatcher<UnixTrace>{"Unix Trace Device", UNIX_TRACE});
 
     for (size_t i = 0; i < _matchers->count(); i++)
     {
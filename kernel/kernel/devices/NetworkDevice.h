@@ -0,0 +1,159 @@
+#pragma once
+
+#include <abi/Network.h>
+#include <libmath/MinMax.h>
+#include <string.h>
+
+#include "kernel/devices/Device.h"
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/MMIO.h"
+#include "kernel/memory/MemoryObject.h"
+
+// What every network driver has in common: the NetworkRings shared with the
+// network stack, the IOCalls around them, read() and write() for tools using
+// the device directly, and the counters of both queues. `TDevice` is the bus
+// specific base class, PCIDevice or VirtioDevice.
+//
+// Drivers only implement sync(), which moves whole batches of frames between
+// the rings and their hardware. They keep their interrupts masked while the
+// stack has frames left to pick up, it calls sync() again once it's done.
+template <typename TDevice>
+class NetworkDevice : public TDevice
+{
+private:
+    MemoryObject *_rings_object = nullptr;
+    RefPtr<MMIORange> _rings_range{};
+
+protected:
+    NetworkRings *_rings = nullptr;
+
+    NetworkQueueStats _rx_stats{};
+    NetworkQueueStats _tx_stats{};
+    uint64_t _interrupts = 0;
+
+    uintptr_t rings_physical_base() { return _rings_range->physical_base(); }
+
+    static void count_batch(NetworkQueueStats &stats, uint32_t packets, uint64_t bytes)
+    {
+        if (packets == 0)
+        {
+            return;
+        }
+
+        stats.packets += packets;
+        stats.bytes += bytes;
+        stats.batches++;
+        stats.largest_batch = MAX(stats.largest_batch, packets);
+    }
+
+    // Reclaims sent frames, submits the new ones and publishes the received
+    // ones, always called with interrupts off.
+    virtual void sync() = 0;
+
+public:
+    virtual MacAddress mac_address() = 0;
+
+    NetworkDevice(DeviceAddress address) : TDevice(address, DeviceClass::NETWORK)
+    {
+        _rings_object = memory_object_create_contiguous(NetworkRings::SIZE);
+        _rings_range = make<MMIORange>(MemoryRange{_rings_object->page(0), _rings_object->size()});
+        _rings = reinterpret_cast<NetworkRings *>(_rings_range->base());
+
+        memset(_rings, 0, sizeof(NetworkRings));
+    }
+
+    ~NetworkDevice()
+    {
+        _rings_range = nullptr;
+        memory_object_deref(_rings_object);
+    }
+
+    // One frame at a time and with a copy, the network stack maps the rings
+    // instead.
+    ResultOr<size_t> read(size64_t offset, void *buffer, size_t size) override
+    {
+        UNUSED(offset);
+
+        InterruptsRetainer retainer;
+
+        sync();
+
+        NetworkRing &rx = _rings->rx;
+
+        if (rx.tail == rx.head)
+        {
+            return 0;
+        }
+
+        // The lengths live in memory the network stack can write to.
+        size_t packet_size = MIN(MIN(rx.lengths[rx.tail % NETWORK_RING_SLOTS], NETWORK_FRAME_SIZE), size);
+        memcpy(buffer, _rings->rx_frame(rx.tail), packet_size);
+        __atomic_store_n(&rx.tail, rx.tail + 1, __ATOMIC_RELEASE);
+
+        sync();
+
+        return packet_size;
+    }
+
+    ResultOr<size_t> write(size64_t offset, const void *buffer, size_t size) override
+    {
+        UNUSED(offset);
+
+        InterruptsRetainer retainer;
+
+        sync();
+
+        NetworkRing &tx = _rings->tx;
+
+        if (tx.head - tx.tail >= NETWORK_RING_SLOTS)
+        {
+            return 0;
+        }
+
+        size_t packet_size = MIN(size, NETWORK_FRAME_SIZE);
+        memcpy(_rings->tx_frame(tx.head), buffer, packet_size);
+        tx.lengths[tx.head % NETWORK_RING_SLOTS] = packet_size;
+        __atomic_store_n(&tx.head, tx.head + 1, __ATOMIC_RELEASE);
+
+        sync();
+
+        return packet_size;
+    }
+
+    Result call(IOCall request, void *args) override
+    {
+        if (request == IOCALL_NETWORK_GET_STATE)
+        {
+            IOCallNetworkSateAgs *state = (IOCallNetworkSateAgs *)args;
+            state->mac_address = mac_address();
+            return SUCCESS;
+        }
+        else if (request == IOCALL_NETWORK_MAP_RINGS)
+        {
+            IOCallNetworkRingsArgs *rings = (IOCallNetworkRingsArgs *)args;
+            rings->handle = _rings_object->id;
+            rings->size = _rings_object->size();
+            return SUCCESS;
+        }
+        else if (request == IOCALL_NETWORK_SYNC)
+        {
+            InterruptsRetainer retainer;
+            sync();
+            return SUCCESS;
+        }
+        else if (request == IOCALL_NETWORK_GET_STATS)
+        {
+            InterruptsRetainer retainer;
+
+            IOCallNetworkStatsArgs *stats = (IOCallNetworkStatsArgs *)args;
+            stats->rx = _rx_stats;
+            stats->tx = _tx_stats;
+            stats->interrupts = _interrupts;
+            return SUCCESS;
+        }
+        else
+        {
+            return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+        }
+    }
+};
@@ -4,6 +4,7 @@
 #include "kernel/devices/Devices.h"
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/node/EventQueue.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
 
@@ -73,6 +74,8 @@ void dispatcher_service()
                     devices_handle_interrupt(i);
                 }
             }
+
+            FsEventQueue::notify_devices();
         }
     }
 }
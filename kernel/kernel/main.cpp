@@ -14,6 +14,7 @@
 #include "kernel/modules/Modules.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/storage/Partitions.h"
+#include "kernel/system/Clock.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Tasking.h"
 #include "kernel/tasking/Userspace.h"
@@ -21,6 +22,8 @@
 #include "devfs/DevicesFileSystem.h"
 #include "devfs/DevicesInfo.h"
 #include "procfs/ProcessInfo.h"
+#include "procfs/SlabInfo.h"
+#include "procfs/SyscallInfo.h"
 
 static void splash_screen()
 {
@@ -41,6 +44,7 @@ void system_main(Handover *handover)
     splash_screen();
     system_initialize();
     memory_initialize(handover);
+    clock_initialize();
     scheduler_initialize();
     tasking_initialize();
     interrupts_initialize();
@@ -49,6 +53,8 @@ void system_main(Handover *handover)
     device_initialize();
     partitions_initialize();
     process_info_initialize();
+    slab_info_initialize();
+    syscall_info_initialize();
     device_info_initialize();
     devices_filesystem_initialize();
     graphic_initialize(handover);
@@ -1,16 +1,31 @@
-#include <libsystem/utils/List.h>
+#include <libutils/ResultOr.h>
+
+#include "archs/Arch.h"
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/memory/Memory.h"
 #include "kernel/memory/MemoryObject.h"
 #include "kernel/memory/Physical.h"
 
+static constexpr int MEMORY_OBJECT_BUCKETS = 1024;
+
 static int _memory_object_id = 0;
-static List *_memory_objects;
+
+// Ids are handed out sequentially, so id % MEMORY_OBJECT_BUCKETS spreads
+// them evenly and chains stay short.
+static MemoryObject *_memory_objects[MEMORY_OBJECT_BUCKETS] = {};
+
+static MemoryObject *&bucket(int id)
+{
+    return _memory_objects[id % MEMORY_OBJECT_BUCKETS];
+}
 
 void memory_object_initialize()
 {
-    _memory_objects = list_create();
+    for (int i = 0; i < MEMORY_OBJECT_BUCKETS; i++)
+    {
+        _memory_objects[i] = nullptr;
+    }
 }
 
 MemoryObject *memory_object_create(size_t size)
@@ -19,23 +34,55 @@ MemoryObject *memory_object_create(size_t size)
 
     size = PAGE_ALIGN_UP(size);
 
-    MemoryObject *memory_object = CREATE(MemoryObject);
+    MemoryObject *memory_object = new MemoryObject{};
 
     memory_object->id = _memory_object_id++;
     memory_object->refcount = 1;
-    memory_object->_range = physical_alloc(size);
+    memory_object->_size = size;
+    memory_object->_pages = (uintptr_t *)calloc(size / ARCH_PAGE_SIZE, sizeof(uintptr_t));
 
-    list_pushback(_memory_objects, memory_object);
+    memory_object->_next = bucket(memory_object->id);
+    bucket(memory_object->id) = memory_object;
+
+    return memory_object;
+}
+
+MemoryObject *memory_object_create_contiguous(size_t size)
+{
+    InterruptsRetainer retainer;
+
+    MemoryObject *memory_object = memory_object_create(size);
+    MemoryRange physical_range = physical_alloc(memory_object->size());
+
+    for (size_t i = 0; i < memory_object->page_count(); i++)
+    {
+        memory_object->_pages[i] = physical_range.base() + i * ARCH_PAGE_SIZE;
+    }
 
     return memory_object;
 }
 
 void memory_object_destroy(MemoryObject *memory_object)
 {
-    list_remove(_memory_objects, memory_object);
+    MemoryObject **link = &bucket(memory_object->id);
+
+    while (*link != memory_object)
+    {
+        link = &(*link)->_next;
+    }
+
+    *link = memory_object->_next;
+
+    for (size_t i = 0; i < memory_object->page_count(); i++)
+    {
+        if (memory_object->_pages[i])
+        {
+            physical_free({memory_object->_pages[i], ARCH_PAGE_SIZE});
+        }
+    }
 
-    physical_free(memory_object->range());
-    free(memory_object);
+    free(memory_object->_pages);
+    delete memory_object;
 }
 
 MemoryObject *memory_object_ref(MemoryObject *memory_object)
@@ -59,7 +106,7 @@ MemoryObject *memory_object_by_id(int id)
 {
     InterruptsRetainer retainer;
 
-    list_foreach(MemoryObject, memory_object, _memory_objects)
+    for (MemoryObject *memory_object = bucket(id); memory_object; memory_object = memory_object->_next)
     {
         if (memory_object->id == id)
         {
@@ -70,3 +117,74 @@ MemoryObject *memory_object_by_id(int id)
 
     return nullptr;
 }
+
+uintptr_t memory_object_commit(MemoryObject *memory_object, size_t index)
+{
+    InterruptsRetainer retainer;
+
+    assert(index < memory_object->page_count());
+
+    if (memory_object->_pages[index])
+    {
+        return memory_object->_pages[index];
+    }
+
+    // Take the frame right after the previous page when it's free, objects
+    // committed in order then end up contiguous and get mapped in long runs.
+    if (index > 0 && memory_object->_pages[index - 1])
+    {
+        MemoryRange next{memory_object->_pages[index - 1] + ARCH_PAGE_SIZE, ARCH_PAGE_SIZE};
+
+        if (next.base() != 0 && !physical_is_used(next))
+        {
+            physical_set_used(next);
+            memory_object->_pages[index] = next.base();
+
+            return next.base();
+        }
+    }
+
+    memory_object->_pages[index] = physical_alloc(ARCH_PAGE_SIZE).base();
+
+    return memory_object->_pages[index];
+}
+
+void memory_object_commit_all(MemoryObject *memory_object)
+{
+    for (size_t i = 0; i < memory_object->page_count(); i++)
+    {
+        memory_object_commit(memory_object, i);
+    }
+}
+
+Result memory_object_map(MemoryObject *memory_object, void *address_space, uintptr_t address, MemoryFlags flags)
+{
+    InterruptsRetainer retainer;
+
+    size_t i = 0;
+
+    while (i < memory_object->page_count())
+    {
+        if (!memory_object->_pages[i])
+        {
+            // Left unmapped, the first access will fault and commit it.
+            i++;
+            continue;
+        }
+
+        size_t run = 1;
+
+        while (i + run < memory_object->page_count() &&
+               memory_object->_pages[i + run] == memory_object->_pages[i] + run * ARCH_PAGE_SIZE)
+        {
+            run++;
+        }
+
+        MemoryRange physical_range{memory_object->_pages[i], run * ARCH_PAGE_SIZE};
+        TRY(arch_virtual_map(address_space, physical_range, address + i * ARCH_PAGE_SIZE, flags));
+
+        i += run;
+    }
+
+    return SUCCESS;
+}
@@ -2,20 +2,40 @@
 
 #include <libsystem/Common.h>
 
+#include "kernel/memory/Memory.h"
+#include "kernel/memory/Slab.h"
+
 struct MemoryObject
 {
     int id;
-    MemoryRange _range;
+    size_t _size;
 
     int refcount;
 
-    auto range() { return _range; }
+    // Physical address of each page, zero until the page gets committed on
+    // first access, so objects never need physically contiguous memory.
+    uintptr_t *_pages;
+
+    // Chaining for the id index.
+    MemoryObject *_next;
+
+    SLAB_ALLOCATED(MemoryObject);
+
+    size_t size() { return _size; }
+
+    size_t page_count() { return _size / ARCH_PAGE_SIZE; }
+
+    uintptr_t page(size_t index) { return _pages[index]; }
 };
 
 void memory_object_initialize();
 
 MemoryObject *memory_object_create(size_t size);
 
+// Committed upfront in one physically contiguous run, for buffers a device
+// reads and writes directly.
+MemoryObject *memory_object_create_contiguous(size_t size);
+
 void memory_object_destroy(MemoryObject *memory_object);
 
 MemoryObject *memory_object_ref(MemoryObject *memory_object);
@@ -23,3 +43,9 @@ MemoryObject *memory_object_ref(MemoryObject *memory_object);
 void memory_object_deref(MemoryObject *memory_object);
 
 MemoryObject *memory_object_by_id(int id);
+
+uintptr_t memory_object_commit(MemoryObject *memory_object, size_t index);
+
+void memory_object_commit_all(MemoryObject *memory_object);
+
+Result memory_object_map(MemoryObject *memory_object, void *address_space, uintptr_t address, MemoryFlags flags);
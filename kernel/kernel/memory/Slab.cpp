@@ -0,0 +1,315 @@
+#include <assert.h>
+#include <libmath/MinMax.h>
+#include <libsystem/Logger.h>
+#include <stdlib.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/Memory.h"
+#include "kernel/memory/Slab.h"
+
+struct Slab
+{
+    SlabCache *cache;
+
+    Slab *prev;
+    Slab *next;
+
+    void *free;
+    size_t used;
+};
+
+// Sits in front of every object so freeing doesn't need to know the cache.
+// Objects too large for the generic caches come from malloc with a null slab.
+struct SlabObject
+{
+    Slab *slab;
+    uintptr_t padding;
+};
+
+static constexpr size_t SLAB_ALIGN = 16;
+static constexpr size_t SLAB_MIN_OBJECTS = 8;
+static constexpr size_t SLAB_HEADER_SIZE = ALIGN_UP(sizeof(Slab), SLAB_ALIGN);
+
+static constexpr size_t SLAB_GENERIC_MIN = 32;
+static constexpr size_t SLAB_GENERIC_MAX = 4096;
+static constexpr int SLAB_GENERIC_COUNT = 8;
+
+static const char *_generic_names[SLAB_GENERIC_COUNT] = {
+    "generic-32",
+    "generic-64",
+    "generic-128",
+    "generic-256",
+    "generic-512",
+    "generic-1024",
+    "generic-2048",
+    "generic-4096",
+};
+
+static SlabCache *_generic_caches[SLAB_GENERIC_COUNT] = {};
+
+static SlabCache *_caches = nullptr;
+
+/* --- Slabs ---------------------------------------------------------------- */
+
+static size_t slab_stride(SlabCache *cache)
+{
+    return sizeof(SlabObject) + cache->object_size;
+}
+
+static void slab_push(Slab *&list, Slab *slab)
+{
+    slab->prev = nullptr;
+    slab->next = list;
+
+    if (list)
+    {
+        list->prev = slab;
+    }
+
+    list = slab;
+}
+
+static void slab_remove(Slab *&list, Slab *slab)
+{
+    if (slab->prev)
+    {
+        slab->prev->next = slab->next;
+    }
+    else
+    {
+        list = slab->next;
+    }
+
+    if (slab->next)
+    {
+        slab->next->prev = slab->prev;
+    }
+
+    slab->prev = nullptr;
+    slab->next = nullptr;
+}
+
+static Slab *slab_create(SlabCache *cache)
+{
+    uintptr_t address = 0;
+
+    // Objects are constructed by their users, there is no point in clearing.
+    if (memory_alloc(arch_kernel_address_space(), cache->slab_size, MEMORY_NONE, &address) != SUCCESS)
+    {
+        return nullptr;
+    }
+
+    Slab *slab = (Slab *)address;
+
+    slab->cache = cache;
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    slab->free = nullptr;
+    slab->used = 0;
+
+    // Thread the free list backward so objects are handed out in address order.
+    for (size_t i = cache->objects_per_slab; i > 0; i--)
+    {
+        auto header = (SlabObject *)(address + SLAB_HEADER_SIZE + (i - 1) * slab_stride(cache));
+        header->slab = slab;
+
+        void **object = (void **)(header + 1);
+        *object = slab->free;
+        slab->free = object;
+    }
+
+    cache->slab_count++;
+
+    return slab;
+}
+
+static void slab_destroy(Slab *slab)
+{
+    slab->cache->slab_count--;
+
+    memory_free(arch_kernel_address_space(), {(uintptr_t)slab, slab->cache->slab_size});
+}
+
+/* --- Caches --------------------------------------------------------------- */
+
+SlabCache *slab_cache_create(const char *name, size_t size)
+{
+    InterruptsRetainer retainer;
+
+    auto cache = (SlabCache *)calloc(1, sizeof(SlabCache));
+
+    cache->name = name;
+    cache->object_size = ALIGN_UP(MAX(size, sizeof(void *)), SLAB_ALIGN);
+
+    // Small objects share a single page, bigger ones get enough pages for a
+    // handful of them so a slab isn't mostly wasted space.
+    if (SLAB_HEADER_SIZE + slab_stride(cache) * SLAB_MIN_OBJECTS > ARCH_PAGE_SIZE * 2)
+    {
+        cache->slab_size = PAGE_ALIGN_UP(SLAB_HEADER_SIZE + slab_stride(cache) * SLAB_MIN_OBJECTS);
+    }
+    else
+    {
+        cache->slab_size = ARCH_PAGE_SIZE;
+    }
+
+    cache->objects_per_slab = (cache->slab_size - SLAB_HEADER_SIZE) / slab_stride(cache);
+
+    cache->next = _caches;
+    _caches = cache;
+
+    return cache;
+}
+
+void *slab_alloc(SlabCache *cache)
+{
+    InterruptsRetainer retainer;
+
+    Slab *slab = cache->partial;
+
+    if (!slab)
+    {
+        if (cache->empty)
+        {
+            slab = cache->empty;
+            cache->empty = nullptr;
+        }
+        else
+        {
+            slab = slab_create(cache);
+        }
+
+        if (!slab)
+        {
+            logger_error("Failed to grow slab cache %s!", cache->name);
+            return nullptr;
+        }
+
+        slab_push(cache->partial, slab);
+    }
+
+    void **object = (void **)slab->free;
+    slab->free = *object;
+    slab->used++;
+
+    if (!slab->free)
+    {
+        slab_remove(cache->partial, slab);
+        slab_push(cache->full, slab);
+    }
+
+    cache->used++;
+    cache->allocations++;
+
+    return object;
+}
+
+void *slab_alloc_sized(size_t size)
+{
+    int index = 0;
+
+    for (size_t class_size = SLAB_GENERIC_MIN; class_size < size; class_size *= 2)
+    {
+        index++;
+    }
+
+    if (index >= SLAB_GENERIC_COUNT)
+    {
+        auto header = (SlabObject *)malloc(sizeof(SlabObject) + size);
+
+        if (!header)
+        {
+            return nullptr;
+        }
+
+        header->slab = nullptr;
+
+        return header + 1;
+    }
+
+    InterruptsRetainer retainer;
+
+    if (!_generic_caches[index])
+    {
+        _generic_caches[index] = slab_cache_create(_generic_names[index], SLAB_GENERIC_MIN << index);
+    }
+
+    return slab_alloc(_generic_caches[index]);
+}
+
+void *slab_alloc_for(SlabCache *&cache, const char *name, size_t size, size_t requested)
+{
+    if (requested > size)
+    {
+        return slab_alloc_sized(requested);
+    }
+
+    InterruptsRetainer retainer;
+
+    if (!cache)
+    {
+        cache = slab_cache_create(name, size);
+    }
+
+    return slab_alloc(cache);
+}
+
+void slab_free(void *object)
+{
+    if (!object)
+    {
+        return;
+    }
+
+    auto header = (SlabObject *)object - 1;
+
+    if (!header->slab)
+    {
+        free(header);
+        return;
+    }
+
+    InterruptsRetainer retainer;
+
+    Slab *slab = header->slab;
+    SlabCache *cache = slab->cache;
+
+    if (!slab->free)
+    {
+        slab_remove(cache->full, slab);
+        slab_push(cache->partial, slab);
+    }
+
+    *(void **)object = slab->free;
+    slab->free = object;
+    slab->used--;
+    cache->used--;
+
+    if (slab->used == 0)
+    {
+        slab_remove(cache->partial, slab);
+
+        if (cache->empty)
+        {
+            slab_destroy(slab);
+        }
+        else
+        {
+            cache->empty = slab;
+        }
+    }
+}
+
+void slab_cache_iterate(void *target, SlabCacheIterateCallback callback)
+{
+    InterruptsRetainer retainer;
+
+    for (SlabCache *cache = _caches; cache; cache = cache->next)
+    {
+        if (callback(target, cache) == Iteration::STOP)
+        {
+            return;
+        }
+    }
+}
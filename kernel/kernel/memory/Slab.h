@@ -0,0 +1,61 @@
+#pragma once
+
+#include <libutils/Iteration.h>
+
+#include <libsystem/Common.h>
+
+// Object caches for the kernel's hot allocations. Every cache hands out objects
+// of a single size from page sized slabs and keeps freed objects on a LIFO
+// list, so allocating is popping a pointer instead of walking the heap.
+
+struct Slab;
+
+struct SlabCache
+{
+    const char *name;
+
+    size_t object_size;
+    size_t slab_size;
+    size_t objects_per_slab;
+
+    // Slabs with free objects first, then full ones. At most one fully free
+    // slab is kept around, the others go back to the page allocator.
+    Slab *partial;
+    Slab *full;
+    Slab *empty;
+
+    size_t slab_count;
+    size_t used;
+    size_t allocations;
+
+    SlabCache *next;
+};
+
+SlabCache *slab_cache_create(const char *name, size_t size);
+
+void *slab_alloc(SlabCache *cache);
+
+// Picks a generic cache by size, for class hierarchies with different sizes.
+void *slab_alloc_sized(size_t size);
+
+void slab_free(void *object);
+
+// Allocates from the cache of a class, creating it on first use. Subclasses
+// larger than the class itself are served from the generic caches.
+void *slab_alloc_for(SlabCache *&cache, const char *name, size_t size, size_t requested);
+
+typedef Iteration (*SlabCacheIterateCallback)(void *target, SlabCache *cache);
+void slab_cache_iterate(void *target, SlabCacheIterateCallback callback);
+
+#define SLAB_ALLOCATED(__type)                                                       \
+    static inline SlabCache *__slab_cache = nullptr;                                 \
+                                                                                     \
+    static void *operator new(size_t size)                                           \
+    {                                                                                \
+        return slab_alloc_for(__slab_cache, #__type, sizeof(__type), size);          \
+    }                                                                                \
+                                                                                     \
+    static void operator delete(void *object)                                        \
+    {                                                                                \
+        slab_free(object);                                                           \
+    }
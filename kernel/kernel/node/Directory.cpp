@@ -9,107 +9,147 @@ FsDirectory::FsDirectory() : FsNode(FILE_TYPE_DIRECTORY)
 {
 }
 
-Result FsDirectory::open(FsHandle &handle)
+int FsDirectory::lookup(const String &name, uint32_t hash)
 {
-    FileListing *listing = (FileListing *)malloc(sizeof(FileListing) + sizeof(DirectoryEntry) * _childs.count());
+    if (_index.empty())
+    {
+        return -1;
+    }
+
+    size_t mask = _index.count() - 1;
 
-    listing->count = _childs.count();
+    for (size_t slot = hash & mask; _index[slot] != -1; slot = (slot + 1) & mask)
+    {
+        auto &entry = _childs[_index[slot]];
+
+        if (entry.hash == hash && entry.name == name)
+        {
+            return _index[slot];
+        }
+    }
+
+    return -1;
+}
+
+void FsDirectory::index(int child)
+{
+    size_t mask = _index.count() - 1;
+    size_t slot = _childs[child].hash & mask;
+
+    while (_index[slot] != -1)
+    {
+        slot = (slot + 1) & mask;
+    }
 
-    int current_index = 0;
+    _index[slot] = child;
+}
 
-    _childs.foreach ([&](auto &entry) {
-        auto record = &listing->entries[current_index];
-        auto node = entry.node;
+void FsDirectory::reindex()
+{
+    size_t size = 16;
 
-        strcpy(record->name, entry.name.cstring());
+    while (size < _childs.count() * 2)
+    {
+        size *= 2;
+    }
 
-        record->stat.type = node->type();
-        record->stat.size = node->size();
+    _index.clear();
 
-        current_index++;
+    for (size_t i = 0; i < size; i++)
+    {
+        _index.push_back(-1);
+    }
 
-        return Iteration::CONTINUE;
-    });
+    for (size_t i = 0; i < _childs.count(); i++)
+    {
+        index(i);
+    }
+}
 
-    handle.attached = listing;
+Result FsDirectory::open(FsHandle &handle)
+{
+    UNUSED(handle);
 
     return SUCCESS;
 }
 
 void FsDirectory::close(FsHandle &handle)
 {
-    free(handle.attached);
+    UNUSED(handle);
 }
 
 ResultOr<size_t> FsDirectory::read(FsHandle &handle, void *buffer, size_t size)
 {
-    if (size == sizeof(DirectoryEntry))
+    if (size != sizeof(DirectoryEntry))
     {
-        size_t index = handle.offset() / sizeof(DirectoryEntry);
+        return 0;
+    }
 
-        FileListing *listing = (FileListing *)handle.attached;
+    // Entries are read straight from the directory, so a concurrent unlink
+    // may shift the listing and make a reader skip one of them.
+    size_t index = handle.offset() / sizeof(DirectoryEntry);
 
-        if (index < listing->count)
-        {
-            *((DirectoryEntry *)buffer) = listing->entries[index];
-
-            return sizeof(DirectoryEntry);
-        }
-        else
-        {
-            return 0;
-        }
-    }
-    else
+    if (index >= _childs.count())
     {
         return 0;
     }
+
+    auto &entry = _childs[index];
+    auto record = (DirectoryEntry *)buffer;
+
+    strlcpy(record->name, entry.name.cstring(), FILE_NAME_LENGTH);
+    record->stat.type = entry.node->type();
+    record->stat.size = entry.node->size();
+
+    return sizeof(DirectoryEntry);
 }
 
 RefPtr<FsNode> FsDirectory::find(String name)
 {
-    RefPtr<FsNode> result;
-
-    _childs.foreach ([&](auto &entry) {
-        if (entry.name == name)
-        {
-            result = entry.node;
+    int child = lookup(name, hash<String>(name));
 
-            return Iteration::STOP;
-        }
-
-        return Iteration::CONTINUE;
-    });
+    if (child == -1)
+    {
+        return nullptr;
+    }
 
-    return result;
+    return _childs[child].node;
 }
 
 Result FsDirectory::link(String name, RefPtr<FsNode> child)
 {
-    if (find(name))
+    uint32_t name_hash = hash<String>(name);
+
+    if (lookup(name, name_hash) != -1)
     {
         return ERR_FILE_EXISTS;
     }
 
-    _childs.push_back({name, child});
+    _childs.push_back({name, name_hash, child});
+
+    if (_childs.count() * 2 > _index.count())
+    {
+        reindex();
+    }
+    else
+    {
+        index(_childs.count() - 1);
+    }
 
     return SUCCESS;
 }
 
 Result FsDirectory::unlink(String name)
 {
+    int child = lookup(name, hash<String>(name));
 
-    bool has_removed_an_entry = _childs.remove_all_match(
-        [&](auto &e) {
-            return e.name == name;
-        });
-
-    if (has_removed_an_entry)
-    {
-        return SUCCESS;
-    }
-    else
+    if (child == -1)
     {
         return ERR_NO_SUCH_FILE_OR_DIRECTORY;
     }
+
+    _childs.remove_index(child);
+    reindex();
+
+    return SUCCESS;
 }
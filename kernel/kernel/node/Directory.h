@@ -4,23 +4,28 @@
 
 #include "kernel/node/Node.h"
 
-struct FileListing
-{
-    size_t count;
-    DirectoryEntry entries[];
-};
-
 struct FsDirectoryEntry
 {
     String name;
+    uint32_t hash;
     RefPtr<FsNode> node;
 };
 
 class FsDirectory : public FsNode
 {
 private:
+    // Entries in link order, readdir walks them by position.
     Vector<FsDirectoryEntry> _childs{};
 
+    // Open addressing table of indexes into _childs, -1 for empty slots.
+    Vector<int> _index{};
+
+    int lookup(const String &name, uint32_t hash);
+
+    void index(int child);
+
+    void reindex();
+
 public:
     FsDirectory();
 
@@ -0,0 +1,203 @@
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/EventQueue.h"
+
+static FsEventQueue *_queues = nullptr;
+
+FsEventQueue::FsEventQueue() : FsNode(FILE_TYPE_EVENT_QUEUE)
+{
+    InterruptsRetainer retainer;
+
+    _next = _queues;
+    _queues = this;
+}
+
+FsEventQueue::~FsEventQueue()
+{
+    InterruptsRetainer retainer;
+
+    while (_interests.any())
+    {
+        remove(_interests[0]);
+    }
+
+    FsEventQueue **link = &_queues;
+
+    while (*link != this)
+    {
+        link = &(*link)->_next;
+    }
+
+    *link = _next;
+}
+
+EventInterest *FsEventQueue::interest_by_handle(int handle_index)
+{
+    for (size_t i = 0; i < _interests.count(); i++)
+    {
+        if (_interests[i]->handle_index == handle_index)
+        {
+            return _interests[i];
+        }
+    }
+
+    return nullptr;
+}
+
+void FsEventQueue::remove(EventInterest *interest)
+{
+    interest->handle->node()->unwatch(interest);
+
+    if (interest->pending)
+    {
+        EventInterest **link = &_pending;
+
+        while (*link != interest)
+        {
+            link = &(*link)->next_pending;
+        }
+
+        *link = interest->next_pending;
+    }
+
+    _interests.remove_value(interest);
+    delete interest;
+}
+
+void FsEventQueue::update(int handle_index, FsHandle *handle, PollEvent events)
+{
+    InterruptsRetainer retainer;
+
+    auto interest = interest_by_handle(handle_index);
+
+    if (interest && (events == 0 || interest->handle != handle))
+    {
+        remove(interest);
+        interest = nullptr;
+    }
+
+    if (events == 0)
+    {
+        return;
+    }
+
+    if (!interest)
+    {
+        interest = new EventInterest{this, handle_index, handle, events, false, nullptr};
+        _interests.push_back(interest);
+        handle->node()->watch(interest);
+    }
+
+    interest->events = events;
+
+    // The handle might be ready already.
+    mark_pending(interest);
+}
+
+void FsEventQueue::forget(FsHandle *handle)
+{
+    InterruptsRetainer retainer;
+
+    for (size_t i = _interests.count(); i > 0; i--)
+    {
+        if (_interests[i - 1]->handle == handle)
+        {
+            remove(_interests[i - 1]);
+        }
+    }
+}
+
+void FsEventQueue::forget_everywhere(FsHandle &handle)
+{
+    InterruptsRetainer retainer;
+
+    auto &watchers = handle.node()->watchers();
+
+    // Forgetting the handle removes its interests from the node.
+    for (size_t i = 0; i < watchers.count();)
+    {
+        if (watchers[i]->handle == &handle)
+        {
+            watchers[i]->queue->forget(&handle);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void FsEventQueue::mark_pending(EventInterest *interest)
+{
+    InterruptsRetainer retainer;
+
+    if (!interest->pending)
+    {
+        interest->pending = true;
+        interest->next_pending = _pending;
+        _pending = interest;
+    }
+}
+
+bool FsEventQueue::collect(Vector<EventQueueReady> &ready, size_t capacity)
+{
+    InterruptsRetainer retainer;
+
+    ready.clear();
+
+    // Whatever doesn't fit stays pending for the next wait.
+    EventInterest **link = &_pending;
+
+    while (*link && ready.count() < capacity)
+    {
+        auto interest = *link;
+        PollEvent result = interest->handle->poll(interest->events);
+
+        if (result)
+        {
+            ready.push_back({{interest->handle_index, interest->events, result}, interest->handle});
+            link = &interest->next_pending;
+        }
+        else
+        {
+            interest->pending = false;
+            *link = interest->next_pending;
+        }
+    }
+
+    // The interests that were reported go to the back, so when more are ready
+    // than the caller takes, the ones further down get their turn next time.
+    if (*link && link != &_pending)
+    {
+        EventInterest *rest = *link;
+        EventInterest **tail = &rest->next_pending;
+
+        while (*tail)
+        {
+            tail = &(*tail)->next_pending;
+        }
+
+        *tail = _pending;
+        *link = nullptr;
+        _pending = rest;
+    }
+
+    return ready.any();
+}
+
+void FsEventQueue::notify_devices()
+{
+    InterruptsRetainer retainer;
+
+    for (FsEventQueue *queue = _queues; queue; queue = queue->_next)
+    {
+        for (size_t i = 0; i < queue->_interests.count(); i++)
+        {
+            auto interest = queue->_interests[i];
+
+            if (interest->handle->node()->type() == FILE_TYPE_DEVICE)
+            {
+                queue->mark_pending(interest);
+            }
+        }
+    }
+}
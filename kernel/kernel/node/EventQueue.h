@@ -0,0 +1,76 @@
+#pragma once
+
+#include <abi/Handle.h>
+#include <libutils/Vector.h>
+
+#include "kernel/node/Handle.h"
+#include "kernel/node/Node.h"
+
+class FsEventQueue;
+
+// A handle a queue watches. Nodes keep a list of the interests on them and
+// flag them when their state changes, waiting then only has to look at what
+// was flagged instead of polling every handle.
+//
+// Like epoll, watching a handle doesn't keep it open: the interests on a
+// handle are dropped when it's destroyed, so closing it still closes the
+// node for the other end.
+struct EventInterest
+{
+    FsEventQueue *queue;
+
+    int handle_index;
+    FsHandle *handle;
+    PollEvent events;
+
+    bool pending;
+    EventInterest *next_pending;
+};
+
+struct EventQueueReady
+{
+    HandlePoll poll;
+
+    // Only compared against the task's handles, it might be gone by the time
+    // the waiting task looks at it.
+    FsHandle *handle;
+};
+
+class FsEventQueue : public FsNode
+{
+private:
+    Vector<EventInterest *> _interests{};
+
+    // Interests that might be ready, the others can't be until their node
+    // says otherwise.
+    EventInterest *_pending = nullptr;
+
+    FsEventQueue *_next = nullptr;
+
+    EventInterest *interest_by_handle(int handle_index);
+
+    void remove(EventInterest *interest);
+
+public:
+    FsEventQueue();
+
+    ~FsEventQueue();
+
+    // Events of zero removes the handle from the queue.
+    void update(int handle_index, FsHandle *handle, PollEvent events);
+
+    void forget(FsHandle *handle);
+
+    // Drops the interests of every queue on `handle`, it's being destroyed.
+    static void forget_everywhere(FsHandle &handle);
+
+    void mark_pending(EventInterest *interest);
+
+    // Polls the pending interests and returns whether any of them is ready.
+    // Level triggered: ready interests stay pending and are reported again
+    // on the next wait, the others are dropped until their node changes.
+    bool collect(Vector<EventQueueReady> &ready, size_t capacity);
+
+    // Device state changes from interrupts, which don't go through nodes.
+    static void notify_devices();
+};
@@ -25,6 +25,7 @@ Result FsFile::open(FsHandle &handle)
         _buffer = (char *)malloc(512);
         _buffer_allocated = 512;
         _buffer_size = 0;
+        _revision++;
     }
 
     return SUCCESS;
@@ -58,6 +59,7 @@ ResultOr<size_t> FsFile::write(FsHandle &handle, const void *buffer, size_t size
 
     _buffer_size = MAX(handle.offset() + size, _buffer_size);
     memcpy((char *)(_buffer) + handle.offset(), buffer, size);
+    _revision++;
 
     return size;
 }
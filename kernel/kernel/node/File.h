@@ -8,8 +8,13 @@ private:
     char *_buffer;
     size_t _buffer_allocated;
     size_t _buffer_size;
+    size_t _revision = 0;
 
 public:
+    // Bumped every time the content changes, so whoever caches something
+    // derived from the file can tell it's stale.
+    size_t revision() { return _revision; }
+
     FsFile();
 
     ~FsFile() override;
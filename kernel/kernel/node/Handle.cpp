@@ -6,6 +6,7 @@
 #include <libsystem/Result.h>
 
 #include "kernel/node/Connection.h"
+#include "kernel/node/EventQueue.h"
 #include "kernel/node/Handle.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
@@ -38,6 +39,8 @@ FsHandle::FsHandle(FsHandle &other)
 
 FsHandle::~FsHandle()
 {
+    FsEventQueue::forget_everywhere(*this);
+
     _node->acquire(scheduler_running_id());
     _node->close(*this);
     _node->release(scheduler_running_id());
@@ -111,6 +114,9 @@ ResultOr<size_t> FsHandle::read(void *buffer, size_t size)
     _offset += read_result.unwrap();
     _node->release(scheduler_running_id());
 
+    // Reading might have made room for writers.
+    _node->did_update();
+
     return read_result;
 }
 
@@ -146,6 +152,8 @@ ResultOr<size_t> FsHandle::write(const void *buffer, size_t size)
 
         _node->release(scheduler_running_id());
 
+        _node->did_update();
+
         return write_result;
     };
 
@@ -259,5 +267,8 @@ ResultOr<RefPtr<FsHandle>> FsHandle::accept()
 
     _node->release(scheduler_running_id());
 
+    // The client is waiting for the connection to be accepted.
+    connection->did_update();
+
     return connection_handle;
 }
@@ -3,6 +3,7 @@
 #include <abi/Handle.h>
 #include <libio/Seek.h>
 
+#include "kernel/memory/Slab.h"
 #include "kernel/node/Node.h"
 
 class FsHandle : public RefCounted<FsHandle>
@@ -14,6 +15,8 @@ private:
     size_t _offset = 0;
 
 public:
+    SLAB_ALLOCATED(FsHandle);
+
     void *attached;
     size_t attached_size;
 
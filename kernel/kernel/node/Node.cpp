@@ -1,5 +1,7 @@
 #include <string.h>
 
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/EventQueue.h"
 #include "kernel/node/Handle.h"
 #include "kernel/node/Node.h"
 
@@ -29,6 +31,8 @@ void FsNode::ref_handle(FsHandle &handle)
     {
         __atomic_add_fetch(&_server, 1, __ATOMIC_SEQ_CST);
     }
+
+    did_update();
 }
 
 void FsNode::deref_handle(FsHandle &handle)
@@ -52,6 +56,32 @@ void FsNode::deref_handle(FsHandle &handle)
     {
         __atomic_sub_fetch(&_server, 1, __ATOMIC_SEQ_CST);
     }
+
+    did_update();
+}
+
+void FsNode::watch(EventInterest *interest)
+{
+    InterruptsRetainer retainer;
+
+    _watchers.push_back(interest);
+}
+
+void FsNode::unwatch(EventInterest *interest)
+{
+    InterruptsRetainer retainer;
+
+    _watchers.remove_value(interest);
+}
+
+void FsNode::did_update()
+{
+    InterruptsRetainer retainer;
+
+    for (size_t i = 0; i < _watchers.count(); i++)
+    {
+        _watchers[i]->queue->mark_pending(_watchers[i]);
+    }
 }
 
 bool FsNode::is_acquire()
@@ -7,10 +7,14 @@
 #include <libutils/RefPtr.h>
 #include <libutils/ResultOr.h>
 #include <libutils/String.h>
+#include <libutils/Vector.h>
 #include <skift/Lock.h>
 
+#include "kernel/memory/Slab.h"
+
 struct FsNode;
 struct FsHandle;
+struct EventInterest;
 
 struct FsNode : public RefCounted<FsNode>
 {
@@ -23,7 +27,11 @@ private:
     unsigned int _clients = 0;
     unsigned int _server = 0;
 
+    Vector<EventInterest *> _watchers{};
+
 public:
+    SLAB_ALLOCATED(FsNode);
+
     FileType type() { return _type; }
 
     unsigned int readers() { return _readers; }
@@ -115,6 +123,15 @@ public:
 
     virtual ResultOr<RefPtr<FsNode>> accept() { return ERR_SOCKET_OPERATION_ON_NON_SOCKET; }
 
+    void watch(EventInterest *interest);
+
+    void unwatch(EventInterest *interest);
+
+    Vector<EventInterest *> &watchers() { return _watchers; }
+
+    // Lets event queues watching the node know its state might have changed.
+    void did_update();
+
     bool is_acquire();
 
     void acquire(int who_acquire);
@@ -0,0 +1,128 @@
+#include <libutils/Hash.h>
+#include <libutils/StringBuilder.h>
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/PathCache.h"
+
+static constexpr size_t PATH_CACHE_SIZE = 512;
+
+struct PathCacheEntry
+{
+    FsNode *root = nullptr;
+    uint32_t hash = 0;
+    String path{};
+
+    // Null for paths that didn't resolve.
+    RefPtr<FsNode> node{};
+};
+
+static PathCacheEntry *_entries = nullptr;
+static size_t _generation = 0;
+
+// Paths are only ever resolved element by element, so the key ignores
+// whether the path was absolute.
+static String path_cache_key(const IO::Path &path)
+{
+    StringBuilder builder{};
+
+    for (size_t i = 0; i < path.length(); i++)
+    {
+        builder.append('/');
+        builder.append(path[i]);
+    }
+
+    return builder.finalize();
+}
+
+static bool is_under(const String &path, const String &prefix)
+{
+    if (path.length() < prefix.length() ||
+        memcmp(path.cstring(), prefix.cstring(), prefix.length()) != 0)
+    {
+        return false;
+    }
+
+    return path.length() == prefix.length() || path[prefix.length()] == '/';
+}
+
+size_t path_cache_generation()
+{
+    InterruptsRetainer retainer;
+
+    return _generation;
+}
+
+bool path_cache_lookup(FsNode *root, const IO::Path &path, RefPtr<FsNode> &node)
+{
+    auto key = path_cache_key(path);
+    uint32_t key_hash = hash<String>(key);
+
+    InterruptsRetainer retainer;
+
+    if (!_entries)
+    {
+        return false;
+    }
+
+    auto &entry = _entries[key_hash % PATH_CACHE_SIZE];
+
+    if (entry.root != root || entry.hash != key_hash || entry.path != key)
+    {
+        return false;
+    }
+
+    node = entry.node;
+
+    return true;
+}
+
+void path_cache_insert(FsNode *root, const IO::Path &path, RefPtr<FsNode> node, size_t generation)
+{
+    auto key = path_cache_key(path);
+    uint32_t key_hash = hash<String>(key);
+
+    InterruptsRetainer retainer;
+
+    if (generation != _generation)
+    {
+        return;
+    }
+
+    if (!_entries)
+    {
+        _entries = new PathCacheEntry[PATH_CACHE_SIZE];
+    }
+
+    auto &entry = _entries[key_hash % PATH_CACHE_SIZE];
+
+    entry.root = root;
+    entry.hash = key_hash;
+    entry.path = key;
+    entry.node = node;
+}
+
+void path_cache_invalidate(const IO::Path &path)
+{
+    auto key = path_cache_key(path);
+
+    InterruptsRetainer retainer;
+
+    _generation++;
+
+    if (!_entries)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < PATH_CACHE_SIZE; i++)
+    {
+        auto &entry = _entries[i];
+
+        if (entry.root && is_under(entry.path, key))
+        {
+            entry.root = nullptr;
+            entry.path = "";
+            entry.node = nullptr;
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <libio/Path.h>
+
+#include "kernel/node/Node.h"
+
+// Remembers what paths resolved to, misses included, so looking up the same
+// path again doesn't have to walk and lock every directory on the way.
+// Anything that links or unlinks nodes must invalidate the affected path.
+
+size_t path_cache_generation();
+
+bool path_cache_lookup(FsNode *root, const IO::Path &path, RefPtr<FsNode> &node);
+
+// Does nothing if the cache was invalidated since generation was taken, the
+// result might be stale already.
+void path_cache_insert(FsNode *root, const IO::Path &path, RefPtr<FsNode> node, size_t generation);
+
+// Drops the path and everything below it.
+void path_cache_invalidate(const IO::Path &path);
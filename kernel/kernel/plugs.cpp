@@ -59,7 +59,12 @@ TimeStamp __plug_system_get_time()
 
 Tick __plug_system_get_ticks()
 {
-    return system_get_ticks();
+    return system_get_tick();
+}
+
+uint64_t __plug_system_get_monotonic_time()
+{
+    return arch_get_monotonic_time();
 }
 
 /* --- Memory allocator plugs ----------------------------------------------- */
@@ -76,8 +81,10 @@ void __plug_memory_unlock()
 
 void *__plug_memory_alloc(size_t size)
 {
+    // Blocks handed out by malloc are not zeroed anyway and calloc clears its
+    // own, clearing fresh heap pages would only be wasted time.
     uintptr_t address = 0;
-    assert(memory_alloc(arch_kernel_address_space(), size, MEMORY_CLEAR, &address) == SUCCESS);
+    assert(memory_alloc(arch_kernel_address_space(), size, MEMORY_NONE, &address) == SUCCESS);
     return (void *)address;
 }
 
@@ -1,4 +1,6 @@
+#include "kernel/node/EventQueue.h"
 #include "kernel/scheduling/Blocker.h"
+#include "kernel/scheduling/Futex.h"
 #include "kernel/tasking/Task.h"
 
 /* --- BlockerAccept -------------------------------------------------------- */
@@ -20,6 +22,13 @@ bool BlockerConnect::can_unblock(Task &)
     return _connection->is_accepted();
 }
 
+/* --- BlockerFutex -------------------------------------------------------- */
+
+bool BlockerFutex::can_unblock(Task &)
+{
+    return _waiter.woken;
+}
+
 /* --- BlockerRead ---------------------------------------------------------- */
 
 bool BlockerRead::can_unblock(Task &)
@@ -32,6 +41,13 @@ void BlockerRead::on_unblock(Task &task)
     _handle.node()->acquire(task.id);
 }
 
+/* --- BlockerEventQueue ---------------------------------------------------- */
+
+bool BlockerEventQueue::can_unblock(Task &)
+{
+    return _queue.collect(_ready, _capacity);
+}
+
 /* --- BlockerSelect -------------------------------------------------------- */
 
 bool BlockerSelect::can_unblock(Task &)
@@ -4,6 +4,8 @@
 
 #include <libutils/Vector.h>
 
+#include "archs/Arch.h"
+
 #include "kernel/node/Handle.h"
 #include "kernel/system/System.h"
 
@@ -13,13 +15,16 @@ class Blocker
 {
 private:
     Result _result = SUCCESS;
-    TimeStamp _timeout = -1;
+    // Nanoseconds since boot, or -1 to wait forever.
+    uint64_t _deadline = -1;
     bool _interrupted = false;
 
 public:
     Result result() { return _result; }
 
-    void timeout(TimeStamp ts) { _timeout = ts; }
+    uint64_t deadline() { return _deadline; }
+
+    void deadline(uint64_t deadline) { _deadline = deadline; }
 
     virtual ~Blocker() {}
 
@@ -44,7 +49,7 @@ public:
 
     bool has_timeout()
     {
-        return _timeout != (Timeout)-1 && _timeout <= system_get_tick();
+        return _deadline != (uint64_t)-1 && _deadline <= arch_get_monotonic_time();
     }
 
     bool is_interrupted()
@@ -128,6 +133,41 @@ public:
     bool can_unblock(Task &task) override;
 };
 
+class FsEventQueue;
+struct EventQueueReady;
+
+class BlockerEventQueue : public Blocker
+{
+private:
+    FsEventQueue &_queue;
+    Vector<EventQueueReady> &_ready;
+    size_t _capacity;
+
+public:
+    BlockerEventQueue(FsEventQueue &queue, Vector<EventQueueReady> &ready, size_t capacity)
+        : _queue{queue}, _ready{ready}, _capacity{capacity}
+    {
+    }
+
+    bool can_unblock(Task &task) override;
+};
+
+struct FutexWaiter;
+
+class BlockerFutex : public Blocker
+{
+private:
+    FutexWaiter &_waiter;
+
+public:
+    BlockerFutex(FutexWaiter &waiter)
+        : _waiter{waiter}
+    {
+    }
+
+    bool can_unblock(Task &task) override;
+};
+
 class BlockerTime : public Blocker
 {
 public:
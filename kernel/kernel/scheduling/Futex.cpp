@@ -0,0 +1,99 @@
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Futex.h"
+
+static constexpr int FUTEX_BUCKETS = 64;
+
+// Waiters are keyed by the process and the user address, threads of the same
+// process share the address space so that's enough to tell futexes apart.
+static FutexWaiter *_futex_waiters[FUTEX_BUCKETS] = {};
+
+static FutexWaiter *&bucket(Task *process, int *address)
+{
+    uintptr_t key = (uintptr_t)address ^ ((uintptr_t)process >> 4);
+
+    return _futex_waiters[(key >> 2) % FUTEX_BUCKETS];
+}
+
+static void futex_remove(FutexWaiter *waiter)
+{
+    FutexWaiter **link = &bucket(waiter->process, waiter->address);
+
+    while (*link && *link != waiter)
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link)
+    {
+        *link = waiter->next;
+    }
+}
+
+void futex_initialize()
+{
+    for (int i = 0; i < FUTEX_BUCKETS; i++)
+    {
+        _futex_waiters[i] = nullptr;
+    }
+}
+
+Result futex_wait(Task *task, int *address, int expected, Timeout timeout)
+{
+    FutexWaiter waiter{task->process(), address, false, nullptr};
+
+    {
+        InterruptsRetainer retainer;
+
+        // The value changed before we got here, the caller will retry.
+        if (__atomic_load_n(address, __ATOMIC_SEQ_CST) != expected)
+        {
+            return SUCCESS;
+        }
+
+        // Queued at the end, so waiters are woken up in the order they came.
+        FutexWaiter **link = &bucket(waiter.process, address);
+
+        while (*link)
+        {
+            link = &(*link)->next;
+        }
+
+        *link = &waiter;
+    }
+
+    BlockerFutex blocker{waiter};
+    Result result = task_block(task, blocker, timeout);
+
+    InterruptsRetainer retainer;
+
+    if (!waiter.woken)
+    {
+        futex_remove(&waiter);
+    }
+
+    return result;
+}
+
+void futex_wake(Task *task, int *address, int count)
+{
+    InterruptsRetainer retainer;
+
+    Task *process = task->process();
+    FutexWaiter **link = &bucket(process, address);
+
+    while (*link && count > 0)
+    {
+        FutexWaiter *waiter = *link;
+
+        if (waiter->process == process && waiter->address == address)
+        {
+            *link = waiter->next;
+            waiter->woken = true;
+            count--;
+        }
+        else
+        {
+            link = &waiter->next;
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "kernel/tasking/Task.h"
+
+struct FutexWaiter
+{
+    Task *process;
+    int *address;
+    bool woken;
+
+    FutexWaiter *next;
+};
+
+void futex_initialize();
+
+Result futex_wait(Task *task, int *address, int expected, Timeout timeout);
+
+void futex_wake(Task *task, int *address, int count);
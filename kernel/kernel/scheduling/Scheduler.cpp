@@ -7,6 +7,7 @@
 
 static bool scheduler_context_switch = false;
 static int scheduler_record[SCHEDULER_RECORD_COUNT] = {};
+static uint32_t scheduler_record_tick = 0;
 
 static Task *running = nullptr;
 static Task *idle = nullptr;
@@ -68,6 +69,11 @@ Task *scheduler_running()
     return running;
 }
 
+bool scheduler_is_idle()
+{
+    return running == idle;
+}
+
 int scheduler_running_id()
 {
     if (running == nullptr)
@@ -109,6 +115,46 @@ static Iteration wakeup_task_if_unblocked(void *, Task *task)
     return Iteration::CONTINUE;
 }
 
+// The timer doesn't fire every millisecond anymore, all the milliseconds since
+// the last switch belong to the task that was running.
+static void scheduler_record_usage(Task *task)
+{
+    uint32_t tick = system_get_tick();
+    uint32_t elapsed = tick - scheduler_record_tick;
+
+    if (elapsed > SCHEDULER_RECORD_COUNT)
+    {
+        elapsed = SCHEDULER_RECORD_COUNT;
+    }
+
+    for (uint32_t i = 0; i < elapsed; i++)
+    {
+        scheduler_record[(tick - i) % SCHEDULER_RECORD_COUNT] = task->id;
+    }
+
+    scheduler_record_tick = tick;
+}
+
+// Running tasks get their quantum, the idle task sleeps until the first blocked
+// task times out. Blockers without a timeout are still polled on every switch,
+// they only change state when something runs, and the idle task gets switched
+// out right away by device interrupts.
+static void scheduler_arm_timer()
+{
+    uint64_t now = arch_get_monotonic_time();
+    uint64_t deadline = now + (running == idle ? SCHEDULER_IDLE_MAX_NS : SCHEDULER_QUANTUM_NS);
+
+    list_foreach(Task, task, blocked_tasks)
+    {
+        if (task->_blocker && task->_blocker->deadline() < deadline)
+        {
+            deadline = task->_blocker->deadline();
+        }
+    }
+
+    arch_timer_arm(deadline);
+}
+
 uintptr_t schedule(uintptr_t current_stack_pointer)
 {
     scheduler_context_switch = true;
@@ -116,7 +162,7 @@ uintptr_t schedule(uintptr_t current_stack_pointer)
     running->kernel_stack_pointer = current_stack_pointer;
     arch_save_context(running);
 
-    scheduler_record[system_get_tick() % SCHEDULER_RECORD_COUNT] = running->id;
+    scheduler_record_usage(running);
 
     list_iterate(blocked_tasks, nullptr, (ListIterationCallback)wakeup_task_if_unblocked);
 
@@ -130,6 +176,8 @@ uintptr_t schedule(uintptr_t current_stack_pointer)
     arch_address_space_switch(running->address_space);
     arch_load_context(running);
 
+    scheduler_arm_timer();
+
     scheduler_context_switch = false;
 
     return running->kernel_stack_pointer;
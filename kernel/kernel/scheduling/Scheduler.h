@@ -4,6 +4,11 @@
 
 #define SCHEDULER_RECORD_COUNT 1000
 
+#define SCHEDULER_QUANTUM_NS 1000000ull
+
+// The PIT can't wait much longer than that in one go.
+#define SCHEDULER_IDLE_MAX_NS 50000000ull
+
 void scheduler_initialize();
 
 void scheduler_did_create_idle_task(Task *task);
@@ -18,6 +23,8 @@ int scheduler_get_usage(int task_id);
 
 Task *scheduler_running();
 
+bool scheduler_is_idle();
+
 int scheduler_running_id();
 
 void scheduler_yield();
@@ -0,0 +1,60 @@
+#include <abi/Clock.h>
+#include <assert.h>
+#include <string.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/MemoryObject.h"
+#include "kernel/system/Clock.h"
+#include "kernel/tasking/Task-Memory.h"
+
+static MemoryObject *_clock_object = nullptr;
+static ClockPage *_clock_page = nullptr;
+
+void clock_initialize()
+{
+    InterruptsRetainer retainer;
+
+    _clock_object = memory_object_create(ARCH_PAGE_SIZE);
+    memory_object_commit_all(_clock_object);
+
+    auto physical_range = MemoryRange{_clock_object->page(0), ARCH_PAGE_SIZE};
+    _clock_page = (ClockPage *)arch_virtual_alloc(arch_kernel_address_space(), physical_range, MEMORY_NONE).base();
+
+    memset(_clock_page, 0, ARCH_PAGE_SIZE);
+
+    uint64_t cycles_at_boot = 0;
+    uint64_t nanoseconds_per_cycle = 0;
+
+    if (arch_clock_calibration(&cycles_at_boot, &nanoseconds_per_cycle))
+    {
+        _clock_page->cycles_available = 1;
+        _clock_page->cycles_at_boot = cycles_at_boot;
+        _clock_page->nanoseconds_per_cycle = nanoseconds_per_cycle;
+    }
+
+    _clock_page->coarse = arch_get_monotonic_time();
+}
+
+void clock_update()
+{
+    if (!_clock_page)
+    {
+        return;
+    }
+
+    // This runs with interrupts disabled on the only processor, readers never
+    // see an odd sequence, but one preempted halfway through reading the page
+    // sees the sequence move and retries.
+    __atomic_store_n(&_clock_page->sequence, _clock_page->sequence + 1, __ATOMIC_RELEASE);
+    _clock_page->coarse = arch_get_monotonic_time();
+    __atomic_store_n(&_clock_page->sequence, _clock_page->sequence + 1, __ATOMIC_RELEASE);
+}
+
+void clock_map(Task *task)
+{
+    assert(_clock_object);
+
+    task_memory_mapping_create_at(task, _clock_object, CLOCK_PAGE_ADDRESS, MEMORY_READ_ONLY);
+}
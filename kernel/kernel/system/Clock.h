@@ -0,0 +1,12 @@
+#pragma once
+
+#include "kernel/tasking/Task.h"
+
+// Sets up the page described in abi/Clock.h, needs the memory manager.
+void clock_initialize();
+
+// Refreshes the coarse time, called on every timer interrupt.
+void clock_update();
+
+// Maps the clock page read only at CLOCK_PAGE_ADDRESS in a user task.
+void clock_map(Task *task);
@@ -0,0 +1,184 @@
+#include <string.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
+#include "kernel/system/System.h"
+
+/* --- Ring ----------------------------------------------------------------- */
+
+// Single producer, the timer interrupt of the processor owning the ring, and
+// single consumer, whoever reads the device. Neither side ever waits for the
+// other: when the reader falls behind, new samples are dropped and counted.
+struct ProfilerRing
+{
+    size_t head;
+    size_t tail;
+    size_t dropped;
+
+    ProfilerSample samples[PROFILER_RING_SIZE];
+};
+
+static ProfilerRing _rings[PROFILER_CPU_COUNT] = {};
+
+static bool _enabled = false;
+
+void profiler_enable()
+{
+    __atomic_store_n(&_enabled, true, __ATOMIC_RELEASE);
+}
+
+void profiler_disable()
+{
+    __atomic_store_n(&_enabled, false, __ATOMIC_RELEASE);
+}
+
+bool profiler_enabled()
+{
+    return __atomic_load_n(&_enabled, __ATOMIC_ACQUIRE);
+}
+
+size_t profiler_dropped()
+{
+    size_t dropped = 0;
+
+    for (auto &ring : _rings)
+    {
+        dropped += __atomic_load_n(&ring.dropped, __ATOMIC_RELAXED);
+    }
+
+    return dropped;
+}
+
+/* --- Unwinding ------------------------------------------------------------ */
+
+// Frames built with -fno-omit-frame-pointer start with the frame pointer of
+// the caller followed by the return address. Every frame is checked before
+// being touched, this runs in the timer interrupt and can't afford to fault.
+typedef bool (*FrameValidator)(Task *task, uintptr_t frame);
+
+static bool kernel_frame_valid(Task *task, uintptr_t frame)
+{
+    uintptr_t stack = (uintptr_t)task->kernel_stack;
+
+    return frame >= stack && frame + 2 * sizeof(uintptr_t) <= stack + PROCESS_STACK_SIZE;
+}
+
+static bool user_frame_valid(Task *task, uintptr_t frame)
+{
+    return arch_virtual_present(task->address_space, frame) &&
+           arch_virtual_present(task->address_space, frame + 2 * sizeof(uintptr_t) - 1);
+}
+
+static size_t unwind(Task *task, uintptr_t ip, uintptr_t fp, FrameValidator valid, uint64_t *frames, size_t capacity)
+{
+    if (ip == 0 || capacity == 0)
+    {
+        return 0;
+    }
+
+    size_t depth = 0;
+    frames[depth++] = ip;
+
+    while (depth < capacity && fp % sizeof(uintptr_t) == 0 && valid(task, fp))
+    {
+        uintptr_t *frame = (uintptr_t *)fp;
+
+        uintptr_t caller_fp = frame[0];
+        uintptr_t return_ip = frame[1];
+
+        if (return_ip == 0)
+        {
+            break;
+        }
+
+        frames[depth++] = return_ip;
+
+        // Stacks grow down, a caller frame below this one means garbage.
+        if (caller_fp <= fp)
+        {
+            break;
+        }
+
+        fp = caller_fp;
+    }
+
+    return depth;
+}
+
+/* --- Sampling ------------------------------------------------------------- */
+
+void profiler_sample(ProfilerContext &context)
+{
+    Task *task = scheduler_running();
+
+    if (!task)
+    {
+        return;
+    }
+
+    auto &ring = _rings[0];
+
+    size_t head = __atomic_load_n(&ring.head, __ATOMIC_RELAXED);
+    size_t tail = __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= PROFILER_RING_SIZE)
+    {
+        __atomic_add_fetch(&ring.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    auto &sample = ring.samples[head % PROFILER_RING_SIZE];
+
+    sample.task = task->id;
+    sample.tick = system_get_tick();
+    strlcpy(sample.name, task->name, PROFILER_TASK_NAME_SIZE);
+
+    // The sample is packed, frames are collected here and copied over.
+    uint64_t frames[PROFILER_MAX_DEPTH];
+
+    size_t kernel_frames = unwind(
+        task,
+        context.kernel_ip,
+        context.kernel_fp,
+        kernel_frame_valid,
+        frames,
+        PROFILER_MAX_DEPTH);
+
+    size_t user_frames = unwind(
+        task,
+        context.user_ip,
+        context.user_fp,
+        user_frame_valid,
+        frames + kernel_frames,
+        PROFILER_MAX_DEPTH - kernel_frames);
+
+    sample.kernel_frames = kernel_frames;
+    sample.user_frames = user_frames;
+    memcpy(sample.frames, frames, (kernel_frames + user_frames) * sizeof(uint64_t));
+
+    __atomic_store_n(&ring.head, head + 1, __ATOMIC_RELEASE);
+}
+
+size_t profiler_read(void *buffer, size_t size)
+{
+    size_t written = 0;
+
+    for (auto &ring : _rings)
+    {
+        size_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+        size_t tail = __atomic_load_n(&ring.tail, __ATOMIC_RELAXED);
+
+        while (tail != head && written + sizeof(ProfilerSample) <= size)
+        {
+            memcpy((uint8_t *)buffer + written, &ring.samples[tail % PROFILER_RING_SIZE], sizeof(ProfilerSample));
+            written += sizeof(ProfilerSample);
+            tail++;
+        }
+
+        __atomic_store_n(&ring.tail, tail, __ATOMIC_RELEASE);
+    }
+
+    return written;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <abi/Profiler.h>
+
+#include <libsystem/Common.h>
+
+// The kernel only brings up the boot processor for now, the day it runs on
+// more every processor gets its own ring and profiler_read() drains them all.
+#define PROFILER_CPU_COUNT 1
+
+#define PROFILER_RING_SIZE 1024
+
+struct ProfilerContext
+{
+    // Where the timer interrupted the kernel, zero if it was running user code.
+    uintptr_t kernel_ip;
+    uintptr_t kernel_fp;
+
+    // Where the task left userspace, zero for kernel tasks.
+    uintptr_t user_ip;
+    uintptr_t user_fp;
+};
+
+void profiler_enable();
+
+void profiler_disable();
+
+bool profiler_enabled();
+
+// Called from the timer interrupt on the processor the sample is taken on.
+void profiler_sample(ProfilerContext &context);
+
+// Copies as many whole samples as fits in the buffer, returns how many bytes were written.
+size_t profiler_read(void *buffer, size_t size);
+
+size_t profiler_dropped();
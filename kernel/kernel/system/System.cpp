@@ -3,6 +3,7 @@
 
 #include "archs/Arch.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Clock.h"
 #include "kernel/system/System.h"
 
 void system_hang()
@@ -25,21 +26,28 @@ void system_stop()
     }
 }
 
-static uint32_t _system_tick;
+static uint32_t _system_timer_interrupts;
 
 void system_tick()
 {
-    if (_system_tick + 1 < _system_tick)
+    if (_system_timer_interrupts + 1 < _system_timer_interrupts)
     {
         logger_fatal("System tick overflow!");
     }
 
-    _system_tick++;
+    _system_timer_interrupts++;
+
+    clock_update();
+}
+
+uint32_t system_get_timer_interrupts()
+{
+    return _system_timer_interrupts;
 }
 
 uint32_t system_get_tick()
 {
-    return _system_tick;
+    return arch_get_monotonic_time() / 1000000;
 }
 
 static TimeStamp _system_boot_timestamp = 0;
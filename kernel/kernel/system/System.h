@@ -17,6 +17,10 @@ void NO_RETURN system_stop();
 
 void system_tick();
 
+// Only a measure of time while the timer is periodic, see arch_timer_arm().
+uint32_t system_get_timer_interrupts();
+
+// Milliseconds since boot.
 uint32_t system_get_tick();
 
 ElapsedTime system_get_uptime();
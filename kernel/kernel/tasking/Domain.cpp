@@ -2,6 +2,7 @@
 
 #include "kernel/node/Directory.h"
 #include "kernel/node/File.h"
+#include "kernel/node/PathCache.h"
 #include "kernel/node/Pipe.h"
 #include "kernel/node/Socket.h"
 #include "kernel/scheduling/Scheduler.h"
@@ -32,6 +33,22 @@ Domain &Domain::operator=(const Domain &other)
 }
 
 RefPtr<FsNode> Domain::find(IO::Path path)
+{
+    RefPtr<FsNode> cached;
+
+    if (path_cache_lookup(root().naked(), path, cached))
+    {
+        return cached;
+    }
+
+    size_t generation = path_cache_generation();
+    auto found = walk(path);
+    path_cache_insert(root().naked(), path, found, generation);
+
+    return found;
+}
+
+RefPtr<FsNode> Domain::walk(IO::Path &path)
 {
     auto current = root();
 
@@ -80,6 +97,8 @@ ResultOr<RefPtr<FsHandle>> Domain::open(IO::Path path, OpenFlag flags)
             parent->acquire(scheduler_running_id());
             parent->link(path.basename(), node);
             parent->release(scheduler_running_id());
+
+            path_cache_invalidate(path);
         }
     }
 
@@ -135,6 +154,7 @@ ResultOr<RefPtr<FsHandle>> Domain::connect(IO::Path path)
     }
 
     auto connection = connection_or_result.unwrap();
+    node->did_update();
     auto connection_handle = make<FsHandle>(connection, OPEN_CLIENT);
 
     BlockerConnect blocker{connection};
@@ -194,6 +214,8 @@ Result Domain::link(IO::Path path, RefPtr<FsNode> node)
     auto result = parent->link(path.basename(), node);
     parent->release(scheduler_running_id());
 
+    path_cache_invalidate(path);
+
     return result;
 }
 
@@ -215,6 +237,8 @@ Result Domain::unlink(IO::Path path)
     auto result = parent->unlink(path.basename());
     parent->release(scheduler_running_id());
 
+    path_cache_invalidate(path);
+
     return result;
 }
 
@@ -267,5 +291,8 @@ Result Domain::rename(IO::Path old_path, IO::Path new_path)
 
     new_parent->release(scheduler_running_id());
 
+    path_cache_invalidate(old_path);
+    path_cache_invalidate(new_path);
+
     return result;
 }
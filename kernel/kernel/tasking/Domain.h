@@ -10,6 +10,8 @@ class Domain
 private:
     RefPtr<FsNode> _root;
 
+    RefPtr<FsNode> walk(IO::Path &path);
+
 public:
     RefPtr<FsNode> root() { return _root; }
 
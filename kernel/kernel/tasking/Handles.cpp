@@ -1,6 +1,8 @@
 
 #include <libsystem/Logger.h>
+#include <libutils/SmallVector.h>
 
+#include "kernel/node/EventQueue.h"
 #include "kernel/node/Pipe.h"
 #include "kernel/node/Terminal.h"
 #include "kernel/scheduling/Blocker.h"
@@ -144,7 +146,7 @@ Result Handles::copy(int source, int destination)
 
 Result Handles::poll(HandlePoll *handles, size_t count, Timeout timeout)
 {
-    Vector<Selected> selected;
+    SmallVector<Selected, 8> selected;
 
     auto release_handles = [&]() {
         for (size_t i = 0; i < selected.count(); i++)
@@ -368,6 +370,93 @@ Result Handles::pipe(int *reader, int *writer)
         OPEN_WRITE);
 }
 
+Result Handles::event_queue(int *queue)
+{
+    *queue = TRY(add(make<FsHandle>(make<FsEventQueue>(), OPEN_READ)));
+
+    return SUCCESS;
+}
+
+Result Handles::event_queue_update(int queue_index, int handle_index, PollEvent events)
+{
+    RefPtr<FsHandle> queue_handle;
+    RefPtr<FsHandle> handle;
+
+    {
+        LockHolder holder(_lock);
+
+        if (!is_valid_handle(queue_index) || !is_valid_handle(handle_index))
+        {
+            return ERR_BAD_HANDLE;
+        }
+
+        queue_handle = _handles[queue_index];
+        handle = _handles[handle_index];
+    }
+
+    if (queue_handle->node()->type() != FILE_TYPE_EVENT_QUEUE)
+    {
+        return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+    }
+
+    auto queue = static_cast<FsEventQueue *>(queue_handle->node().naked());
+    queue->update(handle_index, handle.naked(), events);
+
+    return SUCCESS;
+}
+
+Result Handles::event_queue_wait(int queue_index, HandlePoll *events, size_t capacity, size_t *count, Timeout timeout)
+{
+    RefPtr<FsHandle> queue_handle;
+
+    {
+        LockHolder holder(_lock);
+
+        if (!is_valid_handle(queue_index))
+        {
+            return ERR_BAD_HANDLE;
+        }
+
+        queue_handle = _handles[queue_index];
+    }
+
+    if (queue_handle->node()->type() != FILE_TYPE_EVENT_QUEUE)
+    {
+        return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+    }
+
+    auto queue = static_cast<FsEventQueue *>(queue_handle->node().naked());
+
+    SmallVector<EventQueueReady, 16> ready;
+    BlockerEventQueue blocker{*queue, ready, capacity};
+    TRY(task_block(scheduler_running(), blocker, timeout));
+
+    *count = 0;
+
+    for (size_t i = 0; i < ready.count(); i++)
+    {
+        bool still_open;
+
+        {
+            LockHolder holder(_lock);
+            int index = ready[i].poll.handle;
+            still_open = is_valid_handle(index) && _handles[index].naked() == ready[i].handle;
+        }
+
+        // The handle was closed or replaced without being removed first.
+        if (!still_open)
+        {
+            queue->forget(ready[i].handle);
+            continue;
+        }
+
+        events[*count] = ready[i].poll;
+        *count += 1;
+    }
+
+    return SUCCESS;
+}
+
 Result Handles::pass(Handles &handles, int source, int destination)
 {
     {
@@ -63,5 +63,11 @@ public:
 
     Result pipe(int *reader, int *writer);
 
+    Result event_queue(int *queue);
+
+    Result event_queue_update(int queue_index, int handle_index, PollEvent events);
+
+    Result event_queue_wait(int queue_index, HandlePoll *events, size_t capacity, size_t *count, Timeout timeout);
+
     Result pass(Handles &handles, int source, int destination);
 };
@@ -0,0 +1,77 @@
+#include <string.h>
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/tasking/Syscalls-Trace.h"
+
+/* --- Statistics ----------------------------------------------------------- */
+
+static SyscallStats _stats[__SYSCALL_COUNT] = {};
+
+// Syscalls can be preempted halfway through, the counters are only touched
+// with atomics so a task switch never loses an update.
+void syscall_stats_record(Syscall syscall, uint64_t elapsed)
+{
+    auto &stats = _stats[syscall];
+
+    __atomic_add_fetch(&stats.count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats.total, elapsed, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats.histogram[syscall_histogram_bucket(elapsed)], 1, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&stats.max, __ATOMIC_RELAXED);
+
+    while (elapsed > max &&
+           !__atomic_compare_exchange_n(&stats.max, &max, elapsed, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+SyscallStats syscall_stats(Syscall syscall)
+{
+    InterruptsRetainer retainer;
+
+    return _stats[syscall];
+}
+
+/* --- Tracing -------------------------------------------------------------- */
+
+// Traced tasks are few and their syscalls are slow already, a ring guarded by
+// keeping interrupts off is all it takes on a single processor.
+static SyscallTraceEvent _ring[SYSCALL_TRACE_RING_SIZE];
+static size_t _head = 0;
+static size_t _tail = 0;
+static size_t _dropped = 0;
+
+void syscall_trace_record(const SyscallTraceEvent &event)
+{
+    InterruptsRetainer retainer;
+
+    if (_head - _tail >= SYSCALL_TRACE_RING_SIZE)
+    {
+        _dropped++;
+        return;
+    }
+
+    _ring[_head % SYSCALL_TRACE_RING_SIZE] = event;
+    _head++;
+}
+
+size_t syscall_trace_read(void *buffer, size_t size)
+{
+    InterruptsRetainer retainer;
+
+    size_t written = 0;
+
+    while (_tail != _head && written + sizeof(SyscallTraceEvent) <= size)
+    {
+        memcpy((uint8_t *)buffer + written, &_ring[_tail % SYSCALL_TRACE_RING_SIZE], sizeof(SyscallTraceEvent));
+        written += sizeof(SyscallTraceEvent);
+        _tail++;
+    }
+
+    return written;
+}
+
+size_t syscall_trace_dropped()
+{
+    return _dropped;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <abi/Syscalls.h>
+
+#define SYSCALL_TRACE_RING_SIZE 1024
+
+struct SyscallStats
+{
+    uint64_t count;
+    uint64_t total;
+    uint64_t max;
+    uint64_t histogram[SYSCALL_HISTOGRAM_BUCKETS];
+};
+
+// Always on, every syscall of every task is counted.
+void syscall_stats_record(Syscall syscall, uint64_t elapsed);
+
+SyscallStats syscall_stats(Syscall syscall);
+
+void syscall_trace_record(const SyscallTraceEvent &event);
+
+// Copies as many whole events as fits in the buffer, returns how many bytes were written.
+size_t syscall_trace_read(void *buffer, size_t size);
+
+size_t syscall_trace_dropped();
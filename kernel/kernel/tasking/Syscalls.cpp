@@ -8,8 +8,10 @@
 #include "archs/Arch.h"
 
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Futex.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/system/System.h"
+#include "kernel/tasking/Syscalls-Trace.h"
 #include "kernel/tasking/Syscalls.h"
 #include "kernel/tasking/Task-Launchpad.h"
 #include "kernel/tasking/Task-Memory.h"
@@ -21,6 +23,15 @@ bool syscall_validate_ptr(uintptr_t ptr, size_t size)
     return ptr >= 0x100000 && ptr + size >= 0x100000 && ptr + size >= ptr;
 }
 
+// The base is loaded in FS_BASE on x86_64 at every switch, a non-canonical
+// address would fault in the kernel, so it has to point into user memory.
+static bool syscall_validate_tls(uintptr_t tls)
+{
+    return tls == 0 ||
+           (syscall_validate_ptr(tls, sizeof(uintptr_t)) &&
+            tls + sizeof(uintptr_t) <= USER_MEMORY_END);
+}
+
 /* --- Process -------------------------------------------------------------- */
 
 Result hj_process_this(int *pid)
@@ -30,7 +41,8 @@ Result hj_process_this(int *pid)
         return ERR_BAD_ADDRESS;
     }
 
-    *pid = scheduler_running_id();
+    // Threads report the process they belong to.
+    *pid = scheduler_running()->process()->id;
 
     return SUCCESS;
 }
@@ -79,7 +91,8 @@ static Launchpad copy_launchpad(Launchpad *launchpad)
         launchpad_copy.argv[i].size = launchpad->argv[i].size;
     }
 
-    launchpad_copy.env = strdup(launchpad->env);
+    launchpad_copy.env = (char *)malloc(launchpad->env_size);
+    memcpy(launchpad_copy.env, launchpad->env, launchpad->env_size);
     launchpad_copy.env_size = launchpad->env_size;
 
     return launchpad_copy;
@@ -106,6 +119,7 @@ Result hj_process_launch(Launchpad *launchpad, int *pid)
     auto launchpad_copy = copy_launchpad(launchpad);
 
     launchpad_copy.flags |= TASK_USER;
+    launchpad_copy.flags |= scheduler_running()->_flags & TASK_TRACED;
 
     Result result = task_launch(scheduler_running(), &launchpad_copy, pid);
 
@@ -130,6 +144,12 @@ Result hj_process_exec(Launchpad *launchpad)
         return ERR_BAD_ADDRESS;
     }
 
+    // The other threads would be left running in a torn down image.
+    if (scheduler_running()->is_thread() || scheduler_running()->_threads > 0)
+    {
+        return ERR_OPERATION_NOT_SUPPORTED;
+    }
+
     auto launchpad_copy = copy_launchpad(launchpad);
 
     Result result = task_exec(scheduler_running(), &launchpad_copy);
@@ -147,7 +167,7 @@ Result hj_process_exit(int exit_code)
         arch_backtrace();
     }
 
-    return scheduler_running()->cancel(exit_code);
+    return scheduler_running()->process()->cancel(exit_code);
 }
 
 Result hj_process_cancel(int pid)
@@ -189,6 +209,74 @@ Result hj_process_wait(int tid, int *user_exit_value)
     return result;
 }
 
+/* --- Threads ------------------------------------------------------------- */
+
+Result hj_thread_create(uintptr_t ip, uintptr_t sp, uintptr_t tls, int *tid)
+{
+    if (!syscall_validate_ptr(ip, 1) ||
+        !syscall_validate_ptr(sp, sizeof(uintptr_t)) ||
+        !syscall_validate_tls(tls) ||
+        !syscall_validate_ptr((uintptr_t)tid, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    InterruptsRetainer retainer;
+
+    Task *process = scheduler_running()->process();
+
+    if (process->_is_canceled)
+    {
+        return ERR_NO_SUCH_TASK;
+    }
+
+    *tid = task_create_thread(scheduler_running(), ip, sp, tls)->id;
+
+    return SUCCESS;
+}
+
+Result hj_thread_exit(int exit_code)
+{
+    return scheduler_running()->cancel(exit_code);
+}
+
+Result hj_thread_tls(uintptr_t tls)
+{
+    if (!syscall_validate_tls(tls))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    InterruptsRetainer retainer;
+
+    scheduler_running()->tls_base = tls;
+    arch_load_tls(scheduler_running());
+
+    return SUCCESS;
+}
+
+Result hj_futex_wait(int *address, int expected, Timeout timeout)
+{
+    if (!syscall_validate_ptr((uintptr_t)address, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    return futex_wait(scheduler_running(), address, expected, timeout);
+}
+
+Result hj_futex_wake(int *address, int count)
+{
+    if (!syscall_validate_ptr((uintptr_t)address, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    futex_wake(scheduler_running(), address, count);
+
+    return SUCCESS;
+}
+
 /* --- Shared memory -------------------------------------------------------- */
 
 Result hj_memory_alloc(size_t size, uintptr_t *out_address)
@@ -238,6 +326,20 @@ Result hj_memory_get_handle(uintptr_t address, int *out_handle)
     return task_memory_get_handle(scheduler_running(), address, out_handle);
 }
 
+Result hj_memory_map_file(const char *raw_path, size_t size, uintptr_t *out_address, size_t *out_size)
+{
+    if (!syscall_validate_ptr((uintptr_t)raw_path, size) ||
+        !syscall_validate_ptr((uintptr_t)out_address, sizeof(uintptr_t)) ||
+        !syscall_validate_ptr((uintptr_t)out_size, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto path = IO::Path::parse(raw_path, size).normalized();
+
+    return task_memory_map_file(scheduler_running(), path, out_address, out_size);
+}
+
 /* --- Filesystem ----------------------------------------------------------- */
 
 Result hj_filesystem_mkdir(const char *raw_path, size_t size)
@@ -410,6 +512,39 @@ Result hj_create_term(int *server_handle, int *client_handle)
     return handles.term(server_handle, client_handle);
 }
 
+Result hj_create_event_queue(int *queue_handle)
+{
+    if (!syscall_validate_ptr((uintptr_t)queue_handle, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    return scheduler_running()->handles().event_queue(queue_handle);
+}
+
+/* --- Event queues --------------------------------------------------------- */
+
+Result hj_event_queue_update(int queue_handle, int handle, PollEvent events)
+{
+    return scheduler_running()->handles().event_queue_update(queue_handle, handle, events);
+}
+
+Result hj_event_queue_wait(int queue_handle, HandlePoll *events, size_t capacity, size_t *count, Timeout timeout)
+{
+    if (!syscall_validate_ptr((uintptr_t)events, sizeof(HandlePoll) * capacity) ||
+        !syscall_validate_ptr((uintptr_t)count, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    if (capacity == 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    return scheduler_running()->handles().event_queue_wait(queue_handle, events, capacity, count, timeout);
+}
+
 /* --- Handles -------------------------------------------------------------- */
 
 Result hj_handle_open(int *handle,
@@ -647,11 +782,17 @@ static SyscallHandler syscalls[__SYSCALL_COUNT] = {
     [HJ_PROCESS_CANCEL] = reinterpret_cast<SyscallHandler>(hj_process_cancel),
     [HJ_PROCESS_SLEEP] = reinterpret_cast<SyscallHandler>(hj_process_sleep),
     [HJ_PROCESS_WAIT] = reinterpret_cast<SyscallHandler>(hj_process_wait),
+    [HJ_THREAD_CREATE] = reinterpret_cast<SyscallHandler>(hj_thread_create),
+    [HJ_THREAD_EXIT] = reinterpret_cast<SyscallHandler>(hj_thread_exit),
+    [HJ_THREAD_TLS] = reinterpret_cast<SyscallHandler>(hj_thread_tls),
+    [HJ_FUTEX_WAIT] = reinterpret_cast<SyscallHandler>(hj_futex_wait),
+    [HJ_FUTEX_WAKE] = reinterpret_cast<SyscallHandler>(hj_futex_wake),
     [HJ_MEMORY_ALLOC] = reinterpret_cast<SyscallHandler>(hj_memory_alloc),
     [HJ_MEMORY_MAP] = reinterpret_cast<SyscallHandler>(hj_memory_map),
     [HJ_MEMORY_FREE] = reinterpret_cast<SyscallHandler>(hj_memory_free),
     [HJ_MEMORY_INCLUDE] = reinterpret_cast<SyscallHandler>(hj_memory_include),
     [HJ_MEMORY_GET_HANDLE] = reinterpret_cast<SyscallHandler>(hj_memory_get_handle),
+    [HJ_MEMORY_MAP_FILE] = reinterpret_cast<SyscallHandler>(hj_memory_map_file),
     [HJ_FILESYSTEM_LINK] = reinterpret_cast<SyscallHandler>(hj_filesystem_link),
     [HJ_FILESYSTEM_UNLINK] = reinterpret_cast<SyscallHandler>(hj_filesystem_unlink),
     [HJ_FILESYSTEM_RENAME] = reinterpret_cast<SyscallHandler>(hj_filesystem_rename),
@@ -677,6 +818,9 @@ static SyscallHandler syscalls[__SYSCALL_COUNT] = {
     [HJ_HANDLE_ACCEPT] = reinterpret_cast<SyscallHandler>(hj_handle_accept),
     [HJ_CREATE_PIPE] = reinterpret_cast<SyscallHandler>(hj_create_pipe),
     [HJ_CREATE_TERM] = reinterpret_cast<SyscallHandler>(hj_create_term),
+    [HJ_CREATE_EVENT_QUEUE] = reinterpret_cast<SyscallHandler>(hj_create_event_queue),
+    [HJ_EVENT_QUEUE_UPDATE] = reinterpret_cast<SyscallHandler>(hj_event_queue_update),
+    [HJ_EVENT_QUEUE_WAIT] = reinterpret_cast<SyscallHandler>(hj_event_queue_wait),
 };
 
 #pragma GCC diagnostic pop
@@ -702,6 +846,11 @@ SyscallHandler syscall_get_handler(Syscall syscall)
 #define SYSCALL_NAMES_ENTRY(__entry) #__entry,
 static const char *syscall_names[] = {SYSCALL_LIST(SYSCALL_NAMES_ENTRY)};
 
+const char *syscall_name(Syscall syscall)
+{
+    return syscall_names[syscall];
+}
+
 uintptr_t task_do_syscall(Syscall syscall, uintptr_t arg0, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t arg4)
 {
     SyscallHandler handler = syscall_get_handler(syscall);
@@ -714,10 +863,28 @@ uintptr_t task_do_syscall(Syscall syscall, uintptr_t arg0, uintptr_t arg1, uintp
         return ERR_INVALID_ARGUMENT;
     }
 
+    uint64_t begin = arch_get_monotonic_time();
+
     scheduler_running()->begin_syscall(syscall);
     result = handler(arg0, arg1, arg2, arg3, arg4);
     scheduler_running()->end_syscall();
 
+    uint64_t end = arch_get_monotonic_time();
+
+    syscall_stats_record(syscall, end - begin);
+
+    if (scheduler_running()->_flags & TASK_TRACED)
+    {
+        syscall_trace_record({
+            scheduler_running_id(),
+            syscall,
+            result,
+            {arg0, arg1, arg2, arg3, arg4},
+            begin,
+            end,
+        });
+    }
+
     if (result != SUCCESS && result != TIMEOUT)
     {
         logger_trace(
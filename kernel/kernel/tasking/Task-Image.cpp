@@ -0,0 +1,180 @@
+#include <string.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/File.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/tasking/Task-Image.h"
+#include "kernel/tasking/Task-Memory.h"
+
+static constexpr size_t TASK_IMAGE_CACHE_SIZE = 16;
+
+// Least recently used images first.
+static Vector<RefPtr<TaskImage>> *_images = nullptr;
+
+static size_t node_revision(RefPtr<FsNode> node)
+{
+    return static_cast<FsFile *>(node.naked())->revision();
+}
+
+TaskImage::TaskImage(RefPtr<FsNode> node)
+    : node(node),
+      revision(node_revision(node))
+{
+}
+
+TaskImage::~TaskImage()
+{
+    for (size_t i = 0; i < segments.count(); i++)
+    {
+        if (segments[i].object)
+        {
+            memory_object_deref(segments[i].object);
+        }
+
+        if (segments[i].snapshot)
+        {
+            free(segments[i].snapshot);
+        }
+    }
+}
+
+RefPtr<TaskImage> task_image_lookup(RefPtr<FsNode> node)
+{
+    if (node->type() != FILE_TYPE_REGULAR)
+    {
+        return nullptr;
+    }
+
+    InterruptsRetainer retainer;
+
+    if (!_images)
+    {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < _images->count(); i++)
+    {
+        auto image = (*_images)[i];
+
+        if (image->node != node)
+        {
+            continue;
+        }
+
+        _images->remove_index(i);
+
+        if (image->revision != node_revision(node))
+        {
+            // The file was written to since, drop the stale image.
+            return nullptr;
+        }
+
+        _images->push_back(image);
+
+        return image;
+    }
+
+    return nullptr;
+}
+
+void task_image_cache(RefPtr<TaskImage> image)
+{
+    if (image->node->type() != FILE_TYPE_REGULAR)
+    {
+        return;
+    }
+
+    InterruptsRetainer retainer;
+
+    if (!_images)
+    {
+        _images = new Vector<RefPtr<TaskImage>>();
+    }
+
+    if (_images->count() >= TASK_IMAGE_CACHE_SIZE)
+    {
+        _images->remove_index(0);
+    }
+
+    _images->push_back(image);
+}
+
+Result task_image_capture(Task *task, TaskImage &image, MemoryRange range, bool writable)
+{
+    TaskImageSegment segment{range, nullptr, nullptr};
+
+    if (writable)
+    {
+        segment.snapshot = malloc(range.size());
+
+        if (!segment.snapshot)
+        {
+            return ERR_OUT_OF_MEMORY;
+        }
+
+        memcpy(segment.snapshot, (void *)range.base(), range.size());
+    }
+    else
+    {
+        auto mapping = task_memory_mapping_by_address(task, range.base());
+
+        if (!mapping)
+        {
+            return ERR_BAD_ADDRESS;
+        }
+
+        segment.object = memory_object_ref(mapping->object);
+        image.segments.push_back(segment);
+
+        // Nothing ran in the task yet so the pages are still what was read
+        // from the file, from now on nobody gets to write to them.
+        mapping->flags = MEMORY_USER | MEMORY_READ_ONLY;
+        return memory_object_map(segment.object, task->address_space, range.base(), mapping->flags);
+    }
+
+    image.segments.push_back(segment);
+
+    return SUCCESS;
+}
+
+Result task_image_map(Task *task, TaskImage &image)
+{
+    for (size_t i = 0; i < image.segments.count(); i++)
+    {
+        auto &segment = image.segments[i];
+        auto range = segment.range;
+
+        if (task_memory_mapping_colides(task, range.base(), range.size()))
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+        if (segment.object)
+        {
+            task_memory_mapping_create_at(task, segment.object, range.base(), MEMORY_READ_ONLY);
+            continue;
+        }
+
+        void *parent_address_space = task_switch_address_space(scheduler_running(), task->address_space);
+
+        Result result = task_memory_map(task, range.base(), range.size(), MEMORY_NONE);
+
+        if (result == SUCCESS)
+        {
+            memcpy((void *)range.base(), segment.snapshot, range.size());
+        }
+
+        task_switch_address_space(scheduler_running(), parent_address_space);
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    task_set_entry(task, reinterpret_cast<TaskEntryPoint>(image.entry));
+
+    return SUCCESS;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <libutils/RefPtr.h>
+#include <libutils/Vector.h>
+
+#include "kernel/memory/MemoryObject.h"
+#include "kernel/node/Node.h"
+#include "kernel/tasking/Task.h"
+
+// An executable already loaded once, kept around so launching it again only
+// has to map memory instead of going through the filesystem and the ELF parser.
+struct TaskImageSegment
+{
+    MemoryRange range;
+
+    // Read-only segments are shared by every task running the image, writable
+    // ones are copied from a snapshot taken right after the first load.
+    MemoryObject *object;
+    void *snapshot;
+};
+
+struct TaskImage : public RefCounted<TaskImage>
+{
+    RefPtr<FsNode> node;
+    size_t revision;
+
+    uintptr_t entry = 0;
+    Vector<TaskImageSegment> segments{};
+
+    TaskImage(RefPtr<FsNode> node);
+
+    ~TaskImage();
+};
+
+RefPtr<TaskImage> task_image_lookup(RefPtr<FsNode> node);
+
+void task_image_cache(RefPtr<TaskImage> image);
+
+Result task_image_capture(Task *task, TaskImage &image, MemoryRange range, bool writable);
+
+Result task_image_map(Task *task, TaskImage &image);
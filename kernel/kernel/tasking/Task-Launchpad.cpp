@@ -6,6 +6,7 @@
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/tasking/Task-Image.h"
 #include "kernel/tasking/Task-Launchpad.h"
 #include "kernel/tasking/Task-Memory.h"
 #include "kernel/tasking/Task.h"
@@ -18,7 +19,21 @@ struct ELFLoader
     using Program = TELFFormat::Program;
     using Symbole = TELFFormat::Symbole;
 
-    static Result load_program(Task *task, Stream *elf_file, Program *program_header)
+    static Result read_at(FsHandle &handle, size_t offset, void *buffer, size_t size)
+    {
+        TRY(handle.seek(IO::SeekFrom::start(offset)));
+
+        auto read = TRY(handle.read(buffer, size));
+
+        if (read != size)
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+        return SUCCESS;
+    }
+
+    static Result load_program(Task *task, FsHandle &handle, Program *program_header, TaskImage &image)
     {
         if (program_header->vaddr == 0)
         {
@@ -35,56 +50,85 @@ struct ELFLoader
 
         MemoryRange range = MemoryRange::around_non_aligned_address(program_header->vaddr, program_header->memsz);
 
-        task_memory_map(task, range.base(), range.size(), MEMORY_CLEAR);
-
-        stream_seek(elf_file, IO::SeekFrom::start(program_header->offset));
-        size_t read = stream_read(elf_file, (void *)program_header->vaddr, program_header->filesz);
+        Result result = task_memory_map(task, range.base(), range.size(), MEMORY_CLEAR);
 
-        if (read != program_header->filesz)
+        if (result == SUCCESS)
         {
-            logger_error("Didn't read the right amount from the ELF file!");
+            result = read_at(handle, program_header->offset, (void *)program_header->vaddr, program_header->filesz);
 
-            task_switch_address_space(scheduler_running(), parent_address_space);
-
-            return ERR_EXEC_FORMAT_ERROR;
+            if (result != SUCCESS)
+            {
+                logger_error("Didn't read the right amount from the ELF file!");
+            }
         }
-        else
-        {
-            task_switch_address_space(scheduler_running(), parent_address_space);
 
-            return SUCCESS;
+        if (result == SUCCESS)
+        {
+            result = task_image_capture(task, image, range, program_header->flags & ELF_PROGRAM_W);
         }
+
+        task_switch_address_space(scheduler_running(), parent_address_space);
+
+        return result;
     }
 
-    static Result load(Task *task, Stream *elf_file)
+    static Result load(Task *task, FsHandle &handle, TaskImage &image)
     {
         Header elf_header;
-        size_t elf_header_size = stream_read(elf_file, &elf_header, sizeof(Header));
+        TRY(read_at(handle, 0, &elf_header, sizeof(Header)));
 
-        if (elf_header_size != sizeof(Header) || !elf_header.valid())
+        if (!elf_header.valid())
         {
             return ERR_EXEC_FORMAT_ERROR;
         }
 
-        task_set_entry(task, reinterpret_cast<TaskEntryPoint>(elf_header.entry));
+        image.entry = elf_header.entry;
 
         for (int i = 0; i < elf_header.phnum; i++)
         {
             Program elf_program_header;
-            stream_seek(elf_file, IO::SeekFrom::start(elf_header.phoff + elf_header.phentsize * i));
-
-            if (stream_read(elf_file, &elf_program_header, sizeof(Program)) != sizeof(Program))
-            {
-                return ERR_EXEC_FORMAT_ERROR;
-            }
-
-            TRY(load_program(task, elf_file, &elf_program_header));
+            TRY(read_at(handle, elf_header.phoff + elf_header.phentsize * i, &elf_program_header, sizeof(Program)));
+            TRY(load_program(task, handle, &elf_program_header, image));
         }
 
+        task_set_entry(task, reinterpret_cast<TaskEntryPoint>(image.entry));
+
         return SUCCESS;
     }
 };
 
+static Result task_load_executable(Task *task, const char *executable)
+{
+    auto path = IO::Path::parse(executable);
+    auto handle_or_result = scheduler_running()->domain().open(path, OPEN_READ);
+
+    if (!handle_or_result.success())
+    {
+        logger_error("Failed to open ELF file %s: %s!", executable, result_to_string(handle_or_result.result()));
+        return handle_or_result.result();
+    }
+
+    auto handle = handle_or_result.unwrap();
+    auto image = task_image_lookup(handle->node());
+
+    if (image)
+    {
+        return task_image_map(task, *image);
+    }
+
+    image = make<TaskImage>(handle->node());
+
+#ifdef __x86_64__
+    TRY(ELFLoader<ELF64>::load(task, *handle, *image));
+#else
+    TRY(ELFLoader<ELF32>::load(task, *handle, *image));
+#endif
+
+    task_image_cache(image);
+
+    return SUCCESS;
+}
+
 void task_pass_argc_argv_env(Task *task, Launchpad *launchpad)
 {
     void *parent_address_space = task_switch_address_space(scheduler_running(), task->address_space);
@@ -99,7 +143,7 @@ void task_pass_argc_argv_env(Task *task, Launchpad *launchpad)
 
     uintptr_t argv_list_ref = task_user_stack_push(task, &argv_list, sizeof(argv_list));
 
-    task_user_stack_push(task, "\0", 1); // null terminate the env string
+    task_user_stack_push(task, "\0", 1); // an empty env block reads as zero sized
     uintptr_t env_ref = task_user_stack_push(task, launchpad->env, launchpad->env_size);
 
     task_user_stack_push_ptr(task, (void *)env_ref);
@@ -129,23 +173,11 @@ Result task_launch(Task *parent_task, Launchpad *launchpad, int *pid)
 
     *pid = -1;
 
-    CLEANUP(stream_cleanup) Stream *elf_file = stream_open(launchpad->executable, OPEN_READ);
-
-    if (handle_has_error(elf_file))
-    {
-        logger_error("Failed to open ELF file %s: %s!", launchpad->executable, handle_error_string(elf_file));
-        return handle_get_error(elf_file);
-    }
-
     interrupts_retain();
     Task *task = task_create(parent_task, launchpad->name, launchpad->flags);
     interrupts_release();
 
-#ifdef __x86_64__
-    Result result = ELFLoader<ELF64>::load(task, elf_file);
-#else
-    Result result = ELFLoader<ELF32>::load(task, elf_file);
-#endif
+    Result result = task_load_executable(task, launchpad->executable);
 
     if (result != SUCCESS)
     {
@@ -168,21 +200,17 @@ Result task_exec(Task *task, Launchpad *launchpad)
 {
     assert(task == scheduler_running());
 
-    CLEANUP(stream_cleanup) Stream *elf_file = stream_open(launchpad->executable, OPEN_READ);
+    auto path = IO::Path::parse(launchpad->executable);
 
-    if (handle_has_error(elf_file))
+    if (!task->domain().find(path))
     {
-        logger_error("Failed to open ELF file %s: %s!", launchpad->executable, handle_error_string(elf_file));
-        return handle_get_error(elf_file);
+        logger_error("Failed to open ELF file %s: %s!", launchpad->executable, result_to_string(ERR_NO_SUCH_FILE_OR_DIRECTORY));
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
     }
 
     task_clear_userspace(task);
 
-#ifdef __x86_64__
-    Result result = ELFLoader<ELF64>::load(task, elf_file);
-#else
-    Result result = ELFLoader<ELF32>::load(task, elf_file);
-#endif
+    Result result = task_load_executable(task, launchpad->executable);
 
     if (result != SUCCESS)
     {
@@ -193,4 +221,4 @@ Result task_exec(Task *task, Launchpad *launchpad)
     task_pass_argc_argv_env(task, launchpad);
 
     return SUCCESS;
-}
\ No newline at end of file
+}
@@ -1,8 +1,10 @@
+#include <libsystem/Logger.h>
 #include <string.h>
 
 #include "archs/Arch.h"
 
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/node/File.h"
 #include "kernel/tasking/Task-Memory.h"
 
 static bool will_i_be_kill_if_i_allocate_that(Task *task, size_t size)
@@ -28,32 +30,55 @@ static void kill_me_if_too_greedy(Task *task, size_t size)
     }
 }
 
-MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object)
+static uintptr_t task_memory_find_free_range(Task *task, size_t size)
 {
-    InterruptsRetainer retainer;
+    // Pages of a mapping might not be present yet, so the page tables can't
+    // tell what is free, the mappings themselves have to be checked.
+    uintptr_t candidate = USER_MEMORY_BASE;
+    bool moved = true;
 
-    auto memory_mapping = CREATE(MemoryMapping);
+    while (moved && candidate + size <= USER_MEMORY_END)
+    {
+        moved = false;
 
-    memory_mapping->object = memory_object_ref(memory_object);
-    memory_mapping->address = arch_virtual_alloc(task->address_space, memory_object->range(), MEMORY_USER).base();
-    memory_mapping->size = memory_object->range().size();
+        list_foreach(MemoryMapping, memory_mapping, task->memory_mapping)
+        {
+            if (candidate < memory_mapping->address + memory_mapping->size &&
+                candidate + size > memory_mapping->address)
+            {
+                candidate = memory_mapping->address + memory_mapping->size;
+                moved = true;
+            }
+        }
+    }
 
-    list_pushback(task->memory_mapping, memory_mapping);
+    if (candidate + size > USER_MEMORY_END)
+    {
+        logger_fatal("Out of virtual memory!");
+    }
 
-    return memory_mapping;
+    return candidate;
+}
+
+MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object)
+{
+    InterruptsRetainer retainer;
+
+    return task_memory_mapping_create_at(task, memory_object, task_memory_find_free_range(task, memory_object->size()), MEMORY_NONE);
 }
 
-MemoryMapping *task_memory_mapping_create_at(Task *task, MemoryObject *memory_object, uintptr_t address)
+MemoryMapping *task_memory_mapping_create_at(Task *task, MemoryObject *memory_object, uintptr_t address, MemoryFlags flags)
 {
     InterruptsRetainer retainer;
 
-    auto memory_mapping = CREATE(MemoryMapping);
+    auto memory_mapping = new MemoryMapping{};
 
     memory_mapping->object = memory_object_ref(memory_object);
     memory_mapping->address = address;
-    memory_mapping->size = memory_object->range().size();
+    memory_mapping->size = memory_object->size();
+    memory_mapping->flags = MEMORY_USER | flags;
 
-    assert(SUCCESS == arch_virtual_map(task->address_space, memory_object->range(), address, MEMORY_USER));
+    assert(SUCCESS == memory_object_map(memory_object, task->address_space, address, memory_mapping->flags));
 
     list_pushback(task->memory_mapping, memory_mapping);
 
@@ -68,7 +93,7 @@ void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping)
     memory_object_deref(memory_mapping->object);
 
     list_remove(task->memory_mapping, memory_mapping);
-    free(memory_mapping);
+    delete memory_mapping;
 }
 
 MemoryMapping *task_memory_mapping_by_address(Task *task, uintptr_t address)
@@ -124,9 +149,13 @@ Result task_memory_map(Task *task, uintptr_t address, size_t size, MemoryFlags f
         return ERR_BAD_ADDRESS;
     }
 
+    // The kernel writes to these on behalf of the task from another task's
+    // context (loading executables, setting up stacks) where a fault couldn't
+    // be resolved, so they are committed upfront.
     auto memory_object = memory_object_create(size);
+    memory_object_commit_all(memory_object);
 
-    task_memory_mapping_create_at(task, memory_object, address);
+    task_memory_mapping_create_at(task, memory_object, address, MEMORY_NONE);
 
     memory_object_deref(memory_object);
 
@@ -161,10 +190,10 @@ Result task_memory_include(Task *task, int handle, uintptr_t *out_address, size_
         return ERR_BAD_ADDRESS;
     }
 
-    if (will_i_be_kill_if_i_allocate_that(task, memory_object->range().size()))
+    if (will_i_be_kill_if_i_allocate_that(task, memory_object->size()))
     {
         memory_object_deref(memory_object);
-        kill_me_if_too_greedy(task, memory_object->range().size());
+        kill_me_if_too_greedy(task, memory_object->size());
     }
 
     auto memory_mapping = task_memory_mapping_create(task, memory_object);
@@ -190,6 +219,214 @@ Result task_memory_get_handle(Task *task, uintptr_t address, int *out_handle)
     return SUCCESS;
 }
 
+/* --- File mappings -------------------------------------------------------- */
+
+static constexpr size_t FILE_MAPPING_CACHE_SIZE = 16;
+
+// The content of a file as it was when first mapped, shared read-only by every
+// task mapping it afterward.
+struct FileMapping : public RefCounted<FileMapping>
+{
+    RefPtr<FsNode> node;
+    size_t revision;
+    size_t size;
+    MemoryObject *object;
+
+    FileMapping(RefPtr<FsNode> node, size_t revision, size_t size, MemoryObject *object)
+        : node(node), revision(revision), size(size), object(object)
+    {
+    }
+
+    ~FileMapping()
+    {
+        memory_object_deref(object);
+    }
+};
+
+// Least recently used files first.
+static Vector<RefPtr<FileMapping>> *_file_mappings = nullptr;
+
+static size_t file_revision(RefPtr<FsNode> node)
+{
+    return static_cast<FsFile *>(node.naked())->revision();
+}
+
+static RefPtr<FileMapping> file_mapping_lookup(RefPtr<FsNode> node)
+{
+    InterruptsRetainer retainer;
+
+    if (!_file_mappings)
+    {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < _file_mappings->count(); i++)
+    {
+        auto file_mapping = (*_file_mappings)[i];
+
+        if (file_mapping->node != node)
+        {
+            continue;
+        }
+
+        _file_mappings->remove_index(i);
+
+        if (file_mapping->revision != file_revision(node))
+        {
+            // The file was written to since, drop the stale content.
+            return nullptr;
+        }
+
+        _file_mappings->push_back(file_mapping);
+
+        return file_mapping;
+    }
+
+    return nullptr;
+}
+
+static void file_mapping_cache(RefPtr<FileMapping> file_mapping)
+{
+    InterruptsRetainer retainer;
+
+    if (!_file_mappings)
+    {
+        _file_mappings = new Vector<RefPtr<FileMapping>>();
+    }
+
+    if (_file_mappings->count() >= FILE_MAPPING_CACHE_SIZE)
+    {
+        _file_mappings->remove_index(0);
+    }
+
+    _file_mappings->push_back(file_mapping);
+}
+
+static ResultOr<RefPtr<FileMapping>> file_mapping_load(Task *task, FsHandle &handle)
+{
+    auto node = handle.node();
+    size_t revision = file_revision(node);
+    size_t size = node->size();
+
+    if (size == 0)
+    {
+        return ERR_INVALID_DATA;
+    }
+
+    kill_me_if_too_greedy(task, size);
+
+    // Filled through a temporary mapping in the calling task, the pages are
+    // committed upfront so reading the file doesn't fault on each of them.
+    auto memory_object = memory_object_create(size);
+    memory_object_commit_all(memory_object);
+
+    auto file_mapping = make<FileMapping>(node, revision, size, memory_object);
+    auto memory_mapping = task_memory_mapping_create(task, memory_object);
+
+    size_t read = 0;
+    Result result = SUCCESS;
+
+    while (read < size)
+    {
+        auto read_or_result = handle.read((void *)(memory_mapping->address + read), size - read);
+
+        if (!read_or_result.success())
+        {
+            result = read_or_result.result();
+            break;
+        }
+
+        if (read_or_result.unwrap() == 0)
+        {
+            break;
+        }
+
+        read += read_or_result.unwrap();
+    }
+
+    task_memory_mapping_destroy(task, memory_mapping);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    file_mapping->size = read;
+
+    return file_mapping;
+}
+
+Result task_memory_map_file(Task *task, IO::Path &path, uintptr_t *out_address, size_t *out_size)
+{
+    auto handle = TRY(task->domain().open(path, OPEN_READ));
+
+    if (handle->node()->type() != FILE_TYPE_REGULAR)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    auto file_mapping = file_mapping_lookup(handle->node());
+
+    if (!file_mapping)
+    {
+        file_mapping = TRY(file_mapping_load(task, *handle));
+        file_mapping_cache(file_mapping);
+    }
+
+    kill_me_if_too_greedy(task, file_mapping->object->size());
+
+    auto memory_object = file_mapping->object;
+    auto address = task_memory_find_free_range(task, memory_object->size());
+
+    task_memory_mapping_create_at(task, memory_object, address, MEMORY_READ_ONLY);
+
+    *out_address = address;
+    *out_size = file_mapping->size;
+
+    return SUCCESS;
+}
+
+Result task_memory_fault(Task *task, uintptr_t address)
+{
+    if (!task)
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    InterruptsRetainer retainer;
+
+    list_foreach(MemoryMapping, memory_mapping, task->memory_mapping)
+    {
+        if (!memory_mapping->range().contains(address))
+        {
+            continue;
+        }
+
+        uintptr_t page = PAGE_ALIGN_DOWN(address);
+        size_t index = (page - memory_mapping->address) / ARCH_PAGE_SIZE;
+
+        if (arch_virtual_present(task->address_space, page))
+        {
+            // Not something lazy commit can fix, let the caller report it.
+            return ERR_BAD_ADDRESS;
+        }
+
+        bool fresh = !memory_mapping->object->page(index);
+        uintptr_t physical = memory_object_commit(memory_mapping->object, index);
+
+        TRY(arch_virtual_map(task->address_space, {physical, ARCH_PAGE_SIZE}, page, memory_mapping->flags));
+
+        if (fresh)
+        {
+            memset((void *)page, 0, ARCH_PAGE_SIZE);
+        }
+
+        return SUCCESS;
+    }
+
+    return ERR_BAD_ADDRESS;
+}
+
 void *task_switch_address_space(Task *task, void *address_space)
 {
     void *old_address_space = task->address_space;
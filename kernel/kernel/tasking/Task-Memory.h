@@ -3,22 +3,33 @@
 #include "kernel/memory/MemoryObject.h"
 #include "kernel/tasking/Task.h"
 
+// Same user half arch_virtual_alloc hands addresses from.
+static constexpr uintptr_t USER_MEMORY_BASE = 256 * 1024 * ARCH_PAGE_SIZE;
+static constexpr uintptr_t USER_MEMORY_END = 0xff000000;
+
 struct MemoryMapping
 {
     MemoryObject *object;
 
     uintptr_t address;
     size_t size;
+    MemoryFlags flags;
 
     MemoryRange range() { return {address, size}; }
+
+    SLAB_ALLOCATED(MemoryMapping);
 };
 
 MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object);
 
+MemoryMapping *task_memory_mapping_create_at(Task *task, MemoryObject *memory_object, uintptr_t address, MemoryFlags flags);
+
 void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping);
 
 MemoryMapping *task_memory_mapping_by_address(Task *task, uintptr_t address);
 
+bool task_memory_mapping_colides(Task *task, uintptr_t address, size_t size);
+
 Result task_memory_alloc(Task *task, size_t size, uintptr_t *out_address);
 
 Result task_memory_map(Task *task, uintptr_t address, size_t size, MemoryFlags flags);
@@ -29,6 +40,13 @@ Result task_memory_include(Task *task, int handle, uintptr_t *out_address, size_
 
 Result task_memory_get_handle(Task *task, uintptr_t address, int *out_handle);
 
+// Maps the content of a regular file read-only, tasks mapping a file which
+// wasn't written to since share the same memory object.
+Result task_memory_map_file(Task *task, IO::Path &path, uintptr_t *out_address, size_t *out_size);
+
+// Commit and map the page of a mapping behind a not-present fault.
+Result task_memory_fault(Task *task, uintptr_t address);
+
 void *task_switch_address_space(Task *task, void *address_space);
 
 size_t task_memory_usage(Task *task);
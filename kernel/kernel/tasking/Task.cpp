@@ -1,10 +1,14 @@
+#include <abi/Clock.h>
 #include <assert.h>
 #include <string.h>
 
+#include <libutils/SmallVector.h>
+
 #include "archs/Arch.h"
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Clock.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Finalizer.h"
 #include "kernel/tasking/Task-Memory.h"
@@ -44,6 +48,39 @@ void Task::interrupt()
     }
 }
 
+static void task_cancel_threads(Task *process, int exit_value)
+{
+    InterruptsRetainer retainer;
+
+    // Canceling a thread might take it out of the task list, so collect them first.
+    SmallVector<Task *, 8> threads;
+
+    list_foreach(Task, task, _tasks)
+    {
+        if (task->_process == process)
+        {
+            threads.push_back(task);
+        }
+    }
+
+    for (size_t i = 0; i < threads.count(); i++)
+    {
+        Task *thread = threads[i];
+
+        // Nobody is left to join them.
+        thread->_flags &= ~TASK_WAITABLE;
+
+        if (thread->state() == TASK_STATE_CANCELING)
+        {
+            thread->state(TASK_STATE_CANCELED);
+        }
+        else
+        {
+            thread->cancel(exit_value);
+        }
+    }
+}
+
 Result Task::cancel(int exit_value)
 {
     interrupts_retain();
@@ -57,6 +94,11 @@ Result Task::cancel(int exit_value)
     _is_canceled = true;
     this->exit_value = exit_value;
 
+    if (_threads > 0)
+    {
+        task_cancel_threads(this, exit_value);
+    }
+
     if (_is_doing_syscall)
     {
         interrupts_release();
@@ -129,7 +171,7 @@ Task *task_create(Task *parent, const char *name, TaskFlags flags)
     }
 
     if (parent)
-        task->_domain = parent->_domain;
+        task->_domain = parent->domain();
 
     // Setup shms
     task->memory_mapping = list_create();
@@ -144,6 +186,8 @@ Task *task_create(Task *parent, const char *name, TaskFlags flags)
         task->user_stack_pointer = 0xff000000 + PROCESS_STACK_SIZE;
         task->user_stack = (void *)0xff000000;
         task_switch_address_space(scheduler_running(), parent_address_space);
+
+        clock_map(task);
     }
 
     arch_save_context(task);
@@ -176,7 +220,7 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
 
     if (parent)
     {
-        task->_domain = parent->_domain;
+        task->_domain = parent->domain();
     }
 
     // Setup fildes
@@ -190,11 +234,17 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
 
     list_foreach(MemoryMapping, mapping, parent->memory_mapping)
     {
+        // Shared by everyone rather than copied.
+        if (mapping->address == CLOCK_PAGE_ADDRESS)
+        {
+            continue;
+        }
+
         auto virtual_range = mapping->range();
 
-        auto physical_range = mapping->object->range();
+        size_t size = mapping->object->size();
 
-        void *buffer = malloc(physical_range.size());
+        void *buffer = malloc(size);
         assert(buffer);
         assert(virtual_range.base());
         memcpy(buffer, (void *)virtual_range.base(), virtual_range.size());
@@ -209,8 +259,11 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
         free(buffer);
     }
 
+    clock_map(task);
+
     task->user_stack_pointer = sp;
     task->entry_point = (TaskEntryPoint)ip;
+    task->tls_base = parent->tls_base;
 
     list_pushback(_tasks, task);
 
@@ -219,14 +272,42 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
     return task;
 }
 
-void task_destroy(Task *task)
+Task *task_create_thread(Task *parent, uintptr_t ip, uintptr_t sp, uintptr_t tls)
 {
-    interrupts_retain();
+    ASSERT_INTERRUPTS_RETAINED();
 
-    task->state(TASK_STATE_NONE);
+    Task *process = parent->process();
 
-    interrupts_release();
+    Task *task = new Task{};
+
+    task->id = _task_ids++;
+    task->_flags = TASK_USER | TASK_WAITABLE | (process->_flags & TASK_TRACED);
+    strlcpy(task->name, process->name, PROCESS_NAME_SIZE);
+    task->_state = TASK_STATE_NONE;
+
+    task->_process = process;
+    process->_threads++;
+
+    task->address_space = process->address_space;
+    task->memory_mapping = process->memory_mapping;
+
+    memory_alloc(task->address_space, PROCESS_STACK_SIZE, MEMORY_CLEAR, (uintptr_t *)&task->kernel_stack);
+    task->kernel_stack_pointer = ((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
+
+    // The user stack is owned by whoever created the thread.
+    task->user_stack_pointer = sp;
+    task->entry_point = (TaskEntryPoint)ip;
+    task->tls_base = tls;
 
+    list_pushback(_tasks, task);
+
+    task_go(task);
+
+    return task;
+}
+
+static void task_release_process(Task *task)
+{
     MemoryMapping *mapping = nullptr;
 
     while ((mapping = (MemoryMapping *)list_peek(task->memory_mapping)))
@@ -246,8 +327,49 @@ void task_destroy(Task *task)
     delete task;
 }
 
+void task_destroy(Task *task)
+{
+    interrupts_retain();
+
+    task->state(TASK_STATE_NONE);
+
+    interrupts_release();
+
+    if (task->is_thread())
+    {
+        Task *process = task->_process;
+
+        memory_free(task->address_space, MemoryRange{(uintptr_t)task->kernel_stack, PROCESS_STACK_SIZE});
+        delete task;
+
+        interrupts_retain();
+        bool release_process = --process->_threads == 0 && process->_destroy_pending;
+        interrupts_release();
+
+        if (release_process)
+        {
+            task_release_process(process);
+        }
+
+        return;
+    }
+
+    interrupts_retain();
+    bool has_threads = task->_threads > 0;
+    task->_destroy_pending = has_threads;
+    interrupts_release();
+
+    // The last thread to go will take the process with it.
+    if (!has_threads)
+    {
+        task_release_process(task);
+    }
+}
+
 void task_clear_userspace(Task *task)
 {
+    task->tls_base = 0;
+
     MemoryMapping *mapping = nullptr;
 
     while ((mapping = (MemoryMapping *)list_peek(task->memory_mapping)))
@@ -260,6 +382,8 @@ void task_clear_userspace(Task *task)
     task->user_stack_pointer = 0xff000000 + PROCESS_STACK_SIZE;
     task->user_stack = (void *)0xff000000;
     task_switch_address_space(scheduler_running(), parent_address_space);
+
+    clock_map(task);
 }
 
 void task_iterate(void *target, TaskIterateCallback callback)
@@ -396,7 +520,7 @@ Result task_block(Task *task, Blocker &blocker, Timeout timeout)
         return blocker.result();
     }
 
-    blocker.timeout(timeout == (Timeout)-1 ? -1 : system_get_tick() + timeout);
+    blocker.deadline(timeout == (Timeout)-1 ? -1 : arch_get_monotonic_time() + timeout * 1000000ull);
 
     task->_blocker = &blocker;
     task->state(TASK_STATE_BLOCKED);
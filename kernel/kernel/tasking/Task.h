@@ -42,11 +42,24 @@ struct Task
 
     int exit_value = 0;
 
+    // Threads share the address space, memory mappings, handles and domain of
+    // the task that created them, which stays alive until its last thread is gone.
+    Task *_process = nullptr;
+    int _threads = 0;
+    bool _destroy_pending = false;
+
+    uintptr_t tls_base = 0;
+
     Handles _handles;
     Domain _domain;
 
-    Handles &handles() { return _handles; }
-    Domain &domain() { return _domain; }
+    SLAB_ALLOCATED(Task);
+
+    Task *process() { return _process ? _process : this; }
+    bool is_thread() { return _process != nullptr; }
+
+    Handles &handles() { return process()->_handles; }
+    Domain &domain() { return process()->_domain; }
 
     TaskState state();
 
@@ -93,6 +106,8 @@ Task *task_create(Task *parent, const char *name, TaskFlags flags);
 
 Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags);
 
+Task *task_create_thread(Task *parent, uintptr_t ip, uintptr_t sp, uintptr_t tls);
+
 void task_destroy(Task *task);
 
 void task_clear_userspace(Task *task);
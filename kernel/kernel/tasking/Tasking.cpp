@@ -1,5 +1,6 @@
 #include <libsystem/Logger.h>
 
+#include "kernel/scheduling/Futex.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Finalizer.h"
@@ -22,5 +23,7 @@ void tasking_initialize()
 
     Kernel::finalizer_initialize();
 
+    futex_initialize();
+
     logger_info("Tasking initialized!");
 }
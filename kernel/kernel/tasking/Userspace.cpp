@@ -6,8 +6,6 @@
 #include "kernel/graphics/EarlyConsole.h"
 #include "kernel/tasking/Userspace.h"
 
-#define DEFAULT_ENVIRONMENT "{}"
-
 void userspace_initialize()
 {
     logger_info("Starting the userspace...");
@@ -22,7 +20,8 @@ void userspace_initialize()
     launchpad_handle(init_lauchpad, HANDLE(serial_device), 2);
     launchpad_handle(init_lauchpad, HANDLE(serial_device), 3);
 
-    launchpad_environment(init_lauchpad, DEFAULT_ENVIRONMENT);
+    // init starts with an empty environment and loads the real one itself.
+    launchpad_environment(init_lauchpad, "", 0);
 
     early_console_disable(); // We disable the early console to prevent artifact.
 
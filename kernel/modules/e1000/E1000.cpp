@@ -1,5 +1,7 @@
 #include <libsystem/Logger.h>
-#include <libsystem/utils/Hexdump.h>
+#include <string.h>
+
+#include "kernel/interrupts/Interupts.h"
 
 #include "e1000/E1000.h"
 
@@ -111,9 +113,8 @@ void E1000::initialize_rx()
 
     for (size_t i = 0; i < E1000_NUM_RX_DESC; i++)
     {
-        _rx_buffers.push_back(make<MMIORange>(8192));
-        _rx_descriptors[i].address = _rx_buffers[i]->physical_base();
-        _rx_descriptors[i].status = 0x1;
+        _rx_descriptors[i].address = rings_physical_base() + NetworkRings::rx_offset(i);
+        _rx_descriptors[i].status = 0;
     }
 
     write_register(E1000_REG_RX_LOW, _rx_descriptors_range->physical_base());
@@ -121,8 +122,8 @@ void E1000::initialize_rx()
     write_register(E1000_REG_RX_LENGTH, E1000_NUM_RX_DESC * sizeof(E1000RXDescriptor));
 
     write_register(E1000_REG_RX_HEAD, 0);
-    write_register(E1000_REG_RX_TAIL, E1000_NUM_RX_DESC - 1);
-    write_register(E1000_REG_RX_CONTROL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_8192);
+    write_register(E1000_REG_RX_TAIL, _rx_tail);
+    write_register(E1000_REG_RX_CONTROL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_2048);
 }
 
 void E1000::initialize_tx()
@@ -132,9 +133,7 @@ void E1000::initialize_tx()
 
     for (size_t i = 0; i < E1000_NUM_TX_DESC; i++)
     {
-        _tx_buffers.push_back(make<MMIORange>(8192));
-        _tx_descriptors[i].address = _tx_buffers[i]->physical_base();
-        _tx_descriptors[i].status = 0xff;
+        _tx_descriptors[i].status = TSTA_DD;
     }
 
     write_register(E1000_REG_TX_LOW, _tx_descriptors_range->physical_base());
@@ -142,50 +141,131 @@ void E1000::initialize_tx()
     write_register(E1000_REG_TX_LENGTH, E1000_NUM_TX_DESC * sizeof(E1000TXDescriptor));
 
     write_register(E1000_REG_TX_HEAD, 0);
-    write_register(E1000_REG_TX_TAIL, E1000_NUM_TX_DESC - 1);
+    write_register(E1000_REG_TX_TAIL, 0);
     write_register(E1000_REG_TX_CONTROL, TCTL_EN | TCTL_PSP | (15 << TCTL_CT_SHIFT) | (64 << TCTL_COLD_SHIFT) | TCTL_RTLC);
 }
 
 void E1000::enable_interrupt()
 {
-    write_register(E1000_REG_IMASK, 0x1F6DC);
-    write_register(E1000_REG_IMASK, 0xff & ~4);
-    read_register(0xc0);
+    write_register(E1000_REG_ITR, E1000_INTERRUPT_THROTTLING);
+    write_register(E1000_REG_IMASK, E1000_INTERRUPTS);
+    read_register(E1000_REG_ICR);
+
+    _interrupts_enabled = true;
 }
 
-size_t E1000::receive_packet(void *buffer, size_t size)
+void E1000::sync()
 {
-    UNUSED(size);
+    NetworkRing &tx = _rings->tx;
 
-    logger_trace("rx");
+    // The stack's side of the rings can't be trusted, the kernel keeps its own
+    // counters and only ever writes tx.tail.
+    while (_tx_cleaned != _tx_queued && (_tx_descriptors[_tx_cleaned % E1000_NUM_TX_DESC].status & TSTA_DD))
+    {
+        if (_tx_descriptors[_tx_cleaned % E1000_NUM_TX_DESC].status & (TSTA_EC | TSTA_LC))
+        {
+            _tx_stats.drops++;
+        }
 
-    uint32_t packet_size = _rx_descriptors[_current_rx_descriptors].length;
-    _rx_buffers[_current_rx_descriptors]->read(0, buffer, packet_size);
-    _rx_descriptors[_current_rx_descriptors].status = 0;
+        _tx_tail = _tx_frame_after[_tx_cleaned % E1000_NUM_TX_DESC];
+        _tx_cleaned++;
+    }
 
-    uint16_t old_cur = _current_rx_descriptors;
-    _current_rx_descriptors = (_current_rx_descriptors + 1) % E1000_NUM_RX_DESC;
-    write_register(E1000_REG_RX_TAIL, old_cur);
+    // Dropped frames are given back once everything before them is sent.
+    if (_tx_cleaned == _tx_queued)
+    {
+        _tx_tail = _tx_submitted;
+    }
 
-    return packet_size;
-}
+    __atomic_store_n(&tx.tail, _tx_tail, __ATOMIC_RELEASE);
 
-size_t E1000::send_packet(const void *buffer, size_t size)
-{
-    logger_trace("tx");
+    // The hardware can't tell a full ring from an empty one, one descriptor
+    // always stays behind.
+    uint32_t tx_head = __atomic_load_n(&tx.head, __ATOMIC_ACQUIRE);
+    uint32_t tx_queued = _tx_queued;
+    uint64_t tx_bytes = 0;
+
+    while (_tx_submitted != tx_head &&
+           _tx_submitted - _tx_tail < NETWORK_RING_SLOTS &&
+           _tx_queued - _tx_cleaned < E1000_NUM_TX_DESC - 1)
+    {
+        uint32_t length = tx.lengths[_tx_submitted % NETWORK_RING_SLOTS];
+
+        if (length == 0 || length > NETWORK_FRAME_SIZE)
+        {
+            _tx_stats.drops++;
+            _tx_submitted++;
+            continue;
+        }
+
+        auto &descriptor = _tx_descriptors[_tx_queued % E1000_NUM_TX_DESC];
+
+        descriptor.address = rings_physical_base() + NetworkRings::tx_offset(_tx_submitted);
+        descriptor.length = length;
+        descriptor.command = CMD_EOP | CMD_IFCS | CMD_RS;
+        descriptor.status = 0;
+
+        _tx_frame_after[_tx_queued % E1000_NUM_TX_DESC] = _tx_submitted + 1;
+
+        tx_bytes += length;
+        _tx_submitted++;
+        _tx_queued++;
+    }
+
+    if (_tx_queued != tx_queued)
+    {
+        write_register(E1000_REG_TX_TAIL, _tx_queued % E1000_NUM_TX_DESC);
+        count_batch(_tx_stats, _tx_queued - tx_queued, tx_bytes);
+    }
+
+    NetworkRing &rx = _rings->rx;
+    uint32_t rx_tail = __atomic_load_n(&rx.tail, __ATOMIC_ACQUIRE);
+    uint32_t rx_head = rx.head;
+    uint64_t rx_bytes = 0;
+
+    while (rx.head - rx_tail < E1000_NUM_RX_DESC && (_rx_descriptors[rx.head % E1000_NUM_RX_DESC].status & RSTA_DD))
+    {
+        auto &descriptor = _rx_descriptors[rx.head % E1000_NUM_RX_DESC];
+
+        // Bad frames are stored too (RCTL_SBP), the stack skips empty ones.
+        if (descriptor.errors)
+        {
+            rx.lengths[rx.head % NETWORK_RING_SLOTS] = 0;
+            _rx_stats.drops++;
+        }
+        else
+        {
+            rx.lengths[rx.head % NETWORK_RING_SLOTS] = descriptor.length;
+            rx_bytes += descriptor.length;
+        }
+
+        descriptor.status = 0;
+
+        __atomic_store_n(&rx.head, rx.head + 1, __ATOMIC_RELEASE);
+    }
 
-    _tx_buffers[_current_tx_descriptors]->write(0, buffer, size);
-    _tx_descriptors[_current_tx_descriptors].length = size;
-    _tx_descriptors[_current_tx_descriptors].command = CMD_EOP | CMD_IFCS | CMD_RS;
-    _tx_descriptors[_current_tx_descriptors].status = 0;
+    count_batch(_rx_stats, rx.head - rx_head, rx_bytes);
 
-    _current_tx_descriptors = (_current_tx_descriptors + 1) % E1000_NUM_TX_DESC;
-    write_register(E1000_REG_TX_TAIL, _current_tx_descriptors);
+    // Hand the buffers the stack is done with back to the hardware.
+    uint32_t rx_available = (rx_tail + E1000_NUM_RX_DESC - 1) % E1000_NUM_RX_DESC;
 
-    return size;
+    if (rx_available != _rx_tail)
+    {
+        _rx_tail = rx_available;
+        write_register(E1000_REG_RX_TAIL, _rx_tail);
+    }
+
+    // Nothing is left waiting in the hardware, the next frame can interrupt
+    // again. One that came in since then has its cause already set and
+    // interrupts as soon as it's unmasked.
+    if (!_interrupts_enabled && !(_rx_descriptors[rx.head % E1000_NUM_RX_DESC].status & RSTA_DD))
+    {
+        _interrupts_enabled = true;
+        write_register(E1000_REG_IMASK, E1000_INTERRUPTS);
+    }
 }
 
-E1000::E1000(DeviceAddress address) : PCIDevice(address, DeviceClass::NETWORK)
+E1000::E1000(DeviceAddress address) : NetworkDevice(address)
 {
     auto bar0 = bar(0);
 
@@ -206,66 +286,52 @@ E1000::E1000(DeviceAddress address) : PCIDevice(address, DeviceClass::NETWORK)
     enable_interrupt();
 }
 
+// Interrupts stay masked until the frames that caused this one are picked
+// up, the stack polls the rings in the meantime.
 void E1000::acknowledge_interrupt()
 {
-    write_register(E1000_REG_IMASK, 0x0);
+    write_register(E1000_REG_IMASK_CLEAR, 0xffffffff);
+    _interrupts_enabled = false;
 }
 
 void E1000::handle_interrupt()
 {
-    uint32_t status = read_register(E1000_REG_STATUS);
+    InterruptsRetainer retainer;
 
-    // logger_trace("e1000 interrupt (STATUS=%08x)!", status);
+    // Reading the cause and the missed packets count clears them.
+    uint32_t cause = read_register(E1000_REG_ICR);
+    _rx_stats.drops += read_register(E1000_REG_MPC);
+    _interrupts++;
 
-    if (status & 4)
+    if (cause & ICR_LSC)
     {
         uint32_t flags = read_register(E1000_REG_CONTROL);
         write_register(E1000_REG_CONTROL, flags | E1000_CTL_START_LINK);
     }
+
+    if (!can_read())
+    {
+        _interrupts_enabled = true;
+        write_register(E1000_REG_IMASK, E1000_INTERRUPTS);
+    }
 }
 
 bool E1000::can_write()
 {
-    return (_tx_descriptors[_current_tx_descriptors].status & 1);
+    return _rings->tx.head - _tx_tail < NETWORK_RING_SLOTS ||
+           (_tx_cleaned != _tx_queued && (_tx_descriptors[_tx_cleaned % E1000_NUM_TX_DESC].status & TSTA_DD));
 }
 
+// Frames to pick up, or sent ones to reclaim when the stack is running short
+// of transmit buffers.
 bool E1000::can_read()
 {
-    return _rx_descriptors[_current_rx_descriptors].status & 0x1;
-}
-
-ResultOr<size_t> E1000::read(size64_t offset, void *buffer, size_t size)
-{
-    UNUSED(offset);
-
-    size_t packet_size = receive_packet(buffer, size);
-    logger_trace("Packet receive (size=%u)", packet_size);
-    hexdump(buffer, packet_size);
-
-    return packet_size;
-}
-
-ResultOr<size_t> E1000::write(size64_t offset, const void *buffer, size_t size)
-{
-    UNUSED(offset);
-
-    size_t packet_size = send_packet(buffer, size);
-    logger_trace("Packet send (size=%u)", packet_size);
-    hexdump(buffer, packet_size);
-
-    return packet_size;
-}
-
-Result E1000::call(IOCall request, void *args)
-{
-    if (request == IOCALL_NETWORK_GET_STATE)
-    {
-        IOCallNetworkSateAgs *state = (IOCallNetworkSateAgs *)args;
-        state->mac_address = _mac_address;
-        return SUCCESS;
-    }
-    else
-    {
-        return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
-    }
+    NetworkRing &rx = _rings->rx;
+    NetworkRing &tx = _rings->tx;
+
+    return rx.head != rx.tail ||
+           (_rx_descriptors[rx.head % E1000_NUM_RX_DESC].status & RSTA_DD) ||
+           (tx.head - _tx_tail >= NETWORK_RING_SLOTS / 2 &&
+            _tx_cleaned != _tx_queued &&
+            (_tx_descriptors[_tx_cleaned % E1000_NUM_TX_DESC].status & TSTA_DD));
 }
@@ -1,8 +1,6 @@
 #pragma once
 
-#include <libsystem/utils/Hexdump.h>
-#include <libutils/Vector.h>
-
+#include "kernel/devices/NetworkDevice.h"
 #include "kernel/memory/MMIO.h"
 #include "pci/PCIDevice.h"
 
@@ -10,7 +8,11 @@
 #define E1000_REG_STATUS 0x0008
 
 #define E1000_REG_EEPROM 0x0014
+#define E1000_REG_ICR 0x00C0
+#define E1000_REG_ITR 0x00C4
 #define E1000_REG_IMASK 0x00D0
+#define E1000_REG_IMASK_CLEAR 0x00D8
+#define E1000_REG_MPC 0x4010
 #define E1000_REG_MAC_LOW 0x5400
 #define E1000_REG_MAC_HIGHT 0x5404
 
@@ -21,6 +23,17 @@
 #define E1000_REG_RX_HEAD 0x2810
 #define E1000_REG_RX_TAIL 0x2818
 
+#define ICR_TXDW (1 << 0)   // Transmit Descriptor Written Back
+#define ICR_LSC (1 << 2)    // Link Status Change
+#define ICR_RXDMT0 (1 << 4) // Receive Descriptor Minimum Threshold Reached
+#define ICR_RXO (1 << 6)    // Receiver Overrun
+#define ICR_RXT0 (1 << 7)   // Receiver Timer Interrupt
+
+#define E1000_INTERRUPTS (ICR_TXDW | ICR_LSC | ICR_RXDMT0 | ICR_RXO | ICR_RXT0)
+
+// At most one interrupt every 125us, in 256ns units.
+#define E1000_INTERRUPT_THROTTLING 488
+
 #define RCTL_EN (1 << 1)            // Receiver Enable
 #define RCTL_SBP (1 << 2)           // Store Bad Packets
 #define RCTL_UPE (1 << 3)           // Unicast Promiscuous Enabled
@@ -77,8 +90,12 @@
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
 
-#define E1000_NUM_RX_DESC 32
-#define E1000_NUM_TX_DESC 8
+#define RSTA_DD (1 << 0) // Descriptor Done
+
+// One descriptor per slot of the shared rings, they always point to the same
+// buffer.
+#define E1000_NUM_RX_DESC NETWORK_RING_SLOTS
+#define E1000_NUM_TX_DESC NETWORK_RING_SLOTS
 
 #define E1000_CTL_START_LINK 0x40 //set link up
 
@@ -103,7 +120,7 @@ struct PACKED E1000TXDescriptor
     uint16_t special;
 };
 
-class E1000 : public PCIDevice
+class E1000 : public NetworkDevice<PCIDevice>
 {
 private:
     RefPtr<MMIORange> _mmio_range = {};
@@ -112,15 +129,23 @@ private:
     bool _has_eeprom = false;
     MacAddress _mac_address = {};
 
-    int _current_rx_descriptors = 0;
     RefPtr<MMIORange> _rx_descriptors_range{};
     E1000RXDescriptor *_rx_descriptors{};
-    Vector<RefPtr<MMIORange>> _rx_buffers;
+    uint32_t _rx_tail = E1000_NUM_RX_DESC - 1;
 
-    int _current_tx_descriptors = 0;
     RefPtr<MMIORange> _tx_descriptors_range{};
     E1000TXDescriptor *_tx_descriptors{};
-    Vector<RefPtr<MMIORange>> _tx_buffers;
+
+    // Frames taken from the ring and given back to it, descriptors handed to
+    // the hardware and reclaimed. Frames with a bad length get no descriptor,
+    // so each one remembers where the ring's tail goes once it's sent.
+    uint32_t _tx_submitted = 0;
+    uint32_t _tx_tail = 0;
+    uint32_t _tx_queued = 0;
+    uint32_t _tx_cleaned = 0;
+    uint32_t _tx_frame_after[E1000_NUM_TX_DESC] = {};
+
+    bool _interrupts_enabled = false;
 
     void write_register(uint16_t offset, uint32_t value);
 
@@ -138,13 +163,14 @@ private:
 
     void enable_interrupt();
 
-    size_t receive_packet(void *buffer, size_t size);
-
-    size_t send_packet(const void *buffer, size_t size);
+protected:
+    void sync() override;
 
 public:
     E1000(DeviceAddress address);
 
+    MacAddress mac_address() override { return _mac_address; }
+
     void acknowledge_interrupt() override;
 
     void handle_interrupt() override;
@@ -152,10 +178,4 @@ public:
     bool can_write() override;
 
     bool can_read() override;
-
-    ResultOr<size_t> read(size64_t offset, void *buffer, size_t size) override;
-
-    ResultOr<size_t> write(size64_t offset, const void *buffer, size_t size) override;
-
-    Result call(IOCall request, void *args) override;
 };
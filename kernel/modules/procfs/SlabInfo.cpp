@@ -0,0 +1,69 @@
+#include <string.h>
+
+#include <libjson/Json.h>
+#include <libmath/MinMax.h>
+#include <libsystem/Result.h>
+
+#include "kernel/memory/Slab.h"
+#include "kernel/node/Handle.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "procfs/SlabInfo.h"
+
+FsSlabInfo::FsSlabInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+static Iteration serialize_slab_cache(Json::Value::Array *list, SlabCache *cache)
+{
+    Json::Value::Object cache_object{};
+
+    cache_object["name"] = cache->name;
+    cache_object["object_size"] = (int64_t)cache->object_size;
+    cache_object["slab_size"] = (int64_t)cache->slab_size;
+    cache_object["slabs"] = (int64_t)cache->slab_count;
+    cache_object["used"] = (int64_t)cache->used;
+    cache_object["capacity"] = (int64_t)(cache->slab_count * cache->objects_per_slab);
+    cache_object["allocations"] = (int64_t)cache->allocations;
+
+    list->push_back(move(cache_object));
+
+    return Iteration::CONTINUE;
+}
+
+Result FsSlabInfo::open(FsHandle &handle)
+{
+    Json::Value::Array list{};
+
+    slab_cache_iterate(&list, (SlabCacheIterateCallback)serialize_slab_cache);
+
+    Prettifier pretty{};
+    Json::prettify(pretty, list);
+
+    handle.attached = pretty.finalize().storage().give_ref();
+    handle.attached_size = reinterpret_cast<StringStorage *>(handle.attached)->size();
+
+    return SUCCESS;
+}
+
+void FsSlabInfo::close(FsHandle &handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle.attached));
+}
+
+ResultOr<size_t> FsSlabInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+void slab_info_initialize()
+{
+    scheduler_running()->domain().link(IO::Path::parse("/System/slabinfo"), make<FsSlabInfo>());
+}
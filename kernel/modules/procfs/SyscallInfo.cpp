@@ -0,0 +1,74 @@
+#include <string.h>
+
+#include <libjson/Json.h>
+#include <libmath/MinMax.h>
+#include <libsystem/Result.h>
+
+#include "kernel/node/Handle.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/tasking/Syscalls-Trace.h"
+#include "kernel/tasking/Syscalls.h"
+#include "procfs/SyscallInfo.h"
+
+FsSyscallInfo::FsSyscallInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+Result FsSyscallInfo::open(FsHandle &handle)
+{
+    Json::Value::Array list{};
+
+    for (int i = 0; i < __SYSCALL_COUNT; i++)
+    {
+        auto stats = syscall_stats((Syscall)i);
+
+        Json::Value::Object syscall_object{};
+
+        syscall_object["name"] = syscall_name((Syscall)i);
+        syscall_object["count"] = (int64_t)stats.count;
+        syscall_object["total"] = (int64_t)stats.total;
+        syscall_object["max"] = (int64_t)stats.max;
+
+        Json::Value::Array histogram{};
+
+        for (size_t bucket = 0; bucket < SYSCALL_HISTOGRAM_BUCKETS; bucket++)
+        {
+            histogram.push_back((int64_t)stats.histogram[bucket]);
+        }
+
+        syscall_object["histogram"] = move(histogram);
+
+        list.push_back(move(syscall_object));
+    }
+
+    Prettifier pretty{};
+    Json::prettify(pretty, list);
+
+    handle.attached = pretty.finalize().storage().give_ref();
+    handle.attached_size = reinterpret_cast<StringStorage *>(handle.attached)->size();
+
+    return SUCCESS;
+}
+
+void FsSyscallInfo::close(FsHandle &handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle.attached));
+}
+
+ResultOr<size_t> FsSyscallInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+void syscall_info_initialize()
+{
+    scheduler_running()->domain().link(IO::Path::parse("/System/syscalls"), make<FsSyscallInfo>());
+}
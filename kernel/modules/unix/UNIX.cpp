@@ -17,5 +17,15 @@ Iteration unix_scan(IterationCallback<UNIXAddress> callback)
         return Iteration::STOP;
     }
 
+    if (callback(UNIX_PROFILER) == Iteration::STOP)
+    {
+        return Iteration::STOP;
+    }
+
+    if (callback(UNIX_TRACE) == Iteration::STOP)
+    {
+        return Iteration::STOP;
+    }
+
     return Iteration::CONTINUE;
 }
@@ -5,4 +5,6 @@ enum UNIXAddress
     UNIX_ZERO,
     UNIX_NULL,
     UNIX_RANDOM,
+    UNIX_PROFILER,
+    UNIX_TRACE,
 };
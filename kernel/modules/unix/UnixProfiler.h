@@ -0,0 +1,53 @@
+#pragma once
+
+#include <libsystem/Logger.h>
+
+#include "kernel/system/Profiler.h"
+
+#include "unix/UNIXDevice.h"
+
+class UnixProfiler : public UNIXDevice
+{
+private:
+public:
+    UnixProfiler(DeviceAddress address) : UNIXDevice(address, DeviceClass::PROFILER)
+    {
+    }
+
+    ~UnixProfiler() {}
+
+    // Never blocks, a read returns whatever samples were taken since the
+    // last one, which may be none at all.
+    ResultOr<size_t> read(size64_t offset, void *buffer, size_t size) override
+    {
+        UNUSED(offset);
+
+        if (size < sizeof(ProfilerSample))
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        return profiler_read(buffer, size);
+    }
+
+    Result call(IOCall request, void *args) override
+    {
+        UNUSED(args);
+
+        if (request == IOCALL_PROFILER_START)
+        {
+            profiler_enable();
+            return SUCCESS;
+        }
+        else if (request == IOCALL_PROFILER_STOP)
+        {
+            profiler_disable();
+            logger_info("Profiler stopped, %d samples dropped so far", profiler_dropped());
+            return SUCCESS;
+        }
+        else
+        {
+            return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+        }
+    }
+};
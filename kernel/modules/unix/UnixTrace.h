@@ -0,0 +1,30 @@
+#pragma once
+
+#include "kernel/tasking/Syscalls-Trace.h"
+
+#include "unix/UNIXDevice.h"
+
+class UnixTrace : public UNIXDevice
+{
+private:
+public:
+    UnixTrace(DeviceAddress address) : UNIXDevice(address, DeviceClass::TRACE)
+    {
+    }
+
+    ~UnixTrace() {}
+
+    // Never blocks, a read returns whatever syscalls traced tasks made since
+    // the last one, which may be none at all.
+    ResultOr<size_t> read(size64_t offset, void *buffer, size_t size) override
+    {
+        UNUSED(offset);
+
+        if (size < sizeof(SyscallTraceEvent))
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        return syscall_trace_read(buffer, size);
+    }
+};
@@ -19,3 +19,15 @@
 #define VIRTIO_REGISTER_QUEUE_NOTIFY (0x10)
 #define VIRTIO_REGISTER_DEVICE_STATUS (0x12)
 #define VIRTIO_REGISTER_ISR_STATUS (0x13)
+
+// Device specific configuration, when MSI-X is disabled.
+#define VIRTIO_REGISTER_DEVICE_CONFIG (0x14)
+
+// 2.6 Split Virtqueues
+
+#define VIRTQ_DESCRIPTOR_NEXT (1)
+#define VIRTQ_DESCRIPTOR_WRITE (2)
+
+#define VIRTQ_AVAILABLE_NO_INTERRUPT (1)
+
+#define VIRTQ_ALIGN (4096)
@@ -2,10 +2,85 @@
 
 #include "pci/PCIDevice.h"
 #include "virtio/Virtio.h"
+#include "virtio/Virtqueue.h"
 
 class VirtioDevice : public PCIDevice
 {
 private:
+    uint16_t _io_base = 0;
+
+protected:
+    // Devices are driven through their legacy interface, where registers are
+    // I/O ports behind BAR0. Returns false if there is none.
+    bool begin_initialization()
+    {
+        auto bar0 = bar(0);
+
+        if (bar0.type() != PCIBarType::PIO)
+        {
+            return false;
+        }
+
+        _io_base = bar0.base();
+
+        // I/O space and bus mastering, for the queues.
+        pci_address().write16(PCI_COMMAND, pci_address().read16(PCI_COMMAND) | 0x5);
+
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, 0);
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+
+        return true;
+    }
+
+    // Accepts the subset of `features` the device offers, and returns it.
+    uint32_t negotiate(uint32_t features)
+    {
+        features &= in32(_io_base + VIRTIO_REGISTER_DEVICE_FEATURES);
+        out32(_io_base + VIRTIO_REGISTER_GUEST_FEATURES, features);
+
+        return features;
+    }
+
+    // The size of a queue is up to the device, null if the queue doesn't
+    // exist or is smaller than `minimum_size`.
+    RefPtr<Virtqueue> setup_queue(uint16_t index, uint16_t minimum_size)
+    {
+        out16(_io_base + VIRTIO_REGISTER_QUEUE_SELECT, index);
+        uint16_t size = in16(_io_base + VIRTIO_REGISTER_QUEUE_SIZE);
+
+        if (size == 0 || size < minimum_size)
+        {
+            return nullptr;
+        }
+
+        auto queue = make<Virtqueue>(size);
+        out32(_io_base + VIRTIO_REGISTER_QUEUE_ADDRESS, queue->physical_base() / VIRTQ_ALIGN);
+
+        return queue;
+    }
+
+    void finish_initialization(bool success)
+    {
+        uint8_t status = in8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS);
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, status | (success ? VIRTIO_STATUS_DRIVER_OK : VIRTIO_STATUS_FAILED));
+    }
+
+    uint8_t read_config8(uint16_t offset)
+    {
+        return in8(_io_base + VIRTIO_REGISTER_DEVICE_CONFIG + offset);
+    }
+
+    void notify(uint16_t queue)
+    {
+        out16(_io_base + VIRTIO_REGISTER_QUEUE_NOTIFY, queue);
+    }
+
+    // Reading the status acknowledges the interrupt.
+    uint8_t read_isr()
+    {
+        return in8(_io_base + VIRTIO_REGISTER_ISR_STATUS);
+    }
+
 public:
     VirtioDevice(DeviceAddress address, DeviceClass klass) : PCIDevice(address, klass)
     {
@@ -1 +1,251 @@
-#include "virtio/VirtioGraphic.h"
+#include <libsystem/Logger.h>
+#include <string.h>
+
+#include "virtio/VirtioNetwork.h"
+
+uintptr_t VirtioNetwork::header_physical_address(size_t index)
+{
+    return _headers_range->physical_base() + index * sizeof(VirtioNetworkHeader);
+}
+
+void VirtioNetwork::initialize_queues()
+{
+    _headers_range = make<MMIORange>(2 * NETWORK_RING_SLOTS * sizeof(VirtioNetworkHeader));
+    _headers = reinterpret_cast<VirtioNetworkHeader *>(_headers_range->base());
+    memset(_headers, 0, 2 * NETWORK_RING_SLOTS * sizeof(VirtioNetworkHeader));
+
+    for (uint16_t slot = 0; slot < NETWORK_RING_SLOTS; slot++)
+    {
+        auto &rx_header = _rx_queue->descriptor(2 * slot);
+        rx_header.address = header_physical_address(slot);
+        rx_header.length = sizeof(VirtioNetworkHeader);
+        rx_header.flags = VIRTQ_DESCRIPTOR_NEXT | VIRTQ_DESCRIPTOR_WRITE;
+        rx_header.next = 2 * slot + 1;
+
+        auto &rx_frame = _rx_queue->descriptor(2 * slot + 1);
+        rx_frame.address = rings_physical_base() + NetworkRings::rx_offset(slot);
+        rx_frame.length = NETWORK_FRAME_SIZE;
+        rx_frame.flags = VIRTQ_DESCRIPTOR_WRITE;
+
+        auto &tx_header = _tx_queue->descriptor(2 * slot);
+        tx_header.address = header_physical_address(NETWORK_RING_SLOTS + slot);
+        tx_header.length = sizeof(VirtioNetworkHeader);
+        tx_header.flags = VIRTQ_DESCRIPTOR_NEXT;
+        tx_header.next = 2 * slot + 1;
+
+        auto &tx_frame = _tx_queue->descriptor(2 * slot + 1);
+        tx_frame.address = rings_physical_base() + NetworkRings::tx_offset(slot);
+        tx_frame.flags = 0;
+    }
+
+    for (uint32_t counter = 0; counter < NETWORK_RING_SLOTS; counter++)
+    {
+        _rx_queue->offer(2 * counter);
+    }
+
+    _rx_offered = NETWORK_RING_SLOTS;
+}
+
+VirtioNetwork::VirtioNetwork(DeviceAddress address) : NetworkDevice(address)
+{
+    if (!begin_initialization())
+    {
+        logger_warn("VirtI/O network device without a legacy interface!");
+        return;
+    }
+
+    uint32_t features = negotiate(VIRTIO_NETWORK_F_MAC);
+
+    _rx_queue = setup_queue(VIRTIO_NETWORK_RX_QUEUE, 2 * NETWORK_RING_SLOTS);
+    _tx_queue = setup_queue(VIRTIO_NETWORK_TX_QUEUE, 2 * NETWORK_RING_SLOTS);
+
+    if (!_rx_queue || !_tx_queue)
+    {
+        logger_warn("VirtI/O network device queues are too small!");
+        finish_initialization(false);
+        return;
+    }
+
+    if (features & VIRTIO_NETWORK_F_MAC)
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            _mac_address.bytes[i] = read_config8(i);
+        }
+    }
+
+    initialize_queues();
+    finish_initialization(true);
+
+    notify(VIRTIO_NETWORK_RX_QUEUE);
+
+    _failed = false;
+}
+
+void VirtioNetwork::enable_interrupts(bool enabled)
+{
+    _interrupts_enabled = enabled;
+    _rx_queue->interrupts(enabled);
+    _tx_queue->interrupts(enabled);
+}
+
+// The device uses the buffers in the order they were offered, so slots come
+// back in the order of the rings' counters. The stack's side of the rings
+// can't be trusted, the driver keeps its own counters and only reads the
+// head of the transmit ring and the tail of the receive ring.
+void VirtioNetwork::sync()
+{
+    NetworkRing &tx = _rings->tx;
+
+    while (_tx_queue->has_used())
+    {
+        auto used = _tx_queue->take_used();
+        _tx_tail = _tx_frame_after[(used.id / 2) % NETWORK_RING_SLOTS];
+        _tx_cleaned++;
+    }
+
+    // Dropped frames are given back once everything before them is sent.
+    if (_tx_cleaned == _tx_queued)
+    {
+        _tx_tail = _tx_submitted;
+    }
+
+    __atomic_store_n(&tx.tail, _tx_tail, __ATOMIC_RELEASE);
+
+    // Both queues have room for every slot of the rings.
+    uint32_t tx_head = __atomic_load_n(&tx.head, __ATOMIC_ACQUIRE);
+    uint32_t tx_queued = _tx_queued;
+    uint64_t tx_bytes = 0;
+
+    while (_tx_submitted != tx_head && _tx_submitted - _tx_tail < NETWORK_RING_SLOTS)
+    {
+        uint16_t slot = _tx_submitted % NETWORK_RING_SLOTS;
+        uint32_t length = tx.lengths[slot];
+
+        if (length == 0 || length > NETWORK_FRAME_SIZE)
+        {
+            _tx_stats.drops++;
+            _tx_submitted++;
+            continue;
+        }
+
+        _tx_queue->descriptor(2 * slot + 1).length = length;
+        _tx_queue->offer(2 * slot);
+        _tx_frame_after[slot] = _tx_submitted + 1;
+
+        tx_bytes += length;
+        _tx_submitted++;
+        _tx_queued++;
+    }
+
+    if (_tx_queued != tx_queued)
+    {
+        notify(VIRTIO_NETWORK_TX_QUEUE);
+        count_batch(_tx_stats, _tx_queued - tx_queued, tx_bytes);
+    }
+
+    NetworkRing &rx = _rings->rx;
+    uint32_t rx_tail = __atomic_load_n(&rx.tail, __ATOMIC_ACQUIRE);
+
+    // A tail the stack can't have reached gives nothing back.
+    if (_rx_head - rx_tail > NETWORK_RING_SLOTS)
+    {
+        rx_tail = _rx_offered - NETWORK_RING_SLOTS;
+    }
+
+    uint32_t rx_head = _rx_head;
+    uint64_t rx_bytes = 0;
+
+    while (_rx_head - rx_tail < NETWORK_RING_SLOTS && _rx_queue->has_used())
+    {
+        auto used = _rx_queue->take_used();
+
+        if (used.length < sizeof(VirtioNetworkHeader))
+        {
+            rx.lengths[_rx_head % NETWORK_RING_SLOTS] = 0;
+            _rx_stats.drops++;
+        }
+        else
+        {
+            rx.lengths[_rx_head % NETWORK_RING_SLOTS] = used.length - sizeof(VirtioNetworkHeader);
+            rx_bytes += used.length - sizeof(VirtioNetworkHeader);
+        }
+
+        _rx_head++;
+    }
+
+    __atomic_store_n(&rx.head, _rx_head, __ATOMIC_RELEASE);
+    count_batch(_rx_stats, _rx_head - rx_head, rx_bytes);
+
+    // Offer the buffers the stack is done with back to the device.
+    uint32_t rx_offered = _rx_offered;
+
+    while (_rx_offered - rx_tail < NETWORK_RING_SLOTS)
+    {
+        _rx_queue->offer(2 * (_rx_offered % NETWORK_RING_SLOTS));
+        _rx_offered++;
+    }
+
+    if (_rx_offered != rx_offered)
+    {
+        notify(VIRTIO_NETWORK_RX_QUEUE);
+    }
+
+    if (!_interrupts_enabled && !_rx_queue->has_used())
+    {
+        enable_interrupts(true);
+    }
+}
+
+// Interrupts stay suppressed until the frames that caused this one are
+// picked up, the stack polls the rings in the meantime.
+void VirtioNetwork::acknowledge_interrupt()
+{
+    if (_failed)
+    {
+        return;
+    }
+
+    read_isr();
+    enable_interrupts(false);
+}
+
+void VirtioNetwork::handle_interrupt()
+{
+    if (_failed)
+    {
+        return;
+    }
+
+    InterruptsRetainer retainer;
+
+    _interrupts++;
+
+    if (!can_read())
+    {
+        enable_interrupts(true);
+    }
+}
+
+bool VirtioNetwork::can_write()
+{
+    return !_failed &&
+           (_rings->tx.head - _tx_tail < NETWORK_RING_SLOTS || _tx_queue->has_used());
+}
+
+// Frames to pick up, or sent ones to reclaim when the stack is running short
+// of transmit buffers.
+bool VirtioNetwork::can_read()
+{
+    if (_failed)
+    {
+        return false;
+    }
+
+    NetworkRing &rx = _rings->rx;
+    NetworkRing &tx = _rings->tx;
+
+    return _rx_head != rx.tail ||
+           _rx_queue->has_used() ||
+           (tx.head - _tx_tail >= NETWORK_RING_SLOTS / 2 && _tx_queue->has_used());
+}
@@ -1,16 +1,79 @@
 #pragma once
 
+#include "kernel/devices/NetworkDevice.h"
 #include "virtio/VirtioDevice.h"
 
-class VirtioNetwork : public VirtioDevice
+#define VIRTIO_NETWORK_F_MAC (1 << 5)
+
+#define VIRTIO_NETWORK_RX_QUEUE 0
+#define VIRTIO_NETWORK_TX_QUEUE 1
+
+// Without VIRTIO_NET_F_MRG_RXBUF, every frame comes after one of these.
+struct PACKED VirtioNetworkHeader
+{
+    uint8_t flags;
+    uint8_t gso_type;
+    uint16_t header_length;
+    uint16_t gso_size;
+    uint16_t checksum_start;
+    uint16_t checksum_offset;
+};
+
+// Each slot of the rings has a chain of two descriptors in its queue: its
+// header at 2 * slot, then its frame buffer in the shared rings.
+class VirtioNetwork : public NetworkDevice<VirtioDevice>
 {
 private:
+    bool _failed = true;
+    MacAddress _mac_address = {};
+
+    RefPtr<Virtqueue> _rx_queue{};
+    RefPtr<Virtqueue> _tx_queue{};
+
+    RefPtr<MMIORange> _headers_range{};
+    VirtioNetworkHeader *_headers = nullptr;
+
+    // Frames published to the receive ring and buffers offered to the device.
+    uint32_t _rx_head = 0;
+    uint32_t _rx_offered = 0;
+
+    // Frames taken from the transmit ring and given back to it, chains
+    // offered to the device and reclaimed. Frames with a bad length are never
+    // offered, so each slot remembers where the ring's tail goes once it's
+    // sent.
+    uint32_t _tx_submitted = 0;
+    uint32_t _tx_tail = 0;
+    uint32_t _tx_queued = 0;
+    uint32_t _tx_cleaned = 0;
+    uint32_t _tx_frame_after[NETWORK_RING_SLOTS] = {};
+
+    bool _interrupts_enabled = true;
+
+    uintptr_t header_physical_address(size_t index);
+
+    void initialize_queues();
+
+    void enable_interrupts(bool enabled);
+
+protected:
+    void sync() override;
+
 public:
-    VirtioNetwork(DeviceAddress address) : VirtioDevice(address, DeviceClass::NETWORK)
-    {
-    }
+    VirtioNetwork(DeviceAddress address);
 
     ~VirtioNetwork()
     {
     }
+
+    bool did_fail() override { return _failed; }
+
+    MacAddress mac_address() override { return _mac_address; }
+
+    void acknowledge_interrupt() override;
+
+    void handle_interrupt() override;
+
+    bool can_write() override;
+
+    bool can_read() override;
 };
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libutils/RefCounted.h>
+#include <string.h>
+
+#include "kernel/memory/MMIO.h"
+#include "virtio/Virtio.h"
+
+struct PACKED VirtqDescriptor
+{
+    uint64_t address;
+    uint32_t length;
+    uint16_t flags;
+    uint16_t next;
+};
+
+struct PACKED VirtqUsedElement
+{
+    uint32_t id;
+    uint32_t length;
+};
+
+// A split virtqueue in the legacy layout: the descriptor table, the ring of
+// descriptors offered to the device right after it, and the ring of the ones
+// it's done with on the next VIRTQ_ALIGN boundary.
+class Virtqueue : public RefCounted<Virtqueue>
+{
+private:
+    uint16_t _size;
+    RefPtr<MMIORange> _range;
+
+    VirtqDescriptor *_descriptors;
+    volatile uint16_t *_available;
+    volatile uint16_t *_used;
+
+    uint16_t _last_used = 0;
+
+    static size_t available_offset(uint16_t size) { return sizeof(VirtqDescriptor) * size; }
+
+    static size_t used_offset(uint16_t size)
+    {
+        size_t offset = available_offset(size) + sizeof(uint16_t) * (3 + size);
+        return (offset + VIRTQ_ALIGN - 1) / VIRTQ_ALIGN * VIRTQ_ALIGN;
+    }
+
+    static size_t total_size(uint16_t size) { return used_offset(size) + sizeof(uint16_t) * 3 + sizeof(VirtqUsedElement) * size; }
+
+public:
+    uint16_t size() { return _size; }
+
+    uintptr_t physical_base() { return _range->physical_base(); }
+
+    Virtqueue(uint16_t size)
+        : _size{size},
+          _range{make<MMIORange>(total_size(size))}
+    {
+        memset((void *)_range->base(), 0, _range->size());
+
+        _descriptors = reinterpret_cast<VirtqDescriptor *>(_range->base());
+        _available = reinterpret_cast<uint16_t *>(_range->base() + available_offset(size));
+        _used = reinterpret_cast<uint16_t *>(_range->base() + used_offset(size));
+    }
+
+    VirtqDescriptor &descriptor(uint16_t index) { return _descriptors[index]; }
+
+    // Makes the chain starting at `head` available, the device only looks at
+    // it once notified.
+    void offer(uint16_t head)
+    {
+        uint16_t index = _available[1];
+        _available[2 + index % _size] = head;
+        __atomic_store_n(&_available[1], (uint16_t)(index + 1), __ATOMIC_RELEASE);
+    }
+
+    bool has_used()
+    {
+        return __atomic_load_n(&_used[1], __ATOMIC_ACQUIRE) != _last_used;
+    }
+
+    VirtqUsedElement take_used()
+    {
+        auto *ring = reinterpret_cast<volatile VirtqUsedElement *>(&_used[2]);
+        volatile VirtqUsedElement &element = ring[_last_used % _size];
+        _last_used++;
+
+        return {element.id, element.length};
+    }
+
+    // Only a hint, the device may still interrupt.
+    void interrupts(bool enabled)
+    {
+        __atomic_store_n(&_available[0], (uint16_t)(enabled ? 0 : VIRTQ_AVAILABLE_NO_INTERRUPT), __ATOMIC_SEQ_CST);
+    }
+};
@@ -21,7 +21,8 @@ CONFIGS = \
 	CONFIG_OPTIMISATIONS \
 	CONFIG_VERSION \
 	CONFIG_IS_TEST \
-	CONFIG_IS_RELEASE
+	CONFIG_IS_RELEASE \
+	CONFIG_PROFILE
 
 CONFIGS_PASS_TO_COMPILER = \
 	CONFIG \
@@ -31,7 +32,8 @@ CONFIGS_PASS_TO_COMPILER = \
 	CONFIG_NAME \
 	CONFIG_VERSION \
 	CONFIG_IS_TEST \
-	CONFIG_IS_RELEASE
+	CONFIG_IS_RELEASE \
+	CONFIG_PROFILE
 
 CONFIG                ?=develop
 
@@ -98,6 +100,9 @@ CONFIG_IS_TEST        ?=false
 # Is it a release
 CONFIG_IS_RELEASE     ?=false
 
+# Sample the running task on every timer tick, the tests run under the profiler.
+CONFIG_PROFILE        ?=false
+
 define BUILD_CONFIG_TEMPLATE =
 -D__$(1)__=$(if $(filter $($(1)),true),1,$(if $(filter false, $($(1))),0,\""$($(1))"\"))
 endef
@@ -0,0 +1,67 @@
+#include <libcompression/CRC.h>
+#include <libcompression/Deflate.h>
+#include <libcompression/Inflate.h>
+#include <libio/MemoryReader.h>
+#include <libio/MemoryWriter.h>
+
+#include "hosted/bench/Driver.h"
+
+// Fonts descriptions are a mix of text and numbers, close to what gets
+// compressed on the system (archives, settings, ...).
+static constexpr auto CORPUS = "sysroot/Files/Fonts/sans.json";
+
+BENCH(crc_corpus)
+{
+    auto data = Bench::load(CORPUS);
+
+    while (state.running())
+    {
+        Compression::CRC crc;
+        crc.add((const uint8_t *)data.start(), data.size());
+
+        Bench::keep(crc.checksum());
+        state.processed(data.size());
+    }
+}
+
+BENCH(deflate_corpus)
+{
+    auto data = Bench::load(CORPUS);
+
+    while (state.running())
+    {
+        IO::MemoryReader uncompressed{data};
+        IO::MemoryWriter compressed;
+
+        Compression::Deflate deflate{5};
+        deflate.perform(uncompressed, compressed);
+
+        state.processed(data.size());
+        state.produced(compressed.length().unwrap());
+    }
+}
+
+BENCH(inflate_corpus)
+{
+    auto data = Bench::load(CORPUS);
+
+    IO::MemoryReader uncompressed{data};
+    IO::MemoryWriter compressed;
+
+    Compression::Deflate deflate{5};
+    deflate.perform(uncompressed, compressed);
+
+    Slice compressed_data{compressed.slice()};
+
+    while (state.running())
+    {
+        IO::MemoryReader reader{compressed_data};
+        IO::MemoryWriter writer{data.size()};
+
+        Compression::Inflate inflate;
+        inflate.perform(reader, writer);
+
+        Bench::keep(writer.length().unwrap());
+        state.processed(data.size());
+    }
+}
@@ -0,0 +1,354 @@
+#include <libio/Copy.h>
+#include <libio/File.h>
+#include <libio/Streams.h>
+#include <libjson/Json.h>
+#include <libutils/Vector.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hosted/bench/Driver.h"
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *address, size_t size);
+extern "C" void __libc_free(void *address);
+
+/* --- Allocations ---------------------------------------------------------- */
+
+// Everything ends up in malloc, operator new and the libutils containers
+// included, so counting there catches every allocation of a benchmark.
+static bool _counting = false;
+static size_t _allocations = 0;
+static size_t _allocated_bytes = 0;
+
+static void count_allocation(size_t size)
+{
+    if (_counting)
+    {
+        _allocations++;
+        _allocated_bytes += size;
+    }
+}
+
+extern "C" void *malloc(size_t size)
+{
+    count_allocation(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    count_allocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *address, size_t size)
+{
+    count_allocation(size);
+    return __libc_realloc(address, size);
+}
+
+extern "C" void free(void *address)
+{
+    __libc_free(address);
+}
+
+namespace Bench
+{
+
+static Vector<Benchmark> *_benchmarks;
+
+void __register_benchmark(Benchmark &benchmark)
+{
+    if (!_benchmarks)
+    {
+        _benchmarks = new Vector<Benchmark>();
+    }
+
+    _benchmarks->push_back(benchmark);
+}
+
+static uint64_t now()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000000ull + time.tv_nsec;
+}
+
+/* --- State ---------------------------------------------------------------- */
+
+static uint64_t _start = 0;
+
+bool State::running()
+{
+    if (done == 0)
+    {
+        _allocations = 0;
+        _allocated_bytes = 0;
+        _counting = true;
+        _start = now();
+    }
+
+    if (done < iterations)
+    {
+        done++;
+        return true;
+    }
+
+    elapsed = now() - _start;
+    _counting = false;
+
+    allocations = _allocations;
+    allocated_bytes = _allocated_bytes;
+
+    return false;
+}
+
+Slice load(const char *path)
+{
+    IO::File file{path, OPEN_READ};
+
+    if (!file.exist())
+    {
+        IO::errln("bench: Failed to open {}, run from the root of the repository", path);
+        abort();
+    }
+
+    return IO::read_all(file).unwrap();
+}
+
+/* --- Results -------------------------------------------------------------- */
+
+struct Measure
+{
+    String name;
+    size_t iterations;
+    uint64_t elapsed;
+    size_t bytes;
+    size_t allocations;
+    size_t allocated_bytes;
+    size_t output;
+
+    double ns_per_op() const { return (double)elapsed / iterations; }
+
+    double mb_per_second() const { return elapsed ? (bytes * 1000.0) / elapsed : 0; }
+
+    double allocations_per_op() const { return (double)allocations / iterations; }
+
+    double bytes_per_op() const { return (double)allocated_bytes / iterations; }
+
+    Json::Value serialize() const
+    {
+        Json::Value::Object object;
+
+        object["name"] = name.cstring();
+        object["iterations"] = (int64_t)iterations;
+        object["elapsed"] = (int64_t)elapsed;
+        object["bytes"] = (int64_t)bytes;
+        object["allocations"] = (int64_t)allocations;
+        object["allocated_bytes"] = (int64_t)allocated_bytes;
+        object["output"] = (int64_t)output;
+
+        return object;
+    }
+
+    static Measure deserialize(const Json::Value &value)
+    {
+        return {
+            value.get("name").as_string(),
+            (size_t)value.get("iterations").as_integer(),
+            (uint64_t)value.get("elapsed").as_integer(),
+            (size_t)value.get("bytes").as_integer(),
+            (size_t)value.get("allocations").as_integer(),
+            (size_t)value.get("allocated_bytes").as_integer(),
+            value.has("output") ? (size_t)value.get("output").as_integer() : 0,
+        };
+    }
+};
+
+// Runs the benchmark with more and more iterations until one run lasts long
+// enough for the clock and the noise not to matter anymore.
+static Measure measure(const Benchmark &benchmark, Options &options)
+{
+    State state;
+    size_t iterations = 1;
+
+    while (true)
+    {
+        state = {};
+        state.iterations = iterations;
+
+        benchmark.function(state);
+
+        if (state.elapsed >= options.min_time || iterations >= 1000000000)
+        {
+            break;
+        }
+
+        uint64_t elapsed = MAX(state.elapsed, 1);
+        size_t predicted = (size_t)(iterations * 1.4 * options.min_time / elapsed);
+
+        iterations = MIN(MAX(predicted, iterations + 1), iterations * 100);
+    }
+
+    return {
+        benchmark.name,
+        state.iterations,
+        state.elapsed,
+        state.bytes,
+        state.allocations,
+        state.allocated_bytes,
+        state.output,
+    };
+}
+
+static Vector<Measure> load_results(String path)
+{
+    Vector<Measure> results;
+
+    IO::File file{path, OPEN_READ};
+
+    if (!file.exist())
+    {
+        IO::errln("bench: Failed to open {}", path);
+        return results;
+    }
+
+    auto root = Json::parse(file);
+
+    if (!root.is(Json::OBJECT) || !root.has("benchmarks"))
+    {
+        IO::errln("bench: {} doesn't contain any benchmark", path);
+        return results;
+    }
+
+    auto &benchmarks = root.get("benchmarks");
+
+    for (size_t i = 0; i < benchmarks.length(); i++)
+    {
+        results.push_back(Measure::deserialize(benchmarks.get(i)));
+    }
+
+    return results;
+}
+
+static Result save_results(String path, Vector<Measure> &results)
+{
+    Json::Value::Array benchmarks;
+
+    for (auto &result : results)
+    {
+        benchmarks.push_back(result.serialize());
+    }
+
+    Json::Value::Object root;
+    root["benchmarks"] = move(benchmarks);
+
+    Prettifier pretty{Prettifier::INDENTS};
+    Json::prettify(pretty, root);
+
+    auto data = pretty.finalize();
+
+    IO::File file{path, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    if (!file.exist())
+    {
+        return ERR_NOT_WRITABLE;
+    }
+
+    return file.write(data.cstring(), data.length()).result();
+}
+
+static void column(String text, size_t width, bool right)
+{
+    if (right)
+    {
+        for (size_t i = text.length(); i < width; i++)
+        {
+            IO::out(" ");
+        }
+    }
+
+    IO::out("{}", text);
+
+    if (!right)
+    {
+        for (size_t i = text.length(); i < width; i++)
+        {
+            IO::out(" ");
+        }
+    }
+}
+
+static void report(Measure &result, const Measure *baseline)
+{
+    column(result.name, 40, false);
+    column(IO::format("{} ns/op", (int64_t)result.ns_per_op()), 18, true);
+    column(result.bytes ? IO::format("{} MB/s", result.mb_per_second()) : "", 14, true);
+    column(IO::format("{} allocs/op", (int64_t)result.allocations_per_op()), 18, true);
+    column(IO::format("{} B/op", (int64_t)result.bytes_per_op()), 14, true);
+    column(result.output ? IO::format("{} B out", (int64_t)result.output) : "", 16, true);
+
+    if (baseline)
+    {
+        int64_t change = (int64_t)((result.ns_per_op() / baseline->ns_per_op() - 1) * 100);
+        IO::out("  \e[1;{}m{}{}%\e[m", change > 0 ? 31 : 32, change > 0 ? "+" : "", change);
+    }
+
+    IO::outln("");
+}
+
+int run_all_benchmarks(Options &options)
+{
+    Assert::not_null(_benchmarks);
+
+    Vector<Measure> baselines;
+
+    if (options.compare != "")
+    {
+        baselines = load_results(options.compare);
+    }
+
+    Vector<Measure> results;
+
+    for (auto &benchmark : *_benchmarks)
+    {
+        if (options.filter != "" && !strstr(benchmark.name, options.filter.cstring()))
+        {
+            continue;
+        }
+
+        auto result = measure(benchmark, options);
+
+        const Measure *baseline = nullptr;
+
+        for (auto &candidate : baselines)
+        {
+            if (candidate.name == result.name)
+            {
+                baseline = &candidate;
+            }
+        }
+
+        report(result, baseline);
+        results.push_back(result);
+    }
+
+    if (options.json != "")
+    {
+        auto saved = save_results(options.json, results);
+
+        if (saved != SUCCESS)
+        {
+            IO::errln("bench: Failed to write {}: {}", options.json, get_result_description(saved));
+            return PROCESS_FAILURE;
+        }
+    }
+
+    return PROCESS_SUCCESS;
+}
+
+} // namespace Bench
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <libutils/Slice.h>
+#include <libutils/SourceLocation.h>
+#include <libutils/String.h>
+
+namespace Bench
+{
+
+// Handed to every benchmark, which loops on running() around the code being
+// measured. Anything before the first call to running() is setup and isn't
+// counted, neither in time nor in allocations.
+struct State
+{
+    size_t iterations = 0;
+    size_t done = 0;
+
+    uint64_t elapsed = 0;
+    size_t bytes = 0;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    size_t output = 0;
+
+    bool running();
+
+    // Bytes consumed or produced by one iteration, used for the throughput.
+    void processed(size_t amount) { bytes += amount; }
+
+    // Size of what one iteration produced, for benchmarks where it matters
+    // as much as the time (compressors, encoders, ...).
+    void produced(size_t amount) { output = amount; }
+};
+
+typedef void (*BenchFunction)(State &state);
+
+struct Benchmark;
+
+void __register_benchmark(Benchmark &benchmark);
+
+struct Benchmark
+{
+    const char *name;
+    BenchFunction function;
+    Utils::SourceLocation location;
+
+    Benchmark(const char *name, BenchFunction function, Utils::SourceLocation location = Utils::SourceLocation::current())
+    {
+        this->name = name;
+        this->function = function;
+        this->location = location;
+
+        __register_benchmark(*this);
+    }
+};
+
+#define BENCH(__bench_function)                                     \
+    void __bench_##__bench_function##_function(::Bench::State &);   \
+    ::Bench::Benchmark __bench_##__bench_function##_object{         \
+        #__bench_function,                                          \
+        __bench_##__bench_function##_function,                      \
+    };                                                              \
+    void __bench_##__bench_function##_function(::Bench::State &state)
+
+// Keeps the compiler from optimizing away a result nobody looks at.
+template <typename T>
+inline void keep(const T &value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+}
+
+// Reads a file of the sysroot, paths are relative to the root of the repository.
+Slice load(const char *path);
+
+struct Options
+{
+    String filter = "";
+    String json = "";
+    String compare = "";
+    uint64_t min_time = 500 * 1000 * 1000;
+};
+
+int run_all_benchmarks(Options &options);
+
+} // namespace Bench
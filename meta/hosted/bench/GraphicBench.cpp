@@ -0,0 +1,278 @@
+#include <libcompression/Deflate.h>
+#include <libgraphic/Bitmap.h>
+#include <libgraphic/Font.h>
+#include <libgraphic/Painter.h>
+#include <libgraphic/png/PngReader.h>
+#include <libgraphic/png/PngWriter.h>
+#include <libgraphic/svg/Svg.h>
+#include <libio/MemoryReader.h>
+#include <libio/MemoryWriter.h>
+#include <string.h>
+
+#include "hosted/bench/Driver.h"
+
+static constexpr auto SCREEN_WIDTH = 1920;
+static constexpr auto SCREEN_HEIGHT = 1080;
+
+BENCH(png_decode_wallpaper)
+{
+    auto data = Bench::load("sysroot/Files/Wallpapers/peaks.png");
+
+    while (state.running())
+    {
+        IO::MemoryReader reader{data};
+        Graphic::PngReader png{reader};
+
+        Bench::keep(png.bitmap()->pixels());
+        state.processed(data.size());
+    }
+}
+
+// A desktop: the wallpaper with a few flat windows on top of it.
+static RefPtr<Graphic::Bitmap> screen()
+{
+    auto data = Bench::load("sysroot/Files/Wallpapers/peaks.png");
+    IO::MemoryReader reader{data};
+    Graphic::PngReader png{reader};
+
+    auto bitmap = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    Graphic::Painter painter{bitmap};
+
+    painter.blit(*png.bitmap(), png.bitmap()->bound(), bitmap->bound());
+    painter.fill_rectangle({200, 150, 800, 600}, Graphic::Colors::WHITE);
+    painter.fill_rectangle({200, 150, 800, 32}, Graphic::Colors::BLACK);
+    painter.fill_rectangle({1100, 300, 600, 500}, Graphic::Color::from_hex(0x333333));
+    painter.fill_rectangle({0, 0, SCREEN_WIDTH, 38}, Graphic::Color::from_hex(0x1a1a1a));
+
+    return bitmap;
+}
+
+static void png_encode_screen(Bench::State &state, unsigned int compression_level)
+{
+    auto bitmap = screen();
+
+    while (state.running())
+    {
+        IO::MemoryWriter writer{SCREEN_WIDTH * SCREEN_HEIGHT};
+        Graphic::PngWriter png{writer, compression_level};
+        png.write(*bitmap);
+
+        state.processed(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Graphic::Color));
+        state.produced(writer.length().unwrap());
+    }
+}
+
+BENCH(png_encode_screen_fast)
+{
+    png_encode_screen(state, 1);
+}
+
+BENCH(png_encode_screen_default)
+{
+    png_encode_screen(state, Graphic::PngWriter::DEFAULT_COMPRESSION_LEVEL);
+}
+
+BENCH(png_encode_screen_best)
+{
+    png_encode_screen(state, Compression::Deflate::MAX_COMPRESSION_LEVEL);
+}
+
+BENCH(svg_render_logo)
+{
+    auto data = Bench::load("sysroot/Files/logo.svg");
+
+    while (state.running())
+    {
+        IO::MemoryReader reader{data};
+        auto bitmap = Graphic::Svg::render(reader, 256).unwrap();
+
+        Bench::keep(bitmap->pixels());
+    }
+}
+
+BENCH(painter_fill_screen)
+{
+    auto bitmap = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    Graphic::Painter painter{bitmap};
+
+    while (state.running())
+    {
+        painter.fill_rectangle(bitmap->bound(), Graphic::Colors::RED.with_alpha(0.5));
+
+        Bench::keep(bitmap->pixels());
+        state.processed(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Graphic::Color));
+    }
+}
+
+BENCH(painter_blit_screen)
+{
+    auto source = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    auto destination = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    Graphic::Painter painter{destination};
+
+    while (state.running())
+    {
+        painter.blit(*source, source->bound(), destination->bound());
+
+        Bench::keep(destination->pixels());
+        state.processed(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Graphic::Color));
+    }
+}
+
+BENCH(painter_blur_window)
+{
+    auto bitmap = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    Graphic::Painter painter{bitmap};
+
+    // Roughly what the compositor does behind an acrylic window.
+    Math::Recti window{200, 150, 800, 600};
+
+    while (state.running())
+    {
+        painter.blur(window, 8);
+
+        Bench::keep(bitmap->pixels());
+        state.processed(window.area() * sizeof(Graphic::Color));
+    }
+}
+
+// A wallpaper as big as a 4K screen, for the compositor to fit on 1080p.
+static RefPtr<Graphic::Bitmap> wallpaper_4k()
+{
+    auto data = Bench::load("sysroot/Files/Wallpapers/peaks.png");
+    IO::MemoryReader reader{data};
+    Graphic::PngReader png{reader};
+
+    auto bitmap = Graphic::Bitmap::create_shared(3840, 2160).unwrap();
+    Graphic::Painter painter{bitmap};
+    painter.blit(*png.bitmap(), png.bitmap()->bound(), bitmap->bound());
+
+    return bitmap;
+}
+
+BENCH(painter_scale_4k_to_1080p)
+{
+    auto wallpaper = wallpaper_4k();
+    auto screen = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    Graphic::Painter painter{screen};
+
+    while (state.running())
+    {
+        painter.blit(*wallpaper, wallpaper->bound(), screen->bound());
+
+        Bench::keep(screen->pixels());
+        state.processed(wallpaper->width() * wallpaper->height() * sizeof(Graphic::Color));
+    }
+}
+
+BENCH(painter_scale_4k_to_1080p_cached)
+{
+    auto wallpaper = wallpaper_4k();
+    auto screen = Graphic::Bitmap::create_shared(SCREEN_WIDTH, SCREEN_HEIGHT).unwrap();
+    Graphic::Painter painter{screen};
+
+    while (state.running())
+    {
+        painter.blit(*wallpaper, Graphic::BitmapScaling::STRETCH, screen->bound());
+
+        Bench::keep(screen->pixels());
+        state.processed(wallpaper->width() * wallpaper->height() * sizeof(Graphic::Color));
+    }
+}
+
+BENCH(painter_scale_icon_up)
+{
+    auto data = Bench::load("sysroot/Files/Icons/folder.svg");
+    IO::MemoryReader reader{data};
+
+    // Icons are rendered at their size and shown with nearest filtering,
+    // smooth it to go through the transparent pixels path.
+    auto icon = Graphic::Svg::render(reader, 18).unwrap();
+    icon->filtering(Graphic::BitmapFiltering::LINEAR);
+    auto bitmap = Graphic::Bitmap::create_shared(256, 256).unwrap();
+    Graphic::Painter painter{bitmap};
+
+    while (state.running())
+    {
+        painter.blit(*icon, icon->bound(), bitmap->bound());
+
+        Bench::keep(bitmap->pixels());
+        state.processed(bitmap->width() * bitmap->height() * sizeof(Graphic::Color));
+    }
+}
+
+// Font::get() looks in /Files, read the font from the source tree instead.
+static RefPtr<Graphic::Font> sans()
+{
+    auto data = Bench::load("sysroot/Files/Fonts/sans.png");
+    IO::MemoryReader reader{data};
+    Graphic::PngReader png{reader};
+
+    auto glyph_data = Bench::load("sysroot/Files/Fonts/sans.glyph");
+    Vector<Graphic::Glyph> glyphs;
+
+    for (size_t i = 0; i < glyph_data.size() / sizeof(Graphic::Glyph); i++)
+    {
+        Graphic::Glyph glyph;
+        memcpy(&glyph, reinterpret_cast<const uint8_t *>(glyph_data.start()) + i * sizeof(Graphic::Glyph), sizeof(Graphic::Glyph));
+        glyphs.push_back(glyph);
+    }
+
+    return make<Graphic::Font>(png.bitmap(), glyphs);
+}
+
+// The text of a 10k rows table, more rows than the mesure cache holds.
+static constexpr size_t TEXT_ROWS = 10000;
+
+static Vector<String> text_rows()
+{
+    Vector<String> rows;
+
+    for (size_t i = 0; i < TEXT_ROWS; i++)
+    {
+        rows.push_back(IO::format("/Applications/task-manager/{} {}KiB running", i, i * 37 % 4096));
+    }
+
+    return rows;
+}
+
+BENCH(font_mesure_10k_rows)
+{
+    auto font = sans();
+    auto rows = text_rows();
+
+    while (state.running())
+    {
+        int width = 0;
+
+        for (size_t i = 0; i < rows.count(); i++)
+        {
+            width = MAX(width, font->mesure(rows[i].cstring()).width());
+            state.processed(rows[i].length());
+        }
+
+        Bench::keep(width);
+    }
+}
+
+BENCH(font_layout_and_draw_10k_rows)
+{
+    auto font = sans();
+    auto rows = text_rows();
+    auto bitmap = Graphic::Bitmap::create_shared(800, 600).unwrap();
+    Graphic::Painter painter{bitmap};
+
+    while (state.running())
+    {
+        for (size_t i = 0; i < rows.count(); i++)
+        {
+            int row_height = font->metrics().fulllineheight();
+            Math::Recti row{0, (int)(i % (600 / row_height)) * row_height, 800, row_height};
+
+            painter.draw_string_within(*font, rows[i].cstring(), row, Anchor::LEFT, Graphic::Colors::WHITE);
+            state.processed(rows[i].length());
+        }
+
+        Bench::keep(bitmap->pixels());
+    }
+}
@@ -0,0 +1,73 @@
+#include <libjson/Json.h>
+#include <libutils/StringBuilder.h>
+
+#include "hosted/bench/Driver.h"
+
+BENCH(json_parse_font)
+{
+    auto data = Bench::load("sysroot/Files/Fonts/sans.json");
+
+    while (state.running())
+    {
+        auto value = Json::parse((const char *)data.start(), data.size());
+
+        Bench::keep(value.length());
+        state.processed(data.size());
+    }
+}
+
+BENCH(json_parse_keyboard)
+{
+    auto data = Bench::load("sysroot/Files/Keyboards/en_us.json");
+
+    while (state.running())
+    {
+        auto value = Json::parse((const char *)data.start(), data.size());
+
+        Bench::keep(value.length());
+        state.processed(data.size());
+    }
+}
+
+// Many small objects sharing the same keys, the worst case for allocations.
+static String records()
+{
+    StringBuilder builder;
+    builder.append('[');
+
+    for (int i = 0; i < 1000; i++)
+    {
+        builder.append(i ? "," : "");
+        builder.append("{\"name\": \"item\", \"enabled\": true, \"size\": 42, \"tags\": [\"a\", \"b\"]}");
+    }
+
+    builder.append(']');
+
+    return builder.finalize();
+}
+
+BENCH(json_parse_records)
+{
+    auto data = records();
+
+    while (state.running())
+    {
+        auto value = Json::parse(data.cstring(), data.length());
+
+        Bench::keep(value.length());
+        state.processed(data.length());
+    }
+}
+
+BENCH(json_parse_records_interned_keys)
+{
+    auto data = records();
+
+    while (state.running())
+    {
+        auto value = Json::parse(data.cstring(), data.length(), Json::INTERN_KEYS);
+
+        Bench::keep(value.length());
+        state.processed(data.length());
+    }
+}
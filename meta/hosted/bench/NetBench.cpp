@@ -0,0 +1,176 @@
+#include <string.h>
+
+#include <libnet/RingInterface.h>
+#include <libnet/Stack.h>
+
+#include "hosted/bench/Driver.h"
+
+// A stack on its own NetworkRings, what the network service runs on top of a
+// driver.
+struct Machine
+{
+    NetworkRings *rings;
+    Net::RingInterface interface;
+    Net::Stack stack;
+
+    static NetworkRings *allocate_rings()
+    {
+        auto *rings = reinterpret_cast<NetworkRings *>(new uint8_t[NetworkRings::SIZE]);
+        memset(rings, 0, sizeof(NetworkRings));
+        return rings;
+    }
+
+    Machine(uint8_t id, Ipv4Address address)
+        : rings{allocate_rings()},
+          interface{rings, {{0x52, 0x54, 0x00, 0x12, 0x34, id}}},
+          stack{interface, {address, Ipv4Address::from_octets(255, 255, 255, 0), Ipv4Address::from_octets(10, 0, 2, 2)}}
+    {
+    }
+
+    ~Machine()
+    {
+        delete[] reinterpret_cast<uint8_t *>(rings);
+    }
+
+    void receive()
+    {
+        interface.receive([this](const uint8_t *frame, size_t size) {
+            stack.receive(frame, size);
+        });
+    }
+};
+
+// Does what two NICs on the same wire would: frames sent by one end land in
+// the receive ring of the other, or are dropped when it's full.
+static void wire(Machine &from, Machine &to)
+{
+    NetworkRing &tx = from.rings->tx;
+    NetworkRing &rx = to.rings->rx;
+
+    for (; tx.tail != tx.head; tx.tail++)
+    {
+        if (rx.head - rx.tail < NETWORK_RING_SLOTS)
+        {
+            uint16_t length = tx.lengths[tx.tail % NETWORK_RING_SLOTS];
+            memcpy(to.rings->rx_frame(rx.head), from.rings->tx_frame(tx.tail), length);
+            rx.lengths[rx.head % NETWORK_RING_SLOTS] = length;
+            rx.head++;
+        }
+    }
+}
+
+static void exchange(Machine &left, Machine &right, uint64_t now)
+{
+    left.stack.poll(now);
+    right.stack.poll(now);
+
+    wire(left, right);
+    wire(right, left);
+
+    left.receive();
+    right.receive();
+}
+
+// Minimum size Ethernet frames, half a ring per batch.
+BENCH(net_udp_small_datagrams)
+{
+    static constexpr size_t BATCH = NETWORK_RING_SLOTS / 2;
+    static constexpr size_t PAYLOAD = 18;
+
+    Machine left{1, Ipv4Address::from_octets(10, 0, 2, 15)};
+    Machine right{2, Ipv4Address::from_octets(10, 0, 2, 2)};
+
+    auto sender = left.stack.udp_bind(4000).unwrap();
+    auto receiver = right.stack.udp_bind(5000).unwrap();
+    NetworkEndpoint destination{right.stack.config().address, 5000};
+
+    uint8_t payload[PAYLOAD] = {};
+    uint64_t now = 0;
+
+    // Resolves the address of the other end first.
+    left.stack.udp_send(*sender, destination, payload, PAYLOAD);
+
+    while (!receiver->readable())
+    {
+        exchange(left, right, ++now);
+    }
+
+    receiver->receive();
+
+    while (state.running())
+    {
+        for (size_t i = 0; i < BATCH; i++)
+        {
+            left.stack.udp_send(*sender, destination, payload, PAYLOAD);
+        }
+
+        wire(left, right);
+        right.receive();
+
+        while (receiver->readable())
+        {
+            Bench::keep(receiver->receive().data.count());
+        }
+
+        state.processed(BATCH * PAYLOAD);
+    }
+}
+
+BENCH(net_tcp_bulk_transfer)
+{
+    static constexpr size_t TRANSFER = 256 * 1024;
+
+    Machine left{1, Ipv4Address::from_octets(10, 0, 2, 15)};
+    Machine right{2, Ipv4Address::from_octets(10, 0, 2, 2)};
+
+    auto listener = right.stack.tcp_listen(80).unwrap();
+    auto client = left.stack.tcp_connect({right.stack.config().address, 80}).unwrap();
+
+    uint64_t now = 0;
+
+    while (!listener->readable())
+    {
+        exchange(left, right, ++now);
+    }
+
+    auto server = listener->accept();
+
+    static uint8_t buffer[16 * 1024] = {};
+
+    while (state.running())
+    {
+        size_t sent = 0;
+        size_t received = 0;
+
+        while (received < TRANSFER)
+        {
+            while (sent < TRANSFER)
+            {
+                size_t queued = client->send(buffer, MIN(sizeof(buffer), TRANSFER - sent));
+
+                if (queued == 0)
+                {
+                    break;
+                }
+
+                sent += queued;
+            }
+
+            exchange(left, right, ++now);
+
+            while (server->readable())
+            {
+                size_t read = server->receive(buffer, sizeof(buffer));
+
+                if (read == 0)
+                {
+                    break;
+                }
+
+                received += read;
+            }
+        }
+
+        state.processed(TRANSFER);
+    }
+}
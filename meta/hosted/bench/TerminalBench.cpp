@@ -0,0 +1,26 @@
+#include <libterminal/Terminal.h>
+#include <libutils/StringBuilder.h>
+
+#include "hosted/bench/Driver.h"
+
+// A build log with colors, what a terminal spends most of its time on.
+BENCH(terminal_write_log)
+{
+    StringBuilder builder;
+
+    for (int i = 0; i < 256; i++)
+    {
+        builder.append("\e[1;32m[CXX]\e[m userspace/libraries/libgraphic/Painter.cpp\n");
+    }
+
+    auto text = builder.finalize();
+
+    Terminal::Terminal terminal{80, 25};
+
+    while (state.running())
+    {
+        terminal.write(text.cstring(), text.length());
+
+        state.processed(text.length());
+    }
+}
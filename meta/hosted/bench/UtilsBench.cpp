@@ -0,0 +1,90 @@
+#include <libutils/HashMap.h>
+#include <libutils/Intern.h>
+#include <libutils/SmallVector.h>
+#include <libutils/StringBuilder.h>
+#include <libutils/Vector.h>
+
+#include "hosted/bench/Driver.h"
+
+BENCH(vector_push_back_10k)
+{
+    while (state.running())
+    {
+        Vector<int> vector;
+
+        for (int i = 0; i < 10000; i++)
+        {
+            vector.push_back(i);
+        }
+
+        Bench::keep(vector.raw_storage());
+    }
+}
+
+BENCH(small_vector_push_back_8)
+{
+    while (state.running())
+    {
+        SmallVector<int, 8> vector;
+
+        for (int i = 0; i < 8; i++)
+        {
+            vector.push_back(i);
+        }
+
+        Bench::keep(vector.raw_storage());
+    }
+}
+
+BENCH(hashmap_insert_lookup_1k)
+{
+    while (state.running())
+    {
+        HashMap<int, int> map;
+
+        for (int i = 0; i < 1000; i++)
+        {
+            map[i] = i;
+        }
+
+        int sum = 0;
+
+        for (int i = 0; i < 1000; i++)
+        {
+            sum += map[i];
+        }
+
+        Bench::keep(sum);
+    }
+}
+
+BENCH(string_builder_append_1k)
+{
+    while (state.running())
+    {
+        StringBuilder builder;
+
+        for (int i = 0; i < 1000; i++)
+        {
+            builder.append("hello, ");
+            builder.append('!');
+        }
+
+        auto string = builder.finalize();
+
+        Bench::keep(string.length());
+        state.processed(string.length());
+    }
+}
+
+BENCH(intern_known_identifier)
+{
+    intern("background", 10);
+
+    while (state.running())
+    {
+        auto string = intern("background", 10);
+
+        Bench::keep(string.cstring());
+    }
+}
@@ -0,0 +1,71 @@
+#include <libio/File.h>
+#include <libio/Write.h>
+#include <libwidget/model/TextModel.h>
+
+#include "hosted/bench/Driver.h"
+
+static constexpr size_t LARGE_TEXT_SIZE = 50 * 1024 * 1024;
+
+// Lines of source code, 50 MiB of them.
+static const char *large_text_file()
+{
+    static constexpr const char *PATH = "/tmp/skift-bench-50mb.txt";
+
+    static bool written = false;
+
+    if (!written)
+    {
+        static char line[] = "    painter.fill_rectangle({x, y, width, height}, color); // Some comment\n";
+
+        IO::File file{PATH, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+        for (size_t size = 0; size < LARGE_TEXT_SIZE; size += sizeof(line) - 1)
+        {
+            IO::write(file, line);
+        }
+
+        written = true;
+    }
+
+    return PATH;
+}
+
+// What the text editor does with a large file: open it, then type, break and
+// move lines all over it and undo everything.
+BENCH(text_model_open_and_edit_50mb)
+{
+    auto path = large_text_file();
+
+    while (state.running())
+    {
+        auto model = Widget::TextModel::open(path);
+        Widget::TextCursor cursor;
+
+        size_t step = model->line_count() / 100;
+
+        for (size_t i = 1; i < 100; i++)
+        {
+            cursor.move_to(*model, i * step, 4);
+
+            for (Codepoint codepoint : U"auto ")
+            {
+                if (codepoint)
+                {
+                    model->append_at(cursor, codepoint);
+                }
+            }
+
+            model->newline_at(cursor);
+            model->move_line_down_at(cursor);
+            model->backspace_at(cursor);
+        }
+
+        while (model->can_undo())
+        {
+            model->undo(cursor);
+        }
+
+        Bench::keep(model->line_count());
+        state.processed(LARGE_TEXT_SIZE);
+    }
+}
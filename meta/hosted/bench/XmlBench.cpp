@@ -0,0 +1,18 @@
+#include <libio/MemoryReader.h>
+#include <libxml/Parser.h>
+
+#include "hosted/bench/Driver.h"
+
+BENCH(xml_parse_logo)
+{
+    auto data = Bench::load("sysroot/Files/logo.svg");
+
+    while (state.running())
+    {
+        IO::MemoryReader reader{data};
+        auto document = Xml::parse(reader).unwrap();
+
+        Bench::keep(document.root().children().count());
+        state.processed(data.size());
+    }
+}
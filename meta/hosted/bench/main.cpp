@@ -0,0 +1,52 @@
+#include <libutils/ArgParse.h>
+
+#include "hosted/bench/Driver.h"
+
+constexpr auto PROLOGUE = "Runs the userspace benchmarks on the host.";
+
+constexpr auto OPTION_FILTER_DESCRIPTION = "Only run the benchmarks whose name contains this string.";
+constexpr auto OPTION_JSON_DESCRIPTION = "Write the results to this file.";
+constexpr auto OPTION_COMPARE_DESCRIPTION = "Compare with the results of a previous run.";
+constexpr auto OPTION_TIME_DESCRIPTION = "Minimum time of a run, in milliseconds (default: 500).";
+
+int main(int argc, char const *argv[])
+{
+    ArgParse args{};
+
+    args.should_abort_on_failure();
+
+    args.prologue(PROLOGUE);
+
+    args.usage("");
+    args.usage("OPTION...");
+
+    Bench::Options options{};
+
+    args.option_string('f', "filter", OPTION_FILTER_DESCRIPTION, [&](String &value) {
+        options.filter = value;
+        return ArgParseResult::SHOULD_CONTINUE;
+    });
+
+    args.option_string('j', "json", OPTION_JSON_DESCRIPTION, [&](String &value) {
+        options.json = value;
+        return ArgParseResult::SHOULD_CONTINUE;
+    });
+
+    args.option_string('c', "compare", OPTION_COMPARE_DESCRIPTION, [&](String &value) {
+        options.compare = value;
+        return ArgParseResult::SHOULD_CONTINUE;
+    });
+
+    args.option_int('t', "time", OPTION_TIME_DESCRIPTION, [&](int value) {
+        options.min_time = value * 1000000ull;
+        return ArgParseResult::SHOULD_CONTINUE;
+    });
+
+    auto parse_result = args.eval(argc, argv);
+    if (parse_result != ArgParseResult::SHOULD_CONTINUE)
+    {
+        return parse_result == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    return Bench::run_all_benchmarks(options);
+}
@@ -1,20 +1,107 @@
 #!/bin/bash
-g++ \
+# Builds the userspace libraries natively, with meta/hosted/plugs standing in
+# for the kernel, then links the hosted test, the benchmarks and the build
+# tools needing the libraries against them.
+# Run it from the root of the repository:
+#
+#   meta/hosted/build.sh
+#   build/hosted/bench --json before.json
+#   build/hosted/bench --compare before.json
+#
+# Only the products named on the command line are built when there are some,
+# the makefile uses it to get the atlas compiler:
+#
+#   BUILD_DIRECTORY=build/x86_64/hosted meta/hosted/build.sh atlas-compiler
+
+set -e
+
+BUILD_DIRECTORY=${BUILD_DIRECTORY:-build/hosted}
+PRODUCTS=${@:-test bench atlas-compiler}
+CXX=${CXX:-g++}
+
+CXXFLAGS="\
+    -O2 \
     -g \
     -std=c++20 \
-    -Ilibraries \
-    -Iapps \
-    -Ihosted/includes \
-    -I. \
+    -Iuserspace \
+    -Iuserspace/libraries \
+    -Iuserspace/apps \
+    -Imeta/hosted/includes \
+    -Imeta \
+    -idirafter userspace/libraries/libc \
     -D__CONFIG_IS_RELEASE__=0 \
     -D__CONFIG_IS_HOSTED__=1 \
     -DDISABLE_LOGGER \
-    hosted/test.cpp \
-    libraries/libgraphic/png/PngReader.cpp \
-    libraries/libcompression/Inflate.cpp \
-    libraries/libcompression/CRC.cpp \
-    libraries/libio/File.cpp \
-    libraries/libio/Format.cpp \
-    hosted/plugs/*.cpp \
-    # -fsanitize=address \
-    # -fsanitize=undefined \
+    $EXTRA_CXXFLAGS"
+    # EXTRA_CXXFLAGS="-fsanitize=address -fsanitize=undefined"
+
+# libutils and libjson are header only, the framebuffer needs a real device.
+# Only the parts of libwidget that don't need a window server are built.
+LIBRARIES_SOURCES="\
+    $(ls userspace/libraries/{libio,libcompression,libgraphic,libxml,libterminal,libnet}/*.cpp | grep -v Framebuffer.cpp) \
+    $(ls userspace/libraries/libgraphic/*/*.cpp) \
+    userspace/libraries/libwidget/Theme.cpp \
+    userspace/libraries/libwidget/model/TextModel.cpp \
+    userspace/libraries/libasync/Parallel.cpp \
+    userspace/libraries/libsystem/Result.cpp \
+    userspace/libraries/libsystem/thread/Thread.cpp \
+    userspace/libraries/libc/skift/NumberFormatter.cpp \
+    $(ls meta/hosted/plugs/*.cpp)"
+
+TEST_SOURCES="meta/hosted/test.cpp"
+
+BENCH_SOURCES="$(ls meta/hosted/bench/*.cpp)"
+
+ATLAS_COMPILER_SOURCES="meta/utils/atlas-compiler.cpp"
+
+object_of()
+{
+    echo "$BUILD_DIRECTORY/${1%.cpp}.o"
+}
+
+compile()
+{
+    local object=$(object_of $1)
+    local depends=${object%.o}.d
+
+    # Skip objects newer than their source and every header they include.
+    if [ -f $object ] && [ -f $depends ] &&
+        [ -z "$(find $(sed -e 's/^.*://' -e 's/\\$//' $depends) -newer $object 2>/dev/null)" ]; then
+        return
+    fi
+
+    mkdir -p $(dirname $object)
+    echo "[HOSTED] [CXX] $1"
+    $CXX $CXXFLAGS -MMD -c -o $object $1
+}
+
+export -f object_of compile
+export BUILD_DIRECTORY CXX CXXFLAGS
+
+sources_of()
+{
+    case $1 in
+    test) echo $TEST_SOURCES ;;
+    bench) echo $BENCH_SOURCES ;;
+    atlas-compiler) echo $ATLAS_COMPILER_SOURCES ;;
+    *)
+        echo "Unknown product: $1" >&2
+        exit 1
+        ;;
+    esac
+}
+
+for product in $PRODUCTS; do
+    sources_of $product > /dev/null
+done
+
+PRODUCTS_SOURCES=$(for product in $PRODUCTS; do sources_of $product; done)
+
+echo $LIBRARIES_SOURCES $PRODUCTS_SOURCES | tr ' ' '\n' | xargs -P "$(nproc)" -I{} bash -c 'compile {}'
+
+LIBRARIES_OBJECTS=$(for source in $LIBRARIES_SOURCES; do object_of $source; done)
+
+for product in $PRODUCTS; do
+    echo "[HOSTED] [LD] $product"
+    $CXX $CXXFLAGS -o $BUILD_DIRECTORY/$product $(for source in $(sources_of $product); do object_of $source; done) $LIBRARIES_OBJECTS -lpthread
+done
@@ -0,0 +1,7 @@
+#pragma once
+
+#include_next <math.h>
+
+#ifndef PI
+#    define PI (3.14159265358979323846264338327f)
+#endif
@@ -5,3 +5,5 @@
 size_t strlcpy(char *dst, const char *src, size_t maxlen);
 
 void strrvs(char *str);
+
+void strnapd(char *str, char c, size_t n);
@@ -0,0 +1,76 @@
+#include <libsystem/system/Memory.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Shared memory doesn't cross process boundaries on the host, bitmaps and
+// stacks are plain heap allocations.
+Result memory_alloc(size_t size, uintptr_t *out_address)
+{
+    void *address = calloc(1, size);
+
+    if (!address)
+    {
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    *out_address = reinterpret_cast<uintptr_t>(address);
+
+    return SUCCESS;
+}
+
+Result memory_free(uintptr_t address)
+{
+    free(reinterpret_cast<void *>(address));
+
+    return SUCCESS;
+}
+
+Result memory_include(int handle, uintptr_t *out_address, size_t *out_size)
+{
+    UNUSED(handle);
+    UNUSED(out_address);
+    UNUSED(out_size);
+
+    return ERR_NOT_IMPLEMENTED;
+}
+
+Result memory_get_handle(uintptr_t address, int *out_handle)
+{
+    UNUSED(address);
+
+    *out_handle = -1;
+
+    return ERR_NOT_IMPLEMENTED;
+}
+
+// Nothing to share the file with, it is read on the heap like any allocation.
+Result memory_map_file(const char *path, uintptr_t *out_address, size_t *out_size)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (!file)
+    {
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void *address = malloc(size);
+
+    if (!address || fread(address, 1, size, file) != size)
+    {
+        free(address);
+        fclose(file);
+        return ERR_NOT_READABLE;
+    }
+
+    fclose(file);
+
+    *out_address = reinterpret_cast<uintptr_t>(address);
+    *out_size = size;
+
+    return SUCCESS;
+}
@@ -1,5 +1,23 @@
 #include <libsystem/process/Process.h>
 
+#include <stdlib.h>
+#include <unistd.h>
+
+int process_this()
+{
+    return getpid();
+}
+
+const char *process_name()
+{
+    return "hosted";
+}
+
+void process_exit(int code)
+{
+    exit(code);
+}
+
 String process_resolve(String path)
 {
     return path;
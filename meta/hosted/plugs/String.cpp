@@ -27,3 +27,16 @@ void strrvs(char *str)
         str[j] = c;
     }
 }
+
+void strnapd(char *str, char c, size_t n)
+{
+    for (size_t i = 0; i < (n - 1); i++)
+    {
+        if (str[i] == '\0')
+        {
+            str[i] = c;
+            str[i + 1] = '\0';
+            return;
+        }
+    }
+}
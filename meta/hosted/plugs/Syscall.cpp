@@ -3,9 +3,12 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <linux/futex.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 int open_flags_to_posix(OpenFlag flags)
@@ -16,6 +19,10 @@ int open_flags_to_posix(OpenFlag flags)
     {
         result |= O_RDWR;
     }
+    else if (flags & OPEN_WRITE)
+    {
+        result |= O_WRONLY;
+    }
     else
     {
         result |= O_RDONLY;
@@ -114,64 +121,179 @@ FileState stat_to_skift(struct stat sb)
     return result;
 }
 
-Result errno_to_skift_result()
+Result errno_to_skift_result(long value)
 {
-    Result result = SUCCESS;
+    // errno is only meaningful right after a call that failed, an old value
+    // left by something else must not turn a success into an error.
+    if (value >= 0)
+    {
+        return SUCCESS;
+    }
 
-    if (errno != 0 && result == SUCCESS)
+    switch (errno)
     {
+    case ENOENT:
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+
+    case EEXIST:
+        return ERR_FILE_EXISTS;
+
+    case EISDIR:
+        return ERR_IS_A_DIRECTORY;
+
+    case ENOTDIR:
+        return ERR_NOT_A_DIRECTORY;
+
+    case EACCES:
+    case EPERM:
+        return ERR_ACCESS_DENIED;
+
+    case EBADF:
+        return ERR_BAD_HANDLE;
+
+    case EINVAL:
+        return ERR_INVALID_ARGUMENT;
+
+    case ENOMEM:
+        return ERR_OUT_OF_MEMORY;
+
+    case EMFILE:
+        return ERR_TOO_MANY_HANDLE;
+
+    case EINTR:
+        return INTERRUPTED;
+
+    case ETIMEDOUT:
+        return TIMEOUT;
+
+    default:
         // Catch all
         return ERR_UNKNOWN;
     }
-
-    errno = 0;
-
-    return result;
 }
 
 Result hj_handle_open(int *handle, const char *raw_path, size_t size, OpenFlag flags)
 {
     char buffer[256];
     strlcpy(buffer, raw_path, MIN(256, size + 1));
-    open(buffer, open_flags_to_posix(flags));
+    *handle = open(buffer, open_flags_to_posix(flags), 0644);
 
-    return errno_to_skift_result();
+    return errno_to_skift_result(*handle);
 }
 
 Result hj_handle_close(int handle)
 {
-    close(handle);
-
-    return errno_to_skift_result();
+    return errno_to_skift_result(close(handle));
 }
 
 Result hj_handle_read(int handle, void *buffer, size_t size, size_t *amount_read)
 {
-    *amount_read = read(handle, buffer, size);
+    ssize_t result = read(handle, buffer, size);
+    *amount_read = MAX(result, 0);
 
-    return errno_to_skift_result();
+    return errno_to_skift_result(result);
 }
 
 Result hj_handle_write(int handle, const void *buffer, size_t size, size_t *amount_written)
 {
-    *amount_written = write(handle, buffer, size);
+    ssize_t result = write(handle, buffer, size);
+    *amount_written = MAX(result, 0);
 
-    return errno_to_skift_result();
+    return errno_to_skift_result(result);
 }
 
 Result hj_handle_seek(int handle, ssize64_t *offset, HjWhence whence, ssize64_t *result)
 {
     *result = lseek(handle, *offset, whence_to_posix(whence));
 
-    return errno_to_skift_result();
+    return errno_to_skift_result(*result);
 }
 
 Result hj_handle_stat(int handle, FileState *state)
 {
     struct stat sb;
-    fstat(handle, &sb);
+    int result = fstat(handle, &sb);
+
+    if (result == 0)
+    {
+        *state = stat_to_skift(sb);
+    }
 
-    *state = stat_to_skift(sb);
+    return errno_to_skift_result(result);
+}
+
+Result hj_handle_call(int handle, IOCall request, void *args)
+{
+    UNUSED(handle);
+    UNUSED(request);
+    UNUSED(args);
 
-    return errno_to_skift_result();
+    // There are no devices on the host.
+    return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+}
+
+/* --- Processes and threads ------------------------------------------------ */
+
+Result hj_process_this(int *pid)
+{
+    *pid = getpid();
+
+    return SUCCESS;
+}
+
+Result hj_process_wait(int tid, int *user_exit_value)
+{
+    UNUSED(tid);
+    UNUSED(user_exit_value);
+
+    return ERR_NO_SUCH_TASK;
+}
+
+// Thread::current() finds its block through fs/gs, which glibc already uses
+// for its own TLS, so there are no threads on the host. Thread::spawn()
+// fails and the parallel runtime runs every job on the calling thread.
+Result hj_thread_create(uintptr_t ip, uintptr_t sp, uintptr_t tls, int *tid)
+{
+    UNUSED(ip);
+    UNUSED(sp);
+    UNUSED(tls);
+    UNUSED(tid);
+
+    return ERR_NOT_IMPLEMENTED;
+}
+
+Result hj_thread_exit(int exit_code)
+{
+    UNUSED(exit_code);
+
+    return ERR_NOT_IMPLEMENTED;
+}
+
+Result hj_thread_tls(uintptr_t tls)
+{
+    UNUSED(tls);
+
+    return ERR_NOT_IMPLEMENTED;
+}
+
+Result hj_futex_wait(int *address, int expected, Timeout timeout)
+{
+    struct timespec duration = {
+        .tv_sec = (time_t)(timeout / 1000),
+        .tv_nsec = (long)(timeout % 1000) * 1000000,
+    };
+
+    long result = syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeout == (Timeout)-1 ? nullptr : &duration, nullptr, 0);
+
+    if (result < 0 && errno == EAGAIN)
+    {
+        return SUCCESS;
+    }
+
+    return errno_to_skift_result(result);
+}
+
+Result hj_futex_wake(int *address, int count)
+{
+    return errno_to_skift_result(syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0));
 }
@@ -0,0 +1,93 @@
+// Rasterizes icons and fonts into the atlas loaded by Graphic::Atlas, with the
+// same code the system would otherwise run in every process. It is built
+// against the hosted libraries by meta/hosted/build.sh:
+//
+//   build/hosted/atlas-compiler <output> <icons.svg...> <fonts.glyph...>
+//
+// Each font is made of a .glyph file and the .png next to it.
+
+#include <libgraphic/Atlas.h>
+#include <libio/File.h>
+#include <libio/Format.h>
+#include <libio/Path.h>
+#include <libio/Read.h>
+#include <libio/Streams.h>
+
+#define ICON_SIZES_ENTRY(__size) __size,
+static const int ICON_SIZES[] = {ICON_SIZE_LIST(ICON_SIZES_ENTRY)};
+
+static Result add_icon(Graphic::AtlasBuilder &builder, IO::Path &path)
+{
+    RefPtr<Graphic::Bitmap> bitmaps[Graphic::__ICON_SIZE_COUNT] = {};
+
+    for (size_t i = 0; i < Graphic::__ICON_SIZE_COUNT; i++)
+    {
+        auto bitmap_or_result = Graphic::Bitmap::load_from(path.string(), ICON_SIZES[i]);
+
+        if (bitmap_or_result.success())
+        {
+            bitmaps[i] = bitmap_or_result.unwrap();
+        }
+    }
+
+    return builder.add_icon(path.basename_without_extension(), bitmaps);
+}
+
+static Result add_font(Graphic::AtlasBuilder &builder, IO::Path &path)
+{
+    IO::File glyph_file{path, OPEN_READ};
+
+    if (!glyph_file.exist())
+    {
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+    }
+
+    Vector<Graphic::Glyph> glyphs;
+    TRY(IO::read_vector(glyph_file, glyphs));
+
+    auto name = path.basename_without_extension();
+    auto bitmap = TRY(Graphic::Bitmap::load_from(IO::Path::join(path.dirname(), IO::format("{}.png", name)).string()));
+
+    return builder.add_font(name, bitmap, move(glyphs));
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        IO::errln("usage: atlas-compiler <output> <icons.svg...> <fonts.glyph...>");
+        return PROCESS_FAILURE;
+    }
+
+    Graphic::AtlasBuilder builder;
+
+    for (int i = 2; i < argc; i++)
+    {
+        auto path = IO::Path::parse(argv[i]);
+        auto result = path.extension() == ".glyph" ? add_font(builder, path) : add_icon(builder, path);
+
+        if (result != SUCCESS)
+        {
+            IO::errln("atlas-compiler: {}: {}", argv[i], get_result_description(result));
+            return PROCESS_FAILURE;
+        }
+    }
+
+    IO::File output{argv[1], OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    if (!output.exist())
+    {
+        IO::errln("atlas-compiler: Failed to open {}", argv[1]);
+        return PROCESS_FAILURE;
+    }
+
+    auto result = builder.write(output);
+
+    if (result != SUCCESS)
+    {
+        IO::errln("atlas-compiler: Failed to write {}: {}", argv[1], get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
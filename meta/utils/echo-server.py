@@ -0,0 +1,38 @@
+#!/bin/env python3
+
+# A TCP echo server for the netbench utility. From a guest on QEMU's user
+# mode networking the host is 10.0.2.2, so:
+#
+#   host  $ ./meta/utils/echo-server.py 7777
+#   guest $ netbench 10.0.2.2 7777
+
+import socketserver
+import sys
+
+
+class EchoHandler(socketserver.BaseRequestHandler):
+    def handle(self):
+        total = 0
+
+        while True:
+            data = self.request.recv(65536)
+
+            if not data:
+                break
+
+            self.request.sendall(data)
+            total += len(data)
+
+        print(f"{self.client_address[0]}:{self.client_address[1]} echoed {total} bytes", file=sys.stderr)
+
+
+class EchoServer(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+port = int(sys.argv[1]) if len(sys.argv) > 1 else 7777
+
+with EchoServer(("0.0.0.0", port), EchoHandler) as server:
+    print(f"Echoing on port {port}...", file=sys.stderr)
+    server.serve_forever()
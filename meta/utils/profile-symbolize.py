@@ -0,0 +1,151 @@
+#!/bin/env python3
+
+# Turns the samples collected by `test-driver.py --profile` into collapsed
+# stacks, one line per distinct stack followed by how many times it was seen,
+# which is what flamegraph.pl and speedscope take as input:
+#
+#   make CONFIG=test CONFIG_PROFILE=true
+#   meta/utils/test-driver.py build/disks/skift-x86_32-grub-test.img --profile samples.txt
+#   meta/utils/profile-symbolize.py samples.txt > stacks.txt
+#   flamegraph.pl stacks.txt > flamegraph.svg
+
+import os
+import re
+import sys
+import argparse
+import subprocess
+
+SAMPLE = re.compile(r"^profile: (\d+) (\S+) (\d+) (\d+)((?: [0-9a-fA-F]+)*)$")
+
+
+def panic(msg):
+    print(msg, file=sys.stderr)
+    sys.exit(-1)
+
+
+def log(msg):
+    print(msg, file=sys.stderr)
+
+
+def parse_samples(path):
+    samples = []
+
+    with open(path, "r") as file:
+        for line in file:
+            match = SAMPLE.match(line.strip())
+
+            if not match:
+                continue
+
+            name = match.group(2)
+            kernel_count = int(match.group(3))
+            frames = [int(frame, 16) for frame in match.group(5).split()]
+
+            samples.append((name, frames[:kernel_count], frames[kernel_count:]))
+
+    return samples
+
+
+def find_executable(sysroot, name, cache):
+    if name in cache:
+        return cache[name]
+
+    found = None
+    basename = os.path.basename(name)
+
+    for root, _, files in os.walk(sysroot):
+        if basename in files:
+            found = os.path.join(root, basename)
+            break
+
+    cache[name] = found
+
+    return found
+
+
+class Symbolizer:
+    def __init__(self, addr2line):
+        self.addr2line = addr2line
+        self.symbols = {}
+
+    def resolve(self, elf, addresses):
+        known = self.symbols.setdefault(elf, {})
+        missing = sorted(set(addresses) - set(known.keys()))
+
+        if not missing:
+            return
+
+        output = subprocess.run(
+            [self.addr2line, "-f", "-C", "-e", elf] + [hex(address) for address in missing],
+            stdout=subprocess.PIPE,
+            check=True).stdout.decode(errors='replace').splitlines()
+
+        # Two lines per address, the function then its file and line.
+        for address, function in zip(missing, output[0::2]):
+            known[address] = function if function != "??" else hex(address)
+
+    def lookup(self, elf, address):
+        if not elf:
+            return hex(address)
+
+        return self.symbols[elf][address]
+
+
+def callers(frames):
+    # Past the innermost frame addresses are return addresses, stepping back
+    # by one lands inside the call instruction and so on the right line.
+    return [frames[0]] + [frame - 1 for frame in frames[1:]] if frames else []
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("samples")
+    parser.add_argument("--kernel", default="build/skift-x86_32-test/kernel.bin")
+    parser.add_argument("--sysroot", default="build/skift-x86_32-test/sysroot")
+    parser.add_argument("--addr2line", default="addr2line")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.kernel):
+        panic(f"Kernel {args.kernel} not found, use --kernel")
+
+    samples = parse_samples(args.samples)
+
+    if not samples:
+        panic(f"No samples in {args.samples}")
+
+    executables = {}
+    symbolizer = Symbolizer(args.addr2line)
+    addresses = {}
+
+    for name, kernel, user in samples:
+        addresses.setdefault(args.kernel, set()).update(callers(kernel))
+
+        executable = find_executable(args.sysroot, name, executables)
+
+        if executable:
+            addresses.setdefault(executable, set()).update(callers(user))
+
+    for elf, elf_addresses in addresses.items():
+        symbolizer.resolve(elf, elf_addresses)
+
+    for name, executable in executables.items():
+        if not executable:
+            log(f"No executable found for {name}, its frames are left as addresses")
+
+    stacks = {}
+
+    for name, kernel, user in samples:
+        executable = executables.get(name)
+
+        stack = [name]
+        stack += [symbolizer.lookup(executable, frame) for frame in reversed(callers(user))]
+        stack += [symbolizer.lookup(args.kernel, frame) + "_[k]" for frame in reversed(callers(kernel))]
+
+        line = ";".join(frame.replace(";", ":") for frame in stack)
+        stacks[line] = stacks.get(line, 0) + 1
+
+    for line, count in sorted(stacks.items()):
+        print(f"{line} {count}")
+
+
+main()
@@ -1,12 +1,20 @@
 #!/bin/env python3
 
 import sys
+import argparse
 import subprocess
 
-disk_image = sys.argv[1]
+parser = argparse.ArgumentParser()
+parser.add_argument("disk_image")
+parser.add_argument(
+    "--profile",
+    metavar="SAMPLES",
+    help="collect the samples of a CONFIG_PROFILE=true build into this file")
+args = parser.parse_args()
+
 qemu_command = [
     "qemu-system-x86_64",
-    "-hda", disk_image,
+    "-hda", args.disk_image,
     "-serial", "mon:stdio",
     "-nographic",
     "-rtc", "base=localtime",
@@ -21,19 +29,37 @@ qemu_proc = subprocess.Popen(
 qemu_stdin = qemu_proc.stdin
 qemu_stdout = qemu_proc.stdout
 
+samples = open(args.profile, "w") if args.profile else None
+result = None
+
+
+def finish(code):
+    qemu_proc.kill()
+
+    if samples:
+        samples.close()
+
+    sys.exit(code)
+
+
 while True:
     if qemu_proc.poll() != None:
-        sys.exit(-1)
+        finish(-1 if result == None else result)
 
     message = qemu_stdout.readline().decode(errors='replace').strip()
 
     if message == 'test: PASSED':
-        qemu_proc.kill()
-        sys.exit(0)
+        result = 0
 
     elif message == 'test: FAILED':
-        qemu_proc.kill()
-        sys.exit(-1)
+        result = -1
+
+    elif samples and message.startswith('profile: '):
+        samples.write(message + "\n")
 
     elif message != '':
         print(message)
+
+    # The profiler flushes what is left of its samples once the tests are over.
+    if result != None and (not samples or 'profile: done' in message):
+        finish(result)
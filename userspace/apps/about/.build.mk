@@ -1,4 +1,4 @@
 APPS += ABOUT
 
 ABOUT_NAME = about
-ABOUT_LIBS = widget settings async graphic xml system io compression
+ABOUT_LIBS = widget settings graphic async xml system io compression
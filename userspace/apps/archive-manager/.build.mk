@@ -1,5 +1,5 @@
 APPS += ARCHIVE_MANAGER
 
 ARCHIVE_MANAGER_NAME = archive-manager
-ARCHIVE_MANAGER_LIBS = file filepicker widget settings async graphic xml system io compression
+ARCHIVE_MANAGER_LIBS = file filepicker widget settings graphic async xml system io compression
 
@@ -1,5 +1,5 @@
 APPS += CALCULATOR
 
 CALCULATOR_NAME = calculator
-CALCULATOR_LIBS = widget settings async graphic xml system io compression
+CALCULATOR_LIBS = widget settings graphic async xml system io compression
 
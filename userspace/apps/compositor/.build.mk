@@ -1,4 +1,4 @@
 APPS += COMPOSITOR
 
 COMPOSITOR_NAME = compositor
-COMPOSITOR_LIBS = settings async graphic xml system io compression
+COMPOSITOR_LIBS = settings graphic async xml system io compression
@@ -1,5 +1,11 @@
+#include <libasync/Parallel.h>
+#include <libasync/ThreadPool.h>
 #include <libgraphic/Framebuffer.h>
+#include <libio/Streams.h>
+#include <libsystem/io/Filesystem.h>
 #include <libutils/Vector.h>
+#include <skift/Time.h>
+#include <string.h>
 
 #include "compositor/Cursor.h"
 #include "compositor/Manager.h"
@@ -78,15 +84,14 @@ void renderer_region_dirty(Math::Recti new_region)
     }
 }
 
-void renderer_composite_wallpaper(Math::Recti region)
+void renderer_composite_wallpaper(Graphic::Painter &painter, Math::Recti region)
 {
-    _framebuffer->painter().blit(_wallpaper->scaled(), region, region);
-    _framebuffer->mark_dirty(region);
+    painter.blit(_wallpaper->scaled(), region, region);
 }
 
-void renderer_composite_region(Math::Recti region, Window *window_transparent)
+void renderer_composite_region(Graphic::Painter &painter, Math::Recti region, Window *window_transparent)
 {
-    renderer_composite_wallpaper(region);
+    renderer_composite_wallpaper(painter, region);
 
     manager_iterate_back_to_front([&](Window *window) {
         if (window == window_transparent)
@@ -104,19 +109,17 @@ void renderer_composite_region(Math::Recti region, Window *window_transparent)
 
             if (window->flags() & WINDOW_ACRYLIC)
             {
-                _framebuffer->painter().blit(_wallpaper->acrylic(), destination, destination);
+                painter.blit(_wallpaper->acrylic(), destination, destination);
             }
 
-            _framebuffer->painter().blit(window->frontbuffer(), source, destination);
+            painter.blit(window->frontbuffer(), source, destination);
         }
 
         return Iteration::CONTINUE;
     });
-
-    _framebuffer->mark_dirty(region);
 }
 
-void renderer_region(Math::Recti region)
+void renderer_region(Graphic::Painter &painter, Math::Recti region)
 {
     bool should_paint_wallpaper = true;
 
@@ -138,54 +141,52 @@ void renderer_region(Math::Recti region)
 
             if (window->flags() & WINDOW_TRANSPARENT)
             {
-                renderer_composite_region(destination, window);
-                _framebuffer->painter().blit(window->frontbuffer(), source, destination);
+                renderer_composite_region(painter, destination, window);
+                painter.blit(window->frontbuffer(), source, destination);
             }
             else if (window->flags() & WINDOW_ACRYLIC)
             {
                 if (window->flags() & WINDOW_NO_ROUNDED_CORNERS)
                 {
-                    _framebuffer->painter().blit(_wallpaper->acrylic(), region, region);
-                    _framebuffer->painter().blit(window->frontbuffer(), source, destination);
+                    painter.blit(_wallpaper->acrylic(), region, region);
+                    painter.blit(window->frontbuffer(), source, destination);
                 }
                 else
                 {
-                    _framebuffer->painter().push();
-                    _framebuffer->painter().clip(destination);
+                    painter.push();
+                    painter.clip(destination);
 
-                    renderer_composite_region(window->bound().take_top_left(radius).clipped_with(region), window);
-                    renderer_composite_region(window->bound().take_top_right(radius).clipped_with(region), window);
-                    renderer_composite_region(window->bound().take_bottom_left(radius).clipped_with(region), window);
-                    renderer_composite_region(window->bound().take_bottom_right(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_top_left(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_top_right(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_bottom_left(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_bottom_right(radius).clipped_with(region), window);
 
-                    _framebuffer->painter().blit_rounded(_wallpaper->acrylic(), window->bound(), window->bound(), radius);
-                    _framebuffer->painter().blit_rounded(window->frontbuffer(), window->bound().size(), window->bound(), radius);
-                    _framebuffer->painter().pop();
+                    painter.blit_rounded(_wallpaper->acrylic(), window->bound(), window->bound(), radius);
+                    painter.blit_rounded(window->frontbuffer(), window->bound().size(), window->bound(), radius);
+                    painter.pop();
                 }
             }
             else
             {
                 if (window->flags() & WINDOW_NO_ROUNDED_CORNERS)
                 {
-                    _framebuffer->painter().blit(window->frontbuffer(), source, destination);
+                    painter.blit(window->frontbuffer(), source, destination);
                 }
                 else
                 {
-                    _framebuffer->painter().push();
-                    _framebuffer->painter().clip(destination);
+                    painter.push();
+                    painter.clip(destination);
 
-                    renderer_composite_region(window->bound().take_top_left(radius).clipped_with(region), window);
-                    renderer_composite_region(window->bound().take_top_right(radius).clipped_with(region), window);
-                    renderer_composite_region(window->bound().take_bottom_left(radius).clipped_with(region), window);
-                    renderer_composite_region(window->bound().take_bottom_right(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_top_left(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_top_right(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_bottom_left(radius).clipped_with(region), window);
+                    renderer_composite_region(painter, window->bound().take_bottom_right(radius).clipped_with(region), window);
 
-                    _framebuffer->painter().blit_rounded(window->frontbuffer(), window->bound().size(), window->bound(), radius);
-                    _framebuffer->painter().pop();
+                    painter.blit_rounded(window->frontbuffer(), window->bound().size(), window->bound(), radius);
+                    painter.pop();
                 }
             }
 
-            _framebuffer->mark_dirty(destination);
-
             Math::Recti top;
             Math::Recti botton;
             Math::Recti left;
@@ -193,10 +194,10 @@ void renderer_region(Math::Recti region)
 
             region.substract(destination, top, botton, left, right);
 
-            renderer_region(top);
-            renderer_region(botton);
-            renderer_region(left);
-            renderer_region(right);
+            renderer_region(painter, top);
+            renderer_region(painter, botton);
+            renderer_region(painter, left);
+            renderer_region(painter, right);
 
             should_paint_wallpaper = false;
 
@@ -208,7 +209,7 @@ void renderer_region(Math::Recti region)
 
     if (should_paint_wallpaper)
     {
-        renderer_composite_wallpaper(region);
+        renderer_composite_wallpaper(painter, region);
     }
 }
 
@@ -219,29 +220,47 @@ Math::Recti renderer_bound()
 
 void renderer_repaint_dirty()
 {
-    _dirty_regions.foreach ([](Math::Recti region) {
-        renderer_region(region);
-
-        if (_night_light_enable)
-        {
-            _framebuffer->painter().tint(region, Graphic::Color::from_rgb(1, 0.9, 0.8));
-        }
+    // Dirty regions never overlap, so each one can be composed on its own
+    // worker, with its own painter to keep the clip stacks apart.
+    Async::parallel_for(0, _dirty_regions.count(), 1, [&](size_t begin, size_t end) {
+        Graphic::Painter painter{_framebuffer->bitmap()};
 
-        if (region.colide_with(cursor_bound()))
+        for (size_t i = begin; i < end; i++)
         {
-            renderer_region(cursor_bound());
-
-            cursor_render(_framebuffer->painter());
+            renderer_region(painter, _dirty_regions[i]);
 
             if (_night_light_enable)
             {
-                _framebuffer->painter().tint(cursor_bound(), Graphic::Color::from_rgb(1, 0.9, 0.8));
+                painter.tint(_dirty_regions[i], Graphic::Color::from_rgb(1, 0.9, 0.8));
             }
         }
-
-        return Iteration::CONTINUE;
     });
 
+    bool cursor_dirty = false;
+
+    for (auto &region : _dirty_regions)
+    {
+        _framebuffer->mark_dirty(region);
+        cursor_dirty = cursor_dirty || region.colide_with(cursor_bound());
+    }
+
+    // The cursor spans several regions, it's drawn once they are all done.
+    if (cursor_dirty)
+    {
+        auto &painter = _framebuffer->painter();
+
+        renderer_region(painter, cursor_bound());
+
+        cursor_render(painter);
+
+        if (_night_light_enable)
+        {
+            painter.tint(cursor_bound(), Graphic::Color::from_rgb(1, 0.9, 0.8));
+        }
+
+        _framebuffer->mark_dirty(cursor_bound());
+    }
+
     _framebuffer->blit();
 
     _dirty_regions.clear();
@@ -266,3 +285,42 @@ void renderer_set_wallaper(RefPtr<Graphic::Bitmap>)
 {
     renderer_region_dirty(renderer_bound());
 }
+
+void renderer_screenshot()
+{
+    static Async::ThreadPool _screenshot_pool{1};
+
+    auto framebuffer = _framebuffer->bitmap();
+    auto screenshot_or_error = Graphic::Bitmap::create_shared(framebuffer->width(), framebuffer->height());
+
+    if (!screenshot_or_error.success())
+    {
+        IO::logln("Failed to allocate the screenshot: {}", screenshot_or_error.description());
+        return;
+    }
+
+    // Only the copy happens on the main loop, encoding a full screen takes
+    // far longer than a frame.
+    auto screenshot = screenshot_or_error.unwrap();
+    memcpy(screenshot->pixels(), framebuffer->pixels(), framebuffer->width() * framebuffer->height() * sizeof(Graphic::Color));
+
+    DateTime now = datetime_now();
+
+    auto path = IO::format(
+        "/User/Pictures/screenshot-{04d}-{02d}-{02d}-{02d}-{02d}-{02d}.png",
+        now.year, now.month, now.day, now.hour, now.minute, now.second);
+
+    _screenshot_pool.submit([screenshot, path]() {
+        if (!filesystem_exist("/User/Pictures", FILE_TYPE_DIRECTORY))
+        {
+            filesystem_mkdir("/User/Pictures");
+        }
+
+        auto result = screenshot->save_to(path);
+
+        if (result != SUCCESS)
+        {
+            IO::logln("Failed to save {}: {}", path, get_result_description(result));
+        }
+    });
+}
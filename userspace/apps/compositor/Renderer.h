@@ -14,3 +14,7 @@ void renderer_repaint_dirty();
 bool renderer_set_resolution(int width, int height);
 
 void renderer_set_wallaper(RefPtr<Graphic::Bitmap> wallaper);
+
+// Saves what's on screen under /User/Pictures, the encoding happens off the
+// main loop.
+void renderer_screenshot();
@@ -74,7 +74,15 @@ int main(int argc, char const *argv[])
         KeyboardPacket packet;
         size_t size = keyboard_stream.read(&packet, sizeof(KeyboardPacket)).unwrap();
 
-        if (size == sizeof(KeyboardPacket))
+        if (size == sizeof(KeyboardPacket) &&
+            packet.key == KEYBOARD_KEY_CTRLPRINTSCRN)
+        {
+            if (packet.motion == KEY_MOTION_DOWN)
+            {
+                renderer_screenshot();
+            }
+        }
+        else if (size == sizeof(KeyboardPacket))
         {
             Window *window = manager_focus_window();
 
@@ -1,4 +1,4 @@
 APPS += DEMO
 
 DEMO_NAME = demo
-DEMO_LIBS = widget settings async graphic xml system io compression
+DEMO_LIBS = widget settings graphic async xml system io compression
@@ -1,4 +1,4 @@
 APPS += DEVICE_MANAGER
 
 DEVICE_MANAGER_NAME = device-manager
-DEVICE_MANAGER_LIBS = widget settings async graphic xml system io compression
+DEVICE_MANAGER_LIBS = widget settings graphic async xml system io compression
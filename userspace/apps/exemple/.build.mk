@@ -1,4 +1,4 @@
 APPS += EXEMPLE
 
 EXEMPLE_NAME = exemple
-EXEMPLE_LIBS = widget settings async graphic xml system io compression
+EXEMPLE_LIBS = widget settings graphic async xml system io compression
@@ -1,4 +1,4 @@
 APPS += FILE_MANAGER
 
 FILE_MANAGER_NAME = file-manager
-FILE_MANAGER_LIBS = filepicker widget async settings graphic xml system io compression
+FILE_MANAGER_LIBS = filepicker widget settings graphic async xml system io compression
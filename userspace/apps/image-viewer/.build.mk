@@ -1,4 +1,4 @@
 APPS += IMAGE_VIEWER
 
 IMAGE_VIEWER_NAME = image-viewer
-IMAGE_VIEWER_LIBS = widget settings async graphic xml system io compression
+IMAGE_VIEWER_LIBS = widget settings graphic async xml system io compression
@@ -1,7 +1,7 @@
 APPS += LOGOUT
 
 LOGOUT_NAME = logout
-LOGOUT_LIBS = widget settings async graphic xml system io compression
+LOGOUT_LIBS = widget settings graphic async xml system io compression
 LOGOUT_ICONS = \
 	power-standby \
 	restart \
@@ -1,4 +1,4 @@
 APPS += MEDIA_PLAYER
 
 MEDIA_PLAYER_NAME = media-player
-MEDIA_PLAYER_LIBS = widget settings async graphic xml system io compression
+MEDIA_PLAYER_LIBS = widget settings graphic async xml system io compression
@@ -1,5 +1,5 @@
 APPS += NEKO
 
 NEKO_NAME = neko
-NEKO_LIBS = widget settings async graphic xml system io compression
+NEKO_LIBS = widget settings graphic async xml system io compression
 
@@ -0,0 +1,4 @@
+APPS += NETWORK_SERVICE
+
+NETWORK_SERVICE_NAME = network-service
+NETWORK_SERVICE_LIBS = net async system io
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <libipc/Peer.h>
+#include <libnet/Tcp.h>
+#include <libnet/Udp.h>
+#include <libutils/Optional.h>
+
+#include "network-service/Protocol.h"
+
+namespace Network
+{
+
+// A connection to the service becomes a TCP connection, a listener or a UDP
+// socket with its first request. Clients wait for the response of each
+// request before sending the next one, so responses are only written to
+// someone reading them and the service never blocks on a slow client.
+class Client : public IPC::Peer<Protocol>
+{
+public:
+    RefPtr<Net::TcpConnection> tcp;
+    RefPtr<Net::TcpListener> listener;
+    RefPtr<Net::UdpSocket> udp;
+
+    // The listener an accepting client is waiting on, owned by another client.
+    RefPtr<Net::TcpListener> accepting;
+
+    // The request waiting for its response, and what is left to queue of a
+    // send that didn't fit right away.
+    Optional<NetworkRequest> waiting;
+    Vector<uint8_t> payload{};
+    size_t sent = 0;
+
+    Callback<void(Client &, const Protocol::Message &message)> on_request;
+    Callback<void()> on_disconnect;
+
+    bool bound() { return tcp || listener || udp; }
+
+    Client(IO::Connection connection) : Peer{move(connection)}
+    {
+    }
+
+    void handle_message(const Protocol::Message &message) override
+    {
+        on_request(*this, message);
+    }
+
+    void handle_disconnect() override
+    {
+        if (tcp)
+        {
+            tcp->close();
+        }
+
+        if (listener)
+        {
+            listener->close();
+        }
+
+        if (udp)
+        {
+            udp->close();
+        }
+
+        on_disconnect();
+    }
+
+    void respond(Result result, NetworkEndpoint endpoint, uint32_t size = 0)
+    {
+        Protocol::Message message{};
+        message.response = {result, endpoint, size};
+
+        waiting = {};
+        send(message);
+    }
+
+    void respond(NetworkEndpoint endpoint, Vector<uint8_t> data)
+    {
+        Protocol::Message message{};
+        message.response = {SUCCESS, endpoint, (uint32_t)data.count()};
+        message.payload = move(data);
+
+        waiting = {};
+        send(message);
+    }
+};
+
+} // namespace Network
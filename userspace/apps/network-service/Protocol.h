@@ -0,0 +1,55 @@
+#pragma once
+
+#include <abi/Network.h>
+
+#include <libio/Connection.h>
+#include <libio/Read.h>
+#include <libio/Write.h>
+#include <libutils/Vector.h>
+
+namespace Network
+{
+
+struct Protocol
+{
+    // Requests come in and responses go out, both with their payload.
+    struct Message
+    {
+        NetworkRequest request;
+        NetworkResponse response;
+        Vector<uint8_t> payload;
+    };
+
+    static ResultOr<Message> decode_message(IO::Connection &connection)
+    {
+        Message message{};
+        TRY(IO::read_exactly(connection, &message.request, sizeof(NetworkRequest)));
+
+        if (message.request.type == NETWORK_SEND)
+        {
+            if (message.request.size > NETWORK_SERVICE_CHUNK)
+            {
+                return ERR_INVALID_ARGUMENT;
+            }
+
+            message.payload.resize(message.request.size);
+            TRY(IO::read_exactly(connection, message.payload.raw_storage(), message.request.size));
+        }
+
+        return message;
+    }
+
+    static Result encode_message(IO::Connection &connection, const Message &message)
+    {
+        TRY(IO::write(connection, message.response));
+
+        if (message.payload.count() > 0)
+        {
+            TRY(connection.write(message.payload.raw_storage(), message.payload.count()));
+        }
+
+        return SUCCESS;
+    }
+};
+
+} // namespace Network
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <libasync/Invoker.h>
+#include <libasync/Notifier.h>
+#include <libasync/Timer.h>
+#include <libio/File.h>
+#include <libio/Socket.h>
+#include <libmath/MinMax.h>
+#include <libnet/RingInterface.h>
+#include <libnet/Stack.h>
+#include <libsystem/system/System.h>
+
+#include "network-service/Client.h"
+
+namespace Network
+{
+
+class Server
+{
+private:
+    // The stack's timers are no finer than this.
+    static constexpr Timeout TICK = 50;
+
+    IO::File &_device;
+    Net::RingInterface &_interface;
+    Net::Stack &_stack;
+
+    IO::Socket _socket;
+    OwnPtr<Async::Notifier> _notifier;
+    OwnPtr<Async::Notifier> _device_notifier;
+    OwnPtr<Async::Timer> _timer;
+    OwnPtr<Async::Invoker> _invoker;
+
+    Vector<OwnPtr<Client>> _clients{};
+
+public:
+    Server(IO::File &device, Net::RingInterface &interface, Net::Stack &stack)
+        : _device{device}, _interface{interface}, _stack{stack}
+    {
+        _socket = IO::Socket{NETWORK_SERVICE_PATH, OPEN_CREATE};
+
+        _notifier = own<Async::Notifier>(_socket, POLL_ACCEPT, [this]() {
+            auto connection = _socket.accept();
+
+            if (!connection.success())
+            {
+                return;
+            }
+
+            auto client = own<Client>(connection.unwrap());
+
+            client->on_request = [this](auto &client, auto &message) {
+                handle_client_request(client, message);
+                update();
+            };
+
+            client->on_disconnect = [this]() {
+                handle_client_disconnected();
+            };
+
+            _clients.push_back(client);
+        });
+
+        _device_notifier = own<Async::Notifier>(_device, POLL_READ, [this]() {
+            update();
+        });
+
+        _timer = own<Async::Timer>(TICK, [this]() {
+            update();
+        });
+
+        _timer->start();
+
+        _invoker = own<Async::Invoker>([this]() {
+            _clients.remove_all_match([](auto &client) {
+                return !client->connected();
+            });
+        });
+    }
+
+    // Frames in, sockets, then frames out: whatever happened since the last
+    // update goes to the driver with a single sync of the rings.
+    void update()
+    {
+        _interface.receive([this](const uint8_t *frame, size_t size) {
+            _stack.receive(frame, size);
+        });
+
+        for (size_t i = 0; i < _clients.count(); i++)
+        {
+            if (_clients[i]->connected() && _clients[i]->waiting.present())
+            {
+                progress(*_clients[i]);
+            }
+        }
+
+        _stack.poll(system_get_ticks());
+
+        _device.handle()->call(IOCALL_NETWORK_SYNC, nullptr);
+    }
+
+    RefPtr<Net::TcpListener> find_listener(uint16_t port)
+    {
+        for (size_t i = 0; i < _clients.count(); i++)
+        {
+            auto &listener = _clients[i]->listener;
+
+            if (listener && !listener->closed() && listener->port() == port)
+            {
+                return listener;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void handle_client_request(Client &client, const Protocol::Message &message)
+    {
+        auto &request = message.request;
+
+        if (client.waiting.present())
+        {
+            IO::logln("Client sent a request while waiting for a response!");
+            client.close();
+            return;
+        }
+
+        if (request.type == NETWORK_TCP_CONNECT && !client.bound())
+        {
+            auto tcp = _stack.tcp_connect(request.endpoint);
+
+            if (!tcp.success())
+            {
+                client.respond(tcp.result(), request.endpoint);
+                return;
+            }
+
+            client.tcp = tcp.unwrap();
+            client.waiting = request;
+        }
+        else if (request.type == NETWORK_TCP_LISTEN && !client.bound())
+        {
+            auto listener = _stack.tcp_listen(request.endpoint.port);
+
+            if (!listener.success())
+            {
+                client.respond(listener.result(), request.endpoint);
+                return;
+            }
+
+            client.listener = listener.unwrap();
+            client.respond(SUCCESS, {_stack.config().address, request.endpoint.port});
+        }
+        else if (request.type == NETWORK_TCP_ACCEPT && !client.bound() && !client.accepting)
+        {
+            client.accepting = find_listener(request.endpoint.port);
+
+            if (!client.accepting)
+            {
+                client.respond(ERR_INVALID_ARGUMENT, request.endpoint);
+                return;
+            }
+
+            client.waiting = request;
+        }
+        else if (request.type == NETWORK_UDP_BIND && !client.bound())
+        {
+            auto udp = _stack.udp_bind(request.endpoint.port);
+
+            if (!udp.success())
+            {
+                client.respond(udp.result(), request.endpoint);
+                return;
+            }
+
+            client.udp = udp.unwrap();
+            client.respond(SUCCESS, {_stack.config().address, client.udp->port()});
+        }
+        else if (request.type == NETWORK_SEND && client.tcp)
+        {
+            // Most sends fit in the connection's buffer, only the rest is
+            // kept around until there is room for it.
+            size_t sent = client.tcp->send(message.payload.raw_storage(), message.payload.count());
+
+            if (sent == message.payload.count())
+            {
+                client.respond(SUCCESS, client.tcp->remote(), sent);
+                return;
+            }
+
+            client.payload.clear();
+            client.payload.push_back_many(message.payload.raw_storage() + sent, message.payload.count() - sent);
+            client.sent = 0;
+            client.waiting = request;
+        }
+        else if (request.type == NETWORK_SEND && client.udp)
+        {
+            auto result = _stack.udp_send(*client.udp, request.endpoint, message.payload.raw_storage(), message.payload.count());
+            client.respond(result, request.endpoint, message.payload.count());
+        }
+        else if (request.type == NETWORK_RECEIVE && (client.tcp || client.udp))
+        {
+            client.waiting = request;
+        }
+        else
+        {
+            client.respond(ERR_INVALID_ARGUMENT, request.endpoint);
+        }
+    }
+
+    // Answers the request of `client` if it can be by now.
+    void progress(Client &client)
+    {
+        auto request = client.waiting.unwrap();
+
+        if (request.type == NETWORK_TCP_CONNECT)
+        {
+            if (client.tcp->connecting())
+            {
+                return;
+            }
+
+            if (client.tcp->state() == Net::TcpState::CLOSED)
+            {
+                auto error = client.tcp->error();
+                client.respond(error != SUCCESS ? error : ERR_CONNECTION_REFUSED, request.endpoint);
+            }
+            else
+            {
+                client.respond(SUCCESS, client.tcp->local());
+            }
+        }
+        else if (request.type == NETWORK_TCP_ACCEPT)
+        {
+            if (client.accepting->readable())
+            {
+                client.tcp = client.accepting->accept();
+                client.accepting = nullptr;
+                client.respond(SUCCESS, client.tcp->remote());
+            }
+            else if (client.accepting->closed())
+            {
+                client.accepting = nullptr;
+                client.respond(ERR_STREAM_CLOSED, request.endpoint);
+            }
+        }
+        else if (request.type == NETWORK_SEND)
+        {
+            client.sent += client.tcp->send(client.payload.raw_storage() + client.sent, client.payload.count() - client.sent);
+
+            if (client.sent == client.payload.count())
+            {
+                client.payload.clear();
+                client.respond(SUCCESS, client.tcp->remote(), request.size);
+            }
+            else if (client.tcp->state() == Net::TcpState::CLOSED)
+            {
+                auto error = client.tcp->error();
+                client.payload.clear();
+                client.respond(error != SUCCESS ? error : ERR_STREAM_CLOSED, client.tcp->remote());
+            }
+        }
+        else if (request.type == NETWORK_RECEIVE && client.tcp)
+        {
+            if (!client.tcp->readable())
+            {
+                return;
+            }
+
+            Vector<uint8_t> data;
+            data.resize(request.size);
+            data.resize(client.tcp->receive(data.raw_storage(), data.count()));
+
+            if (data.count() == 0 && client.tcp->error() != SUCCESS)
+            {
+                client.respond(client.tcp->error(), client.tcp->remote());
+            }
+            else
+            {
+                client.respond(client.tcp->remote(), move(data));
+            }
+        }
+        else if (request.type == NETWORK_RECEIVE && client.udp)
+        {
+            if (!client.udp->readable())
+            {
+                return;
+            }
+
+            auto datagram = client.udp->receive();
+            datagram.data.resize(MIN(datagram.data.count(), request.size));
+            client.respond(datagram.endpoint, move(datagram.data));
+        }
+    }
+
+    void handle_client_disconnected()
+    {
+        _invoker->invoke_later();
+    }
+};
+
+} // namespace Network
@@ -0,0 +1,94 @@
+#include <libasync/Loop.h>
+#include <libio/Streams.h>
+#include <libjson/Json.h>
+#include <libsystem/system/Memory.h>
+
+#include "network-service/Server.h"
+
+#define NETWORK_CONFIG_PATH "/Configs/network.json"
+
+static Ipv4Address config_address(const Json::Value &config, String key, Ipv4Address fallback)
+{
+    if (!config.has(key))
+    {
+        return fallback;
+    }
+
+    auto address = Net::parse_ipv4(config.get(key).as_string().cstring());
+
+    if (!address.present())
+    {
+        IO::errln("Invalid {} in " NETWORK_CONFIG_PATH ", using the default.", key);
+        return fallback;
+    }
+
+    return address.unwrap();
+}
+
+// Defaults to what QEMU's user mode networking hands out.
+static Net::StackConfig load_config()
+{
+    Json::Value config{};
+
+    IO::File file{NETWORK_CONFIG_PATH, OPEN_READ};
+
+    if (file.exist())
+    {
+        config = Json::parse(file);
+    }
+
+    return {
+        config_address(config, "address", Ipv4Address::from_octets(10, 0, 2, 15)),
+        config_address(config, "netmask", Ipv4Address::from_octets(255, 255, 255, 0)),
+        config_address(config, "gateway", Ipv4Address::from_octets(10, 0, 2, 2)),
+    };
+}
+
+int main(int argc, const char **argv)
+{
+    UNUSED(argc);
+    UNUSED(argv);
+
+    IO::logln("Initializing network-service...");
+
+    IO::File device{NETWORK_DEVICE_PATH, OPEN_READ | OPEN_WRITE};
+
+    IOCallNetworkSateAgs state = {};
+    IOCallNetworkRingsArgs rings = {};
+
+    if (!device.exist() ||
+        device.handle()->call(IOCALL_NETWORK_GET_STATE, &state) != SUCCESS ||
+        device.handle()->call(IOCALL_NETWORK_MAP_RINGS, &rings) != SUCCESS)
+    {
+        IO::errln("No usable network device!");
+        return PROCESS_FAILURE;
+    }
+
+    uintptr_t address = 0;
+    size_t size = 0;
+
+    if (memory_include(rings.handle, &address, &size) != SUCCESS || size < NetworkRings::SIZE)
+    {
+        IO::errln("Failed to map the packet rings!");
+        return PROCESS_FAILURE;
+    }
+
+    IO::logln("Loading configuration...");
+
+    auto config = load_config();
+
+    IO::logln("Address {}.{}.{}.{} gateway {}.{}.{}.{}",
+              config.address[0], config.address[1], config.address[2], config.address[3],
+              config.gateway[0], config.gateway[1], config.gateway[2], config.gateway[3]);
+
+    Net::RingInterface interface{reinterpret_cast<NetworkRings *>(address), state.mac_address};
+    Net::Stack stack{interface, config, system_get_ticks()};
+
+    IO::logln("Starting server...");
+
+    Network::Server server{device, interface, stack};
+
+    IO::logln("Ready!");
+
+    return Async::Loop::the()->run();
+}
@@ -1,5 +1,5 @@
 APPS += ONBOARDING
 
 ONBOARDING_NAME = onboarding
-ONBOARDING_LIBS = widget settings async graphic xml system io compression
+ONBOARDING_LIBS = widget settings graphic async xml system io compression
 ONBOARDING_ICONS =
@@ -1,4 +1,4 @@
 APPS += PAINT
 
 PAINT_NAME = paint
-PAINT_LIBS = widget settings async graphic xml system io compression
+PAINT_LIBS = filepicker widget settings graphic async xml system io compression
@@ -1,5 +1,7 @@
 #include <assert.h>
 
+#include <libfilepicker/FilePicker.h>
+#include <libio/Streams.h>
 #include <libwidget/Application.h>
 #include <libwidget/Container.h>
 #include <libwidget/Elements.h>
@@ -92,6 +94,18 @@ public:
 
         _open_document = toolbar->add<Widget::ButtonElement>(Widget::ButtonElement::TEXT, Graphic::Icon::get("folder-open"));
         _save_document = toolbar->add<Widget::ButtonElement>(Widget::ButtonElement::TEXT, Graphic::Icon::get("content-save"));
+        _save_document->on(Widget::Event::ACTION, [this](auto) {
+            FilePicker::Dialog picker{FilePicker::DIALOG_FLAGS_SAVE};
+            if (picker.show() == Widget::DialogResult::OK)
+            {
+                auto result = _document->bitmap().save_to(picker.selected_file().unwrap());
+
+                if (result != SUCCESS)
+                {
+                    IO::logln("Failed to save the document: {}", get_result_description(result));
+                }
+            }
+        });
         _new_document = toolbar->add<Widget::ButtonElement>(Widget::ButtonElement::TEXT, Graphic::Icon::get("image-plus"));
 
         toolbar->add(Widget::separator());
@@ -1,4 +1,4 @@
 APPS += PANEL
 
 PANEL_NAME = panel
-PANEL_LIBS = widget settings async graphic xml system io compression
+PANEL_LIBS = widget settings graphic async xml system io compression
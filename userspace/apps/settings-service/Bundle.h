@@ -22,7 +22,7 @@ struct Bundle
             return {};
         }
 
-        auto value = Json::parse(file);
+        auto value = Json::parse(file, Json::INTERN_KEYS);
 
         if (!value.is(Json::OBJECT))
         {
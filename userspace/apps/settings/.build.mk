@@ -1,5 +1,5 @@
 APPS += SETTINGS
 
 SETTINGS_NAME = settings
-SETTINGS_LIBS = widget settings async graphic xml system io compression
+SETTINGS_LIBS = widget settings graphic async xml system io compression
 SETTINGS_ICONS = cog home
\ No newline at end of file
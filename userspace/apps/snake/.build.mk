@@ -1,4 +1,4 @@
 APPS += SNAKE
 
 SNAKE_NAME = snake
-SNAKE_LIBS = widget settings async graphic xml system io compression
+SNAKE_LIBS = widget settings graphic async xml system io compression
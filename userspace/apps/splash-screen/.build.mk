@@ -1,4 +1,4 @@
 APPS += SPLASH_SCREEN
 
 SPLASH_SCREEN_NAME = splash-screen
-SPLASH_SCREEN_LIBS = graphic xml system io compression
+SPLASH_SCREEN_LIBS = graphic async xml system io compression
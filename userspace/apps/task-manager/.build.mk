@@ -1,4 +1,4 @@
 APPS += TASK_MANAGER
 
 TASK_MANAGER_NAME = task-manager
-TASK_MANAGER_LIBS = widget settings async graphic xml system io compression
+TASK_MANAGER_LIBS = widget settings graphic async xml system io compression
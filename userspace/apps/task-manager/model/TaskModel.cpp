@@ -89,6 +89,16 @@ Widget::Variant TaskModel::data(int row, int column)
     }
 }
 
+static bool same_task(const Json::Value &left, const Json::Value &right)
+{
+    return left.get("id").as_integer() == right.get("id").as_integer() &&
+           left.get("user").is(Json::TRUE) == right.get("user").is(Json::TRUE) &&
+           left.get("name").as_string() == right.get("name").as_string() &&
+           left.get("state").as_string() == right.get("state").as_string() &&
+           left.get("cpu").as_integer() == right.get("cpu").as_integer() &&
+           left.get("ram").as_integer() / 1024 == right.get("ram").as_integer() / 1024;
+}
+
 void TaskModel::update()
 {
     IO::File file{"/System/processes", OPEN_READ};
@@ -98,8 +108,34 @@ void TaskModel::update()
         return;
     }
 
+    Json::Value previous = move(_data);
     _data = Json::parse(file);
-    did_update();
+
+    if (previous.length() != _data.length())
+    {
+        did_update();
+        return;
+    }
+
+    // Most tasks don't change from one refresh to the other, only notify the
+    // runs of rows that did so the table doesn't have to repaint everything.
+    int first_changed = -1;
+
+    for (int row = 0; row <= (int)_data.length(); row++)
+    {
+        bool changed = row < (int)_data.length() &&
+                       !same_task(previous.get(row), _data.get(row));
+
+        if (changed && first_changed < 0)
+        {
+            first_changed = row;
+        }
+        else if (!changed && first_changed >= 0)
+        {
+            did_update_rows(first_changed, row - first_changed);
+            first_changed = -1;
+        }
+    }
 }
 
 static String greedy(Json::Value &data, const char *field)
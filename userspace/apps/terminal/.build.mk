@@ -1,4 +1,4 @@
 APPS += TERMINAL
 
 TERMINAL_NAME = terminal
-TERMINAL_LIBS = terminal widget settings async graphic xml system io compression
+TERMINAL_LIBS = terminal widget settings graphic async xml system io compression
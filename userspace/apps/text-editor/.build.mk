@@ -1,5 +1,5 @@
 APPS += TEXT_EDITOR
 
 TEXT_EDITOR_NAME = text-editor
-TEXT_EDITOR_LIBS = filepicker widget settings async graphic xml system io compression
+TEXT_EDITOR_LIBS = filepicker widget settings graphic async xml system io compression
 
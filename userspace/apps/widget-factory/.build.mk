@@ -1,4 +1,4 @@
 APPS += WIDGET_FACTORY
 
 WIDGET_FACTORY_NAME = widget-factory
-WIDGET_FACTORY_LIBS = filepicker widget settings async graphic xml system io compression
+WIDGET_FACTORY_LIBS = filepicker widget settings graphic async xml system io compression
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+// Right below the user stack, mapped read only in every user process.
+#define CLOCK_PAGE_ADDRESS 0xfefff000
+
+// Published by the kernel so the monotonic time can be read without a syscall.
+// When the cycle counter is calibrated the time is computed from it, otherwise
+// the coarse time, refreshed on every timer interrupt, is used as is.
+// The sequence is odd while the kernel is writing, readers retry until they
+// see the same even value before and after reading the page.
+struct ClockPage
+{
+    uint32_t sequence;
+    uint32_t cycles_available;
+
+    uint64_t cycles_at_boot;
+
+    // Nanoseconds per cycle, 32.32 fixed point.
+    uint64_t nanoseconds_per_cycle;
+
+    // Nanoseconds since boot at the last timer interrupt.
+    uint64_t coarse;
+};
+
+static inline uint64_t clock_cycles_to_nanoseconds(uint64_t cycles, uint64_t scale)
+{
+    // Split in 16 bit chunks so none of the products overflows.
+    return (cycles >> 32) * scale +
+           ((((cycles >> 16) & 0xFFFF) * scale) >> 16) +
+           (((cycles & 0xFFFF) * scale) >> 32);
+}
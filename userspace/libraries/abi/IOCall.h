@@ -45,6 +45,20 @@ struct IOCallNetworkSateAgs
     MacAddress mac_address;
 };
 
+struct IOCallNetworkRingsArgs
+{
+    // Memory object holding the NetworkRings, for memory_include().
+    int handle;
+    size_t size;
+};
+
+struct IOCallNetworkStatsArgs
+{
+    NetworkQueueStats rx;
+    NetworkQueueStats tx;
+    uint64_t interrupts;
+};
+
 enum IOCall
 {
     IOCALL_TERMINAL_GET_SIZE,
@@ -61,6 +75,12 @@ enum IOCall
     IOCALL_TEXTMODE_SET_STATE,
 
     IOCALL_NETWORK_GET_STATE,
+    IOCALL_NETWORK_MAP_RINGS,
+    IOCALL_NETWORK_SYNC,
+    IOCALL_NETWORK_GET_STATS,
+
+    IOCALL_PROFILER_START,
+    IOCALL_PROFILER_STOP,
 
     __IOCALL_COUNT,
 };
@@ -3,4 +3,5 @@
 #define MEMORY_NONE (0)
 #define MEMORY_USER (1 << 0)
 #define MEMORY_CLEAR (1 << 1)
+#define MEMORY_READ_ONLY (1 << 2)
 typedef unsigned int MemoryFlags;
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libsystem/Common.h>
+#include <libsystem/Result.h>
 
 struct MacAddress
 {
@@ -10,4 +11,154 @@ struct MacAddress
     {
         return bytes[index];
     }
+
+    bool operator==(const MacAddress &other) const
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            if (bytes[i] != other.bytes[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const MacAddress &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+struct Ipv4Address
+{
+    // In host byte order, 10.0.2.15 is 0x0a00020f.
+    uint32_t value;
+
+    static constexpr Ipv4Address from_octets(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    {
+        return {((uint32_t)a << 24) | ((uint32_t)b << 16) | ((uint32_t)c << 8) | (uint32_t)d};
+    }
+
+    uint8_t operator[](int index) const
+    {
+        return (value >> (24 - index * 8)) & 0xff;
+    }
+
+    bool operator==(const Ipv4Address &other) const { return value == other.value; }
+
+    bool operator!=(const Ipv4Address &other) const { return value != other.value; }
+};
+
+struct NetworkEndpoint
+{
+    Ipv4Address address;
+    uint16_t port;
+};
+
+/* --- Packet rings --------------------------------------------------------- */
+
+#define NETWORK_RING_SLOTS 64
+#define NETWORK_FRAME_SIZE 2048
+
+// head and tail are free running counters, the slot of a frame is its counter
+// modulo NETWORK_RING_SLOTS. The producer fills slots and moves head, the
+// consumer reads the frames in [tail, head) and moves tail to give them back.
+struct NetworkRing
+{
+    uint32_t head;
+    uint32_t tail;
+    uint16_t lengths[NETWORK_RING_SLOTS];
+};
+
+// Frames are exchanged through a single memory object mapped by both the
+// driver and the network stack, the hardware reads and writes the buffers
+// directly so frames are never copied between them.
+struct NetworkRings
+{
+    // Filled by the driver, consumed by the stack.
+    NetworkRing rx;
+
+    // Filled by the stack, consumed by the driver.
+    NetworkRing tx;
+
+    static constexpr size_t HEADER_SIZE = 4096;
+
+    static constexpr size_t SIZE = HEADER_SIZE + 2 * NETWORK_RING_SLOTS * NETWORK_FRAME_SIZE;
+
+    static constexpr size_t rx_offset(uint32_t counter)
+    {
+        return HEADER_SIZE + (counter % NETWORK_RING_SLOTS) * NETWORK_FRAME_SIZE;
+    }
+
+    static constexpr size_t tx_offset(uint32_t counter)
+    {
+        return HEADER_SIZE + (NETWORK_RING_SLOTS + counter % NETWORK_RING_SLOTS) * NETWORK_FRAME_SIZE;
+    }
+
+    uint8_t *rx_frame(uint32_t counter)
+    {
+        return reinterpret_cast<uint8_t *>(this) + rx_offset(counter);
+    }
+
+    uint8_t *tx_frame(uint32_t counter)
+    {
+        return reinterpret_cast<uint8_t *>(this) + tx_offset(counter);
+    }
+};
+
+static_assert(sizeof(NetworkRings) <= NetworkRings::HEADER_SIZE);
+
+// Kept by the driver for each direction.
+struct NetworkQueueStats
+{
+    uint64_t packets;
+    uint64_t bytes;
+
+    // Frames lost on the way, because the ring was full or the hardware
+    // reported an error.
+    uint64_t drops;
+
+    // How many times frames were handed over, and the most at once.
+    uint64_t batches;
+    uint32_t largest_batch;
+};
+
+/* --- Network service ------------------------------------------------------ */
+
+#define NETWORK_SERVICE_PATH "/Session/network.ipc"
+
+// The largest payload a single request or response carries.
+#define NETWORK_SERVICE_CHUNK (16 * 1024)
+
+enum NetworkRequestType : uint8_t
+{
+    // The first request on a connection says what it is for.
+    NETWORK_TCP_CONNECT,
+    NETWORK_TCP_LISTEN,
+    NETWORK_TCP_ACCEPT,
+    NETWORK_UDP_BIND,
+
+    // Followed by `size` bytes, the response comes once they are queued.
+    NETWORK_SEND,
+
+    // The response carries up to `size` bytes, or a single datagram, and
+    // comes once there is something to read. Zero bytes is the end of the
+    // stream.
+    NETWORK_RECEIVE,
+};
+
+struct NetworkRequest
+{
+    NetworkRequestType type;
+    NetworkEndpoint endpoint;
+    uint32_t size;
+};
+
+struct NetworkResponse
+{
+    Result result;
+    NetworkEndpoint endpoint;
+    uint32_t size;
 };
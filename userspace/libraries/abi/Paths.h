@@ -14,4 +14,8 @@
 
 #define SERIAL_DEVICE_PATH DEVICE_PATH "/serial"
 
+#define PROFILER_DEVICE_PATH DEVICE_PATH "/profiler"
+
+#define TRACE_DEVICE_PATH DEVICE_PATH "/trace"
+
 #define UNIX_DEVICE_PATH(__device) DEVICE_PATH "/" __device
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <abi/Time.h>
+
+#define PROFILER_MAX_DEPTH 16
+
+#define PROFILER_TASK_NAME_SIZE 32
+
+// One tick of the timer. Frames are stored from the innermost outward, the
+// kernel ones first. Addresses are always 64 bits wide so the host side
+// doesn't have to care about the architecture the samples come from.
+struct PACKED ProfilerSample
+{
+    int task;
+    Tick tick;
+
+    uint8_t kernel_frames;
+    uint8_t user_frames;
+
+    char name[PROFILER_TASK_NAME_SIZE];
+
+    uint64_t frames[PROFILER_MAX_DEPTH];
+};
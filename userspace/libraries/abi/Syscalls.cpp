@@ -56,6 +56,31 @@ Result hj_process_wait(int tid, int *user_exit_value)
     return __syscall(HJ_PROCESS_WAIT, (uintptr_t)tid, (uintptr_t)user_exit_value);
 }
 
+Result hj_thread_create(uintptr_t ip, uintptr_t sp, uintptr_t tls, int *tid)
+{
+    return __syscall(HJ_THREAD_CREATE, ip, sp, tls, (uintptr_t)tid);
+}
+
+Result hj_thread_exit(int exit_code)
+{
+    return __syscall(HJ_THREAD_EXIT, (uintptr_t)exit_code);
+}
+
+Result hj_thread_tls(uintptr_t tls)
+{
+    return __syscall(HJ_THREAD_TLS, tls);
+}
+
+Result hj_futex_wait(int *address, int expected, Timeout timeout)
+{
+    return __syscall(HJ_FUTEX_WAIT, (uintptr_t)address, (uintptr_t)expected, timeout);
+}
+
+Result hj_futex_wake(int *address, int count)
+{
+    return __syscall(HJ_FUTEX_WAKE, (uintptr_t)address, (uintptr_t)count);
+}
+
 Result hj_memory_alloc(size_t size, uintptr_t *out_address)
 {
     return __syscall(HJ_MEMORY_ALLOC, (uintptr_t)size, (uintptr_t)out_address);
@@ -81,6 +106,11 @@ Result hj_memory_get_handle(uintptr_t address, int *out_handle)
     return __syscall(HJ_MEMORY_GET_HANDLE, address, (uintptr_t)out_handle);
 }
 
+Result hj_memory_map_file(const char *raw_path, size_t size, uintptr_t *out_address, size_t *out_size)
+{
+    return __syscall(HJ_MEMORY_MAP_FILE, (uintptr_t)raw_path, (uintptr_t)size, (uintptr_t)out_address, (uintptr_t)out_size);
+}
+
 Result hj_filesystem_mkdir(const char *raw_path, size_t size)
 {
     return __syscall(HJ_FILESYSTEM_MKDIR, (uintptr_t)raw_path, (uintptr_t)size);
@@ -159,6 +189,21 @@ Result hj_create_term(int *server_handle, int *client_handle)
     return __syscall(HJ_CREATE_TERM, (uintptr_t)server_handle, (uintptr_t)client_handle);
 }
 
+Result hj_create_event_queue(int *queue_handle)
+{
+    return __syscall(HJ_CREATE_EVENT_QUEUE, (uintptr_t)queue_handle);
+}
+
+Result hj_event_queue_update(int queue_handle, int handle, PollEvent events)
+{
+    return __syscall(HJ_EVENT_QUEUE_UPDATE, (uintptr_t)queue_handle, (uintptr_t)handle, (uintptr_t)events);
+}
+
+Result hj_event_queue_wait(int queue_handle, HandlePoll *events, size_t capacity, size_t *count, Timeout timeout)
+{
+    return __syscall(HJ_EVENT_QUEUE_WAIT, (uintptr_t)queue_handle, (uintptr_t)events, (uintptr_t)capacity, (uintptr_t)count, timeout);
+}
+
 Result hj_handle_open(int *handle, const char *raw_path, size_t size, OpenFlag flags)
 {
     return __syscall(HJ_HANDLE_OPEN, (uintptr_t)handle, (uintptr_t)raw_path, (uintptr_t)size, flags);
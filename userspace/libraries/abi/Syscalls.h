@@ -10,46 +10,55 @@
 #include <abi/Launchpad.h>
 #include <abi/System.h>
 
-#define SYSCALL_LIST(__ENTRY)     \
-    __ENTRY(HJ_PROCESS_THIS)      \
-    __ENTRY(HJ_PROCESS_NAME)      \
-    __ENTRY(HJ_PROCESS_LAUNCH)    \
-    __ENTRY(HJ_PROCESS_CLONE)     \
-    __ENTRY(HJ_PROCESS_EXEC)      \
-    __ENTRY(HJ_PROCESS_EXIT)      \
-    __ENTRY(HJ_PROCESS_CANCEL)    \
-    __ENTRY(HJ_PROCESS_SLEEP)     \
-    __ENTRY(HJ_PROCESS_WAIT)      \
-    __ENTRY(HJ_MEMORY_ALLOC)      \
-    __ENTRY(HJ_MEMORY_MAP)        \
-    __ENTRY(HJ_MEMORY_FREE)       \
-    __ENTRY(HJ_MEMORY_INCLUDE)    \
-    __ENTRY(HJ_MEMORY_GET_HANDLE) \
-    __ENTRY(HJ_FILESYSTEM_LINK)   \
-    __ENTRY(HJ_FILESYSTEM_UNLINK) \
-    __ENTRY(HJ_FILESYSTEM_RENAME) \
-    __ENTRY(HJ_FILESYSTEM_MKPIPE) \
-    __ENTRY(HJ_FILESYSTEM_MKDIR)  \
-    __ENTRY(HJ_SYSTEM_INFO)       \
-    __ENTRY(HJ_SYSTEM_STATUS)     \
-    __ENTRY(HJ_SYSTEM_TIME)       \
-    __ENTRY(HJ_SYSTEM_TICKS)      \
-    __ENTRY(HJ_SYSTEM_REBOOT)     \
-    __ENTRY(HJ_SYSTEM_SHUTDOWN)   \
-    __ENTRY(HJ_HANDLE_OPEN)       \
-    __ENTRY(HJ_HANDLE_CLOSE)      \
-    __ENTRY(HJ_HANDLE_REOPEN)     \
-    __ENTRY(HJ_HANDLE_COPY)       \
-    __ENTRY(HJ_HANDLE_POLL)       \
-    __ENTRY(HJ_HANDLE_READ)       \
-    __ENTRY(HJ_HANDLE_WRITE)      \
-    __ENTRY(HJ_HANDLE_CALL)       \
-    __ENTRY(HJ_HANDLE_SEEK)       \
-    __ENTRY(HJ_HANDLE_STAT)       \
-    __ENTRY(HJ_HANDLE_CONNECT)    \
-    __ENTRY(HJ_HANDLE_ACCEPT)     \
-    __ENTRY(HJ_CREATE_PIPE)       \
-    __ENTRY(HJ_CREATE_TERM)
+#define SYSCALL_LIST(__ENTRY)      \
+    __ENTRY(HJ_PROCESS_THIS)       \
+    __ENTRY(HJ_PROCESS_NAME)       \
+    __ENTRY(HJ_PROCESS_LAUNCH)     \
+    __ENTRY(HJ_PROCESS_CLONE)      \
+    __ENTRY(HJ_PROCESS_EXEC)       \
+    __ENTRY(HJ_PROCESS_EXIT)       \
+    __ENTRY(HJ_PROCESS_CANCEL)     \
+    __ENTRY(HJ_PROCESS_SLEEP)      \
+    __ENTRY(HJ_PROCESS_WAIT)       \
+    __ENTRY(HJ_THREAD_CREATE)      \
+    __ENTRY(HJ_THREAD_EXIT)        \
+    __ENTRY(HJ_THREAD_TLS)         \
+    __ENTRY(HJ_FUTEX_WAIT)         \
+    __ENTRY(HJ_FUTEX_WAKE)         \
+    __ENTRY(HJ_MEMORY_ALLOC)       \
+    __ENTRY(HJ_MEMORY_MAP)         \
+    __ENTRY(HJ_MEMORY_FREE)        \
+    __ENTRY(HJ_MEMORY_INCLUDE)     \
+    __ENTRY(HJ_MEMORY_GET_HANDLE)  \
+    __ENTRY(HJ_MEMORY_MAP_FILE)    \
+    __ENTRY(HJ_FILESYSTEM_LINK)    \
+    __ENTRY(HJ_FILESYSTEM_UNLINK)  \
+    __ENTRY(HJ_FILESYSTEM_RENAME)  \
+    __ENTRY(HJ_FILESYSTEM_MKPIPE)  \
+    __ENTRY(HJ_FILESYSTEM_MKDIR)   \
+    __ENTRY(HJ_SYSTEM_INFO)        \
+    __ENTRY(HJ_SYSTEM_STATUS)      \
+    __ENTRY(HJ_SYSTEM_TIME)        \
+    __ENTRY(HJ_SYSTEM_TICKS)       \
+    __ENTRY(HJ_SYSTEM_REBOOT)      \
+    __ENTRY(HJ_SYSTEM_SHUTDOWN)    \
+    __ENTRY(HJ_HANDLE_OPEN)        \
+    __ENTRY(HJ_HANDLE_CLOSE)       \
+    __ENTRY(HJ_HANDLE_REOPEN)      \
+    __ENTRY(HJ_HANDLE_COPY)        \
+    __ENTRY(HJ_HANDLE_POLL)        \
+    __ENTRY(HJ_HANDLE_READ)        \
+    __ENTRY(HJ_HANDLE_WRITE)       \
+    __ENTRY(HJ_HANDLE_CALL)        \
+    __ENTRY(HJ_HANDLE_SEEK)        \
+    __ENTRY(HJ_HANDLE_STAT)        \
+    __ENTRY(HJ_HANDLE_CONNECT)     \
+    __ENTRY(HJ_HANDLE_ACCEPT)      \
+    __ENTRY(HJ_CREATE_PIPE)        \
+    __ENTRY(HJ_CREATE_TERM)        \
+    __ENTRY(HJ_CREATE_EVENT_QUEUE) \
+    __ENTRY(HJ_EVENT_QUEUE_UPDATE) \
+    __ENTRY(HJ_EVENT_QUEUE_WAIT)
 
 #define SYSCALL_ENUM_ENTRY(__entry) __entry,
 
@@ -58,6 +67,36 @@ enum Syscall
     SYSCALL_LIST(SYSCALL_ENUM_ENTRY) __SYSCALL_COUNT
 };
 
+// Latencies are sorted in buckets of doubling width, the first one holding
+// everything under a microsecond and the last one everything left.
+#define SYSCALL_HISTOGRAM_BUCKETS 16
+
+static inline uint64_t syscall_histogram_limit(size_t bucket) { return 1000ull << bucket; }
+
+static inline size_t syscall_histogram_bucket(uint64_t nanoseconds)
+{
+    size_t bucket = 0;
+
+    while (bucket + 1 < SYSCALL_HISTOGRAM_BUCKETS && nanoseconds >= syscall_histogram_limit(bucket))
+    {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+// One syscall made by a task launched with TASK_TRACED, times are in
+// nanoseconds since boot.
+struct SyscallTraceEvent
+{
+    int task;
+    Syscall syscall;
+    Result result;
+    uintptr_t arguments[5];
+    uint64_t entry;
+    uint64_t exit;
+};
+
 static Result __syscall(Syscall syscall, uintptr_t p1, uintptr_t p2, uintptr_t p3, uintptr_t p4, uintptr_t p5)
 {
     Result __ret = ERR_NOT_IMPLEMENTED;
@@ -121,12 +160,25 @@ Result hj_process_cancel(int pid);
 Result hj_process_sleep(int time);
 Result hj_process_wait(int tid, int *user_exit_value);
 
+Result hj_thread_create(uintptr_t ip, uintptr_t sp, uintptr_t tls, int *tid);
+Result hj_thread_exit(int exit_code);
+Result hj_thread_tls(uintptr_t tls);
+
+// Sleeps only if *address still holds expected, callers have to check the
+// value again once they wake up.
+Result hj_futex_wait(int *address, int expected, Timeout timeout);
+Result hj_futex_wake(int *address, int count);
+
 Result hj_memory_alloc(size_t size, uintptr_t *out_address);
 Result hj_memory_map(uintptr_t address, size_t size, int flags);
 Result hj_memory_free(uintptr_t address);
 Result hj_memory_include(int handle, uintptr_t *out_address, size_t *out_size);
 Result hj_memory_get_handle(uintptr_t address, int *out_handle);
 
+// Maps the content of a file read-only, every task mapping the same file
+// gets the same pages until the file is written to.
+Result hj_memory_map_file(const char *raw_path, size_t size, uintptr_t *out_address, size_t *out_size);
+
 Result hj_filesystem_mkdir(const char *raw_path, size_t size);
 Result hj_filesystem_mkpipe(const char *raw_path, size_t size);
 Result hj_filesystem_link(const char *raw_old_path, size_t old_size, const char *raw_new_path, size_t new_size);
@@ -142,6 +194,10 @@ Result hj_system_shutdown();
 
 Result hj_create_pipe(int *reader_handle, int *writer_handle);
 Result hj_create_term(int *server_handle, int *client_handle);
+Result hj_create_event_queue(int *queue_handle);
+
+Result hj_event_queue_update(int queue_handle, int handle, PollEvent events);
+Result hj_event_queue_wait(int queue_handle, HandlePoll *events, size_t capacity, size_t *count, Timeout timeout);
 
 Result hj_handle_open(int *handle, const char *raw_path, size_t size, OpenFlag flags);
 Result hj_handle_close(int handle);
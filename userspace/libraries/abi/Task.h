@@ -23,6 +23,9 @@ enum TaskState
 #define TASK_WAITABLE (1 << 0)
 #define TASK_USER (1 << 1)
 
+// Syscalls of the task, its threads and the tasks it launches go to /Devices/trace.
+#define TASK_TRACED (1 << 2)
+
 typedef unsigned int TaskFlags;
 
 static inline const char *task_state_string(TaskState state)
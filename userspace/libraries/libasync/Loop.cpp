@@ -4,7 +4,7 @@
 #include <libasync/Timer.h>
 #include <libsystem/system/System.h>
 #include <libutils/Assert.h>
-#include <libutils/Vector.h>
+#include <libutils/SmallVector.h>
 
 namespace Async
 {
@@ -23,74 +23,269 @@ RefPtr<Loop> Loop::the()
     return _instance;
 }
 
-void Loop::update_notifier(int id, PollEvent event)
+void Loop::update_interest(int handle)
 {
-    for (size_t i = 0; i < _notifiers.count(); i++)
+    PollEvent events = 0;
+
+    if (_notifiers.has_key(handle))
     {
-        if (_notifiers[i]->handle()->id() == id &&
-            _notifiers[i]->events() & event)
+        auto &notifiers = _notifiers[handle];
+
+        for (size_t i = 0; i < notifiers.count(); i++)
         {
-            _notifiers[i]->invoke();
+            if (notifiers[i])
+            {
+                events |= notifiers[i]->events();
+            }
         }
     }
+
+    hj_event_queue_update(_queue, handle, events);
 }
 
-void Loop::update_polling_list()
+void Loop::sweep_notifiers()
 {
-    _polls.clear();
+    SmallVector<int, 16> empty_handles;
 
-    for (Notifier *notifier : _notifiers)
+    _notifiers.foreach ([&](auto &handle, auto &notifiers) {
+        notifiers.remove_all_value(nullptr);
+
+        if (notifiers.empty())
+        {
+            empty_handles.push_back(handle);
+        }
+
+        return Iteration::CONTINUE;
+    });
+
+    for (size_t i = 0; i < empty_handles.count(); i++)
     {
-        _polls.push_back({
-            notifier->handle()->id(),
-            notifier->events(),
-            0,
-        });
+        _notifiers.remove_key(empty_handles[i]);
+    }
+
+    _should_sweep = false;
+}
+
+void Loop::update_notifiers(HandlePoll *events, size_t count)
+{
+    _dispatching = true;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int handle = events[i].handle;
+
+        if (!_notifiers.has_key(handle))
+        {
+            continue;
+        }
+
+        // Callbacks might register notifiers and move the list around, so it
+        // is looked up again every time.
+        for (size_t j = 0; j < _notifiers[handle].count(); j++)
+        {
+            Notifier *notifier = _notifiers[handle][j];
+
+            if (notifier && (notifier->events() & events[i].result))
+            {
+                notifier->invoke();
+            }
+        }
+    }
+
+    _dispatching = false;
+
+    if (_should_sweep)
+    {
+        sweep_notifiers();
     }
 }
 
 void Loop::register_notifier(Notifier *notifier)
 {
+    int handle = notifier->handle()->id();
 
-    _notifiers.push_back(notifier);
+    _notifiers[handle].push_back(notifier);
 
-    update_polling_list();
+    update_interest(handle);
 }
 
 void Loop::unregister_notifier(Notifier *notifier)
 {
-    _notifiers.remove_all_value(notifier);
+    int handle = notifier->handle()->id();
+
+    if (!_notifiers.has_key(handle))
+    {
+        return;
+    }
 
-    update_polling_list();
+    auto &notifiers = _notifiers[handle];
+
+    if (_dispatching)
+    {
+        for (size_t i = 0; i < notifiers.count(); i++)
+        {
+            if (notifiers[i] == notifier)
+            {
+                notifiers[i] = nullptr;
+                _should_sweep = true;
+            }
+        }
+    }
+    else
+    {
+        notifiers.remove_all_value(notifier);
+
+        if (notifiers.empty())
+        {
+            _notifiers.remove_key(handle);
+        }
+    }
+
+    update_interest(handle);
 }
 
 /* --- Timers --------------------------------------------------------------- */
 
-void Loop::register_timer(Timer *timer)
+// Timers due this close to each other fire in the same pump instead of
+// waking the loop up once for each of them.
+static constexpr Timeout TIMER_COALESCING = 4;
+
+void Loop::timers_swap(size_t a, size_t b)
+{
+    swap(_timers[a], _timers[b]);
+
+    _timers[a]->_heap_index = a;
+    _timers[b]->_heap_index = b;
+}
+
+void Loop::timers_sift_up(size_t index)
+{
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+
+        if (_timers[parent]->scheduled() <= _timers[index]->scheduled())
+        {
+            return;
+        }
+
+        timers_swap(parent, index);
+        index = parent;
+    }
+}
+
+void Loop::timers_sift_down(size_t index)
 {
+    while (true)
+    {
+        size_t smallest = index;
+        size_t left = index * 2 + 1;
+        size_t right = index * 2 + 2;
+
+        if (left < _timers.count() && _timers[left]->scheduled() < _timers[smallest]->scheduled())
+        {
+            smallest = left;
+        }
+
+        if (right < _timers.count() && _timers[right]->scheduled() < _timers[smallest]->scheduled())
+        {
+            smallest = right;
+        }
+
+        if (smallest == index)
+        {
+            return;
+        }
+
+        timers_swap(index, smallest);
+        index = smallest;
+    }
+}
+
+void Loop::timers_push(Timer *timer)
+{
+    if (timer->interval() == 0)
+    {
+        _idle_timers.push_back(timer);
+        return;
+    }
+
+    timer->_heap_index = _timers.count();
     _timers.push_back(timer);
+    timers_sift_up(timer->_heap_index);
+}
+
+void Loop::timers_remove(Timer *timer)
+{
+    size_t index = timer->_heap_index;
+
+    if (index == Timer::NOT_SCHEDULED)
+    {
+        _idle_timers.remove_value(timer);
+        _due_timers.remove_value(timer);
+        return;
+    }
+
+    timer->_heap_index = Timer::NOT_SCHEDULED;
+
+    Timer *moved = _timers.pop_back();
+
+    if (moved != timer)
+    {
+        _timers[index] = moved;
+        moved->_heap_index = index;
+
+        timers_sift_up(index);
+        timers_sift_down(moved->_heap_index);
+    }
+}
+
+void Loop::register_timer(Timer *timer)
+{
+    timers_push(timer);
 }
 
 void Loop::unregister_timer(Timer *timer)
 {
-    _timers.remove_value(timer);
+    timers_remove(timer);
 }
 
 void Loop::update_timers()
 {
     TimeStamp current_fire = system_get_ticks();
 
-    auto timers_list_copy = _timers;
+    while (!_timers.empty() && _timers[0]->scheduled() <= current_fire + TIMER_COALESCING)
+    {
+        Timer *timer = _timers[0];
+        timers_remove(timer);
+        _due_timers.push_back(timer);
+    }
+
+    for (size_t i = 0; i < _idle_timers.count(); i++)
+    {
+        _due_timers.push_back(_idle_timers[i]);
+    }
+
+    _idle_timers.clear();
 
-    timers_list_copy.foreach ([&](auto timer) {
-        if (timer->running() && timer->scheduled() <= current_fire)
+    // Callbacks are free to start, stop or destroy any timer, so each one is
+    // scheduled again before its callback runs and taken off the list first.
+    while (!_due_timers.empty())
+    {
+        Timer *timer = _due_timers[0];
+        _due_timers.remove_index(0);
+
+        // Freshly started timers were never scheduled, they aren't late.
+        if (timer->scheduled() != 0 && timer->scheduled() < current_fire)
         {
-            timer->trigger();
-            timer->schedule(current_fire + timer->interval());
+            _timer_lateness.record(current_fire - timer->scheduled());
         }
 
-        return Iteration::CONTINUE;
-    });
+        timer->schedule(current_fire + timer->interval());
+        timers_push(timer);
+
+        timer->trigger();
+    }
 }
 
 /* --- Invokers ------------------------------------------------------------- */
@@ -123,6 +318,7 @@ static Vector<AtExitHook> _atexit_hooks;
 
 Loop::Loop()
 {
+    Assert::equal(hj_create_event_queue(&_queue), SUCCESS);
 }
 
 Loop::~Loop()
@@ -131,37 +327,26 @@ Loop::~Loop()
     {
         _atexit_hooks[i]();
     }
+
+    hj_handle_close(_queue);
 }
 
 Timeout Loop::get_timeout()
 {
-    Timeout timeout = UINT32_MAX;
+    if (_timers.empty())
+    {
+        return UINT32_MAX;
+    }
 
     TimeStamp current_tick = system_get_ticks();
+    TimeStamp next = _timers[0]->scheduled();
 
-    _timers.foreach ([&](auto timer) {
-        if (!timer->running() || timer->interval() == 0)
-        {
-            return Iteration::CONTINUE;
-        }
-
-        if (timer->scheduled() < current_tick)
-        {
-            timeout = 0;
-            return Iteration::CONTINUE;
-        }
-
-        Timeout remaining = timer->scheduled() - current_tick;
-
-        if (remaining <= timeout)
-        {
-            timeout = remaining;
-        }
-
-        return Iteration::CONTINUE;
-    });
+    if (next <= current_tick)
+    {
+        return 0;
+    }
 
-    return timeout;
+    return next - current_tick;
 }
 
 void Loop::atexit(AtExitHook hook)
@@ -169,9 +354,11 @@ void Loop::atexit(AtExitHook hook)
     _atexit_hooks.push_back(hook);
 }
 
+// Handles left out stay ready in the kernel and come back on the next pump.
+static constexpr size_t EVENTS_PER_PUMP = 64;
+
 void Loop::pump(bool pool)
 {
-
     Timeout timeout = 0;
 
     if (!pool)
@@ -179,21 +366,30 @@ void Loop::pump(bool pool)
         timeout = get_timeout();
     }
 
-    Result result = hj_handle_poll(_polls.raw_storage(), _polls.count(), timeout);
+    HandlePoll events[EVENTS_PER_PUMP];
+    size_t count = 0;
+
+    Result result = hj_event_queue_wait(_queue, events, EVENTS_PER_PUMP, &count, timeout);
 
-    if (result_is_error(result))
+    if (result == TIMEOUT)
     {
-        exit(PROCESS_FAILURE);
+        count = 0;
     }
-
-    for (const HandlePoll &poll : _polls)
+    else if (result_is_error(result))
     {
-        update_notifier(poll.handle, poll.result);
+        exit(PROCESS_FAILURE);
+        return;
     }
 
+    TimeStamp dispatch_start = system_get_ticks();
+
+    update_notifiers(events, count);
+
     update_timers();
 
     update_invoker();
+
+    _dispatch_time.record(system_get_ticks() - dispatch_start);
 }
 
 int Loop::run()
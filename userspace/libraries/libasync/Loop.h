@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libio/Handle.h>
+#include <libutils/HashMap.h>
 #include <libutils/RefCounted.h>
 #include <libutils/Vector.h>
 
@@ -15,6 +16,27 @@ class Timer;
 
 class Invoker;
 
+// Counts of durations in milliseconds, bucket i holds values under 2^i and
+// the last one everything larger.
+struct LatencyHistogram
+{
+    static constexpr int BUCKET_COUNT = 12;
+
+    size_t buckets[BUCKET_COUNT] = {};
+
+    void record(Timeout duration)
+    {
+        int bucket = 0;
+
+        while (bucket < BUCKET_COUNT - 1 && duration >= (1u << bucket))
+        {
+            bucket++;
+        }
+
+        buckets[bucket]++;
+    }
+};
+
 class Loop : public RefCounted<Loop>
 {
 private:
@@ -24,15 +46,43 @@ private:
     bool _nested_is_running = false;
     int _nested_exit_value = 0;
 
-    Vector<HandlePoll> _polls;
+    // Interest is registered with the kernel once per handle, waiting only
+    // returns the handles which are ready. Notifiers unregistered while
+    // dispatching are left as null and swept once it is done.
+    int _queue = HANDLE_INVALID_ID;
+    HashMap<int, Vector<Notifier *>> _notifiers;
+    bool _dispatching = false;
+    bool _should_sweep = false;
 
-    Vector<Notifier *> _notifiers;
+    // Min-heap on the scheduled time, timers keep their own index in it.
     Vector<Timer *> _timers;
+
+    // Zero interval timers fire on every pump but never wake the loop up.
+    Vector<Timer *> _idle_timers;
+
+    // Popped from the heap and waiting for their callback to run.
+    Vector<Timer *> _due_timers;
+
     Vector<Invoker *> _invoker;
 
-    void update_polling_list();
+    LatencyHistogram _timer_lateness;
+    LatencyHistogram _dispatch_time;
 
-    void update_notifier(int id, PollEvent event);
+    void update_interest(int handle);
+
+    void sweep_notifiers();
+
+    void update_notifiers(HandlePoll *events, size_t count);
+
+    void timers_swap(size_t a, size_t b);
+
+    void timers_sift_up(size_t index);
+
+    void timers_sift_down(size_t index);
+
+    void timers_push(Timer *timer);
+
+    void timers_remove(Timer *timer);
 
     void update_timers();
 
@@ -55,6 +105,12 @@ public:
 
     void unregister_timer(Timer *timer);
 
+    // How late timers fired compared to when they were scheduled.
+    const LatencyHistogram &timer_lateness() { return _timer_lateness; }
+
+    // How long handling the events of a single pump took.
+    const LatencyHistogram &dispatch_time() { return _dispatch_time; }
+
     void register_invoker(Invoker *timer);
 
     void unregister_invoker(Invoker *timer);
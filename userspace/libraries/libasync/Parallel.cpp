@@ -0,0 +1,290 @@
+#include <abi/Syscalls.h>
+
+#include <libasync/Parallel.h>
+#include <libmath/MinMax.h>
+
+namespace Async
+{
+
+/* --- Runtime -------------------------------------------------------------- */
+
+// Constant initialized, so it's already usable by whichever thread is the
+// first to ask for the runtime, even from another static constructor.
+static constinit Lock _the_lock{"parallel-runtime-the"};
+
+Runtime &Runtime::the()
+{
+    Runtime *runtime = __atomic_load_n(&_the, __ATOMIC_ACQUIRE);
+
+    if (runtime)
+    {
+        return *runtime;
+    }
+
+    // Starting the workers takes a while, the other threads wait for it
+    // instead of each spawning a runtime of their own.
+    LockHolder holder{_the_lock};
+
+    runtime = __atomic_load_n(&_the, __ATOMIC_RELAXED);
+
+    if (!runtime)
+    {
+        runtime = new Runtime();
+        __atomic_store_n(&_the, runtime, __ATOMIC_RELEASE);
+    }
+
+    return *runtime;
+}
+
+Runtime::Runtime(size_t workers)
+{
+    for (size_t i = 0; i <= workers; i++)
+    {
+        _deques.push_back(own<WorkDeque>());
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        auto worker_or_result = Thread::spawn([this, i]() { work(i); });
+
+        if (!worker_or_result.success())
+        {
+            // Whoever waits on a group runs the jobs, so fewer workers is
+            // slower but still correct.
+            break;
+        }
+
+        _workers.push_back(worker_or_result.unwrap());
+    }
+}
+
+Runtime::~Runtime()
+{
+    _lock.acquire();
+    _stopping = true;
+    _has_jobs.broadcast();
+    _lock.release();
+
+    _workers.clear();
+
+    Job *job = nullptr;
+
+    while ((job = find_job(_deques.count() - 1)))
+    {
+        run(job);
+    }
+}
+
+size_t Runtime::current_deque()
+{
+    Thread *thread = Thread::current();
+
+    for (size_t i = 0; i < _workers.count(); i++)
+    {
+        if (_workers[i].naked() == thread)
+        {
+            return i;
+        }
+    }
+
+    return _deques.count() - 1;
+}
+
+Job *Runtime::find_job(size_t self)
+{
+    Job *job = _deques[self]->pop();
+
+    for (size_t i = 1; !job && i < _deques.count(); i++)
+    {
+        job = _deques[(self + i) % _deques.count()]->steal();
+    }
+
+    if (job)
+    {
+        __atomic_sub_fetch(&_queued, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return job;
+}
+
+void Runtime::work(size_t self)
+{
+    while (true)
+    {
+        Job *job = find_job(self);
+
+        if (job)
+        {
+            run(job);
+            continue;
+        }
+
+        LockHolder holder{_lock};
+
+        if (_stopping)
+        {
+            return;
+        }
+
+        // Announce we are going to sleep before looking at the queue one last
+        // time, either we see the new job or schedule() sees us and signals.
+        __atomic_add_fetch(&_sleeping, 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&_queued, __ATOMIC_SEQ_CST) == 0)
+        {
+            _has_jobs.wait(_lock);
+        }
+
+        __atomic_sub_fetch(&_sleeping, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+void Runtime::schedule(Job *job)
+{
+    __atomic_add_fetch(&_queued, 1, __ATOMIC_SEQ_CST);
+    _deques[current_deque()]->push(job);
+
+    if (__atomic_load_n(&_sleeping, __ATOMIC_SEQ_CST) > 0)
+    {
+        LockHolder holder{_lock};
+        _has_jobs.signal();
+    }
+}
+
+bool Runtime::help()
+{
+    Job *job = find_job(current_deque());
+
+    if (!job)
+    {
+        return false;
+    }
+
+    run(job);
+
+    return true;
+}
+
+void Runtime::run(Job *job)
+{
+    job->work();
+    job->group->finished();
+
+    delete job;
+}
+
+/* --- JobGroup ------------------------------------------------------------- */
+
+void JobGroup::spawn(Callback<void()> work)
+{
+    __atomic_add_fetch(&_pending, 1, __ATOMIC_SEQ_CST);
+    _runtime.schedule(new Job{move(work), this});
+}
+
+void JobGroup::finished()
+{
+    if (__atomic_sub_fetch(&_pending, 1, __ATOMIC_SEQ_CST) == 0)
+    {
+        hj_futex_wake(&_pending, __INT_MAX__);
+    }
+}
+
+void JobGroup::wait()
+{
+    while (true)
+    {
+        int pending = __atomic_load_n(&_pending, __ATOMIC_SEQ_CST);
+
+        if (pending == 0)
+        {
+            return;
+        }
+
+        // Nothing left to steal, what's left is running on other workers.
+        if (!_runtime.help())
+        {
+            hj_futex_wait(&_pending, pending, -1);
+        }
+    }
+}
+
+/* --- Parallel for --------------------------------------------------------- */
+
+static void split(JobGroup &group, size_t begin, size_t end, size_t grain, Callback<void(size_t, size_t)> &body)
+{
+    while (end - begin > grain)
+    {
+        size_t middle = begin + (end - begin) / 2;
+
+        group.spawn([&group, middle, end, grain, &body]() {
+            split(group, middle, end, grain, body);
+        });
+
+        end = middle;
+    }
+
+    body(begin, end);
+}
+
+void parallel_for(size_t begin, size_t end, size_t grain, Callback<void(size_t, size_t)> body, Runtime &runtime)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    grain = MAX(grain, 1);
+
+    if (end - begin <= grain || runtime.workers() == 0)
+    {
+        body(begin, end);
+        return;
+    }
+
+    JobGroup group{runtime};
+    split(group, begin, end, grain, body);
+    group.wait();
+}
+
+/* --- Task graph ----------------------------------------------------------- */
+
+void TaskGraph::spawn(JobGroup &group, size_t index)
+{
+    group.spawn([this, &group, index]() {
+        _nodes[index].work();
+
+        for (size_t dependent : _nodes[index].dependents)
+        {
+            if (__atomic_sub_fetch(&_nodes[dependent].dependencies, 1, __ATOMIC_SEQ_CST) == 0)
+            {
+                spawn(group, dependent);
+            }
+        }
+    });
+}
+
+void TaskGraph::run(Runtime &runtime)
+{
+    // Roots are picked before starting anything, once running, nodes bring
+    // the counters of their dependents down to zero and spawn them themselves.
+    Vector<size_t> roots;
+
+    for (size_t i = 0; i < _nodes.count(); i++)
+    {
+        if (_nodes[i].dependencies == 0)
+        {
+            roots.push_back(i);
+        }
+    }
+
+    JobGroup group{runtime};
+
+    for (size_t root : roots)
+    {
+        spawn(group, root);
+    }
+
+    group.wait();
+}
+
+} // namespace Async
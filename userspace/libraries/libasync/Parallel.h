@@ -0,0 +1,204 @@
+#pragma once
+
+#include <libsystem/thread/Thread.h>
+#include <libutils/Callback.h>
+#include <libutils/Optional.h>
+#include <libutils/RefCounted.h>
+#include <libutils/RefPtr.h>
+#include <libutils/Vector.h>
+#include <skift/Condition.h>
+#include <skift/Lock.h>
+
+namespace Async
+{
+
+class JobGroup;
+
+struct Job
+{
+    Callback<void()> work;
+    JobGroup *group;
+};
+
+// The owner pushes and pops at the back, so it keeps working on what it just
+// split off while it's still in cache. Thieves take from the front, the
+// oldest jobs, which are usually the biggest pieces left.
+class WorkDeque
+{
+private:
+    Lock _lock{"work-deque"};
+    Vector<Job *> _jobs;
+
+public:
+    void push(Job *job)
+    {
+        LockHolder holder{_lock};
+        _jobs.push_back(job);
+    }
+
+    Job *pop()
+    {
+        LockHolder holder{_lock};
+        return _jobs.empty() ? nullptr : _jobs.pop_back();
+    }
+
+    Job *steal()
+    {
+        LockHolder holder{_lock};
+        return _jobs.empty() ? nullptr : _jobs.pop();
+    }
+};
+
+class Runtime
+{
+private:
+    // One deque per worker, plus a last one for the threads which aren't.
+    Vector<OwnPtr<WorkDeque>> _deques;
+    Vector<OwnPtr<Thread>> _workers;
+
+    Lock _lock{"parallel-runtime"};
+    Condition _has_jobs;
+
+    int _queued = 0;
+    int _sleeping = 0;
+    bool _stopping = false;
+
+    static inline Runtime *_the = nullptr;
+
+    NONCOPYABLE(Runtime);
+    NONMOVABLE(Runtime);
+
+    size_t current_deque();
+
+    Job *find_job(size_t self);
+
+    void work(size_t self);
+
+public:
+    static constexpr size_t DEFAULT_WORKERS = 4;
+
+    static Runtime &the();
+
+    size_t workers() { return _workers.count(); }
+
+    Runtime(size_t workers = DEFAULT_WORKERS);
+
+    ~Runtime();
+
+    void schedule(Job *job);
+
+    // Runs one queued job on the calling thread, returns false if there was none.
+    bool help();
+
+    static void run(Job *job);
+};
+
+// Counts the jobs spawned through it, waiting on the group lends a hand with
+// the queued jobs instead of just blocking, so jobs can wait on nested groups.
+class JobGroup
+{
+private:
+    Runtime &_runtime;
+    int _pending = 0;
+
+    NONCOPYABLE(JobGroup);
+    NONMOVABLE(JobGroup);
+
+public:
+    JobGroup(Runtime &runtime = Runtime::the())
+        : _runtime{runtime}
+    {
+    }
+
+    ~JobGroup()
+    {
+        wait();
+    }
+
+    Runtime &runtime() { return _runtime; }
+
+    bool done() { return __atomic_load_n(&_pending, __ATOMIC_SEQ_CST) == 0; }
+
+    void spawn(Callback<void()> work);
+
+    void finished();
+
+    void wait();
+};
+
+// Calls body(begin, end) on pieces of at most grain elements, splitting the
+// range in halves so idle workers steal large pieces first.
+void parallel_for(size_t begin, size_t end, size_t grain, Callback<void(size_t, size_t)> body, Runtime &runtime = Runtime::the());
+
+template <typename T>
+class Future
+{
+private:
+    struct State : public RefCounted<State>
+    {
+        JobGroup group;
+        Optional<T> value;
+
+        State(Runtime &runtime) : group{runtime} {}
+    };
+
+    RefPtr<State> _state;
+
+public:
+    Future(Callback<T()> work, Runtime &runtime = Runtime::the())
+        : _state{make<State>(runtime)}
+    {
+        auto state = _state;
+
+        _state->group.spawn([state, work = move(work)]() {
+            state->value = work();
+        });
+    }
+
+    bool done() { return _state->group.done(); }
+
+    T &get()
+    {
+        _state->group.wait();
+        return _state->value.unwrap();
+    }
+};
+
+template <typename T>
+Future<T> run(Callback<T()> work, Runtime &runtime = Runtime::the())
+{
+    return Future<T>(move(work), runtime);
+}
+
+// Nodes run once every node they depend on is done, independent ones in parallel.
+class TaskGraph
+{
+private:
+    struct Node
+    {
+        Callback<void()> work;
+        Vector<size_t> dependents;
+        int dependencies;
+    };
+
+    Vector<Node> _nodes;
+
+    void spawn(JobGroup &group, size_t index);
+
+public:
+    size_t add(Callback<void()> work)
+    {
+        _nodes.push_back({move(work), {}, 0});
+        return _nodes.count() - 1;
+    }
+
+    void depend(size_t node, size_t on)
+    {
+        _nodes[on].dependents.push_back(node);
+        _nodes[node].dependencies++;
+    }
+
+    void run(Runtime &runtime = Runtime::the());
+};
+
+} // namespace Async
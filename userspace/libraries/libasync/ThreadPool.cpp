@@ -0,0 +1,92 @@
+#include <libasync/ThreadPool.h>
+
+namespace Async
+{
+
+ThreadPool::ThreadPool(size_t workers)
+{
+    for (size_t i = 0; i < workers; i++)
+    {
+        auto worker_or_result = Thread::spawn([this]() { work(); });
+
+        if (!worker_or_result.success())
+        {
+            break;
+        }
+
+        _workers.push_back(worker_or_result.unwrap());
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    _lock.acquire();
+    _stopping = true;
+    _has_jobs.broadcast();
+    _lock.release();
+
+    // Workers finish what's left in the queue before going away.
+    _workers.clear();
+}
+
+void ThreadPool::work()
+{
+    _lock.acquire();
+
+    while (true)
+    {
+        while (_jobs.empty() && !_stopping)
+        {
+            _has_jobs.wait(_lock);
+        }
+
+        if (_jobs.empty())
+        {
+            break;
+        }
+
+        auto job = _jobs.pop();
+        _busy++;
+
+        _lock.release();
+        job();
+        _lock.acquire();
+
+        _busy--;
+
+        if (_jobs.empty() && _busy == 0)
+        {
+            _is_idle.broadcast();
+        }
+    }
+
+    _lock.release();
+}
+
+void ThreadPool::submit(Callback<void()> job)
+{
+    if (_workers.empty())
+    {
+        job();
+        return;
+    }
+
+    _lock.acquire();
+    _jobs.push_back(move(job));
+    _has_jobs.signal();
+    _lock.release();
+}
+
+void ThreadPool::wait()
+{
+    _lock.acquire();
+
+    while (!_jobs.empty() || _busy > 0)
+    {
+        _is_idle.wait(_lock);
+    }
+
+    _lock.release();
+}
+
+} // namespace Async
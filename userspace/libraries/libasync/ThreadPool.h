@@ -0,0 +1,48 @@
+#pragma once
+
+#include <libsystem/thread/Thread.h>
+#include <libutils/Callback.h>
+#include <libutils/Vector.h>
+#include <skift/Condition.h>
+#include <skift/Lock.h>
+
+namespace Async
+{
+
+// A fixed set of worker threads pulling jobs from a shared queue, for work
+// like decoding or blurring which doesn't need to happen on the main loop.
+class ThreadPool
+{
+private:
+    Lock _lock{"thread-pool"};
+    Condition _has_jobs;
+    Condition _is_idle;
+
+    Vector<Callback<void()>> _jobs;
+    Vector<OwnPtr<Thread>> _workers;
+
+    size_t _busy = 0;
+    bool _stopping = false;
+
+    NONCOPYABLE(ThreadPool);
+    NONMOVABLE(ThreadPool);
+
+    void work();
+
+public:
+    static constexpr size_t DEFAULT_WORKERS = 4;
+
+    size_t workers() { return _workers.count(); }
+
+    ThreadPool(size_t workers = DEFAULT_WORKERS);
+
+    ~ThreadPool();
+
+    // Runs the job on the calling thread if no worker could be started.
+    void submit(Callback<void()> job);
+
+    // Blocks until every job submitted so far is done.
+    void wait();
+};
+
+} // namespace Async
@@ -13,6 +13,12 @@ class Timer :
     public Source
 {
 private:
+    friend class Loop;
+
+    static constexpr size_t NOT_SCHEDULED = (size_t)-1;
+
+    size_t _heap_index = NOT_SCHEDULED;
+
     bool _running = false;
     TimeStamp _scheduled = 0;
     Timeout _interval = 0;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <abi/Syscalls.h>
+
+#include <skift/Lock.h>
+
+// Waiters sleep on a sequence number bumped by every signal, a signal sent
+// between releasing the lock and going to sleep changes it and the wait
+// returns right away instead of missing it.
+class Condition
+{
+private:
+    int _sequence = 0;
+
+    NONMOVABLE(Condition);
+    NONCOPYABLE(Condition);
+
+public:
+    constexpr Condition() {}
+
+    Result wait(Lock &lock, Timeout timeout = -1)
+    {
+        int sequence = __atomic_load_n(&_sequence, __ATOMIC_SEQ_CST);
+
+        lock.release();
+        Result result = hj_futex_wait(&_sequence, sequence, timeout);
+        lock.acquire();
+
+        return result;
+    }
+
+    void signal()
+    {
+        __atomic_add_fetch(&_sequence, 1, __ATOMIC_SEQ_CST);
+        hj_futex_wake(&_sequence, 1);
+    }
+
+    void broadcast()
+    {
+        __atomic_add_fetch(&_sequence, 1, __ATOMIC_SEQ_CST);
+        hj_futex_wake(&_sequence, __INT_MAX__);
+    }
+};
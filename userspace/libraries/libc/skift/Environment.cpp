@@ -1,14 +1,31 @@
+#include <libjson/Binary.h>
 #include <libjson/Json.h>
+#include <skift/Environment.h>
 
 static Json::Value *_root = nullptr;
 
-void environment_load(const char *buffer)
+void environment_load(const char *block)
 {
     if (_root)
     {
         delete _root;
     }
-    _root = new Json::Value(move(Json::parse(buffer, strlen(buffer))));
+
+    // The size is only known once its prefix has been read, bound it to the
+    // largest varint for now.
+    Json::Decoder prefix{reinterpret_cast<const uint8_t *>(block), 10};
+    size_t size = prefix.varint();
+
+    auto value = Json::decode(reinterpret_cast<const uint8_t *>(block) + prefix.offset, size);
+
+    if (value.is(Json::OBJECT))
+    {
+        _root = new Json::Value(move(value));
+    }
+    else
+    {
+        _root = new Json::Value(Json::Value::Object{});
+    }
 }
 
 Json::Value &environment()
@@ -31,3 +48,19 @@ String environment_copy()
         return "{}";
     }
 }
+
+Vector<uint8_t> environment_block()
+{
+    Vector<uint8_t> value;
+
+    if (_root)
+    {
+        Json::encode(value, *_root);
+    }
+
+    Vector<uint8_t> block;
+    Json::encode_varint(block, value.count());
+    block.push_back_many(value);
+
+    return block;
+}
@@ -3,8 +3,12 @@
 #include <libutils/String.h>
 #include <libjson/Json.h>
 
-void environment_load(const char *buffer);
+// New processes receive their environment as a binary encoded value (see
+// libjson/Binary.h) prefixed by its size as a varint.
+void environment_load(const char *block);
 
 Json::Value &environment();
 
 String environment_copy();
+
+Vector<uint8_t> environment_block();
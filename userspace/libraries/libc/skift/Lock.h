@@ -8,6 +8,8 @@
 
 #ifdef __KERNEL__
 #    include "kernel/interrupts/Interupts.h"
+#else
+#    include <skift/ThreadLocal.h>
 #endif
 
 class Lock
@@ -15,7 +17,12 @@ class Lock
 private:
     static constexpr auto NO_HOLDER = 0xDEADDEAD;
 
-    bool _locked = false;
+    // 0: unlocked, 1: locked, 2: locked and someone might be sleeping on it.
+    static constexpr int UNLOCKED = 0;
+    static constexpr int LOCKED = 1;
+    static constexpr int CONTENDED = 2;
+
+    int _state = UNLOCKED;
     int _holder = NO_HOLDER;
     const char *_name = "lock-not-initialized";
 
@@ -35,9 +42,7 @@ private:
 public:
     bool locked() const
     {
-        bool result;
-        __atomic_load(&_locked, &result, __ATOMIC_SEQ_CST);
-        return result;
+        return __atomic_load_n(&_state, __ATOMIC_SEQ_CST) != UNLOCKED;
     }
 
     int holder() const
@@ -60,29 +65,51 @@ public:
     {
     }
 
-    int process_this()
+    // Threads of a process share its id, in userspace they are told apart by
+    // the one in their TLS block, which also saves a syscall per acquire.
+    int holder_this()
     {
+#ifdef __KERNEL__
         int pid = 0;
         hj_process_this(&pid);
         return pid;
+#else
+        return thread_this();
+#endif
     }
 
     void acquire(Utils::SourceLocation location = Utils::SourceLocation::current())
     {
-        acquire_for(process_this(), location);
+        acquire_for(holder_this(), location);
     }
 
     void acquire_for(int holder, Utils::SourceLocation location = Utils::SourceLocation::current())
     {
-        while (!__sync_bool_compare_and_swap(&_locked, 0, 1))
-        {
-
 #ifdef __KERNEL__
+        while (!__sync_bool_compare_and_swap(&_state, UNLOCKED, LOCKED))
+        {
             ASSERT_INTERRUPTS_NOT_RETAINED();
-#endif
-
             asm("pause");
         }
+#else
+        int state = __sync_val_compare_and_swap(&_state, UNLOCKED, LOCKED);
+
+        if (state != UNLOCKED)
+        {
+            // Mark the lock as contended and sleep until it's handed over, so
+            // the holder knows it has someone to wake up.
+            if (state != CONTENDED)
+            {
+                state = __atomic_exchange_n(&_state, CONTENDED, __ATOMIC_SEQ_CST);
+            }
+
+            while (state != UNLOCKED)
+            {
+                hj_futex_wait(&_state, CONTENDED, -1);
+                state = __atomic_exchange_n(&_state, CONTENDED, __ATOMIC_SEQ_CST);
+            }
+        }
+#endif
 
         __sync_synchronize();
         _last_acquire_location = location;
@@ -91,12 +118,12 @@ public:
 
     bool try_acquire(Utils::SourceLocation location = Utils::SourceLocation::current())
     {
-        return try_acquire_for(process_this(), location);
+        return try_acquire_for(holder_this(), location);
     }
 
     bool try_acquire_for(int holder, Utils::SourceLocation location = Utils::SourceLocation::current())
     {
-        if (__sync_bool_compare_and_swap(&_locked, 0, 1))
+        if (__sync_bool_compare_and_swap(&_state, UNLOCKED, LOCKED))
         {
             __sync_synchronize();
 
@@ -115,24 +142,31 @@ public:
 
     void release(Utils::SourceLocation location = Utils::SourceLocation::current())
     {
-        release_for(process_this(), location);
+        release_for(holder_this(), location);
     }
 
     void release_for(int holder, Utils::SourceLocation location = Utils::SourceLocation::current())
     {
         ensure_acquired_for(holder, location);
 
-        __sync_synchronize();
-
-        __atomic_store_n(&_locked, 0, __ATOMIC_SEQ_CST);
-
         _last_release_location = location;
         _holder = NO_HOLDER;
+
+        __sync_synchronize();
+
+#ifdef __KERNEL__
+        __atomic_store_n(&_state, UNLOCKED, __ATOMIC_SEQ_CST);
+#else
+        if (__atomic_exchange_n(&_state, UNLOCKED, __ATOMIC_SEQ_CST) == CONTENDED)
+        {
+            hj_futex_wake(&_state, 1);
+        }
+#endif
     }
 
     void ensure_acquired(Utils::SourceLocation location = Utils::SourceLocation::current())
     {
-        ensure_acquired_for(process_this(), location);
+        ensure_acquired_for(holder_this(), location);
     }
 
     void ensure_acquired_for(int holder, Utils::SourceLocation location = Utils::SourceLocation::current())
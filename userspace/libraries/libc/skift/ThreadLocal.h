@@ -0,0 +1,46 @@
+#pragma once
+
+class Thread;
+
+// The kernel points gs (i386) or fs (x86_64) at this block, the first word
+// being a pointer to itself is how a thread finds it.
+struct ThreadLocalStorage
+{
+    ThreadLocalStorage *self;
+    Thread *thread;
+
+    // Written by hj_thread_create() before the thread starts. The main thread
+    // is 0, like it was before its block was installed.
+    int id;
+};
+
+// The main thread gets its block once a second thread shows up, until then
+// there is no one to tell it apart from.
+inline bool __thread_local_storage_ready = false;
+
+static inline ThreadLocalStorage *thread_local_storage()
+{
+    if (!__thread_local_storage_ready)
+    {
+        return nullptr;
+    }
+
+    ThreadLocalStorage *storage = nullptr;
+
+#if defined(__x86_64__)
+    asm volatile("mov %%fs:0, %0"
+                 : "=r"(storage));
+#elif defined(__i386__)
+    asm volatile("mov %%gs:0, %0"
+                 : "=r"(storage));
+#endif
+
+    return storage;
+}
+
+static inline int thread_this()
+{
+    ThreadLocalStorage *storage = thread_local_storage();
+
+    return storage ? storage->id : 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <libmath/MinMax.h>
+#include <libsystem/Common.h>
+
+namespace Compression
+{
+
+// The checksum ending zlib streams.
+// See https://tools.ietf.org/html/rfc1950#section-8.2
+class Adler32
+{
+private:
+    static constexpr uint32_t MODULO = 65521;
+
+    // The most bytes that can be summed before _b overflows.
+    static constexpr size_t BLOCK_SIZE = 5552;
+
+    uint32_t _a = 1;
+    uint32_t _b = 0;
+
+public:
+    inline void add(const uint8_t *data, size_t size)
+    {
+        while (size > 0)
+        {
+            size_t block = MIN(size, BLOCK_SIZE);
+
+            for (size_t i = 0; i < block; i++)
+            {
+                _a += data[i];
+                _b += _a;
+            }
+
+            _a %= MODULO;
+            _b %= MODULO;
+
+            data += block;
+            size -= block;
+        }
+    }
+
+    inline uint32_t checksum()
+    {
+        return (_b << 16) | _a;
+    }
+};
+
+} // namespace Compression
\ No newline at end of file
@@ -1,12 +1,791 @@
 #include <libcompression/Common.h>
 #include <libcompression/Deflate.h>
-#include <libcompression/Huffman.h>
 #include <libio/BufReader.h>
 #include <libutils/Array.h>
+#include <libutils/OwnPtr.h>
+
+#include <string.h>
+
 namespace Compression
 {
 
-Deflate::Deflate(unsigned int compression_level) : _compression_level(compression_level)
+/* --- Parameters ----------------------------------------------------------- */
+
+static constexpr size_t WINDOW_SIZE = 32768;
+static constexpr size_t MIN_MATCH = 3;
+static constexpr size_t MAX_MATCH = 258;
+
+// Enough data ahead of the position for the longest match and the hash of
+// the byte following it.
+static constexpr size_t MIN_LOOKAHEAD = MAX_MATCH + MIN_MATCH + 1;
+
+static constexpr size_t HASH_BITS = 15;
+static constexpr size_t HASH_SIZE = 1 << HASH_BITS;
+
+// Literals and matches collected before a block is written, each block gets
+// codes fitted to what it contains.
+static constexpr size_t BLOCK_SYMBOLS = 16384;
+
+static constexpr size_t LITERAL_CODES = 286;
+static constexpr size_t FIXED_LITERAL_CODES = 288;
+static constexpr size_t DISTANCE_CODES = 30;
+static constexpr size_t CODE_LENGTH_CODES = 19;
+static constexpr size_t END_OF_BLOCK = 256;
+static constexpr size_t FIRST_LENGTH_CODE = 257;
+
+// The code lengths themselves are sent with codes of at most 7 bits.
+static constexpr size_t MAX_CODE_LENGTH_CODE_BIT_LENGTH = 7;
+
+static constexpr uint8_t CODE_LENGTH_ORDER[CODE_LENGTH_CODES] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+struct CompressionParameters
+{
+    // How many earlier occurrences of the same three bytes are looked at.
+    unsigned int max_chain;
+
+    // Past a match this long, only a quarter of the chain is looked at.
+    unsigned int good_length;
+
+    // A match at least this long is taken without looking any further.
+    unsigned int nice_length;
+
+    // Whether a match is given up when the next byte starts a longer one.
+    bool lazy;
+};
+
+// Indexed by compression level, level 0 doesn't search for matches.
+static constexpr CompressionParameters COMPRESSION_PARAMETERS[] = {
+    {0, 0, 0, false},
+    {4, 4, 8, false},
+    {8, 4, 16, false},
+    {16, 4, 32, false},
+    {16, 8, 32, true},
+    {32, 8, 64, true},
+    {64, 8, 128, true},
+    {128, 8, 258, true},
+    {512, 32, 258, true},
+    {2048, 32, 258, true},
+};
+
+/* --- Codes ---------------------------------------------------------------- */
+
+template <typename T, int N>
+static inline constexpr Array<T, N> calculate_length_codes()
+{
+    Array<T, N> lookup;
+
+    for (size_t length = 0; length < MIN_MATCH; length++)
+    {
+        lookup[length] = 0;
+    }
+
+    // 258 fits in the extra bits of code 284 but has its own code, which
+    // comes last so it wins.
+    for (size_t code = 0; code < sizeof(BASE_LENGTHS) / sizeof(BASE_LENGTHS[0]); code++)
+    {
+        size_t first = BASE_LENGTHS[code];
+        size_t last = MIN(first + (1u << BASE_LENGTH_EXTRA_BITS[code]), MAX_MATCH + 1);
+
+        for (size_t length = first; length < last; length++)
+        {
+            lookup[length] = code;
+        }
+    }
+
+    return lookup;
+}
+
+static const Array<uint8_t, MAX_MATCH + 1> LENGTH_CODES = calculate_length_codes<uint8_t, MAX_MATCH + 1>();
+
+static inline size_t distance_code(size_t distance)
+{
+    if (distance <= 4)
+    {
+        return distance - 1;
+    }
+
+    // Two codes per power of two, told apart by the bit after the highest one.
+    size_t value = distance - 1;
+    size_t highest_bit = 31 - __builtin_clz(value);
+
+    return highest_bit * 2 + ((value >> (highest_bit - 1)) & 1);
+}
+
+static inline uint16_t reverse_bits(uint16_t code, size_t length)
+{
+    uint16_t reversed = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+
+    return reversed;
+}
+
+// Canonical codes for the given lengths, bit reversed since huffman codes
+// are packed starting with their most significant bit.
+// See https://tools.ietf.org/html/rfc1951#section-3.2.2
+static void build_codes(const uint8_t *lengths, size_t count, uint16_t *codes)
+{
+    uint16_t length_count[MAX_CODE_BIT_LENGTH + 1] = {};
+
+    for (size_t i = 0; i < count; i++)
+    {
+        length_count[lengths[i]]++;
+    }
+
+    length_count[0] = 0;
+
+    uint16_t next_code[MAX_CODE_BIT_LENGTH + 1] = {};
+    uint16_t code = 0;
+
+    for (size_t bits = 1; bits <= MAX_CODE_BIT_LENGTH; bits++)
+    {
+        code = (code + length_count[bits - 1]) << 1;
+        next_code[bits] = code;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        codes[i] = lengths[i] ? reverse_bits(next_code[lengths[i]]++, lengths[i]) : 0;
+    }
+}
+
+// Huffman code lengths for the given frequencies, none of them longer than
+// max_bits. At least two symbols get a code, so that even a tree with a
+// single symbol is complete.
+static void build_lengths(const uint32_t *frequencies, size_t count, uint8_t *lengths, size_t max_bits)
+{
+    uint32_t weights[FIXED_LITERAL_CODES];
+    size_t used = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        weights[i] = frequencies[i];
+        used += weights[i] != 0;
+    }
+
+    for (size_t i = 0; used < 2 && i < count; i++)
+    {
+        if (weights[i] == 0)
+        {
+            weights[i] = 1;
+            used++;
+        }
+    }
+
+    while (true)
+    {
+        // Leaves sorted by weight, followed by the internal nodes in the
+        // order they are created, whose weight doesn't decrease either. So
+        // the two lightest nodes are always at the front of one of them.
+        uint16_t symbols[FIXED_LITERAL_CODES];
+        uint32_t node_weights[FIXED_LITERAL_CODES * 2];
+        uint16_t parents[FIXED_LITERAL_CODES * 2];
+        uint16_t depths[FIXED_LITERAL_CODES * 2];
+
+        size_t leaves = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (weights[i] == 0)
+            {
+                continue;
+            }
+
+            size_t j = leaves++;
+
+            for (; j > 0 && weights[symbols[j - 1]] > weights[i]; j--)
+            {
+                symbols[j] = symbols[j - 1];
+            }
+
+            symbols[j] = i;
+        }
+
+        for (size_t i = 0; i < leaves; i++)
+        {
+            node_weights[i] = weights[symbols[i]];
+        }
+
+        size_t next_leaf = 0;
+        size_t next_node = leaves;
+        size_t nodes = leaves;
+
+        auto lightest = [&]() {
+            if (next_leaf < leaves && (next_node == nodes || node_weights[next_leaf] <= node_weights[next_node]))
+            {
+                return next_leaf++;
+            }
+
+            return next_node++;
+        };
+
+        while (nodes < leaves * 2 - 1)
+        {
+            size_t left = lightest();
+            size_t right = lightest();
+
+            node_weights[nodes] = node_weights[left] + node_weights[right];
+            parents[left] = nodes;
+            parents[right] = nodes;
+            nodes++;
+        }
+
+        // Parents always come after their children.
+        size_t deepest = 0;
+        depths[nodes - 1] = 0;
+
+        for (size_t i = nodes - 1; i-- > 0;)
+        {
+            depths[i] = depths[parents[i]] + 1;
+            deepest = MAX(deepest, depths[i]);
+        }
+
+        if (deepest <= max_bits)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                lengths[i] = 0;
+            }
+
+            for (size_t i = 0; i < leaves; i++)
+            {
+                lengths[symbols[i]] = depths[i];
+            }
+
+            return;
+        }
+
+        // Flatten the distribution until the tree is shallow enough.
+        for (size_t i = 0; i < count; i++)
+        {
+            if (weights[i])
+            {
+                weights[i] = (weights[i] >> 1) | 1;
+            }
+        }
+    }
+}
+
+/* --- Compressor ----------------------------------------------------------- */
+
+struct Symbol
+{
+    uint16_t literal_or_length;
+
+    // Zero for literals.
+    uint16_t distance;
+};
+
+struct CodeLengthSymbol
+{
+    uint8_t symbol;
+    uint8_t extra;
+};
+
+// Finds matches with hash chains, as zlib does, and writes them in blocks
+// using either the fixed codes or codes built for the block, whichever is
+// smaller.
+// See https://tools.ietf.org/html/rfc1951#section-4
+class Compressor
+{
+private:
+    IO::Reader &_reader;
+    IO::BitWriter &_writer;
+    CompressionParameters _parameters;
+
+    // Two windows of data, the first one being the history of the second. The
+    // padding lets matches be compared eight bytes at a time.
+    uint8_t _window[WINDOW_SIZE * 2 + 8] = {};
+    size_t _position = 0;
+    size_t _end = 0;
+    bool _end_of_input = false;
+
+    // Offset in the stream of the start of the window.
+    uint32_t _base = 0;
+
+    // Stream offset + 1 of the last occurrence of each hash, zero if none.
+    uint32_t _head[HASH_SIZE] = {};
+
+    // The previous occurrence with the same hash, for each offset of the window.
+    uint32_t _chain[WINDOW_SIZE] = {};
+
+    Symbol _symbols[BLOCK_SYMBOLS];
+    size_t _symbols_count = 0;
+
+    uint32_t _literal_frequencies[LITERAL_CODES] = {};
+    uint32_t _distance_frequencies[DISTANCE_CODES] = {};
+
+    uint8_t _fixed_literal_lengths[FIXED_LITERAL_CODES];
+    uint16_t _fixed_literal_codes[FIXED_LITERAL_CODES];
+    uint8_t _fixed_distance_lengths[DISTANCE_CODES];
+    uint16_t _fixed_distance_codes[DISTANCE_CODES];
+
+    Result fill()
+    {
+        // Drop what's too far behind to be matched anymore.
+        if (_position >= WINDOW_SIZE * 2 - MIN_LOOKAHEAD)
+        {
+            memmove(_window, _window + WINDOW_SIZE, _end - WINDOW_SIZE);
+
+            _position -= WINDOW_SIZE;
+            _end -= WINDOW_SIZE;
+            _base += WINDOW_SIZE;
+        }
+
+        while (!_end_of_input && _end < WINDOW_SIZE * 2)
+        {
+            size_t read = TRY(_reader.read(_window + _end, WINDOW_SIZE * 2 - _end));
+
+            _end_of_input = read == 0;
+            _end += read;
+        }
+
+        return SUCCESS;
+    }
+
+    inline size_t hash(size_t position)
+    {
+        uint32_t bytes = _window[position] | (_window[position + 1] << 8) | (_window[position + 2] << 16);
+        return (bytes * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // Returns the previous occurrence of the bytes at the position.
+    inline uint32_t insert(size_t position)
+    {
+        size_t bucket = hash(position);
+        uint32_t previous = _head[bucket];
+
+        _chain[(_base + position) & (WINDOW_SIZE - 1)] = previous;
+        _head[bucket] = _base + position + 1;
+
+        return previous;
+    }
+
+    inline void insert_range(size_t from, size_t to)
+    {
+        for (size_t position = from; position < to && position + MIN_MATCH <= _end; position++)
+        {
+            insert(position);
+        }
+    }
+
+    static inline size_t match_length(const uint8_t *a, const uint8_t *b, size_t max_length)
+    {
+        size_t length = 0;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        while (length + 8 <= max_length)
+        {
+            uint64_t a_word;
+            uint64_t b_word;
+
+            memcpy(&a_word, a + length, sizeof(a_word));
+            memcpy(&b_word, b + length, sizeof(b_word));
+
+            if (a_word != b_word)
+            {
+                return length + (__builtin_ctzll(a_word ^ b_word) >> 3);
+            }
+
+            length += 8;
+        }
+#endif
+
+        while (length < max_length && a[length] == b[length])
+        {
+            length++;
+        }
+
+        return length;
+    }
+
+    // Walks the chain of the position looking for a match longer than the
+    // one given.
+    size_t longest_match(size_t position, uint32_t candidate, size_t best_length, size_t &best_distance)
+    {
+        size_t max_length = MIN(MAX_MATCH, _end - position);
+        uint32_t current = _base + position;
+        const uint8_t *bytes = _window + position;
+
+        unsigned int chain = _parameters.max_chain;
+
+        if (best_length >= _parameters.good_length)
+        {
+            chain >>= 2;
+        }
+
+        for (; candidate != 0 && chain > 0 && best_length < max_length; chain--)
+        {
+            uint32_t match = candidate - 1;
+
+            // Chain entries further than the window have been reused.
+            if (match < _base || current - match >= WINDOW_SIZE)
+            {
+                break;
+            }
+
+            candidate = _chain[match & (WINDOW_SIZE - 1)];
+
+            const uint8_t *match_bytes = _window + (match - _base);
+
+            if (match_bytes[best_length] != bytes[best_length] || match_bytes[0] != bytes[0])
+            {
+                continue;
+            }
+
+            size_t length = match_length(match_bytes, bytes, max_length);
+
+            if (length > best_length)
+            {
+                best_length = length;
+                best_distance = current - match;
+
+                if (length >= _parameters.nice_length)
+                {
+                    break;
+                }
+            }
+        }
+
+        return best_length;
+    }
+
+    Result emit_literal(uint8_t literal)
+    {
+        _symbols[_symbols_count++] = {literal, 0};
+        _literal_frequencies[literal]++;
+
+        if (_symbols_count == BLOCK_SYMBOLS)
+        {
+            return write_block(false);
+        }
+
+        return SUCCESS;
+    }
+
+    Result emit_match(size_t length, size_t distance)
+    {
+        _symbols[_symbols_count++] = {(uint16_t)length, (uint16_t)distance};
+        _literal_frequencies[FIRST_LENGTH_CODE + LENGTH_CODES[length]]++;
+        _distance_frequencies[distance_code(distance)]++;
+
+        if (_symbols_count == BLOCK_SYMBOLS)
+        {
+            return write_block(false);
+        }
+
+        return SUCCESS;
+    }
+
+    static void encode_lengths(const uint8_t *lengths, size_t count, CodeLengthSymbol *symbols, size_t &symbols_count)
+    {
+        // See https://tools.ietf.org/html/rfc1951#section-3.2.7
+        for (size_t i = 0; i < count;)
+        {
+            uint8_t length = lengths[i];
+            size_t run = 1;
+
+            while (i + run < count && lengths[i + run] == length)
+            {
+                run++;
+            }
+
+            if (length == 0 && run >= 3)
+            {
+                for (; run >= 3;)
+                {
+                    size_t repeat = MIN(run, 138);
+
+                    symbols[symbols_count++] = repeat >= 11 ? CodeLengthSymbol{18, (uint8_t)(repeat - 11)}
+                                                            : CodeLengthSymbol{17, (uint8_t)(repeat - 3)};
+                    i += repeat;
+                    run -= repeat;
+                }
+            }
+            else if (length != 0 && run >= 4)
+            {
+                symbols[symbols_count++] = {length, 0};
+                i++;
+                run--;
+
+                for (; run >= 3;)
+                {
+                    size_t repeat = MIN(run, 6);
+
+                    symbols[symbols_count++] = {16, (uint8_t)(repeat - 3)};
+                    i += repeat;
+                    run -= repeat;
+                }
+            }
+            else
+            {
+                symbols[symbols_count++] = {length, 0};
+                i++;
+            }
+        }
+    }
+
+    static size_t code_length_extra_bits(uint8_t symbol)
+    {
+        switch (symbol)
+        {
+        case 16:
+            return 2;
+        case 17:
+            return 3;
+        case 18:
+            return 7;
+        default:
+            return 0;
+        }
+    }
+
+    void write_symbols(const uint16_t *literal_codes, const uint8_t *literal_lengths, const uint16_t *distance_codes, const uint8_t *distance_lengths)
+    {
+        for (size_t i = 0; i < _symbols_count; i++)
+        {
+            auto &symbol = _symbols[i];
+
+            if (symbol.distance == 0)
+            {
+                _writer.put_bits(literal_codes[symbol.literal_or_length], literal_lengths[symbol.literal_or_length]);
+                continue;
+            }
+
+            size_t length_code = LENGTH_CODES[symbol.literal_or_length];
+            _writer.put_bits(literal_codes[FIRST_LENGTH_CODE + length_code], literal_lengths[FIRST_LENGTH_CODE + length_code]);
+            _writer.put_bits(symbol.literal_or_length - BASE_LENGTHS[length_code], BASE_LENGTH_EXTRA_BITS[length_code]);
+
+            size_t dist_code = distance_code(symbol.distance);
+            _writer.put_bits(distance_codes[dist_code], distance_lengths[dist_code]);
+            _writer.put_bits(symbol.distance - BASE_DISTANCE[dist_code], BASE_DISTANCE_EXTRA_BITS[dist_code]);
+        }
+
+        _writer.put_bits(literal_codes[END_OF_BLOCK], literal_lengths[END_OF_BLOCK]);
+    }
+
+    Result write_block(bool final)
+    {
+        _literal_frequencies[END_OF_BLOCK] = 1;
+
+        uint8_t literal_lengths[LITERAL_CODES];
+        uint8_t distance_lengths[DISTANCE_CODES];
+
+        build_lengths(_literal_frequencies, LITERAL_CODES, literal_lengths, MAX_CODE_BIT_LENGTH);
+        build_lengths(_distance_frequencies, DISTANCE_CODES, distance_lengths, MAX_CODE_BIT_LENGTH);
+
+        size_t literal_count = LITERAL_CODES;
+        while (literal_count > FIRST_LENGTH_CODE && literal_lengths[literal_count - 1] == 0)
+        {
+            literal_count--;
+        }
+
+        size_t distance_count = DISTANCE_CODES;
+        while (distance_count > 1 && distance_lengths[distance_count - 1] == 0)
+        {
+            distance_count--;
+        }
+
+        // The lengths of both trees are sent using a third one.
+        CodeLengthSymbol code_length_symbols[LITERAL_CODES + DISTANCE_CODES];
+        size_t code_length_symbols_count = 0;
+
+        encode_lengths(literal_lengths, literal_count, code_length_symbols, code_length_symbols_count);
+        encode_lengths(distance_lengths, distance_count, code_length_symbols, code_length_symbols_count);
+
+        uint32_t code_length_frequencies[CODE_LENGTH_CODES] = {};
+
+        for (size_t i = 0; i < code_length_symbols_count; i++)
+        {
+            code_length_frequencies[code_length_symbols[i].symbol]++;
+        }
+
+        uint8_t code_length_lengths[CODE_LENGTH_CODES];
+        build_lengths(code_length_frequencies, CODE_LENGTH_CODES, code_length_lengths, MAX_CODE_LENGTH_CODE_BIT_LENGTH);
+
+        size_t code_length_count = CODE_LENGTH_CODES;
+        while (code_length_count > 4 && code_length_lengths[CODE_LENGTH_ORDER[code_length_count - 1]] == 0)
+        {
+            code_length_count--;
+        }
+
+        // The extra bits are the same either way, only the codes are compared.
+        size_t dynamic_bits = 5 + 5 + 4 + 3 * code_length_count;
+        size_t fixed_bits = 0;
+
+        for (size_t i = 0; i < code_length_symbols_count; i++)
+        {
+            auto symbol = code_length_symbols[i].symbol;
+            dynamic_bits += code_length_lengths[symbol] + code_length_extra_bits(symbol);
+        }
+
+        for (size_t i = 0; i < LITERAL_CODES; i++)
+        {
+            dynamic_bits += _literal_frequencies[i] * literal_lengths[i];
+            fixed_bits += _literal_frequencies[i] * _fixed_literal_lengths[i];
+        }
+
+        for (size_t i = 0; i < DISTANCE_CODES; i++)
+        {
+            dynamic_bits += _distance_frequencies[i] * distance_lengths[i];
+            fixed_bits += _distance_frequencies[i] * _fixed_distance_lengths[i];
+        }
+
+        _writer.put_bits(final ? 1 : 0, 1);
+
+        if (dynamic_bits < fixed_bits)
+        {
+            _writer.put_bits(BT_DYNAMIC_HUFFMAN, 2);
+            _writer.put_bits(literal_count - FIRST_LENGTH_CODE, 5);
+            _writer.put_bits(distance_count - 1, 5);
+            _writer.put_bits(code_length_count - 4, 4);
+
+            for (size_t i = 0; i < code_length_count; i++)
+            {
+                _writer.put_bits(code_length_lengths[CODE_LENGTH_ORDER[i]], 3);
+            }
+
+            uint16_t code_length_codes[CODE_LENGTH_CODES];
+            build_codes(code_length_lengths, CODE_LENGTH_CODES, code_length_codes);
+
+            for (size_t i = 0; i < code_length_symbols_count; i++)
+            {
+                auto &symbol = code_length_symbols[i];
+
+                _writer.put_bits(code_length_codes[symbol.symbol], code_length_lengths[symbol.symbol]);
+                _writer.put_bits(symbol.extra, code_length_extra_bits(symbol.symbol));
+            }
+
+            uint16_t literal_codes[LITERAL_CODES];
+            uint16_t distance_codes[DISTANCE_CODES];
+
+            build_codes(literal_lengths, LITERAL_CODES, literal_codes);
+            build_codes(distance_lengths, DISTANCE_CODES, distance_codes);
+
+            write_symbols(literal_codes, literal_lengths, distance_codes, distance_lengths);
+        }
+        else
+        {
+            _writer.put_bits(BT_FIXED_HUFFMAN, 2);
+            write_symbols(_fixed_literal_codes, _fixed_literal_lengths, _fixed_distance_codes, _fixed_distance_lengths);
+        }
+
+        _symbols_count = 0;
+        memset(_literal_frequencies, 0, sizeof(_literal_frequencies));
+        memset(_distance_frequencies, 0, sizeof(_distance_frequencies));
+
+        return _writer.flush();
+    }
+
+public:
+    Compressor(IO::Reader &reader, IO::BitWriter &writer, CompressionParameters parameters)
+        : _reader{reader}, _writer{writer}, _parameters{parameters}
+    {
+        // See https://tools.ietf.org/html/rfc1951#section-3.2.6
+        for (size_t i = 0; i < FIXED_LITERAL_CODES; i++)
+        {
+            _fixed_literal_lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+        }
+
+        for (size_t i = 0; i < DISTANCE_CODES; i++)
+        {
+            _fixed_distance_lengths[i] = 5;
+        }
+
+        build_codes(_fixed_literal_lengths, FIXED_LITERAL_CODES, _fixed_literal_codes);
+        build_codes(_fixed_distance_lengths, DISTANCE_CODES, _fixed_distance_codes);
+    }
+
+    Result compress()
+    {
+        size_t previous_length = MIN_MATCH - 1;
+        size_t previous_distance = 0;
+
+        // The byte before the position is waiting to be written, unless the
+        // match starting there turns out to be the better one.
+        bool previous_pending = false;
+
+        while (true)
+        {
+            if (_end - _position < MIN_LOOKAHEAD && !_end_of_input)
+            {
+                TRY(fill());
+            }
+
+            if (_position == _end)
+            {
+                break;
+            }
+
+            size_t length = MIN_MATCH - 1;
+            size_t distance = 0;
+
+            if (_end - _position >= MIN_MATCH)
+            {
+                uint32_t candidate = insert(_position);
+
+                if (candidate != 0 && previous_length < _parameters.nice_length)
+                {
+                    length = longest_match(_position, candidate, _parameters.lazy ? previous_length : MIN_MATCH - 1, distance);
+                }
+            }
+
+            if (!_parameters.lazy)
+            {
+                if (length >= MIN_MATCH)
+                {
+                    TRY(emit_match(length, distance));
+                    insert_range(_position + 1, _position + length);
+                    _position += length;
+                }
+                else
+                {
+                    TRY(emit_literal(_window[_position]));
+                    _position++;
+                }
+
+                continue;
+            }
+
+            if (previous_length >= MIN_MATCH && length <= previous_length)
+            {
+                TRY(emit_match(previous_length, previous_distance));
+                insert_range(_position + 1, _position - 1 + previous_length);
+
+                _position += previous_length - 1;
+                previous_pending = false;
+                previous_length = MIN_MATCH - 1;
+            }
+            else
+            {
+                if (previous_pending)
+                {
+                    TRY(emit_literal(_window[_position - 1]));
+                }
+
+                previous_pending = true;
+                previous_length = length;
+                previous_distance = distance;
+                _position++;
+            }
+        }
+
+        if (previous_pending)
+        {
+            TRY(emit_literal(_window[_position - 1]));
+        }
+
+        return write_block(true);
+    }
+};
+
+/* --- Deflate -------------------------------------------------------------- */
+
+Deflate::Deflate(unsigned int compression_level) : _compression_level(MIN(compression_level, MAX_COMPRESSION_LEVEL))
 {
     /*
 	 * The higher the compression level, the more we should bother trying to
@@ -52,7 +831,20 @@ Result Deflate::write_uncompressed_blocks(IO::Reader &in_data, IO::BitWriter &ou
 Result Deflate::compress_none(IO::Reader &uncompressed, IO::Writer &compressed)
 {
     IO::BitWriter bit_writer(compressed);
-    return write_uncompressed_blocks(uncompressed, bit_writer, true);
+    TRY(write_uncompressed_blocks(uncompressed, bit_writer, true));
+    return bit_writer.flush();
+}
+
+Result Deflate::compress_huffman(IO::Reader &uncompressed, IO::Writer &compressed)
+{
+    IO::BitWriter bit_writer(compressed);
+
+    // Too big for the stack of most threads.
+    auto compressor = own<Compressor>(uncompressed, bit_writer, COMPRESSION_PARAMETERS[_compression_level]);
+    TRY(compressor->compress());
+
+    bit_writer.align();
+    return bit_writer.flush();
 }
 
 Result Deflate::perform(IO::Reader &uncompressed, IO::Writer &compressed)
@@ -62,18 +854,18 @@ Result Deflate::perform(IO::Reader &uncompressed, IO::Writer &compressed)
 
     // If the data amount is too small it's not worth compressing it.
     // Depends on the compression level
-    if (buf_reader.buffered().unwrap() < _min_size_to_compress)
+    if (TRY(buf_reader.buffered()) < _min_size_to_compress)
         [[unlikely]]
     {
         return compress_none(buf_reader, compressed);
     }
 
-    switch (_compression_level)
+    if (_compression_level == 0)
     {
-    // TODO: set the compression method according to the level
-    default:
         return compress_none(buf_reader, compressed);
     }
+
+    return compress_huffman(buf_reader, compressed);
 }
 
 } // namespace Compression
\ No newline at end of file
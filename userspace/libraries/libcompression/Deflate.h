@@ -16,6 +16,7 @@ private:
 
     // Compression modes
     static Result compress_none(IO::Reader &uncompressed, IO::Writer &compressed);
+    Result compress_huffman(IO::Reader &uncompressed, IO::Writer &compressed);
 
     // Write functions
     static Result write_uncompressed_blocks(IO::Reader &in_data, IO::BitWriter &out_writer, bool final);
@@ -23,6 +24,10 @@ private:
     static void write_uncompressed_block(const uint8_t *block_data, size_t block_len, IO::BitWriter &out_writer, bool final);
 
 public:
+    static constexpr unsigned int MAX_COMPRESSION_LEVEL = 9;
+
+    // 0 stores the data as is, from 1 to 9 matches are searched for longer
+    // and longer, trading speed for size.
     Deflate(unsigned int compression_level);
 
     Result perform(IO::Reader &uncompressed, IO::Writer &compressed);
@@ -9,63 +9,11 @@
 #include <libio/Streams.h>
 #include <libutils/InlineRingBuffer.h>
 
+#include <string.h>
+
 namespace Compression
 {
 
-static constexpr uint8_t BASE_LENGTH_EXTRA_BITS[] = {
-    0, 0, 0, 0, 0, 0, 0, 0, //257 - 264
-    1, 1, 1, 1,             //265 - 268
-    2, 2, 2, 2,             //269 - 273
-    3, 3, 3, 3,             //274 - 276
-    4, 4, 4, 4,             //278 - 280
-    5, 5, 5, 5,             //281 - 284
-    0                       //285
-};
-
-static constexpr uint16_t BASE_LENGTHS[] = {
-    3, 4, 5, 6, 7, 8, 9, 10, //257 - 264
-    11, 13, 15, 17,          //265 - 268
-    19, 23, 27, 31,          //269 - 273
-    35, 43, 51, 59,          //274 - 276
-    67, 83, 99, 115,         //278 - 280
-    131, 163, 195, 227,      //281 - 284
-    258                      //285
-};
-
-static constexpr uint16_t BASE_DISTANCE[] = {
-    1, 2, 3, 4,   //0-3
-    5, 7,         //4-5
-    9, 13,        //6-7
-    17, 25,       //8-9
-    33, 49,       //10-11
-    65, 97,       //12-13
-    129, 193,     //14-15
-    257, 385,     //16-17
-    513, 769,     //18-19
-    1025, 1537,   //20-21
-    2049, 3073,   //22-23
-    4097, 6145,   //24-25
-    8193, 12289,  //26-27
-    16385, 24577, //28-29
-};
-
-static constexpr uint8_t BASE_DISTANCE_EXTRA_BITS[] = {
-    0, 0, 0, 0, //0-3
-    1, 1,       //4-5
-    2, 2,       //6-7
-    3, 3,       //8-9
-    4, 4,       //10-11
-    5, 5,       //12-13
-    6, 6,       //14-15
-    7, 7,       //16-17
-    8, 8,       //18-19
-    9, 9,       //20-21
-    10, 10,     //22-23
-    11, 11,     //24-25
-    12, 12,     //26-27
-    13, 13,     //28-29
-};
-
 void Inflate::get_bit_length_count(HashMap<unsigned int, unsigned int> &bit_length_count, const Vector<unsigned int> &code_bit_lengths)
 {
     for (unsigned int i = 0; i != code_bit_lengths.count(); i++)
@@ -83,7 +31,10 @@ void Inflate::get_first_code(HashMap<unsigned int, unsigned int> &first_codes, H
 {
     unsigned int code = 0;
     unsigned int prev_bl_count = 0;
-    for (unsigned int i = 1; i <= (unsigned int)bit_length_count.count(); i++)
+
+    // Every length up to the longest possible one, a length no code uses
+    // still shifts the first code of the longer ones.
+    for (unsigned int i = 1; i <= MAX_CODE_BIT_LENGTH; i++)
     {
         if (i >= 2)
         {
@@ -239,11 +190,97 @@ Result Inflate::build_dynamic_huffman_alphabet(IO::BitReader &input)
     return Result::SUCCESS;
 }
 
+// Matches reach at most 32KiB back, so instead of holding the whole output
+// until the end, it goes through a window twice that size which is handed to
+// the writer every time it fills up.
+class InflateWindow
+{
+private:
+    static constexpr size_t HISTORY = 32768;
+    static constexpr size_t SIZE = HISTORY * 2;
+
+    IO::Writer &_writer;
+    uint8_t *_data;
+    size_t _used = 0;
+    size_t _flushed = 0;
+
+    Result slide()
+    {
+        TRY(flush());
+
+        memmove(_data, _data + SIZE - HISTORY, HISTORY);
+        _used = HISTORY;
+        _flushed = HISTORY;
+
+        return SUCCESS;
+    }
+
+public:
+    InflateWindow(IO::Writer &writer)
+        : _writer{writer}, _data{new uint8_t[SIZE]}
+    {
+    }
+
+    ~InflateWindow()
+    {
+        delete[] _data;
+    }
+
+    ALWAYS_INLINE Result put(uint8_t byte)
+    {
+        if (_used == SIZE)
+        {
+            TRY(slide());
+        }
+
+        _data[_used++] = byte;
+
+        return SUCCESS;
+    }
+
+    Result repeat(size_t distance, size_t length)
+    {
+        if (distance == 0 || distance > _used)
+        {
+            IO::logln("Invalid back reference distance: {}", distance);
+            return Result::ERR_INVALID_DATA;
+        }
+
+        for (size_t i = 0; i < length; i++)
+        {
+            if (_used == SIZE)
+            {
+                TRY(slide());
+            }
+
+            _data[_used] = _data[_used - distance];
+            _used++;
+        }
+
+        return SUCCESS;
+    }
+
+    Result flush()
+    {
+        while (_flushed < _used)
+        {
+            size_t written = TRY(_writer.write(_data + _flushed, _used - _flushed));
+
+            if (written == 0)
+            {
+                return Result::ERR_NOT_WRITABLE;
+            }
+
+            _flushed += written;
+        }
+
+        return SUCCESS;
+    }
+};
+
 FLATTEN Result Inflate::read_blocks(IO::Reader &reader, IO::Writer &uncompressed)
 {
-    // We use this as our sliding window. We should write directly into "uncompressed in the future"
-    // And limit the amount of data we keep in our sliding window (Dequeue would be nice)
-    IO::MemoryWriter dest_writer{32768};
+    InflateWindow window{uncompressed};
 
     uint8_t bfinal;
     IO::BitReader bits{reader};
@@ -264,7 +301,25 @@ FLATTEN Result Inflate::read_blocks(IO::Reader &reader, IO::Writer &uncompressed
             TRY(IO::skip(reader, 2));
 
             // copy the uncompressed data
-            TRY(IO::copy(reader, dest_writer, len));
+            size_t remaining = len;
+
+            while (remaining > 0)
+            {
+                Array<uint8_t, IO::COPY_CHUNK_SIZE> chunk;
+                size_t read = TRY(reader.read(chunk.raw_storage(), MIN(chunk.count(), remaining)));
+
+                if (read == 0)
+                {
+                    break;
+                }
+
+                for (size_t i = 0; i < read; i++)
+                {
+                    TRY(window.put(chunk[i]));
+                }
+
+                remaining -= read;
+            }
         }
         else if (btype == BT_FIXED_HUFFMAN || btype == BT_DYNAMIC_HUFFMAN)
         {
@@ -292,7 +347,7 @@ FLATTEN Result Inflate::read_blocks(IO::Reader &reader, IO::Writer &uncompressed
                 if (decoded_symbol <= 255)
                 {
                     // Literal symbol
-                    IO::write<uint8_t>(dest_writer, decoded_symbol);
+                    TRY(window.put(decoded_symbol));
                 }
                 else if (decoded_symbol >= 257 && decoded_symbol <= 285)
                 {
@@ -305,12 +360,7 @@ FLATTEN Result Inflate::read_blocks(IO::Reader &reader, IO::Writer &uncompressed
 
                     unsigned int total_dist = BASE_DISTANCE[dist_code] + bits.grab_bits(BASE_DISTANCE_EXTRA_BITS[dist_code]);
 
-                    for (unsigned int i = 0; i != total_length; i++)
-                    {
-                        size_t offset = TRY(dest_writer.length()) - total_dist;
-                        uint8_t val = dest_writer.buffer()[offset];
-                        IO::write<uint8_t>(dest_writer, val);
-                    }
+                    TRY(window.repeat(total_dist, total_length));
                 }
                 else if (decoded_symbol == 256)
                 {
@@ -331,8 +381,10 @@ FLATTEN Result Inflate::read_blocks(IO::Reader &reader, IO::Writer &uncompressed
         }
     } while (!bfinal);
 
-    auto final_reader = IO::MemoryReader(Slice(dest_writer.slice()));
-    return IO::copy(final_reader, uncompressed);
+    TRY(window.flush());
+    uncompressed.flush();
+
+    return SUCCESS;
 }
 
 FLATTEN ResultOr<size_t> Inflate::perform(IO::Reader &compressed, IO::Writer &uncompressed)
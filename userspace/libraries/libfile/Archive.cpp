@@ -1,3 +1,4 @@
+#include <libasync/Parallel.h>
 #include <libfile/Archive.h>
 #include <libfile/TARArchive.h>
 #include <libfile/ZipArchive.h>
@@ -17,3 +18,31 @@ RefPtr<Archive> Archive::open(IO::Path path, bool read)
         return nullptr;
     }
 }
+
+Result Archive::extract_all(Callback<OwnPtr<IO::Writer>(const Entry &)> writer_for)
+{
+    Lock lock{"archive-extract"};
+    Result result = SUCCESS;
+
+    // Entries are compressed on their own and extract() opens its own reader
+    // on the archive, so they don't depend on each other.
+    Async::parallel_for(0, _entries.count(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            auto writer = writer_for(_entries[i]);
+            Result entry_result = writer ? extract(i, *writer) : ERR_NOT_WRITABLE;
+
+            if (entry_result != SUCCESS)
+            {
+                LockHolder holder{lock};
+
+                if (result == SUCCESS)
+                {
+                    result = entry_result;
+                }
+            }
+        }
+    });
+
+    return result;
+}
@@ -4,6 +4,8 @@
 #include <libio/Writer.h>
 #include <libsystem/Result.h>
 #include <libio/Path.h>
+#include <libutils/Callback.h>
+
 class Archive : public RefCounted<Archive>
 {
 public:
@@ -36,6 +38,10 @@ public:
     virtual Result extract(unsigned int entry_index, IO::Writer &writer) = 0;
     virtual Result insert(const char *entry_name, IO::Reader &reader) = 0;
 
+    // Extracts every entry, several at once on the parallel runtime.
+    // writer_for is called once per entry, from any thread.
+    Result extract_all(Callback<OwnPtr<IO::Writer>(const Entry &)> writer_for);
+
     inline const IO::Path &get_path()
     {
         return _path;
@@ -0,0 +1,305 @@
+#include <string.h>
+
+#include <libgraphic/Atlas.h>
+#include <libio/Streams.h>
+#include <libio/Write.h>
+#include <libsystem/system/Memory.h>
+
+namespace Graphic
+{
+
+/* --- Atlas ---------------------------------------------------------------- */
+
+static bool _atlas_loaded = false;
+static Atlas *_atlas = nullptr;
+
+Atlas *Atlas::get()
+{
+    if (_atlas_loaded)
+    {
+        return _atlas;
+    }
+
+    _atlas_loaded = true;
+
+    uintptr_t address = 0;
+    size_t size = 0;
+
+    if (memory_map_file(PATH, &address, &size) != SUCCESS)
+    {
+        return nullptr;
+    }
+
+    auto atlas = new Atlas{Slice{reinterpret_cast<const void *>(address), size}};
+
+    if (!atlas->valid())
+    {
+        IO::logln("{} is not a valid atlas, falling back to the original files", PATH);
+
+        delete atlas;
+        memory_free(address);
+
+        return nullptr;
+    }
+
+    _atlas = atlas;
+
+    return _atlas;
+}
+
+const Atlas::IconEntry *Atlas::icons() const
+{
+    auto data = static_cast<const uint8_t *>(_data.start());
+    return reinterpret_cast<const IconEntry *>(data + sizeof(Header));
+}
+
+const Atlas::FontEntry *Atlas::fonts() const
+{
+    return reinterpret_cast<const FontEntry *>(icons() + header().icon_count);
+}
+
+bool Atlas::contains(size_t offset, size_t size) const
+{
+    return offset <= _data.size() && size <= _data.size() - offset;
+}
+
+bool Atlas::valid() const
+{
+    if (!contains(0, sizeof(Header)) ||
+        header().magic != MAGIC ||
+        header().version != VERSION)
+    {
+        return false;
+    }
+
+    size_t available = _data.size() - sizeof(Header);
+
+    if (header().icon_count > available / sizeof(IconEntry))
+    {
+        return false;
+    }
+
+    available -= header().icon_count * sizeof(IconEntry);
+
+    return header().font_count <= available / sizeof(FontEntry);
+}
+
+static RefPtr<Bitmap> atlas_bitmap(const Slice &data, const Atlas::Image &image)
+{
+    if (image.width == 0 || image.width > 0x4000 || image.height > 0x4000 || image.offset % alignof(Color) != 0)
+    {
+        return nullptr;
+    }
+
+    size_t size = image.width * image.height * sizeof(Color);
+
+    if (image.offset > data.size() || size > data.size() - image.offset)
+    {
+        return nullptr;
+    }
+
+    // The atlas is mapped read-only, nothing ever draws onto icons or glyphs.
+    auto pixels = static_cast<const uint8_t *>(data.start()) + image.offset;
+
+    return Bitmap::create_static(image.width, image.height, const_cast<Color *>(reinterpret_cast<const Color *>(pixels)));
+}
+
+template <typename TEntry>
+static const TEntry *atlas_lookup(const TEntry *entries, size_t count, const char *name)
+{
+    size_t lower = 0;
+    size_t upper = count;
+
+    while (lower < upper)
+    {
+        size_t middle = lower + (upper - lower) / 2;
+        int order = strncmp(entries[middle].name, name, Atlas::NAME_SIZE);
+
+        if (order == 0)
+        {
+            return &entries[middle];
+        }
+        else if (order < 0)
+        {
+            lower = middle + 1;
+        }
+        else
+        {
+            upper = middle;
+        }
+    }
+
+    return nullptr;
+}
+
+RefPtr<Bitmap> Atlas::icon(const char *name, IconSize size) const
+{
+    auto entry = atlas_lookup(icons(), header().icon_count, name);
+
+    if (!entry)
+    {
+        return nullptr;
+    }
+
+    return atlas_bitmap(_data, entry->images[size]);
+}
+
+bool Atlas::has_icon(const char *name) const
+{
+    return atlas_lookup(icons(), header().icon_count, name) != nullptr;
+}
+
+ResultOr<RefPtr<Font>> Atlas::font(const char *name) const
+{
+    // Fonts aren't sorted, there are only a handful of them.
+    for (size_t i = 0; i < header().font_count; i++)
+    {
+        auto &entry = fonts()[i];
+
+        if (strncmp(entry.name, name, NAME_SIZE) != 0)
+        {
+            continue;
+        }
+
+        auto bitmap = atlas_bitmap(_data, entry.bitmap);
+
+        if (!bitmap ||
+            entry.glyphs_offset % alignof(Glyph) != 0 ||
+            entry.glyph_count > _data.size() / sizeof(Glyph) ||
+            !contains(entry.glyphs_offset, entry.glyph_count * sizeof(Glyph)))
+        {
+            return ERR_BAD_FONT_FILE_FORMAT;
+        }
+
+        auto data = static_cast<const uint8_t *>(_data.start());
+        auto glyphs = reinterpret_cast<const Glyph *>(data + entry.glyphs_offset);
+
+        Vector<Glyph> copy(entry.glyph_count);
+
+        for (size_t j = 0; j < entry.glyph_count; j++)
+        {
+            copy.push_back(glyphs[j]);
+        }
+
+        return make<Font>(bitmap, move(copy));
+    }
+
+    return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+}
+
+/* --- Builder -------------------------------------------------------------- */
+
+Result AtlasBuilder::add_icon(String name, RefPtr<Bitmap> bitmaps[__ICON_SIZE_COUNT])
+{
+    if (name.length() >= Atlas::NAME_SIZE)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    IconSource icon{name, {}};
+
+    for (size_t i = 0; i < __ICON_SIZE_COUNT; i++)
+    {
+        icon.bitmaps[i] = bitmaps[i];
+    }
+
+    _icons.push_back(move(icon));
+
+    return SUCCESS;
+}
+
+Result AtlasBuilder::add_font(String name, RefPtr<Bitmap> bitmap, Vector<Glyph> glyphs)
+{
+    if (name.length() >= Atlas::NAME_SIZE)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    _fonts.push_back({name, bitmap, move(glyphs)});
+
+    return SUCCESS;
+}
+
+static Atlas::Image atlas_image(RefPtr<Bitmap> bitmap, size_t &offset)
+{
+    if (!bitmap)
+    {
+        return {0, 0, 0};
+    }
+
+    Atlas::Image image{(uint32_t)offset, (uint32_t)bitmap->width(), (uint32_t)bitmap->height()};
+    offset += bitmap->width() * bitmap->height() * sizeof(Color);
+
+    return image;
+}
+
+static Result atlas_write_pixels(IO::Writer &writer, RefPtr<Bitmap> bitmap)
+{
+    if (!bitmap)
+    {
+        return SUCCESS;
+    }
+
+    TRY(writer.write(bitmap->pixels(), bitmap->width() * bitmap->height() * sizeof(Color)));
+
+    return SUCCESS;
+}
+
+Result AtlasBuilder::write(IO::Writer &writer)
+{
+    _icons.sort([](auto &left, auto &right) {
+        return strcmp(left.name.cstring(), right.name.cstring());
+    });
+
+    Atlas::Header header{Atlas::MAGIC, Atlas::VERSION, (uint32_t)_icons.count(), (uint32_t)_fonts.count()};
+    TRY(IO::write(writer, header));
+
+    size_t offset = sizeof(Atlas::Header) +
+                    _icons.count() * sizeof(Atlas::IconEntry) +
+                    _fonts.count() * sizeof(Atlas::FontEntry);
+
+    for (auto &icon : _icons)
+    {
+        Atlas::IconEntry entry{};
+        strncpy(entry.name, icon.name.cstring(), Atlas::NAME_SIZE);
+
+        for (size_t i = 0; i < __ICON_SIZE_COUNT; i++)
+        {
+            entry.images[i] = atlas_image(icon.bitmaps[i], offset);
+        }
+
+        TRY(IO::write(writer, entry));
+    }
+
+    for (auto &font : _fonts)
+    {
+        Atlas::FontEntry entry{};
+        strncpy(entry.name, font.name.cstring(), Atlas::NAME_SIZE);
+
+        entry.bitmap = atlas_image(font.bitmap, offset);
+        entry.glyphs_offset = offset;
+        entry.glyph_count = font.glyphs.count();
+        offset += font.glyphs.count() * sizeof(Glyph);
+
+        TRY(IO::write(writer, entry));
+    }
+
+    // Same order as the offsets given out above.
+    for (auto &icon : _icons)
+    {
+        for (size_t i = 0; i < __ICON_SIZE_COUNT; i++)
+        {
+            TRY(atlas_write_pixels(writer, icon.bitmaps[i]));
+        }
+    }
+
+    for (auto &font : _fonts)
+    {
+        TRY(atlas_write_pixels(writer, font.bitmap));
+        TRY(writer.write(font.glyphs.raw_storage(), font.glyphs.count() * sizeof(Glyph)));
+    }
+
+    return SUCCESS;
+}
+
+} // namespace Graphic
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <libgraphic/Bitmap.h>
+#include <libgraphic/Font.h>
+#include <libgraphic/Icon.h>
+#include <libio/Writer.h>
+#include <libutils/Slice.h>
+#include <libutils/Vector.h>
+
+namespace Graphic
+{
+
+// Icons at every size and font bitmaps, rasterized once at build time by
+// meta/utils/atlas-compiler.cpp and packed in a single file. Processes map it
+// read-only and share its pages, looking something up only means finding its
+// offset in the file.
+//
+// The file starts with a header, followed by the icons sorted by name, the
+// fonts, then the pixels and glyphs they point to. Offsets are relative to
+// the start of the file and everything is 4 bytes aligned.
+class Atlas
+{
+public:
+    static constexpr auto PATH = "/Files/graphic.atlas";
+
+    static constexpr uint32_t MAGIC = 0x534c5441; // "ATLS"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t NAME_SIZE = 32;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t icon_count;
+        uint32_t font_count;
+    };
+
+    // A width of zero stands for an image which couldn't be rasterized.
+    struct Image
+    {
+        uint32_t offset;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct IconEntry
+    {
+        char name[NAME_SIZE];
+        Image images[__ICON_SIZE_COUNT];
+    };
+
+    struct FontEntry
+    {
+        char name[NAME_SIZE];
+        Image bitmap;
+        uint32_t glyphs_offset;
+        uint32_t glyph_count;
+    };
+
+private:
+    Slice _data;
+
+    const Header &header() const { return *static_cast<const Header *>(_data.start()); }
+
+    const IconEntry *icons() const;
+
+    const FontEntry *fonts() const;
+
+    bool contains(size_t offset, size_t size) const;
+
+public:
+    // The atlas of the system, mapped the first time it's needed. Null when
+    // it is missing or invalid, callers fall back to the original files.
+    static Atlas *get();
+
+    Atlas(Slice data) : _data{data} {}
+
+    bool valid() const;
+
+    // Null if the atlas doesn't have the icon, or not at that size.
+    RefPtr<Bitmap> icon(const char *name, IconSize size) const;
+
+    bool has_icon(const char *name) const;
+
+    ResultOr<RefPtr<Font>> font(const char *name) const;
+};
+
+// Lays out icons and fonts the way Atlas expects them.
+class AtlasBuilder
+{
+private:
+    struct IconSource
+    {
+        String name;
+        RefPtr<Bitmap> bitmaps[__ICON_SIZE_COUNT];
+    };
+
+    struct FontSource
+    {
+        String name;
+        RefPtr<Bitmap> bitmap;
+        Vector<Glyph> glyphs;
+    };
+
+    Vector<IconSource> _icons;
+    Vector<FontSource> _fonts;
+
+public:
+    // Bitmaps can be null for sizes the icon doesn't have.
+    Result add_icon(String name, RefPtr<Bitmap> bitmaps[__ICON_SIZE_COUNT]);
+
+    Result add_font(String name, RefPtr<Bitmap> bitmap, Vector<Glyph> glyphs);
+
+    Result write(IO::Writer &writer);
+};
+
+} // namespace Graphic
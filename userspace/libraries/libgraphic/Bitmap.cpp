@@ -1,4 +1,5 @@
 #include <libgraphic/Bitmap.h>
+#include <libgraphic/Scaling.h>
 #include <libgraphic/png/Png.h>
 #include <libgraphic/svg/Svg.h>
 #include <libio/Copy.h>
@@ -95,8 +96,48 @@ RefPtr<Bitmap> Bitmap::load_from_or_placeholder(String path, int size_hint)
 
 Result Bitmap::save_to(String path)
 {
-    UNUSED(path);
-    return Result::ERR_NOT_IMPLEMENTED;
+    IO::Path p = IO::Path::parse(path);
+    if (p.extension() != ".png")
+    {
+        IO::logln("Unknown bitmap extension: {}", p.extension());
+        return Result::ERR_NOT_IMPLEMENTED;
+    }
+
+    IO::File file{path, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    if (!file.exist())
+    {
+        return ERR_NOT_WRITABLE;
+    }
+
+    return Png::save(file, *this);
+}
+
+RefPtr<Bitmap> Bitmap::scaled(Math::Recti source, Math::Vec2i size)
+{
+    bool stale = __atomic_exchange_n(&_scaled_stale, false, __ATOMIC_RELAXED);
+
+    if (_scaled && !stale && _scaled_source == source && _scaled->size() == size)
+    {
+        return _scaled;
+    }
+
+    _scaled = nullptr;
+
+    auto bitmap_or_result = create_shared(size.x(), size.y());
+
+    if (!bitmap_or_result.success())
+    {
+        return nullptr;
+    }
+
+    auto bitmap = bitmap_or_result.unwrap();
+    scale(*this, source, *bitmap, bitmap->bound(), bitmap->bound(), ScalingBlending::COPY);
+
+    _scaled = bitmap;
+    _scaled_source = source;
+
+    return _scaled;
 }
 
 Bitmap::~Bitmap()
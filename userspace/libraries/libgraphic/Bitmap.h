@@ -41,6 +41,10 @@ private:
     BitmapFiltering _filtering;
     Color *_pixels;
 
+    RefPtr<Bitmap> _scaled;
+    Math::Recti _scaled_source;
+    bool _scaled_stale = false;
+
     NONCOPYABLE(Bitmap);
     NONMOVABLE(Bitmap);
 
@@ -65,7 +69,13 @@ public:
     Math::Vec2i size() const { return Math::Vec2i(_width, _height); }
     Math::Recti bound() const { return Math::Recti(_width, _height); }
 
-    void filtering(BitmapFiltering filtering) { _filtering = filtering; }
+    BitmapFiltering filtering() const { return _filtering; }
+
+    void filtering(BitmapFiltering filtering)
+    {
+        _filtering = filtering;
+        _scaled = nullptr;
+    }
 
     static RefPtr<Bitmap> placeholder();
 
@@ -81,6 +91,26 @@ public:
 
     Result save_to(String path);
 
+    // The `source` rectangle resampled to `size`, kept until the next call
+    // asks for something else, so an image shown at the same size over and
+    // over is only scaled once. Null if there's no memory for it.
+    //
+    // Drawing onto the bitmap with a Painter makes it stale, writing its
+    // pixels directly doesn't. Painters on other threads may draw onto the
+    // bitmap at the same time, but scaling it while anything draws onto it
+    // or scales it on another thread is not safe.
+    RefPtr<Bitmap> scaled(Math::Recti source, Math::Vec2i size);
+
+    // Called by painters before each write, down to single pixels, so it
+    // only stores when the flag actually changes.
+    void did_change()
+    {
+        if (!__atomic_load_n(&_scaled_stale, __ATOMIC_RELAXED))
+        {
+            __atomic_store_n(&_scaled_stale, true, __ATOMIC_RELAXED);
+        }
+    }
+
     void set_pixel(Math::Vec2i position, Color color)
     {
         if (bound().contains(position))
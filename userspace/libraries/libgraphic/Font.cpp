@@ -1,5 +1,6 @@
 #include <stdio.h>
 
+#include <libgraphic/Atlas.h>
 #include <libgraphic/Font.h>
 #include <libio/File.h>
 #include <libio/Format.h>
@@ -41,6 +42,19 @@ ResultOr<RefPtr<Font>> Font::get(String name)
 {
     if (!_fonts.has_key(name))
     {
+        auto atlas = Atlas::get();
+
+        if (atlas)
+        {
+            auto font_or_error = atlas->font(name.cstring());
+
+            if (font_or_error.success())
+            {
+                _fonts[name] = font_or_error.unwrap();
+                return _fonts[name];
+            }
+        }
+
         auto glyph_or_error = font_load_glyph(name);
 
         if (!glyph_or_error.success())
@@ -63,30 +77,85 @@ ResultOr<RefPtr<Font>> Font::get(String name)
     return _fonts[name];
 }
 
-bool Font::has(Codepoint codepoint) const
+Font::Font(RefPtr<Bitmap> bitmap, Vector<Glyph> glyphs)
+    : _bitmap(bitmap),
+      _glyphs(move(glyphs))
 {
-    for (int i = 0; _glyphs[i].codepoint != 0; i++)
+    for (size_t i = 0; i < DENSE_GLYPH_COUNT; i++)
+    {
+        _dense_glyphs[i] = -1;
+    }
+
+    bool sorted = true;
+
+    for (size_t i = 0; i < _glyphs.count() && _glyphs[i].codepoint != 0; i++)
     {
-        if (_glyphs[i].codepoint == codepoint)
+        Codepoint codepoint = _glyphs[i].codepoint;
+
+        if (codepoint < DENSE_GLYPH_COUNT)
+        {
+            if (_dense_glyphs[codepoint] < 0)
+            {
+                _dense_glyphs[codepoint] = i;
+            }
+        }
+        else
         {
-            return true;
+            if (_sparse_glyphs.any() && _glyphs[_sparse_glyphs.peek_back()].codepoint >= codepoint)
+            {
+                sorted = false;
+            }
+
+            _sparse_glyphs.push_back(i);
         }
     }
 
-    return false;
+    if (!sorted)
+    {
+        _sparse_glyphs.sort([&](int left, int right) {
+            if (_glyphs[left].codepoint != _glyphs[right].codepoint)
+            {
+                return _glyphs[left].codepoint > _glyphs[right].codepoint ? 1 : -1;
+            }
+
+            return left - right;
+        });
+    }
+
+    _default = glyph(U'?');
 }
 
-const Glyph &Font::glyph(Codepoint codepoint) const
+int Font::lookup(Codepoint codepoint) const
 {
-    for (int i = 0; _glyphs[i].codepoint != 0; i++)
+    if (codepoint < DENSE_GLYPH_COUNT)
+    {
+        return _dense_glyphs[codepoint];
+    }
+
+    size_t lower = 0;
+    size_t upper = _sparse_glyphs.count();
+
+    while (lower < upper)
     {
-        if (_glyphs[i].codepoint == codepoint)
+        size_t middle = lower + (upper - lower) / 2;
+
+        if (_glyphs[_sparse_glyphs[middle]].codepoint < codepoint)
         {
-            return _glyphs[i];
+            lower = middle + 1;
+        }
+        else
+        {
+            upper = middle;
         }
     }
 
-    return _default;
+    if (lower < _sparse_glyphs.count() &&
+        _glyphs[_sparse_glyphs[lower]].codepoint == codepoint)
+    {
+        return _sparse_glyphs[lower];
+    }
+
+    return -1;
 }
 
 Math::Recti Font::mesure(Codepoint codepoint) const
@@ -96,8 +165,25 @@ Math::Recti Font::mesure(Codepoint codepoint) const
     return {g.advance, metrics().lineheight()};
 }
 
-Math::Recti Font::mesure(const char *string) const
+int Font::mesure_width(const char *string) const
 {
+    size_t length = strlen(string);
+    uint32_t string_hash = hash(string, length);
+
+    if (_mesure_cache.empty())
+    {
+        _mesure_cache.resize(MESURE_CACHE_SIZE);
+    }
+
+    auto &entry = _mesure_cache[string_hash % MESURE_CACHE_SIZE];
+
+    if (entry.hash == string_hash &&
+        entry.text.length() == length &&
+        memcmp(entry.text.cstring(), string, length) == 0)
+    {
+        return entry.width;
+    }
+
     int width = 0;
 
     codepoint_foreach(reinterpret_cast<const uint8_t *>(string), [&](auto codepoint) {
@@ -105,19 +191,19 @@ Math::Recti Font::mesure(const char *string) const
         width += g.advance;
     });
 
-    return Math::Recti(width, metrics().lineheight());
+    entry = {string_hash, width, String{string, length}};
+
+    return width;
 }
 
-Math::Recti Font::mesure_with_fulllineheight(const char *string)
+Math::Recti Font::mesure(const char *string) const
 {
-    int width = 0;
-
-    codepoint_foreach(reinterpret_cast<const uint8_t *>(string), [&](auto codepoint) {
-        auto &g = glyph(codepoint);
-        width += g.advance;
-    });
+    return Math::Recti(mesure_width(string), metrics().lineheight());
+}
 
-    return Math::Recti(width, metrics().fulllineheight());
+Math::Recti Font::mesure_with_fulllineheight(const char *string)
+{
+    return Math::Recti(mesure_width(string), metrics().fulllineheight());
 }
 
 } // namespace Graphic
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libgraphic/Bitmap.h>
+#include <libutils/Array.h>
 #include <libutils/String.h>
 #include <libutils/Vector.h>
 #include <libutils/unicode/Codepoint.h>
@@ -52,10 +53,33 @@ struct Glyph
 class Font : public RefCounted<Font>
 {
 private:
+    static constexpr size_t DENSE_GLYPH_COUNT = 256;
+    static constexpr size_t MESURE_CACHE_SIZE = 256;
+
+    struct MesureCacheEntry
+    {
+        uint32_t hash;
+        int width;
+        String text;
+    };
+
     RefPtr<Bitmap> _bitmap;
     Glyph _default;
     Vector<Glyph> _glyphs;
 
+    // ASCII and Latin-1 glyphs are looked up directly, the other ones through
+    // an index sorted by codepoint.
+    Array<int, DENSE_GLYPH_COUNT> _dense_glyphs;
+    Vector<int> _sparse_glyphs{};
+
+    // Widths of recently mesured strings, indexed by the hash of the string.
+    // Mesuring doesn't change the font, so const methods fill it too.
+    mutable Vector<MesureCacheEntry> _mesure_cache{};
+
+    int lookup(Codepoint codepoint) const;
+
+    int mesure_width(const char *string) const;
+
 public:
     const FontMetrics metrics() const
     {
@@ -66,16 +90,24 @@ public:
 
     static ResultOr<RefPtr<Font>> get(String name);
 
-    Font(RefPtr<Bitmap> bitmap, Vector<Glyph> glyphs)
-        : _bitmap(bitmap),
-          _glyphs(move(glyphs))
+    Font(RefPtr<Bitmap> bitmap, Vector<Glyph> glyphs);
+
+    bool has(Codepoint codepoint) const
     {
-        _default = glyph(U'?');
+        return lookup(codepoint) >= 0;
     }
 
-    bool has(Codepoint codepoint) const;
+    const Glyph &glyph(Codepoint codepoint) const
+    {
+        int index = lookup(codepoint);
 
-    const Glyph &glyph(Codepoint codepoint) const;
+        if (index < 0)
+        {
+            return _default;
+        }
+
+        return _glyphs[index];
+    }
 
     Math::Recti mesure(Codepoint codepoint) const;
 
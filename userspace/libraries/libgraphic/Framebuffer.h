@@ -23,6 +23,8 @@ public:
 
     Painter &painter() { return _painter; }
 
+    RefPtr<Bitmap> bitmap() { return _bitmap; }
+
     Math::Recti resolution() { return _bitmap->bound(); }
 
     Framebuffer(Handle handle, RefPtr<Bitmap> bitmap);
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <libgraphic/Atlas.h>
 #include <libgraphic/Icon.h>
 #include <libio/Format.h>
 #include <libio/Path.h>
@@ -18,6 +19,23 @@ const int _icon_sizes[] = {ICON_SIZE_LIST(ICON_SIZES_ENTRY)};
 static RefPtr<Icon> icon_load(String name)
 {
     auto icon = make<Icon>(name);
+    auto atlas = Atlas::get();
+
+    if (atlas && atlas->has_icon(name.cstring()))
+    {
+        for (size_t i = 0; i < __ICON_SIZE_COUNT; i++)
+        {
+            auto size = static_cast<IconSize>(i);
+            auto bitmap = atlas->icon(name.cstring(), size);
+
+            if (bitmap)
+            {
+                icon->set_bitmap(size, bitmap);
+            }
+        }
+
+        return icon;
+    }
 
     for (size_t i = 0; i < __ICON_SIZE_COUNT; i++)
     {
@@ -1,8 +1,11 @@
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <libasync/Parallel.h>
 #include <libgraphic/Font.h>
 #include <libgraphic/Painter.h>
+#include <libgraphic/Scaling.h>
 #include <libgraphic/StackBlur.h>
 #include <libutils/Assert.h>
 #include <libutils/Random.h>
@@ -10,6 +13,13 @@
 namespace Graphic
 {
 
+// Rows (or columns) per job when blurring, big enough for a job to be worth
+// the scheduling, small enough to keep every worker busy on a window.
+static constexpr size_t BLUR_TILE_SIZE = 32;
+
+// Largest image kept scaled by blit() with a BitmapScaling, a 1440p screen.
+static constexpr int SCALED_CACHE_AREA = 2560 * 1440;
+
 Painter::Painter(RefPtr<Bitmap> bitmap)
 {
     _bitmap = bitmap;
@@ -56,6 +66,10 @@ Math::Recti Painter::apply_clip(Math::Recti rectangle)
         rectangle = rectangle.clipped_with(clip());
         rectangle = rectangle.clipped_with(_bitmap->bound());
 
+        // Everything drawing more than a pixel clips its destination first,
+        // right before writing to it.
+        _bitmap->did_change();
+
         return rectangle;
     }
     else
@@ -112,6 +126,7 @@ void Painter::plot(Math::Vec2i position, Color color)
 
     if (clip().contains(transformed))
     {
+        _bitmap->did_change();
         _bitmap->blend_pixel(transformed, color);
     }
 }
@@ -125,38 +140,67 @@ void Painter::blit_fast(Bitmap &bitmap, Math::Recti source, Math::Recti destinat
         return;
     }
 
+    if (!bitmap.bound().contains(Math::Recti{result.source.position(), result.destination.size()}))
+    {
+        for (int y = 0; y < result.destination.height(); y++)
+        {
+            for (int x = 0; x < result.destination.width(); x++)
+            {
+                Math::Vec2i position(x, y);
+
+                Color sample = bitmap.get_pixel(result.source.position() + position);
+                _bitmap->blend_pixel(result.destination.position() + position, sample);
+            }
+        }
+
+        return;
+    }
+
     for (int y = 0; y < result.destination.height(); y++)
     {
-        for (int x = 0; x < result.destination.width(); x++)
+        Color *from = bitmap.pixels() + (result.source.y() + y) * bitmap.width() + result.source.x();
+        Color *to = _bitmap->pixels() + (result.destination.y() + y) * _bitmap->width() + result.destination.x();
+
+        int width = result.destination.width();
+        int x = 0;
+
+        // Runs of opaque pixels, all of them for most bitmaps, are copied as is.
+        while (x < width)
         {
-            Math::Vec2i position(x, y);
+            int run = x;
 
-            Color sample = bitmap.get_pixel(result.source.position() + position);
-            _bitmap->blend_pixel(result.destination.position() + position, sample);
+            while (run < width && from[run].alpha() == 0xff)
+            {
+                run++;
+            }
+
+            if (run > x)
+            {
+                memcpy(static_cast<void *>(to + x), from + x, (run - x) * sizeof(Color));
+                x = run;
+            }
+            else
+            {
+                to[x] = Color::blend(from[x], to[x]);
+                x++;
+            }
         }
     }
 }
 
 void Painter::blit_scaled(Bitmap &bitmap, Math::Recti source, Math::Recti destination)
 {
-    auto result = apply(source, destination);
+    // Scaled from the whole destination, not just the part within the clip,
+    // or pixels would shift around as the clip changes.
+    Math::Recti transformed_destination = apply_transform(destination);
+    Math::Recti clipped_destination = apply_clip(transformed_destination);
 
-    if (result.is_empty())
+    if (clipped_destination.is_empty())
     {
         return;
     }
 
-    for (int y = 0; y < result.destination.height(); y++)
-    {
-        for (int x = 0; x < result.destination.width(); x++)
-        {
-            float xx = x / (float)result.destination.width();
-            float yy = y / (float)result.destination.height();
-
-            Color sample = bitmap.sample(result.source, Math::Vec2f(xx, yy));
-            _bitmap->blend_pixel(result.destination.position() + Math::Vec2i(x, y), sample);
-        }
-    }
+    scale(bitmap, source, *_bitmap, transformed_destination, clipped_destination, ScalingBlending::BLEND);
 }
 
 FLATTEN void Painter::blit(Bitmap &bitmap, Math::Recti source, Math::Recti destination)
@@ -174,26 +218,43 @@ FLATTEN void Painter::blit(Bitmap &bitmap, Math::Recti source, Math::Recti desti
 
 void Painter::blit(Bitmap &bitmap, BitmapScaling scaling, Math::Recti destionation)
 {
+    Math::Recti bound;
+
     if (scaling == BitmapScaling::COVER)
     {
-        blit(bitmap, bitmap.bound(), bitmap.bound().cover(destionation));
+        bound = bitmap.bound().cover(destionation);
     }
     else if (scaling == BitmapScaling::STRETCH)
     {
-        blit(bitmap, bitmap.bound(), destionation);
+        bound = destionation;
     }
     else if (scaling == BitmapScaling::CENTER)
     {
-        blit(bitmap, bitmap.bound(), bitmap.bound().centered_within(destionation));
+        bound = bitmap.bound().centered_within(destionation);
     }
     else if (scaling == BitmapScaling::FIT)
     {
-        blit(bitmap, bitmap.bound(), bitmap.bound().fit(destionation));
+        bound = bitmap.bound().fit(destionation);
     }
     else
     {
         ASSERT_NOT_REACHED();
     }
+
+    // Images laid out this way are painted again and again at the same size,
+    // keep them scaled unless that takes more memory than is reasonable.
+    if (bound.size() != bitmap.size() && bound.area() <= SCALED_CACHE_AREA)
+    {
+        auto scaled = bitmap.scaled(bitmap.bound(), bound.size());
+
+        if (scaled)
+        {
+            blit_fast(*scaled, scaled->bound(), bound);
+            return;
+        }
+    }
+
+    blit(bitmap, bitmap.bound(), bound);
 }
 
 FLATTEN void Painter::clear(Color color)
@@ -576,10 +637,42 @@ FLATTEN void Painter::blit_colored(Bitmap &bitmap, Math::Recti source, Math::Rec
     }
 }
 
-void Painter::draw_glyph(Font &font, const Glyph &glyph, Math::Vec2i position, Color color)
+void Painter::blit_glyph(Font &font, const Glyph &glyph, Math::Vec2i position, Color color)
 {
-    Math::Recti dest(position - glyph.origin, glyph.bound.size());
+    Math::Recti destination = apply_transform({position - glyph.origin, glyph.bound.size()});
+    Math::Recti clipped_destination = apply_clip(destination);
 
+    if (clipped_destination.is_empty())
+    {
+        return;
+    }
+
+    // Glyphs are never scaled, so their coverage is read straight from the
+    // font bitmap instead of being sampled.
+    Bitmap &bitmap = font.bitmap();
+    Math::Vec2i source = glyph.bound.position() + (clipped_destination.position() - destination.position());
+
+    for (int y = 0; y < clipped_destination.height(); y++)
+    {
+        for (int x = 0; x < clipped_destination.width(); x++)
+        {
+            Math::Vec2i offset(x, y);
+
+            uint8_t coverage = bitmap.get_pixel(source + offset).red();
+
+            if (coverage == 0)
+            {
+                continue;
+            }
+
+            auto alpha = coverage * color.alpha() / 255;
+            _bitmap->blend_pixel_no_check(clipped_destination.position() + offset, color.with_alpha_byte(alpha));
+        }
+    }
+}
+
+void Painter::draw_glyph(Font &font, const Glyph &glyph, Math::Vec2i position, Color color)
+{
     // auto metrics = font.metrics();
     // auto baseline = position.y();
     //
@@ -594,16 +687,39 @@ void Painter::draw_glyph(Font &font, const Glyph &glyph, Math::Vec2i position, C
     //  draw_metric(metrics.descend(baseline), Colors::ORANGE);
     //  draw_metric(metrics.fulldescend(baseline), Colors::RED);
 
-    blit_colored(font.bitmap(), glyph.bound, dest, color);
+    blit_glyph(font, glyph, position, color);
 }
 
 FLATTEN void Painter::draw_string(Font &font, const char *str, Math::Vec2i position, Color color)
 {
-    codepoint_foreach(reinterpret_cast<const uint8_t *>(str), [&](auto codepoint) {
+    // No glyph reaches further than a line away from the baseline, so the
+    // whole string can be skipped when that band is clipped out.
+    int lineheight = font.metrics().fulllineheight();
+    int baseline = position.y() + origin().y();
+
+    if (baseline + lineheight <= clip().y() ||
+        baseline - lineheight >= clip().y() + clip().height())
+    {
+        return;
+    }
+
+    int clip_right = clip().x() + clip().width() - origin().x();
+
+    for (auto cursor = reinterpret_cast<const uint8_t *>(str); *cursor;)
+    {
+        Codepoint codepoint = 0;
+        cursor += utf8_to_codepoint(cursor, &codepoint);
+
         auto &glyph = font.glyph(codepoint);
-        draw_glyph(font, glyph, position, color);
+
+        if (position.x() - glyph.origin.x() >= clip_right)
+        {
+            break;
+        }
+
+        blit_glyph(font, glyph, position, color);
         position = position + Math::Vec2i(glyph.advance, 0);
-    });
+    }
 }
 
 void Painter::draw_string_within(Font &font, const char *str, Math::Recti container, Anchor anchor, Color color)
@@ -621,12 +737,23 @@ FLATTEN void Painter::blur(Math::Recti rectangle, int radius)
 {
     rectangle = apply(rectangle);
 
-    stackblur((unsigned char *)_bitmap->pixels(),
-              _bitmap->width(),
-              _bitmap->height(),
-              radius,
-              rectangle.x(), rectangle.x() + rectangle.width(),
-              rectangle.y(), rectangle.y() + rectangle.height());
+    if (rectangle.is_empty())
+    {
+        return;
+    }
+
+    auto pixels = (unsigned char *)_bitmap->pixels();
+    int width = _bitmap->width();
+
+    // Rows are blurred on their own then columns, each pass is split in tiles
+    // for the workers, the second one starts once the first one is done.
+    Async::parallel_for(rectangle.top(), rectangle.bottom(), BLUR_TILE_SIZE, [&](size_t begin, size_t end) {
+        stackblur_rows(pixels, width, radius, rectangle.left(), rectangle.right(), begin, end);
+    });
+
+    Async::parallel_for(rectangle.left(), rectangle.right(), BLUR_TILE_SIZE, [&](size_t begin, size_t end) {
+        stackblur_columns(pixels, width, radius, rectangle.top(), rectangle.bottom(), begin, end);
+    });
 }
 
 FLATTEN void Painter::saturation(Math::Recti rectangle, float value)
@@ -124,6 +124,8 @@ private:
 
     void blit_colored(Bitmap &src, Math::Recti source, Math::Recti destination, Color color);
 
+    void blit_glyph(Font &font, const Glyph &glyph, Math::Vec2i position, Color color);
+
     void draw_circle_helper(Math::Recti bound, Math::Vec2i center, int radius, int thickness, Color color);
 };
 
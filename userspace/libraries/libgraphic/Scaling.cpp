@@ -0,0 +1,496 @@
+#include <string.h>
+
+#include <libasync/Parallel.h>
+#include <libgraphic/Scaling.h>
+#include <libutils/Vector.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#    define SCALING_SSE2
+#    include <cpuid.h>
+#    include <emmintrin.h>
+#endif
+
+namespace Graphic
+{
+
+// Rows per job, same trade-off as when blurring.
+static constexpr size_t SCALING_TILE_SIZE = 32;
+
+// Weights along an axis sum to WEIGHT_ONE. In between the two passes opaque
+// rows keep each channel times 1 << OPAQUE_SHIFT, which still fits the 16 bits
+// signed multiplies SSE2 has, other rows are premultiplied and need 32 bits.
+static constexpr int WEIGHT_SHIFT = 12;
+static constexpr int WEIGHT_ONE = 1 << WEIGHT_SHIFT;
+static constexpr int OPAQUE_SHIFT = 7;
+
+/* --- Kernels -------------------------------------------------------------- */
+
+// Where the pixels along one axis of the destination come from: `taps` source
+// pixels each and their weights. Pixels which need fewer are padded with null
+// weights, and `taps` is even so SSE2 can go through them in pairs.
+struct ScalingKernel
+{
+    int taps = 2;
+    Vector<int> indexes;
+    Vector<int16_t> weights;
+
+    const int *indexes_of(int pixel) const { return indexes.raw_storage() + pixel * taps; }
+
+    const int16_t *weights_of(int pixel) const { return weights.raw_storage() + pixel * taps; }
+};
+
+// `offset` and `length` are the span of the source along the axis, `limit` the
+// size of the bitmap, indexes are clamped to it. Only destination pixels from
+// `begin` to `end` get an entry.
+static ScalingKernel scaling_kernel(BitmapFiltering filtering, int offset, int length, int limit, int destination, int begin, int end)
+{
+    ScalingKernel kernel;
+
+    bool downscaling = filtering == BitmapFiltering::LINEAR && length > destination;
+
+    if (downscaling)
+    {
+        // As many as the widest pixel covers, when the sizes divide evenly
+        // that's just their ratio.
+        kernel.taps = 0;
+
+        for (int i = begin; i < end; i++)
+        {
+            int64_t first = i * (int64_t)length / destination;
+            int64_t last = ((i + 1) * (int64_t)length + destination - 1) / destination;
+
+            kernel.taps = MAX(kernel.taps, (int)(last - first));
+        }
+
+        kernel.taps += kernel.taps % 2;
+    }
+
+    kernel.indexes.resize((end - begin) * kernel.taps);
+    kernel.weights.resize((end - begin) * kernel.taps);
+
+    auto clamped = [&](int64_t index) {
+        return (int)clamp(offset + index, 0, limit - 1);
+    };
+
+    for (int i = begin; i < end; i++)
+    {
+        int *indexes = kernel.indexes.raw_storage() + (i - begin) * kernel.taps;
+        int16_t *weights = kernel.weights.raw_storage() + (i - begin) * kernel.taps;
+
+        if (filtering == BitmapFiltering::NEAREST)
+        {
+            int64_t index = (2 * i + 1) * (int64_t)length / (2 * destination);
+
+            indexes[0] = indexes[1] = clamped(index);
+            weights[0] = WEIGHT_ONE;
+            weights[1] = 0;
+        }
+        else if (downscaling)
+        {
+            // In 1/destination of a source pixel, the destination pixel spans
+            // [start, stop) and each source pixel `destination` units.
+            int64_t start = i * (int64_t)length;
+            int64_t stop = start + length;
+
+            int tap = 0;
+            int total = 0;
+            int largest = 0;
+
+            for (int64_t j = start / destination; j * destination < stop; j++, tap++)
+            {
+                int64_t overlap = MIN(stop, (j + 1) * destination) - MAX(start, j * destination);
+
+                indexes[tap] = clamped(j);
+                weights[tap] = (overlap * WEIGHT_ONE + length / 2) / length;
+                total += weights[tap];
+
+                if (weights[tap] > weights[largest])
+                {
+                    largest = tap;
+                }
+            }
+
+            // Rounding shouldn't make the image darker or brighter.
+            weights[largest] += WEIGHT_ONE - total;
+
+            for (; tap < kernel.taps; tap++)
+            {
+                indexes[tap] = indexes[tap - 1];
+                weights[tap] = 0;
+            }
+        }
+        else
+        {
+            // Pixel centers are lined up, so the edges of both images match.
+            int64_t center = (2 * i + 1) * (int64_t)length * WEIGHT_ONE / (2 * destination) - WEIGHT_ONE / 2;
+            int64_t whole = center >> WEIGHT_SHIFT;
+            int fraction = center - (whole << WEIGHT_SHIFT);
+
+            indexes[0] = clamped(whole);
+            indexes[1] = clamped(whole + 1);
+            weights[0] = WEIGHT_ONE - fraction;
+            weights[1] = fraction;
+        }
+    }
+
+    return kernel;
+}
+
+static int32_t weight_pair(const int16_t *weights)
+{
+    uint32_t pair;
+    memcpy(&pair, weights, sizeof(pair));
+    return pair;
+}
+
+/* --- Scalar --------------------------------------------------------------- */
+
+// The first pass combines the source rows of a destination row, the second
+// one the columns of that. Rows are given starting at the first column.
+
+static uint8_t scale_rows_opaque_scalar(const Color *const *rows, const int16_t *weights, int taps, int begin, int end, int16_t *out)
+{
+    constexpr int SHIFT = WEIGHT_SHIFT - OPAQUE_SHIFT;
+    constexpr int ROUND = 1 << (SHIFT - 1);
+
+    uint8_t alpha = 0xff;
+
+    for (int x = begin; x < end; x++)
+    {
+        int red = 0, green = 0, blue = 0;
+
+        for (int k = 0; k < taps; k++)
+        {
+            Color color = rows[k][x];
+
+            red += color.red() * weights[k];
+            green += color.green() * weights[k];
+            blue += color.blue() * weights[k];
+            alpha &= color.alpha();
+        }
+
+        out[x * 4 + 0] = (red + ROUND) >> SHIFT;
+        out[x * 4 + 1] = (green + ROUND) >> SHIFT;
+        out[x * 4 + 2] = (blue + ROUND) >> SHIFT;
+        out[x * 4 + 3] = 0xff << OPAQUE_SHIFT;
+    }
+
+    return alpha;
+}
+
+static void scale_columns_opaque_scalar(const int16_t *in, const ScalingKernel &kernel, int begin, int end, Color *out)
+{
+    constexpr int SHIFT = WEIGHT_SHIFT + OPAQUE_SHIFT;
+    constexpr int ROUND = 1 << (SHIFT - 1);
+
+    for (int i = begin; i < end; i++)
+    {
+        const int *indexes = kernel.indexes_of(i);
+        const int16_t *weights = kernel.weights_of(i);
+
+        int red = 0, green = 0, blue = 0;
+
+        for (int k = 0; k < kernel.taps; k++)
+        {
+            const int16_t *pixel = in + indexes[k] * 4;
+
+            red += pixel[0] * weights[k];
+            green += pixel[1] * weights[k];
+            blue += pixel[2] * weights[k];
+        }
+
+        out[i] = Color::from_rgb_byte(
+            (red + ROUND) >> SHIFT,
+            (green + ROUND) >> SHIFT,
+            (blue + ROUND) >> SHIFT);
+    }
+}
+
+static void scale_rows_premultiplied(const Color *const *rows, const int16_t *weights, int taps, int begin, int end, int32_t *out)
+{
+    constexpr int ROUND = 1 << (WEIGHT_SHIFT - 1);
+
+    for (int x = begin; x < end; x++)
+    {
+        int red = 0, green = 0, blue = 0, alpha = 0;
+
+        for (int k = 0; k < taps; k++)
+        {
+            Color color = rows[k][x];
+
+            red += color.red() * color.alpha() * weights[k];
+            green += color.green() * color.alpha() * weights[k];
+            blue += color.blue() * color.alpha() * weights[k];
+            alpha += color.alpha() * 0xff * weights[k];
+        }
+
+        out[x * 4 + 0] = (red + ROUND) >> WEIGHT_SHIFT;
+        out[x * 4 + 1] = (green + ROUND) >> WEIGHT_SHIFT;
+        out[x * 4 + 2] = (blue + ROUND) >> WEIGHT_SHIFT;
+        out[x * 4 + 3] = (alpha + ROUND) >> WEIGHT_SHIFT;
+    }
+}
+
+static void scale_columns_premultiplied(const int32_t *in, const ScalingKernel &kernel, int count, Color *out, ScalingBlending blending)
+{
+    constexpr int ROUND = 1 << (WEIGHT_SHIFT - 1);
+
+    for (int i = 0; i < count; i++)
+    {
+        const int *indexes = kernel.indexes_of(i);
+        const int16_t *weights = kernel.weights_of(i);
+
+        int red = 0, green = 0, blue = 0, alpha = 0;
+
+        for (int k = 0; k < kernel.taps; k++)
+        {
+            const int32_t *pixel = in + indexes[k] * 4;
+
+            red += pixel[0] * weights[k];
+            green += pixel[1] * weights[k];
+            blue += pixel[2] * weights[k];
+            alpha += pixel[3] * weights[k];
+        }
+
+        // Channels are now times 255 times the alpha, itself times 255.
+        red = (red + ROUND) >> WEIGHT_SHIFT;
+        green = (green + ROUND) >> WEIGHT_SHIFT;
+        blue = (blue + ROUND) >> WEIGHT_SHIFT;
+        alpha = (alpha + ROUND) >> WEIGHT_SHIFT;
+
+        Color color = Colors::BLACKTRANSPARENT;
+
+        if (alpha > 0)
+        {
+            color = Color::from_rgba_byte(
+                MIN(0xff, (red * 0xff + alpha / 2) / alpha),
+                MIN(0xff, (green * 0xff + alpha / 2) / alpha),
+                MIN(0xff, (blue * 0xff + alpha / 2) / alpha),
+                (alpha + 0x7f) / 0xff);
+        }
+
+        if (blending == ScalingBlending::BLEND)
+        {
+            out[i] = Color::blend(color, out[i]);
+        }
+        else
+        {
+            out[i] = color;
+        }
+    }
+}
+
+/* --- SSE2 ----------------------------------------------------------------- */
+
+// Source pixels are widened to 16 bits per channel and a pair of taps is
+// interleaved, so one multiply-add weights and sums both of them. Rows go
+// four pixels at a time, columns one pixel at a time since taps are scattered.
+
+#ifdef SCALING_SSE2
+
+#    define SSE2 __attribute__((target("sse2")))
+
+static bool has_sse2()
+{
+#    ifdef __x86_64__
+    return true;
+#    else
+    static int sse2 = -1;
+
+    if (sse2 < 0)
+    {
+        unsigned int eax, ebx, ecx, edx;
+        sse2 = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (edx & bit_SSE2);
+    }
+
+    return sse2;
+#    endif
+}
+
+SSE2 static int scale_rows_opaque_sse2(const Color *const *rows, const int16_t *weights, int taps, int count, int16_t *out, uint8_t *alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (WEIGHT_SHIFT - OPAQUE_SHIFT - 1));
+
+    __m128i opaque = _mm_set1_epi8(-1);
+
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i first = zero;
+        __m128i second = zero;
+        __m128i third = zero;
+        __m128i fourth = zero;
+
+        for (int k = 0; k < taps; k += 2)
+        {
+            __m128i top = _mm_loadu_si128((const __m128i *)(rows[k] + x));
+            __m128i bottom = _mm_loadu_si128((const __m128i *)(rows[k + 1] + x));
+            __m128i weight = _mm_set1_epi32(weight_pair(weights + k));
+
+            opaque = _mm_and_si128(opaque, _mm_and_si128(top, bottom));
+
+            __m128i top_low = _mm_unpacklo_epi8(top, zero);
+            __m128i top_high = _mm_unpackhi_epi8(top, zero);
+            __m128i bottom_low = _mm_unpacklo_epi8(bottom, zero);
+            __m128i bottom_high = _mm_unpackhi_epi8(bottom, zero);
+
+            first = _mm_add_epi32(first, _mm_madd_epi16(_mm_unpacklo_epi16(top_low, bottom_low), weight));
+            second = _mm_add_epi32(second, _mm_madd_epi16(_mm_unpackhi_epi16(top_low, bottom_low), weight));
+            third = _mm_add_epi32(third, _mm_madd_epi16(_mm_unpacklo_epi16(top_high, bottom_high), weight));
+            fourth = _mm_add_epi32(fourth, _mm_madd_epi16(_mm_unpackhi_epi16(top_high, bottom_high), weight));
+        }
+
+        first = _mm_srai_epi32(_mm_add_epi32(first, round), WEIGHT_SHIFT - OPAQUE_SHIFT);
+        second = _mm_srai_epi32(_mm_add_epi32(second, round), WEIGHT_SHIFT - OPAQUE_SHIFT);
+        third = _mm_srai_epi32(_mm_add_epi32(third, round), WEIGHT_SHIFT - OPAQUE_SHIFT);
+        fourth = _mm_srai_epi32(_mm_add_epi32(fourth, round), WEIGHT_SHIFT - OPAQUE_SHIFT);
+
+        _mm_storeu_si128((__m128i *)(out + x * 4), _mm_packs_epi32(first, second));
+        _mm_storeu_si128((__m128i *)(out + x * 4 + 8), _mm_packs_epi32(third, fourth));
+    }
+
+    // Alpha is the last byte of each pixel.
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(opaque, _mm_set1_epi8(-1)));
+    *alpha = (mask & 0x8888) == 0x8888 ? 0xff : 0;
+
+    return x;
+}
+
+SSE2 static void scale_columns_opaque_sse2(const int16_t *in, const ScalingKernel &kernel, int count, Color *out)
+{
+    const __m128i round = _mm_set1_epi32(1 << (WEIGHT_SHIFT + OPAQUE_SHIFT - 1));
+
+    for (int i = 0; i < count; i++)
+    {
+        const int *indexes = kernel.indexes_of(i);
+        const int16_t *weights = kernel.weights_of(i);
+
+        __m128i sum = _mm_setzero_si128();
+
+        for (int k = 0; k < kernel.taps; k += 2)
+        {
+            __m128i left = _mm_loadl_epi64((const __m128i *)(in + indexes[k] * 4));
+            __m128i right = _mm_loadl_epi64((const __m128i *)(in + indexes[k + 1] * 4));
+            __m128i weight = _mm_set1_epi32(weight_pair(weights + k));
+
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(left, right), weight));
+        }
+
+        sum = _mm_srai_epi32(_mm_add_epi32(sum, round), WEIGHT_SHIFT + OPAQUE_SHIFT);
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_packus_epi16(sum, sum);
+
+        uint32_t pixel = _mm_cvtsi128_si32(sum);
+        memcpy(static_cast<void *>(&out[i]), &pixel, sizeof(pixel));
+    }
+}
+
+#endif
+
+/* --- Dispatch ------------------------------------------------------------- */
+
+static bool scale_rows_opaque(const Color *const *rows, const int16_t *weights, int taps, int count, int16_t *out)
+{
+    int done = 0;
+    uint8_t alpha = 0xff;
+
+#ifdef SCALING_SSE2
+    if (has_sse2())
+    {
+        done = scale_rows_opaque_sse2(rows, weights, taps, count, out, &alpha);
+    }
+#endif
+
+    alpha &= scale_rows_opaque_scalar(rows, weights, taps, done, count, out);
+
+    return alpha == 0xff;
+}
+
+static void scale_columns_opaque(const int16_t *in, const ScalingKernel &kernel, int count, Color *out)
+{
+#ifdef SCALING_SSE2
+    if (has_sse2())
+    {
+        scale_columns_opaque_sse2(in, kernel, count, out);
+        return;
+    }
+#endif
+
+    scale_columns_opaque_scalar(in, kernel, 0, count, out);
+}
+
+void scale(Bitmap &from, Math::Recti source, Bitmap &to, Math::Recti destination, Math::Recti clip, ScalingBlending blending)
+{
+    clip = clip.clipped_with(destination).clipped_with(to.bound());
+
+    if (clip.is_empty() || source.is_empty() || from.bound().is_empty())
+    {
+        return;
+    }
+
+    auto columns = scaling_kernel(
+        from.filtering(),
+        source.x(), source.width(), from.width(), destination.width(),
+        clip.left() - destination.left(), clip.right() - destination.left());
+
+    auto rows = scaling_kernel(
+        from.filtering(),
+        source.y(), source.height(), from.height(), destination.height(),
+        clip.top() - destination.top(), clip.bottom() - destination.top());
+
+    // Only the columns the second pass reads go through the first one, then
+    // indexes are made relative to the first of them.
+    int first_column = from.width();
+    int last_column = 0;
+
+    int *indexes = columns.indexes.raw_storage();
+
+    for (size_t i = 0; i < columns.indexes.count(); i++)
+    {
+        first_column = MIN(first_column, indexes[i]);
+        last_column = MAX(last_column, indexes[i]);
+    }
+
+    for (size_t i = 0; i < columns.indexes.count(); i++)
+    {
+        indexes[i] -= first_column;
+    }
+
+    int column_count = last_column - first_column + 1;
+
+    Async::parallel_for(clip.top(), clip.bottom(), SCALING_TILE_SIZE, [&](size_t begin, size_t end) {
+        Vector<const Color *> lines;
+        lines.resize(rows.taps);
+
+        Vector<int16_t> opaque;
+        opaque.resize(column_count * 4);
+
+        Vector<int32_t> premultiplied;
+
+        for (size_t y = begin; y < end; y++)
+        {
+            int row = y - clip.top();
+
+            for (int k = 0; k < rows.taps; k++)
+            {
+                lines[k] = from.pixels() + rows.indexes_of(row)[k] * from.width() + first_column;
+            }
+
+            Color *out = to.pixels() + y * to.width() + clip.x();
+
+            if (scale_rows_opaque(lines.raw_storage(), rows.weights_of(row), rows.taps, column_count, opaque.raw_storage()))
+            {
+                scale_columns_opaque(opaque.raw_storage(), columns, clip.width(), out);
+                continue;
+            }
+
+            premultiplied.resize(column_count * 4);
+            scale_rows_premultiplied(lines.raw_storage(), rows.weights_of(row), rows.taps, 0, column_count, premultiplied.raw_storage());
+            scale_columns_premultiplied(premultiplied.raw_storage(), columns, clip.width(), out, blending);
+        }
+    });
+}
+
+} // namespace Graphic
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <libgraphic/Bitmap.h>
+
+namespace Graphic
+{
+
+enum class ScalingBlending
+{
+    // Write the resampled pixels as they are.
+    COPY,
+    // Blend them over what's already in the target.
+    BLEND,
+};
+
+// Resamples the `source` rectangle of `from` to the size of `destination` and
+// draws it onto `to`, only pixels within `clip` are written.
+//
+// Both axes are scaled on their own: bilinear when upscaling, an average of
+// the covered pixels when downscaling, or the nearest pixel if `from` is set
+// to BitmapFiltering::NEAREST. Weights are computed once per column and row,
+// and opaque rows skip alpha premultiplication and blending.
+void scale(Bitmap &from, Math::Recti source, Bitmap &to, Math::Recti destination, Math::Recti clip, ScalingBlending blending);
+
+} // namespace Graphic
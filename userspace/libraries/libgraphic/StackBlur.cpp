@@ -39,19 +39,16 @@ static unsigned char const stackblur_shr[255] = {
     24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
     24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24};
 
-void stackblur(
-    unsigned char *src,  ///< input image data
-    unsigned int w,      ///< image width
-    unsigned int h,      ///< image height
-    unsigned int radius, ///< blur intensity (should be in 2..254 range)
+void stackblur_rows(
+    unsigned char *src,
+    unsigned int w,
+    unsigned int radius,
     unsigned int min_x,
     unsigned int max_x,
-    unsigned int min_y,
-    unsigned int max_y)
+    unsigned int y_begin,
+    unsigned int y_end)
 {
-    UNUSED(h);
-
-    unsigned int x, y, xp, yp, i;
+    unsigned int x, y, xp, i;
     unsigned int sp;
     unsigned int stack_start;
     unsigned char *stack_ptr;
@@ -70,7 +67,6 @@ void stackblur(
     unsigned long sum_out_b;
 
     unsigned int wm = max_x - min_x - 1;
-    unsigned int hm = max_y - min_y - 1;
     unsigned int w4 = w * 4;
     unsigned int div = (radius * 2) + 1;
     unsigned int mul_sum = stackblur_mul[radius];
@@ -78,7 +74,7 @@ void stackblur(
     unsigned char stack[div * 3];
 
     {
-        for (y = min_y; y < max_y; y++)
+        for (y = y_begin; y < y_end; y++)
         {
             sum_r = sum_g = sum_b =
                 sum_in_r = sum_in_g = sum_in_b =
@@ -178,9 +174,44 @@ void stackblur(
             }
         }
     }
+}
+
+void stackblur_columns(
+    unsigned char *src,
+    unsigned int w,
+    unsigned int radius,
+    unsigned int min_y,
+    unsigned int max_y,
+    unsigned int x_begin,
+    unsigned int x_end)
+{
+    unsigned int x, y, yp, i;
+    unsigned int sp;
+    unsigned int stack_start;
+    unsigned char *stack_ptr;
+
+    unsigned char *src_ptr;
+    unsigned char *dst_ptr;
+
+    unsigned long sum_r;
+    unsigned long sum_g;
+    unsigned long sum_b;
+    unsigned long sum_in_r;
+    unsigned long sum_in_g;
+    unsigned long sum_in_b;
+    unsigned long sum_out_r;
+    unsigned long sum_out_g;
+    unsigned long sum_out_b;
+
+    unsigned int hm = max_y - min_y - 1;
+    unsigned int w4 = w * 4;
+    unsigned int div = (radius * 2) + 1;
+    unsigned int mul_sum = stackblur_mul[radius];
+    unsigned char shr_sum = stackblur_shr[radius];
+    unsigned char stack[div * 3];
 
     {
-        for (x = min_x; x < max_x; x++)
+        for (x = x_begin; x < x_end; x++)
         {
             sum_r = sum_g = sum_b =
                 sum_in_r = sum_in_g = sum_in_b =
@@ -282,4 +313,20 @@ void stackblur(
     }
 }
 
+void stackblur(
+    unsigned char *src,  ///< input image data
+    unsigned int w,      ///< image width
+    unsigned int h,      ///< image height
+    unsigned int radius, ///< blur intensity (should be in 2..254 range)
+    unsigned int min_x,
+    unsigned int max_x,
+    unsigned int min_y,
+    unsigned int max_y)
+{
+    UNUSED(h);
+
+    stackblur_rows(src, w, radius, min_x, max_x, min_y, max_y);
+    stackblur_columns(src, w, radius, min_y, max_y, min_x, max_x);
+}
+
 } // namespace Graphic
@@ -13,4 +13,24 @@ void stackblur(
     unsigned int minY,
     unsigned int maxY);
 
+// The two passes of stackblur(), every row (or column) is blurred on its own,
+// so they can be split in bands and run in parallel.
+void stackblur_rows(
+    unsigned char *src,
+    unsigned int w,
+    unsigned int radius,
+    unsigned int min_x,
+    unsigned int max_x,
+    unsigned int y_begin,
+    unsigned int y_end);
+
+void stackblur_columns(
+    unsigned char *src,
+    unsigned int w,
+    unsigned int radius,
+    unsigned int min_y,
+    unsigned int max_y,
+    unsigned int x_begin,
+    unsigned int x_end);
+
 };
\ No newline at end of file
@@ -2,8 +2,11 @@
 
 #include <libgraphic/Bitmap.h>
 #include <libio/Reader.h>
+#include <libio/Writer.h>
 
 namespace Graphic::Png
 {
 ResultOr<RefPtr<Bitmap>> load(IO::Reader &reader);
+
+Result save(IO::Writer &writer, Bitmap &bitmap);
 } // namespace Graphic::Svg
\ No newline at end of file
@@ -1,13 +1,12 @@
+#include <libasync/Parallel.h>
 #include <libcompression/Inflate.h>
 #include <libgraphic/png/PngReader.h>
+#include <libgraphic/png/PngScanline.h>
 #include <libio/CRCReader.h>
 #include <libio/Read.h>
 #include <libio/ScopedReader.h>
-#include <libio/Skip.h>
 #include <libio/Streams.h>
 #include <libutils/Array.h>
-#include <libutils/Assert.h>
-#include <libutils/Chrono.h>
 
 namespace Graphic
 {
@@ -31,37 +30,50 @@ Result PngReader::read()
 
     TRY(read_chunks());
 
-    IO::MemoryWriter uncompressed_writer;
-    TRY(uncompress(uncompressed_writer));
-    uint8_t *scanlines = uncompressed_writer.buffer();
+    if (!_bitmap || _row != _height)
+    {
+        IO::logln("Missing image data");
+        return Result::ERR_INVALID_DATA;
+    }
+
+    return Result::SUCCESS;
+}
+
+/* --- Chunks --------------------------------------------------------------- */
+
+Result PngReader::read_chunk_header(ChunkHeader &header)
+{
+    if (_has_pending_header)
+    {
+        _has_pending_header = false;
+        header = _pending_header;
+
+        return Result::SUCCESS;
+    }
 
-    // Unfilter the scanlines
-    size_t out_size = _width * _height * num_channels() * bytes_per_pixel();
-    uint8_t *raw_buffer = new uint8_t[out_size];
-    memset(raw_buffer, 0, out_size);
-    TRY(unfilter(raw_buffer, scanlines));
+    header.length = TRY(IO::read<be_uint32_t>(_reader))();
 
-    TRY(convert(raw_buffer));
-    delete[] raw_buffer;
+    // CRC checksum includes the chunk signature and chunk data
+    // See https://www.w3.org/TR/2003/REC-PNG-20031110/#5Introduction
+    IO::CRCReader crc_reader(_reader);
+    header.signature = TRY(IO::read<be_uint32_t>(crc_reader))();
+    header.crc = crc_reader.checksum();
 
     return Result::SUCCESS;
 }
 
 Result PngReader::read_chunks()
 {
-    size_t idat_counter = 0;
     bool end = false;
-    uint32_t prev_signature = 0;
     while (!end)
     {
-        auto chunk_length = TRY(IO::read<be_uint32_t>(_reader));
-        // CRC checksum includes the chunk signature and chunk data
-        // See https://www.w3.org/TR/2003/REC-PNG-20031110/#5Introduction
-        IO::CRCReader crc_reader(_reader);
-        auto chunk_signature = TRY(IO::read<be_uint32_t>(crc_reader));
-        IO::ScopedReader scoped_reader(crc_reader, chunk_length());
-
-        switch (chunk_signature())
+        ChunkHeader header;
+        TRY(read_chunk_header(header));
+
+        IO::CRCReader crc_reader(_reader, header.crc);
+        IO::ScopedReader scoped_reader(crc_reader, header.length);
+
+        switch (header.signature)
         {
         case Png::ImageHeader::SIG:
         {
@@ -127,7 +139,7 @@ Result PngReader::read_chunks()
 
         case Png::Palette::SIG:
         {
-            auto num_entries = chunk_length() / 3;
+            auto num_entries = header.length / 3;
             for (size_t i = 0; i < num_entries; i++)
             {
                 uint8_t red = TRY(IO::read<uint8_t>(scoped_reader));
@@ -145,7 +157,7 @@ Result PngReader::read_chunks()
             // See: https://www.w3.org/TR/2003/REC-PNG-20031110/#5ChunkOrdering
             if (_colour_type == Png::CT_PALETTE)
             {
-                auto num_entries = chunk_length();
+                auto num_entries = header.length;
                 if (num_entries > _palette.count())
                 {
                     IO::logln("Transparency chunk has more entries than current palette");
@@ -173,18 +185,18 @@ Result PngReader::read_chunks()
 
         case Png::ImageData::SIG:
         {
-            // The first chunk begins with the compression method
-            if (idat_counter > 0 && prev_signature != Png::ImageData::SIG)
+            // All of them are read in one go
+            if (_bitmap)
             {
                 IO::logln("Multiple iDat chunks must be subsequent");
                 return Result::ERR_INVALID_DATA;
             }
 
-            // Read the data for this chunk into our concatenated compressed data
-            TRY(IO::copy(scoped_reader, _idat_writer));
-            idat_counter++;
+            // The image data reader checks the chunks itself, up to the one
+            // following the last IDAT.
+            TRY(read_image_data(header));
         }
-        break;
+        continue;
 
         case Png::TextualData::SIG:
         {
@@ -205,7 +217,7 @@ Result PngReader::read_chunks()
 
         default:
         {
-            IO::logln("Unknown PNG chunk: {08x}", chunk_signature());
+            IO::logln("Unknown PNG chunk: {08x}", header.signature);
             Vector<uint8_t> data;
             TRY(IO::read_vector(scoped_reader, data));
         }
@@ -218,193 +230,129 @@ Result PngReader::read_chunks()
             IO::logln("Chunk checksum validation failed");
             return Result::ERR_INVALID_DATA;
         }
-        prev_signature = chunk_signature();
     }
 
     return Result::SUCCESS;
 }
 
-// Copyright (c) 2005-2020 Lode Vandevenne
-Result PngReader::unfilter(uint8_t *out, uint8_t *in)
+/* --- Image data ----------------------------------------------------------- */
+
+Result PngReader::ImageDataReader::load(ChunkHeader header)
 {
-    // For PNG filter method 0
-    // this function unfilters a single image (e.g. without interlacing this is called once, with Adam7 seven times)
-    // out must have enough bytes allocated already, in must have the scanlines + 1 filter_type byte per scanline
-    // w and h are image dimensions or dimensions of reduced image, bpp is bits per pixel
-    // in and out are allowed to be the same memory address (but aren't the same size since in has the extra filter bytes)
-    uint8_t *prevline = 0;
+    _chunk.resize(header.length);
+    _position = 0;
 
-    // bytewidth is used for filtering, is 1 when bpp < 8, number of bytes per pixel otherwise
-    size_t bytewidth = (bits_per_pixel() + 7u) / 8u;
-    size_t linebytes = (_width * bits_per_pixel() + 7u) / 8u;
+    IO::CRCReader crc_reader(_png._reader, header.crc);
 
-    for (uint32_t y = 0; y < _height; ++y)
+    for (size_t loaded = 0; loaded < header.length;)
     {
-        size_t outindex = linebytes * y;
-        size_t inindex = (1 + linebytes) * y; /*the extra filterbyte added to each row*/
-        Png::FilterType filter_type = (Png::FilterType)in[inindex];
+        size_t read = TRY(crc_reader.read(_chunk.raw_storage() + loaded, header.length - loaded));
 
-        TRY(unfilter_scanline(&out[outindex], &in[inindex + 1], prevline, bytewidth, filter_type, linebytes));
+        if (read == 0)
+        {
+            IO::logln("Truncated iDat chunk");
+            return Result::ERR_INVALID_DATA;
+        }
 
-        prevline = &out[outindex];
+        loaded += read;
+    }
+
+    auto crc = TRY(IO::read<be_uint32_t>(_png._reader));
+    if (crc() != crc_reader.checksum())
+    {
+        IO::logln("Chunk checksum validation failed");
+        return Result::ERR_INVALID_DATA;
     }
 
     return Result::SUCCESS;
 }
 
-// Path predictor, used by PNG filter type 4
-// The parameters are of type short, but should come from unsigned charunsigned chars, the shorts
-// are only needed to make the paeth calculation correct.
-static uint8_t paeth_predictor(int16_t a, int16_t b, int16_t c)
+Result PngReader::ImageDataReader::next()
 {
-    int16_t pa = abs(b - c);
-    int16_t pb = abs(a - c);
-    int16_t pc = abs(a + b - c - c);
+    ChunkHeader header;
+    TRY(_png.read_chunk_header(header));
 
-    /* return input value associated with smallest of pa, pb, pc (with certain priority if equal) */
-    if (pb < pa)
+    if (header.signature != Png::ImageData::SIG)
     {
-        a = b;
-        pa = pb;
+        _png._pending_header = header;
+        _png._has_pending_header = true;
+        _ended = true;
+
+        return Result::SUCCESS;
     }
 
-    return (pc < pa) ? c : a;
+    return load(header);
 }
 
-// Copyright (c) 2005-2020 Lode Vandevenne
-Result PngReader::unfilter_scanline(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
-                                    size_t bytewidth, Png::FilterType filter_type, size_t length)
+Result PngReader::ImageDataReader::finish()
 {
-    // For PNG filter method 0
-    // unfilter a PNG image scanline by scanline. when the pixels are smaller than 1 byte,
-    // the filter works byte per byte (bytewidth = 1)
-    // precon is the previous unfiltered scanline, recon the result, scanline the current one
-    // the incoming scanlines do NOT include the filter_type byte, that one is given in the parameter filter_type instead
-    // recon and scanline MAY be the same memory address! precon must be disjoint.
-    size_t i;
-
-    switch (filter_type)
+    while (!_ended)
     {
-    case Png::FT_NONE:
-        for (i = 0; i != length; ++i)
-        {
-            recon[i] = scanline[i];
-        }
-        break;
+        _position = _chunk.count();
+        TRY(next());
+    }
 
-    case Png::FT_SUB:
-        for (i = 0; i != bytewidth; ++i)
-        {
-            recon[i] = scanline[i];
-        }
+    return Result::SUCCESS;
+}
 
-        for (i = bytewidth; i < length; ++i)
+ResultOr<size_t> PngReader::ImageDataReader::read(void *buffer, size_t size)
+{
+    while (_position == _chunk.count())
+    {
+        if (_ended)
         {
-            recon[i] = scanline[i] + recon[i - bytewidth];
+            return 0;
         }
-        break;
 
-    case Png::FT_UP:
-        if (precon)
-        {
-            for (i = 0; i != length; ++i)
-            {
-                recon[i] = scanline[i] + precon[i];
-            }
-        }
-        else
-        {
-            for (i = 0; i != length; ++i)
-            {
-                recon[i] = scanline[i];
-            }
-        }
-        break;
+        TRY(next());
+    }
 
-    case Png::FT_AVERAGE:
-        if (precon)
-        {
-            for (i = 0; i != bytewidth; ++i)
-            {
-                recon[i] = scanline[i] + (precon[i] >> 1u);
-            }
+    size_t read = MIN(size, _chunk.count() - _position);
+    memcpy(buffer, _chunk.raw_storage() + _position, read);
+    _position += read;
 
-            for (i = bytewidth; i < length; ++i)
-            {
-                recon[i] = scanline[i] + ((recon[i - bytewidth] + precon[i]) >> 1u);
-            }
-        }
-        else
-        {
-            for (i = 0; i != bytewidth; ++i)
-            {
-                recon[i] = scanline[i];
-            }
+    return read;
+}
 
-            for (i = bytewidth; i < length; ++i)
-            {
-                recon[i] = scanline[i] + (recon[i - bytewidth] >> 1u);
-            }
-        }
-        break;
+Result PngReader::read_image_data(ChunkHeader header)
+{
+    if (_width == 0 || _height == 0)
+    {
+        IO::logln("Image data before the image header");
+        return Result::ERR_INVALID_DATA;
+    }
 
-    case Png::FT_PAETH:
-        if (precon)
-        {
-            for (i = 0; i != bytewidth; ++i)
-            {
-                recon[i] = (scanline[i] + precon[i]); /*paeth_predictor(0, precon[i], 0) is always precon[i]*/
-            }
+    if (_colour_type == Png::CT_PALETTE && _palette.empty())
+    {
+        IO::logln("Palette colour type requires a palett data");
+        return Result::ERR_INVALID_DATA;
+    }
 
-            if (bytewidth >= 2)
-            {
-                for (; i + 1 < length; i += 2)
-                {
-                    size_t j = i - bytewidth;
-                    uint8_t s0 = scanline[i + 0], s1 = scanline[i + 1];
-                    uint8_t r0 = recon[j + 0], r1 = recon[j + 1];
-                    uint8_t p0 = precon[i + 0], p1 = precon[i + 1];
-                    uint8_t q0 = precon[j + 0], q1 = precon[j + 1];
-                    recon[i + 0] = s0 + paeth_predictor(r0, p0, q0);
-                    recon[i + 1] = s1 + paeth_predictor(r1, p1, q1);
-                }
-            }
+    if (_colour_type != Png::CT_RGBA &&
+        _colour_type != Png::CT_RGB &&
+        _colour_type != Png::CT_GREY &&
+        _colour_type != Png::CT_GREY_ALPHA &&
+        _colour_type != Png::CT_PALETTE)
+    {
+        IO::logln("Unsupported PNG colour type: {}", _colour_type);
+        return Result::ERR_NOT_IMPLEMENTED;
+    }
 
-            for (; i != length; ++i)
-            {
-                recon[i] = (scanline[i] + paeth_predictor(recon[i - bytewidth], precon[i], precon[i - bytewidth]));
-            }
-        }
-        else
-        {
-            for (i = 0; i != bytewidth; ++i)
-            {
-                recon[i] = scanline[i];
-            }
+    _bitmap = TRY(Bitmap::create_shared(_width, _height));
 
-            for (i = bytewidth; i < length; ++i)
-            {
-                /*paeth_predictor(recon[i - bytewidth], 0, 0) is always recon[i - bytewidth]*/
-                recon[i] = (scanline[i] + recon[i - bytewidth]);
-            }
-        }
-        break;
+    _scanline.resize(1 + bytes_per_row());
 
-    default:
-        IO::logln("Invalid filter type: {}", filter_type);
-        return Result::ERR_INVALID_DATA; /*error: nonexistent filter type given*/
+    if (_colour_type != Png::CT_RGBA)
+    {
+        _rows.resize((1 + CONVERT_ROWS_PER_BATCH) * bytes_per_row());
     }
 
-    return Result::SUCCESS;
-}
-
-Result PngReader::uncompress(IO::MemoryWriter &uncompressed_writer)
-{
-    IO::MemoryReader compressed_reader(Slice(_idat_writer.slice()));
+    ImageDataReader image_data{*this};
+    TRY(image_data.load(header));
 
     // Two bytes before the actual deflate data
     // See https://www.w3.org/TR/2003/REC-PNG-20031110/#10Compression
-    auto cm_cinfo = TRY(IO::read<uint8_t>(compressed_reader));
+    auto cm_cinfo = TRY(IO::read<uint8_t>(image_data));
 
     // ZLib compression mode should be DEFLATE
     if ((cm_cinfo & 15) != 8)
@@ -420,69 +368,115 @@ Result PngReader::uncompress(IO::MemoryWriter &uncompressed_writer)
         return Result::ERR_INVALID_DATA;
     }
 
-    auto flags = TRY(IO::read<uint8_t>(compressed_reader));
+    auto flags = TRY(IO::read<uint8_t>(image_data));
     UNUSED(flags);
 
-    // Decode our compressed image data
+    // Rows are unfiltered and converted as they come out of the inflater.
+    ScanlineWriter scanlines{*this};
     Compression::Inflate inflate;
-    return inflate.perform(compressed_reader, uncompressed_writer).result();
+    TRY(inflate.perform(image_data, scanlines));
+
+    convert_pending_rows();
+
+    return image_data.finish();
 }
 
-Result PngReader::convert(uint8_t *buffer)
+/* --- Scanlines ------------------------------------------------------------ */
+
+ResultOr<size_t> PngReader::ScanlineWriter::write(const void *buffer, size_t size)
 {
-    _pixels.resize(_width * _height);
+    auto data = static_cast<const uint8_t *>(buffer);
+    size_t remaining = size;
+    size_t length = _png._scanline.count();
 
-    switch (_colour_type)
+    while (remaining > 0)
     {
-    case Png::CT_RGBA:
-        for (size_t i = 0; i < _width * _height; i++)
+        // Whole rows are unfiltered where they are.
+        if (_png._scanline_used == 0 && remaining >= length)
         {
-            _pixels[i] = Color::from_rgba_byte(buffer[i * 4],
-                                               buffer[i * 4 + 1],
-                                               buffer[i * 4 + 2],
-                                               buffer[i * 4 + 3]);
+            TRY(_png.write_scanline(data));
+            data += length;
+            remaining -= length;
+            continue;
         }
-        break;
-    case Png::CT_RGB:
-        for (size_t i = 0; i < _width * _height; i++)
-        {
-            _pixels[i] = Color::from_rgb_byte(buffer[i * 3],
-                                              buffer[i * 3 + 1],
-                                              buffer[i * 3 + 2]);
-        }
-        break;
 
-    case Png::CT_GREY:
-        for (size_t i = 0; i < _width * _height; i++)
-        {
-            _pixels[i] = Color::from_monochrome_byte(buffer[i]);
-        }
-        break;
-    case Png::CT_GREY_ALPHA:
-        for (size_t i = 0; i < _width * _height; i++)
-        {
-            _pixels[i] = Color::from_monochrome_alpha_byte(buffer[i * 2],
-                                                           buffer[i * 2 + 1]);
-        }
-        break;
-    case Png::CT_PALETTE:
-        if (_palette.empty())
+        size_t copied = MIN(remaining, length - _png._scanline_used);
+        memcpy(_png._scanline.raw_storage() + _png._scanline_used, data, copied);
+        _png._scanline_used += copied;
+        data += copied;
+        remaining -= copied;
+
+        if (_png._scanline_used == length)
         {
-            IO::logln("Palette colour type requires a palett data");
-            return Result::ERR_INVALID_DATA;
+            _png._scanline_used = 0;
+            TRY(_png.write_scanline(_png._scanline.raw_storage()));
         }
+    }
+
+    return size;
+}
+
+Result PngReader::write_scanline(const uint8_t *scanline)
+{
+    if (_row == _height)
+    {
+        IO::logln("More image data than the image has rows");
+        return Result::ERR_INVALID_DATA;
+    }
+
+    size_t linebytes = bytes_per_row();
+
+    // bytewidth is used for filtering, is 1 when bpp < 8, number of bytes per pixel otherwise
+    size_t bytewidth = (bits_per_pixel() + 7u) / 8u;
+
+    auto filter_type = (Png::FilterType)scanline[0];
+
+    // The samples of RGBA images already are colors, they are unfiltered
+    // straight into the bitmap, the row above being the previous one.
+    uint8_t *recon = _colour_type == Png::CT_RGBA
+                         ? reinterpret_cast<uint8_t *>(_bitmap->pixels()) + _row * linebytes
+                         : _rows.raw_storage() + (1 + _rows_pending) * linebytes;
 
-        for (size_t i = 0; i < _width * _height; i++)
+    const uint8_t *precon = _row > 0 ? recon - linebytes : nullptr;
+
+    TRY(Png::unfilter_scanline(recon, scanline + 1, precon, bytewidth, filter_type, linebytes));
+
+    _row++;
+
+    if (_colour_type != Png::CT_RGBA)
+    {
+        _rows_pending++;
+
+        if (_rows_pending == CONVERT_ROWS_PER_BATCH)
         {
-            _pixels[i] = _palette[buffer[i]];
+            convert_pending_rows();
         }
-        break;
-    default:
-        IO::logln("Unsupported PNG colour type: %u", _colour_type);
-        return Result::ERR_NOT_IMPLEMENTED;
     }
 
     return Result::SUCCESS;
 }
 
+void PngReader::convert_pending_rows()
+{
+    if (_rows_pending == 0)
+    {
+        return;
+    }
+
+    size_t linebytes = bytes_per_row();
+    uint8_t *rows = _rows.raw_storage() + linebytes;
+    size_t first_row = _row - _rows_pending;
+
+    Async::parallel_for(0, _rows_pending, CONVERT_ROWS_PER_JOB, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            Png::convert_scanline(_colour_type, _palette, rows + i * linebytes, _bitmap->pixels() + (first_row + i) * _width, _width);
+        }
+    });
+
+    // The last row is the one above the first of the next batch.
+    memcpy(_rows.raw_storage(), rows + (_rows_pending - 1) * linebytes, linebytes);
+    _rows_pending = 0;
+}
+
 } // namespace Graphic
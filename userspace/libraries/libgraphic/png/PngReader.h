@@ -2,10 +2,11 @@
 
 #include <abi/Time.h>
 
+#include <libgraphic/Bitmap.h>
 #include <libgraphic/Color.h>
 #include <libgraphic/png/PngCommon.h>
-#include <libio/MemoryWriter.h>
 #include <libio/Reader.h>
+#include <libio/Writer.h>
 #include <libutils/Vector.h>
 
 namespace Graphic
@@ -13,23 +14,84 @@ namespace Graphic
 class PngReader
 {
 private:
+    // Unfiltered rows are converted to colors in batches, in parallel.
+    static constexpr size_t CONVERT_ROWS_PER_BATCH = 64;
+    static constexpr size_t CONVERT_ROWS_PER_JOB = 16;
+
+    struct ChunkHeader
+    {
+        uint32_t length;
+        uint32_t signature;
+
+        // Of the signature, the data is added to it as it is read.
+        uint32_t crc;
+    };
+
+    // Hands the data of consecutive IDAT chunks to the inflater as one
+    // stream, keeping a single chunk in memory.
+    class ImageDataReader : public IO::Reader
+    {
+    private:
+        PngReader &_png;
+        Vector<uint8_t> _chunk;
+        size_t _position = 0;
+        bool _ended = false;
+
+        Result next();
+
+    public:
+        ImageDataReader(PngReader &png) : _png{png} {}
+
+        Result load(ChunkHeader header);
+
+        // Skips what the inflater didn't read, up to the chunk after the last IDAT.
+        Result finish();
+
+        ResultOr<size_t> read(void *buffer, size_t size) override;
+    };
+
+    // Takes the inflated scanlines and turns them into pixels as soon as a
+    // whole row is there.
+    class ScanlineWriter : public IO::Writer
+    {
+    private:
+        PngReader &_png;
+
+    public:
+        ScanlineWriter(PngReader &png) : _png{png} {}
+
+        ResultOr<size_t> write(const void *buffer, size_t size) override;
+    };
+
     bool _valid = false;
     uint32_t _width = 0;
     uint32_t _height = 0;
     uint8_t _bit_depth = 0;
-    Vector<Color> _pixels;
+    RefPtr<Bitmap> _bitmap;
     Vector<Color> _palette;
     DateTime _modified;
     Png::ColourType _colour_type;
     IO::Reader &_reader;
-    IO::MemoryWriter _idat_writer;
 
-    Result uncompress(IO::MemoryWriter &uncompressed_writer);
-    Result unfilter(uint8_t *in, uint8_t *out);
-    Result unfilter_scanline(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
-                             size_t bytewidth, Png::FilterType filterType, size_t length);
-    Result convert(uint8_t *data);
+    // The header the image data reader ran into after the last IDAT chunk.
+    bool _has_pending_header = false;
+    ChunkHeader _pending_header;
+
+    // Filter byte followed by the scanline being received.
+    Vector<uint8_t> _scanline;
+    size_t _scanline_used = 0;
+    uint32_t _row = 0;
+
+    // The previous unfiltered row followed by those waiting to be converted,
+    // unused for RGBA which unfilters straight into the bitmap.
+    Vector<uint8_t> _rows;
+    size_t _rows_pending = 0;
+
+    Result read_chunk_header(ChunkHeader &header);
     Result read_chunks();
+    Result read_image_data(ChunkHeader header);
+    Result write_scanline(const uint8_t *scanline);
+    void convert_pending_rows();
 
     Result read();
 
@@ -62,14 +124,19 @@ private:
         return (num_channels() * _bit_depth);
     }
 
+    inline size_t bytes_per_row()
+    {
+        return (_width * bits_per_pixel() + 7u) / 8u;
+    }
+
 public:
     inline bool valid() const { return _valid; }
     inline uint32_t width() const { return _width; }
     inline uint32_t height() const { return _height; }
-    inline const Vector<Color> &pixels() const { return _pixels; }
+    inline RefPtr<Bitmap> bitmap() const { return _bitmap; }
     inline const DateTime &modified() const { return _modified; }
 
     PngReader(IO::Reader &reader);
 };
 
-} // namespace Graphic
\ No newline at end of file
+} // namespace Graphic
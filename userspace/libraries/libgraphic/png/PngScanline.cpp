@@ -0,0 +1,560 @@
+#include <libgraphic/png/PngScanline.h>
+#include <libio/Streams.h>
+#include <libutils/Assert.h>
+
+#include <string.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#    define PNG_SCANLINE_SSE2
+#    include <cpuid.h>
+#    include <emmintrin.h>
+#endif
+
+namespace Graphic::Png
+{
+
+/* --- Scalar --------------------------------------------------------------- */
+
+// Path predictor, used by PNG filter type 4
+// The parameters are of type short, but should come from unsigned charunsigned chars, the shorts
+// are only needed to make the paeth calculation correct.
+static uint8_t paeth_predictor(int16_t a, int16_t b, int16_t c)
+{
+    int16_t pa = abs(b - c);
+    int16_t pb = abs(a - c);
+    int16_t pc = abs(a + b - c - c);
+
+    /* return input value associated with smallest of pa, pb, pc (with certain priority if equal) */
+    if (pb < pa)
+    {
+        a = b;
+        pa = pb;
+    }
+
+    return (pc < pa) ? c : a;
+}
+
+// Copyright (c) 2005-2020 Lode Vandevenne
+static Result unfilter_scanline_scalar(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
+                                       size_t bytewidth, FilterType filter_type, size_t length)
+{
+    // For PNG filter method 0
+    // unfilter a PNG image scanline by scanline. when the pixels are smaller than 1 byte,
+    // the filter works byte per byte (bytewidth = 1)
+    // precon is the previous unfiltered scanline, recon the result, scanline the current one
+    // the incoming scanlines do NOT include the filter_type byte, that one is given in the parameter filter_type instead
+    // recon and scanline MAY be the same memory address! precon must be disjoint.
+    size_t i;
+
+    switch (filter_type)
+    {
+    case FT_NONE:
+        for (i = 0; i != length; ++i)
+        {
+            recon[i] = scanline[i];
+        }
+        break;
+
+    case FT_SUB:
+        for (i = 0; i != bytewidth; ++i)
+        {
+            recon[i] = scanline[i];
+        }
+
+        for (i = bytewidth; i < length; ++i)
+        {
+            recon[i] = scanline[i] + recon[i - bytewidth];
+        }
+        break;
+
+    case FT_UP:
+        if (precon)
+        {
+            for (i = 0; i != length; ++i)
+            {
+                recon[i] = scanline[i] + precon[i];
+            }
+        }
+        else
+        {
+            for (i = 0; i != length; ++i)
+            {
+                recon[i] = scanline[i];
+            }
+        }
+        break;
+
+    case FT_AVERAGE:
+        if (precon)
+        {
+            for (i = 0; i != bytewidth; ++i)
+            {
+                recon[i] = scanline[i] + (precon[i] >> 1u);
+            }
+
+            for (i = bytewidth; i < length; ++i)
+            {
+                recon[i] = scanline[i] + ((recon[i - bytewidth] + precon[i]) >> 1u);
+            }
+        }
+        else
+        {
+            for (i = 0; i != bytewidth; ++i)
+            {
+                recon[i] = scanline[i];
+            }
+
+            for (i = bytewidth; i < length; ++i)
+            {
+                recon[i] = scanline[i] + (recon[i - bytewidth] >> 1u);
+            }
+        }
+        break;
+
+    case FT_PAETH:
+        if (precon)
+        {
+            for (i = 0; i != bytewidth; ++i)
+            {
+                recon[i] = (scanline[i] + precon[i]); /*paeth_predictor(0, precon[i], 0) is always precon[i]*/
+            }
+
+            if (bytewidth >= 2)
+            {
+                for (; i + 1 < length; i += 2)
+                {
+                    size_t j = i - bytewidth;
+                    uint8_t s0 = scanline[i + 0], s1 = scanline[i + 1];
+                    uint8_t r0 = recon[j + 0], r1 = recon[j + 1];
+                    uint8_t p0 = precon[i + 0], p1 = precon[i + 1];
+                    uint8_t q0 = precon[j + 0], q1 = precon[j + 1];
+                    recon[i + 0] = s0 + paeth_predictor(r0, p0, q0);
+                    recon[i + 1] = s1 + paeth_predictor(r1, p1, q1);
+                }
+            }
+
+            for (; i != length; ++i)
+            {
+                recon[i] = (scanline[i] + paeth_predictor(recon[i - bytewidth], precon[i], precon[i - bytewidth]));
+            }
+        }
+        else
+        {
+            for (i = 0; i != bytewidth; ++i)
+            {
+                recon[i] = scanline[i];
+            }
+
+            for (i = bytewidth; i < length; ++i)
+            {
+                /*paeth_predictor(recon[i - bytewidth], 0, 0) is always recon[i - bytewidth]*/
+                recon[i] = (scanline[i] + recon[i - bytewidth]);
+            }
+        }
+        break;
+
+    default:
+        IO::logln("Invalid filter type: {}", filter_type);
+        return Result::ERR_INVALID_DATA; /*error: nonexistent filter type given*/
+    }
+
+    return Result::SUCCESS;
+}
+
+static void convert_scanline_scalar(ColourType colour_type, const Vector<Color> &palette,
+                                    const uint8_t *samples, Color *pixels, size_t begin, size_t end)
+{
+    switch (colour_type)
+    {
+    case CT_RGBA:
+        for (size_t i = begin; i < end; i++)
+        {
+            pixels[i] = Color::from_rgba_byte(samples[i * 4],
+                                              samples[i * 4 + 1],
+                                              samples[i * 4 + 2],
+                                              samples[i * 4 + 3]);
+        }
+        break;
+
+    case CT_RGB:
+        for (size_t i = begin; i < end; i++)
+        {
+            pixels[i] = Color::from_rgb_byte(samples[i * 3],
+                                             samples[i * 3 + 1],
+                                             samples[i * 3 + 2]);
+        }
+        break;
+
+    case CT_GREY:
+        for (size_t i = begin; i < end; i++)
+        {
+            pixels[i] = Color::from_monochrome_byte(samples[i]);
+        }
+        break;
+
+    case CT_GREY_ALPHA:
+        for (size_t i = begin; i < end; i++)
+        {
+            pixels[i] = Color::from_monochrome_alpha_byte(samples[i * 2],
+                                                          samples[i * 2 + 1]);
+        }
+        break;
+
+    case CT_PALETTE:
+        for (size_t i = begin; i < end; i++)
+        {
+            // Out of range indices are an error in the file, black is what
+            // most decoders show for them.
+            pixels[i] = samples[i] < palette.count() ? palette[samples[i]] : Color::from_rgba_byte(0, 0, 0, 0xff);
+        }
+        break;
+
+    default:
+        Assert::not_reached();
+    }
+}
+
+// Filters are cheap next to deflating the result, they stay scalar.
+void filter_scanline(uint8_t *filtered, const uint8_t *samples, const uint8_t *presamples,
+                     size_t bytewidth, FilterType filter_type, size_t length)
+{
+    size_t i;
+
+    switch (filter_type)
+    {
+    case FT_NONE:
+        memcpy(filtered, samples, length);
+        break;
+
+    case FT_SUB:
+        for (i = 0; i != bytewidth; ++i)
+        {
+            filtered[i] = samples[i];
+        }
+
+        for (i = bytewidth; i < length; ++i)
+        {
+            filtered[i] = samples[i] - samples[i - bytewidth];
+        }
+        break;
+
+    case FT_UP:
+        for (i = 0; i != length; ++i)
+        {
+            filtered[i] = samples[i] - presamples[i];
+        }
+        break;
+
+    case FT_AVERAGE:
+        for (i = 0; i != bytewidth; ++i)
+        {
+            filtered[i] = samples[i] - (presamples[i] >> 1u);
+        }
+
+        for (i = bytewidth; i < length; ++i)
+        {
+            filtered[i] = samples[i] - ((samples[i - bytewidth] + presamples[i]) >> 1u);
+        }
+        break;
+
+    case FT_PAETH:
+        for (i = 0; i != bytewidth; ++i)
+        {
+            filtered[i] = samples[i] - presamples[i];
+        }
+
+        for (i = bytewidth; i < length; ++i)
+        {
+            filtered[i] = samples[i] - paeth_predictor(samples[i - bytewidth], presamples[i], presamples[i - bytewidth]);
+        }
+        break;
+
+    default:
+        Assert::not_reached();
+    }
+}
+
+/* --- SSE2 ----------------------------------------------------------------- */
+
+// Sub, Average and Paeth depend on the pixel to the left, so rather than
+// sixteen bytes at a time these work a whole pixel at a time, with every
+// channel in its own lane. That covers RGB and RGBA, the formats wallpapers
+// and icons come in, the others go through the scalar code.
+
+#ifdef PNG_SCANLINE_SSE2
+
+#    define SSE2 __attribute__((target("sse2")))
+
+static bool has_sse2()
+{
+#    ifdef __x86_64__
+    return true;
+#    else
+    static int sse2 = -1;
+
+    if (sse2 < 0)
+    {
+        unsigned int eax, ebx, ecx, edx;
+        sse2 = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (edx & bit_SSE2);
+    }
+
+    return sse2;
+#    endif
+}
+
+template <size_t BPP>
+SSE2 static inline __m128i load_pixel(const uint8_t *pixel)
+{
+    uint32_t value = 0;
+    memcpy(&value, pixel, BPP);
+    return _mm_cvtsi32_si128(value);
+}
+
+template <size_t BPP>
+SSE2 static inline void store_pixel(uint8_t *pixel, __m128i value)
+{
+    uint32_t raw = _mm_cvtsi128_si32(value);
+    memcpy(pixel, &raw, BPP);
+}
+
+SSE2 static inline __m128i abs_epi16(__m128i value)
+{
+    return _mm_max_epi16(value, _mm_sub_epi16(_mm_setzero_si128(), value));
+}
+
+SSE2 static inline __m128i blend(__m128i mask, __m128i if_set, __m128i if_clear)
+{
+    return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+}
+
+template <size_t BPP>
+SSE2 static void unfilter_sub(uint8_t *recon, const uint8_t *scanline, size_t length)
+{
+    __m128i a = _mm_setzero_si128();
+
+    for (size_t i = 0; i + BPP <= length; i += BPP)
+    {
+        a = _mm_add_epi8(a, load_pixel<BPP>(scanline + i));
+        store_pixel<BPP>(recon + i, a);
+    }
+}
+
+SSE2 static void unfilter_up(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(scanline + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(precon + i));
+        _mm_storeu_si128((__m128i *)(recon + i), _mm_add_epi8(x, b));
+    }
+
+    for (; i < length; i++)
+    {
+        recon[i] = scanline[i] + precon[i];
+    }
+}
+
+template <size_t BPP>
+SSE2 static void unfilter_average(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, size_t length)
+{
+    __m128i one = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+
+    for (size_t i = 0; i + BPP <= length; i += BPP)
+    {
+        __m128i b = load_pixel<BPP>(precon + i);
+
+        // avg_epu8 rounds up, the filter rounds down.
+        __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+
+        a = _mm_add_epi8(load_pixel<BPP>(scanline + i), average);
+        store_pixel<BPP>(recon + i, a);
+    }
+}
+
+template <size_t BPP>
+SSE2 static void unfilter_paeth(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, size_t length)
+{
+    __m128i zero = _mm_setzero_si128();
+
+    // Widened to 16 bits so the differences don't overflow.
+    __m128i a = zero;
+    __m128i c = zero;
+
+    for (size_t i = 0; i + BPP <= length; i += BPP)
+    {
+        __m128i b = _mm_unpacklo_epi8(load_pixel<BPP>(precon + i), zero);
+
+        __m128i pa = abs_epi16(_mm_sub_epi16(b, c));
+        __m128i pb = abs_epi16(_mm_sub_epi16(a, c));
+        __m128i pc = abs_epi16(_mm_sub_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, c)));
+
+        // Same priorities as paeth_predictor()
+        __m128i mask = _mm_cmplt_epi16(pb, pa);
+        __m128i predictor = blend(mask, b, a);
+        pa = _mm_min_epi16(pa, pb);
+
+        mask = _mm_cmplt_epi16(pc, pa);
+        predictor = blend(mask, c, predictor);
+
+        __m128i x = _mm_add_epi8(load_pixel<BPP>(scanline + i), _mm_packus_epi16(predictor, predictor));
+        store_pixel<BPP>(recon + i, x);
+
+        a = _mm_unpacklo_epi8(x, zero);
+        c = b;
+    }
+}
+
+template <size_t BPP>
+SSE2 static bool unfilter_scanline_sse2(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
+                                        FilterType filter_type, size_t length)
+{
+    switch (filter_type)
+    {
+    case FT_SUB:
+        unfilter_sub<BPP>(recon, scanline, length);
+        return true;
+
+    case FT_UP:
+        if (!precon)
+        {
+            return false;
+        }
+
+        unfilter_up(recon, scanline, precon, length);
+        return true;
+
+    case FT_AVERAGE:
+        if (!precon)
+        {
+            return false;
+        }
+
+        unfilter_average<BPP>(recon, scanline, precon, length);
+        return true;
+
+    case FT_PAETH:
+        if (!precon)
+        {
+            return false;
+        }
+
+        unfilter_paeth<BPP>(recon, scanline, precon, length);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// Four pixels at a time: the twelve bytes they take are spread in the four
+// lanes by shifting the register, the byte left over in each lane becomes
+// the alpha.
+SSE2 static size_t convert_rgb_sse2(const uint8_t *samples, Color *pixels, size_t count)
+{
+    __m128i alpha = _mm_set1_epi32(0xff000000);
+
+    size_t i = 0;
+
+    // Loads are sixteen bytes wide, stop before reading past the samples.
+    for (; i + 6 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(samples + i * 3));
+
+        __m128i p01 = _mm_unpacklo_epi32(x, _mm_srli_si128(x, 3));
+        __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(x, 6), _mm_srli_si128(x, 9));
+
+        _mm_storeu_si128((__m128i *)(pixels + i), _mm_or_si128(_mm_unpacklo_epi64(p01, p23), alpha));
+    }
+
+    return i;
+}
+
+SSE2 static size_t convert_grey_sse2(const uint8_t *samples, Color *pixels, size_t count)
+{
+    __m128i alpha = _mm_set1_epi32(0xff000000);
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i grey = _mm_loadu_si128((const __m128i *)(samples + i));
+
+        __m128i low = _mm_unpacklo_epi8(grey, grey);
+        __m128i high = _mm_unpackhi_epi8(grey, grey);
+
+        _mm_storeu_si128((__m128i *)(pixels + i + 0), _mm_or_si128(_mm_unpacklo_epi16(low, low), alpha));
+        _mm_storeu_si128((__m128i *)(pixels + i + 4), _mm_or_si128(_mm_unpackhi_epi16(low, low), alpha));
+        _mm_storeu_si128((__m128i *)(pixels + i + 8), _mm_or_si128(_mm_unpacklo_epi16(high, high), alpha));
+        _mm_storeu_si128((__m128i *)(pixels + i + 12), _mm_or_si128(_mm_unpackhi_epi16(high, high), alpha));
+    }
+
+    return i;
+}
+
+#endif
+
+/* --- Dispatch ------------------------------------------------------------- */
+
+Result unfilter_scanline(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
+                         size_t bytewidth, FilterType filter_type, size_t length)
+{
+#ifdef PNG_SCANLINE_SSE2
+    if (has_sse2())
+    {
+        if (bytewidth == 4 && unfilter_scanline_sse2<4>(recon, scanline, precon, filter_type, length))
+        {
+            return SUCCESS;
+        }
+
+        if (bytewidth == 3 && unfilter_scanline_sse2<3>(recon, scanline, precon, filter_type, length))
+        {
+            return SUCCESS;
+        }
+
+        if (filter_type == FT_UP && precon)
+        {
+            unfilter_up(recon, scanline, precon, length);
+            return SUCCESS;
+        }
+    }
+#endif
+
+    return unfilter_scanline_scalar(recon, scanline, precon, bytewidth, filter_type, length);
+}
+
+void convert_scanline(ColourType colour_type, const Vector<Color> &palette,
+                      const uint8_t *samples, Color *pixels, size_t count)
+{
+    static_assert(sizeof(Color) == 4);
+
+    // Colors are laid out as RGBA bytes, these samples already are pixels.
+    if (colour_type == CT_RGBA)
+    {
+        if ((const void *)samples != (const void *)pixels)
+        {
+            memcpy(pixels, samples, count * sizeof(Color));
+        }
+
+        return;
+    }
+
+    size_t done = 0;
+
+#ifdef PNG_SCANLINE_SSE2
+    if (has_sse2() && colour_type == CT_RGB)
+    {
+        done = convert_rgb_sse2(samples, pixels, count);
+    }
+    else if (has_sse2() && colour_type == CT_GREY)
+    {
+        done = convert_grey_sse2(samples, pixels, count);
+    }
+#endif
+
+    convert_scanline_scalar(colour_type, palette, samples, pixels, done, count);
+}
+
+} // namespace Graphic::Png
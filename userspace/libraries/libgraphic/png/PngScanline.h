@@ -0,0 +1,26 @@
+#pragma once
+
+#include <libgraphic/Color.h>
+#include <libgraphic/png/PngCommon.h>
+#include <libsystem/Result.h>
+#include <libutils/Vector.h>
+
+namespace Graphic::Png
+{
+
+// Reverses the filter of one scanline. precon is the previous unfiltered
+// scanline, or null for the first one, it must not overlap recon.
+// recon and scanline may be the same memory.
+Result unfilter_scanline(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
+                         size_t bytewidth, FilterType filter_type, size_t length);
+
+// Applies the filter to one row of samples, the reverse of unfilter_scanline.
+// presamples is the previous row, all zeros for the first one.
+void filter_scanline(uint8_t *filtered, const uint8_t *samples, const uint8_t *presamples,
+                     size_t bytewidth, FilterType filter_type, size_t length);
+
+// Expands unfiltered 8 bit samples to colors.
+void convert_scanline(ColourType colour_type, const Vector<Color> &palette,
+                      const uint8_t *samples, Color *pixels, size_t count);
+
+} // namespace Graphic::Png
@@ -0,0 +1,234 @@
+#include <libcompression/CRC.h>
+#include <libcompression/Deflate.h>
+#include <libgraphic/png/PngScanline.h>
+#include <libgraphic/png/PngWriter.h>
+#include <libio/Write.h>
+#include <libutils/Array.h>
+
+#include <string.h>
+
+namespace Graphic
+{
+
+PngWriter::PngWriter(IO::Writer &writer, unsigned int compression_level)
+    : _writer(writer), _compression_level(compression_level)
+{
+}
+
+Result PngWriter::write(Bitmap &bitmap)
+{
+    Array<uint8_t, 8> signature{137, 80, 78, 71, 13, 10, 26, 10};
+    TRY(_writer.write(signature.raw_storage(), sizeof(signature)));
+
+    auto colour_type = Png::CT_RGB;
+
+    for (int i = 0; i < bitmap.width() * bitmap.height(); i++)
+    {
+        if (bitmap.pixels()[i].alpha() != 0xff)
+        {
+            colour_type = Png::CT_RGBA;
+            break;
+        }
+    }
+
+    Png::ImageHeader image_header{
+        (uint32_t)bitmap.width(),
+        (uint32_t)bitmap.height(),
+        8,
+        colour_type,
+        Png::CM_Inflate,
+        0,
+        0,
+    };
+
+    TRY(write_chunk(Png::ImageHeader::SIG, &image_header, sizeof(image_header)));
+
+    ImageDataWriter image_data{*this};
+
+    // Two bytes before the actual deflate data, the level is only a hint.
+    // See https://www.w3.org/TR/2003/REC-PNG-20031110/#10Compression
+    uint8_t cm_cinfo = 0x78;
+    uint8_t flags = _compression_level < 2 ? 0x01 : _compression_level < 6 ? 0x5e : _compression_level == 6 ? 0x9c : 0xda;
+
+    TRY(IO::write(image_data, cm_cinfo));
+    TRY(IO::write(image_data, flags));
+
+    ScanlineReader scanlines{bitmap, colour_type};
+    Compression::Deflate deflate{_compression_level};
+    TRY(deflate.perform(scanlines, image_data));
+
+    be_uint32_t adler32 = scanlines.checksum();
+    TRY(IO::write(image_data, adler32));
+    TRY(image_data.finish());
+
+    return write_chunk(Png::ImageEnd::SIG, nullptr, 0);
+}
+
+/* --- Chunks --------------------------------------------------------------- */
+
+Result PngWriter::write_chunk(uint32_t signature, const void *data, size_t size)
+{
+    be_uint32_t length = size;
+    be_uint32_t be_signature = signature;
+
+    TRY(IO::write(_writer, length));
+    TRY(IO::write(_writer, be_signature));
+
+    if (size > 0)
+    {
+        TRY(_writer.write(data, size));
+    }
+
+    // CRC checksum includes the chunk signature and chunk data
+    // See https://www.w3.org/TR/2003/REC-PNG-20031110/#5Introduction
+    Compression::CRC crc;
+    crc.add(reinterpret_cast<const uint8_t *>(&be_signature), sizeof(be_signature));
+    crc.add(static_cast<const uint8_t *>(data), size);
+
+    be_uint32_t checksum = crc.checksum();
+    TRY(IO::write(_writer, checksum));
+
+    return SUCCESS;
+}
+
+ResultOr<size_t> PngWriter::ImageDataWriter::write(const void *buffer, size_t size)
+{
+    auto data = static_cast<const uint8_t *>(buffer);
+
+    for (size_t remaining = size; remaining > 0;)
+    {
+        size_t copied = MIN(remaining, _chunk.count() - _used);
+        memcpy(_chunk.raw_storage() + _used, data, copied);
+
+        _used += copied;
+        data += copied;
+        remaining -= copied;
+
+        if (_used == _chunk.count())
+        {
+            TRY(finish());
+        }
+    }
+
+    return size;
+}
+
+Result PngWriter::ImageDataWriter::finish()
+{
+    if (_used == 0)
+    {
+        return SUCCESS;
+    }
+
+    TRY(_png.write_chunk(Png::ImageData::SIG, _chunk.raw_storage(), _used));
+    _used = 0;
+
+    return SUCCESS;
+}
+
+/* --- Scanlines ------------------------------------------------------------ */
+
+PngWriter::ScanlineReader::ScanlineReader(Bitmap &bitmap, Png::ColourType colour_type)
+    : _bitmap{bitmap}, _colour_type{colour_type}
+{
+    _bytes_per_pixel = colour_type == Png::CT_RGBA ? 4 : 3;
+
+    size_t linebytes = bitmap.width() * _bytes_per_pixel;
+
+    _samples.resize(linebytes);
+    _presamples.resize(linebytes);
+    _scanline.resize(1 + linebytes);
+    _candidate.resize(linebytes);
+
+    _scanline_position = _scanline.count();
+}
+
+static size_t filter_cost(const uint8_t *filtered, size_t length)
+{
+    size_t cost = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        cost += __builtin_abs((int8_t)filtered[i]);
+    }
+
+    return cost;
+}
+
+// Picks for each row the filter giving the smallest sum of absolute values,
+// the heuristic suggested by the specification.
+// See https://www.w3.org/TR/2003/REC-PNG-20031110/#12Filter-selection
+void PngWriter::ScanlineReader::filter_row()
+{
+    size_t linebytes = _samples.count();
+    const Color *pixels = _bitmap.pixels() + _row * _bitmap.width();
+
+    // Colors are laid out as RGBA bytes.
+    if (_colour_type == Png::CT_RGBA)
+    {
+        memcpy(_samples.raw_storage(), pixels, linebytes);
+    }
+    else
+    {
+        uint8_t *samples = _samples.raw_storage();
+
+        for (int x = 0; x < _bitmap.width(); x++)
+        {
+            samples[x * 3 + 0] = pixels[x].red();
+            samples[x * 3 + 1] = pixels[x].green();
+            samples[x * 3 + 2] = pixels[x].blue();
+        }
+    }
+
+    uint8_t *scanline = _scanline.raw_storage();
+    size_t best_cost = SIZE_MAX;
+
+    for (auto filter_type : {Png::FT_NONE, Png::FT_SUB, Png::FT_UP, Png::FT_AVERAGE, Png::FT_PAETH})
+    {
+        Png::filter_scanline(_candidate.raw_storage(), _samples.raw_storage(), _presamples.raw_storage(), _bytes_per_pixel, filter_type, linebytes);
+
+        size_t cost = filter_cost(_candidate.raw_storage(), linebytes);
+
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            scanline[0] = filter_type;
+            memcpy(scanline + 1, _candidate.raw_storage(), linebytes);
+        }
+    }
+
+    memcpy(_presamples.raw_storage(), _samples.raw_storage(), linebytes);
+
+    _adler32.add(scanline, _scanline.count());
+    _scanline_position = 0;
+    _row++;
+}
+
+ResultOr<size_t> PngWriter::ScanlineReader::read(void *buffer, size_t size)
+{
+    auto data = static_cast<uint8_t *>(buffer);
+    size_t read = 0;
+
+    while (read < size)
+    {
+        if (_scanline_position == _scanline.count())
+        {
+            if (_row == _bitmap.height())
+            {
+                break;
+            }
+
+            filter_row();
+        }
+
+        size_t copied = MIN(size - read, _scanline.count() - _scanline_position);
+        memcpy(data + read, _scanline.raw_storage() + _scanline_position, copied);
+
+        _scanline_position += copied;
+        read += copied;
+    }
+
+    return read;
+}
+
+} // namespace Graphic
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <libcompression/Adler32.h>
+#include <libgraphic/Bitmap.h>
+#include <libgraphic/png/PngCommon.h>
+#include <libio/Reader.h>
+#include <libio/Writer.h>
+#include <libutils/Vector.h>
+
+namespace Graphic
+{
+class PngWriter
+{
+private:
+    // Size of the IDAT chunks the compressed data is cut into.
+    static constexpr size_t IMAGE_DATA_CHUNK_SIZE = 32768;
+
+    // Filters the rows of the bitmap as the compressor asks for more data,
+    // keeping only two rows in memory.
+    class ScanlineReader : public IO::Reader
+    {
+    private:
+        Bitmap &_bitmap;
+        Png::ColourType _colour_type;
+        size_t _bytes_per_pixel;
+        int _row = 0;
+
+        // The row being filtered and the one above it, all zeros for the
+        // first row.
+        Vector<uint8_t> _samples;
+        Vector<uint8_t> _presamples;
+
+        // Filter byte followed by the filtered row, and the filter being
+        // tried against it.
+        Vector<uint8_t> _scanline;
+        Vector<uint8_t> _candidate;
+        size_t _scanline_position;
+
+        Compression::Adler32 _adler32;
+
+        void filter_row();
+
+    public:
+        ScanlineReader(Bitmap &bitmap, Png::ColourType colour_type);
+
+        uint32_t checksum() { return _adler32.checksum(); }
+
+        ResultOr<size_t> read(void *buffer, size_t size) override;
+    };
+
+    // Cuts the compressed stream into IDAT chunks.
+    class ImageDataWriter : public IO::Writer
+    {
+    private:
+        PngWriter &_png;
+        Vector<uint8_t> _chunk;
+        size_t _used = 0;
+
+    public:
+        ImageDataWriter(PngWriter &png) : _png{png}
+        {
+            _chunk.resize(IMAGE_DATA_CHUNK_SIZE);
+        }
+
+        // Writes what's left in the last chunk.
+        Result finish();
+
+        ResultOr<size_t> write(const void *buffer, size_t size) override;
+    };
+
+    IO::Writer &_writer;
+    unsigned int _compression_level;
+
+    Result write_chunk(uint32_t signature, const void *data, size_t size);
+
+public:
+    // Greedy matching, screenshots and drawings are mostly flat areas which
+    // compress well without searching much.
+    static constexpr unsigned int DEFAULT_COMPRESSION_LEVEL = 3;
+
+    PngWriter(IO::Writer &writer, unsigned int compression_level = DEFAULT_COMPRESSION_LEVEL);
+
+    // Opaque bitmaps are saved without their alpha channel.
+    Result write(Bitmap &bitmap);
+};
+
+} // namespace Graphic
@@ -1,3 +1,4 @@
+#include <libasync/Parallel.h>
 #include <libsystem/Logger.h>
 
 #include <libgraphic/Painter.h>
@@ -8,7 +9,6 @@ namespace Graphic
 
 Rasterizer::Rasterizer(RefPtr<Bitmap> bitmap) : _bitmap{bitmap}
 {
-    _scanline.resize(_bitmap->width());
 }
 
 void Rasterizer::clear()
@@ -54,37 +54,42 @@ void Rasterizer::flatten(const Path &path, const Math::Mat3x2f &transform)
     }
 }
 
-void Rasterizer::rasterize(Paint &paint)
+void Rasterizer::rasterize_band(Paint &paint, Math::Recti bound, int top, int bottom)
 {
+    Vector<uint16_t> coverage;
+    coverage.resize(_bitmap->width());
+
+    Vector<Math::Edgef> actives_edges;
+
     auto line = [&](float start, float end) {
         for (float x = start; x < end; x += 1.0f / 4)
         {
-            if ((int)x < (int)_scanline.count())
+            if ((int)x < (int)coverage.count())
             {
-                _scanline[(int)x] += 1;
+                coverage[(int)x] += 1;
             }
         }
     };
 
     auto scanline = [&](int start, int end, float y) {
-        _actives_edges.clear();
+        actives_edges.clear();
 
         for (auto &edge : _edges.edges())
         {
             if (y >= edge.min_y() && y < edge.max_y())
             {
-                _actives_edges.push_back(edge);
+                actives_edges.push_back(edge);
             }
         }
 
-        _actives_edges.sort([&](Math::Edgef &a, Math::Edgef &b) { return a.intersection_y(y).x() - b.intersection_y(y).x(); });
+        actives_edges.sort([&](Math::Edgef &a, Math::Edgef &b) { return a.intersection_y(y).x() - b.intersection_y(y).x(); });
 
         bool odd_even = true;
 
-        for (size_t i = 0; i + 1 < _actives_edges.count(); i++)
+        for (size_t i = 0; i + 1 < actives_edges.count(); i++)
         {
-            auto &a = _actives_edges[i];
-            auto &b = _actives_edges[i + 1];
+            auto &a = actives_edges[i];
+            auto &b = actives_edges[i + 1];
 
             float seg_start = MAX(a.intersection_y(y).x(), start);
             float seg_end = MIN(b.intersection_y(y).x(), end);
@@ -98,13 +103,11 @@ void Rasterizer::rasterize(Paint &paint)
         }
     };
 
-    auto bound = get_clip();
-
-    for (int y = bound.top(); y < bound.bottom(); y++)
+    for (int y = top; y < bottom; y++)
     {
         for (int i = bound.left(); i < bound.right(); i++)
         {
-            _scanline[i] = 0;
+            coverage[i] = 0;
         }
 
         for (float yy = (y - 0.5f); yy < (y + 0.5f); yy += 1.0f / 4)
@@ -120,7 +123,7 @@ void Rasterizer::rasterize(Paint &paint)
             };
 
             auto color = sample(paint, p);
-            auto alpha = clamp((_scanline[i] / 16.0f), 0, 1);
+            auto alpha = clamp((coverage[i] / 16.0f), 0, 1);
 
             if (alpha >= 0.003f)
             {
@@ -130,6 +133,21 @@ void Rasterizer::rasterize(Paint &paint)
     }
 }
 
+void Rasterizer::rasterize(Paint &paint)
+{
+    auto bound = get_clip();
+
+    if (bound.is_empty())
+    {
+        return;
+    }
+
+    // Bands only write their own rows, so they don't need to synchronize.
+    Async::parallel_for(bound.top(), bound.bottom(), BAND_HEIGHT, [&](size_t top, size_t bottom) {
+        rasterize_band(paint, bound, top, bottom);
+    });
+}
+
 void FLATTEN Rasterizer::fill(Path &path, const Math::Mat3x2f &transform, Paint paint)
 {
     clear();
@@ -16,16 +16,20 @@ private:
     static constexpr auto TOLERANCE = 0.25f;
     static constexpr auto MAX_DEPTH = 8;
 
+    // Rows per job, each band gets its own coverage buffer and can be filled
+    // independently from the others.
+    static constexpr auto BAND_HEIGHT = 16;
+
     RefPtr<Bitmap> _bitmap;
     EdgeList _edges;
-    Vector<Math::Edgef> _actives_edges;
     Optional<Math::Recti> _clip;
-    Vector<uint16_t> _scanline;
 
     void clear();
 
     void flatten(const Path &path, const Math::Mat3x2f &transform);
 
+    void rasterize_band(Paint &paint, Math::Recti bound, int top, int bottom);
+
     void rasterize(Paint &paint);
 
 public:
@@ -16,42 +16,105 @@ public:
         flush();
     }
 
+    // Up to 32 bits at once, least significant bit first.
     inline void put_bits(unsigned int v, const size_t num_bits)
     {
-        _bit_buffer |= v << _bit_count;
+        _bit_buffer |= (uint64_t)v << _bit_count;
         _bit_count += num_bits;
+
+        if (_bit_count >= 32)
+        {
+            flush_bits();
+        }
     }
 
+    // The writer has to be aligned first.
     inline void put_data(const uint8_t *data, size_t len)
     {
-        _writer.write(data, len);
+        flush_bits();
+        flush_buffer();
+
+        while (_result == SUCCESS && len > 0)
+        {
+            auto written = _writer.write(data, len);
+
+            if (!written.success() || written.unwrap() == 0)
+            {
+                _result = written.success() ? ERR_NOT_WRITABLE : written.result();
+                return;
+            }
+
+            data += written.unwrap();
+            len -= written.unwrap();
+        }
     }
 
     inline void put_uint16(uint16_t v)
     {
-        IO::write(_writer, v);
+        put_bits(v, 16);
     }
 
     inline void align()
     {
         _bit_count += -_bit_count & 7;
-        flush();
+        flush_bits();
     }
 
-    inline void flush()
+    // Writes out everything but an incomplete last byte, returns the first
+    // error the underlying writer ran into.
+    inline Result flush()
+    {
+        flush_bits();
+        flush_buffer();
+
+        return _result;
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 4096;
+
+    uint64_t _bit_buffer = 0;
+    uint8_t _bit_count = 0;
+
+    uint8_t _buffer[BUFFER_SIZE];
+    size_t _buffer_used = 0;
+
+    Result _result = SUCCESS;
+    Writer &_writer;
+
+    inline void flush_bits()
     {
-        // Flush one byte at a time
         while (_bit_count >= 8)
         {
-            IO::write(_writer, (uint8_t)_bit_buffer);
+            if (_buffer_used == BUFFER_SIZE)
+            {
+                flush_buffer();
+            }
+
+            _buffer[_buffer_used++] = (uint8_t)_bit_buffer;
             _bit_count -= 8;
             _bit_buffer >>= 8;
         }
     }
 
-private:
-    uint_fast32_t _bit_buffer;
-    uint8_t _bit_count;
-    Writer &_writer;
+    inline void flush_buffer()
+    {
+        size_t written = 0;
+
+        while (_result == SUCCESS && written < _buffer_used)
+        {
+            auto result = _writer.write(_buffer + written, _buffer_used - written);
+
+            if (!result.success() || result.unwrap() == 0)
+            {
+                _result = result.success() ? ERR_NOT_WRITABLE : result.result();
+                break;
+            }
+
+            written += result.unwrap();
+        }
+
+        _buffer_used = 0;
+    }
 };
 } // namespace IO
\ No newline at end of file
@@ -38,12 +38,19 @@ public:
 
     ~BufReader()
     {
-        delete _buffer;
+        delete[] _buffer;
     }
 
+    // Fills the buffer first if it is empty, so it can be used to peek at
+    // the size of small inputs.
     ResultOr<size_t> buffered()
     {
-        return _used;
+        if (_head == _used)
+        {
+            TRY(fill());
+        }
+
+        return _used - _head;
     }
 
     ResultOr<size_t> read(void *buffer, size_t size) override
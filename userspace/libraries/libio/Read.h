@@ -42,6 +42,27 @@ inline ResultOr<T> peek(SeekableReader auto &reader)
     return result;
 }
 
+// Streams like connections hand out whatever they have at the moment, this
+// keeps reading until `size` bytes came in.
+inline Result read_exactly(Reader &reader, void *buffer, size_t size)
+{
+    size_t total = 0;
+
+    while (total < size)
+    {
+        size_t read = TRY(reader.read((uint8_t *)buffer + total, size - total));
+
+        if (read == 0)
+        {
+            return ERR_STREAM_CLOSED;
+        }
+
+        total += read;
+    }
+
+    return SUCCESS;
+}
+
 template <typename T>
 inline ResultOr<T> read(Reader &reader)
 {
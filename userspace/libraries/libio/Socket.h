@@ -1,7 +1,12 @@
 #pragma once
 
+#include <abi/Network.h>
+
 #include <libio/Connection.h>
 #include <libio/Handle.h>
+#include <libio/Read.h>
+#include <libio/Write.h>
+#include <libmath/MinMax.h>
 
 namespace IO
 {
@@ -39,4 +44,174 @@ public:
     }
 };
 
+/* --- Network sockets ------------------------------------------------------ */
+
+// Every network socket is a connection of its own to the network service,
+// and every request waits for its response.
+static inline ResultOr<NetworkResponse> network_request(Connection &connection, NetworkRequest request, const void *payload = nullptr)
+{
+    TRY(write(connection, request));
+
+    if (payload != nullptr)
+    {
+        TRY(connection.write(payload, request.size));
+    }
+
+    NetworkResponse response;
+    TRY(read_exactly(connection, &response, sizeof(response)));
+    TRY(response.result);
+
+    return response;
+}
+
+static inline ResultOr<Connection> network_open(NetworkRequest request)
+{
+    auto connection = TRY(Socket::connect(NETWORK_SERVICE_PATH));
+    TRY(network_request(connection, request));
+    return connection;
+}
+
+class TcpSocket final :
+    public Reader,
+    public Writer,
+    public RawHandle
+{
+private:
+    Connection _connection;
+    NetworkEndpoint _remote;
+
+public:
+    RefPtr<Handle> handle() override { return _connection.handle(); }
+
+    NetworkEndpoint remote() { return _remote; }
+
+    TcpSocket(Connection connection, NetworkEndpoint remote)
+        : _connection{connection}, _remote{remote}
+    {
+    }
+
+    static ResultOr<TcpSocket> connect(NetworkEndpoint remote)
+    {
+        auto connection = TRY(network_open({NETWORK_TCP_CONNECT, remote, 0}));
+        return TcpSocket{connection, remote};
+    }
+
+    // Returns as soon as some data came in, zero once the other end closed
+    // the stream.
+    ResultOr<size_t> read(void *buffer, size_t size) override
+    {
+        size = MIN(size, NETWORK_SERVICE_CHUNK);
+
+        auto response = TRY(network_request(_connection, {NETWORK_RECEIVE, _remote, (uint32_t)size}));
+        TRY(read_exactly(_connection, buffer, response.size));
+
+        return response.size;
+    }
+
+    // Returns once everything is queued for sending, not once it is
+    // acknowledged.
+    ResultOr<size_t> write(const void *buffer, size_t size) override
+    {
+        size_t written = 0;
+
+        while (written < size)
+        {
+            size_t chunk = MIN(size - written, NETWORK_SERVICE_CHUNK);
+            TRY(network_request(_connection, {NETWORK_SEND, _remote, (uint32_t)chunk}, (const uint8_t *)buffer + written));
+            written += chunk;
+        }
+
+        return written;
+    }
+
+    // The connection is closed gracefully, what was written still goes out.
+    void close() { _connection.close(); }
+};
+
+class TcpListener :
+    public RawHandle
+{
+private:
+    Connection _connection;
+    uint16_t _port;
+
+public:
+    RefPtr<Handle> handle() override { return _connection.handle(); }
+
+    uint16_t port() { return _port; }
+
+    TcpListener(Connection connection, uint16_t port)
+        : _connection{connection}, _port{port}
+    {
+    }
+
+    static ResultOr<TcpListener> listen(uint16_t port)
+    {
+        auto connection = TRY(network_open({NETWORK_TCP_LISTEN, {{0}, port}, 0}));
+        return TcpListener{connection, port};
+    }
+
+    // Waits for the next incoming connection.
+    ResultOr<TcpSocket> accept()
+    {
+        auto connection = TRY(Socket::connect(NETWORK_SERVICE_PATH));
+        auto response = TRY(network_request(connection, {NETWORK_TCP_ACCEPT, {{0}, _port}, 0}));
+        return TcpSocket{connection, response.endpoint};
+    }
+
+    void close() { _connection.close(); }
+};
+
+class UdpSocket :
+    public RawHandle
+{
+private:
+    Connection _connection;
+    uint16_t _port;
+
+public:
+    RefPtr<Handle> handle() override { return _connection.handle(); }
+
+    uint16_t port() { return _port; }
+
+    UdpSocket(Connection connection, uint16_t port)
+        : _connection{connection}, _port{port}
+    {
+    }
+
+    // A port of zero picks any free one.
+    static ResultOr<UdpSocket> bind(uint16_t port)
+    {
+        auto connection = TRY(Socket::connect(NETWORK_SERVICE_PATH));
+        auto response = TRY(network_request(connection, {NETWORK_UDP_BIND, {{0}, port}, 0}));
+        return UdpSocket{connection, response.endpoint.port};
+    }
+
+    Result send_to(NetworkEndpoint destination, const void *buffer, size_t size)
+    {
+        if (size > NETWORK_SERVICE_CHUNK)
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        TRY(network_request(_connection, {NETWORK_SEND, destination, (uint32_t)size}, buffer));
+
+        return SUCCESS;
+    }
+
+    // Waits for the next datagram, what doesn't fit in `buffer` is dropped.
+    ResultOr<size_t> receive_from(void *buffer, size_t size, NetworkEndpoint &from)
+    {
+        size = MIN(size, NETWORK_SERVICE_CHUNK);
+
+        auto response = TRY(network_request(_connection, {NETWORK_RECEIVE, {{0}, 0}, (uint32_t)size}));
+        TRY(read_exactly(_connection, buffer, response.size));
+        from = response.endpoint;
+
+        return response.size;
+    }
+
+    void close() { _connection.close(); }
+};
+
 } // namespace IO
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <string.h>
+
+#include <libjson/Value.h>
+#include <libutils/Vector.h>
+
+namespace Json
+{
+
+// Compact binary form of a value: a type tag followed by its payload, with
+// lengths and integers stored as LEB128 varints. Nothing has to be escaped or
+// scanned, which makes it much cheaper to produce and to read back than text.
+// Tags are the Type plus one so a zero byte never starts a valid value.
+
+inline void encode_varint(Vector<uint8_t> &out, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        out.push_back(value ? (byte | 0x80) : byte);
+    } while (value);
+}
+
+inline void encode_string(Vector<uint8_t> &out, const String &string)
+{
+    encode_varint(out, string.length());
+    out.push_back_many(reinterpret_cast<const uint8_t *>(string.cstring()), string.length());
+}
+
+inline void encode(Vector<uint8_t> &out, const Value &value)
+{
+    out.push_back(value.type() + 1);
+
+    if (value.is(STRING))
+    {
+        encode_string(out, value.as_string());
+    }
+    else if (value.is(INTEGER))
+    {
+        int64_t integer = value.as_integer();
+        encode_varint(out, ((uint64_t)integer << 1) ^ (uint64_t)(integer >> 63));
+    }
+#ifndef __KERNEL__
+    else if (value.is(DOUBLE))
+    {
+        double number = value.as_double();
+        out.push_back_many(reinterpret_cast<const uint8_t *>(&number), sizeof(number));
+    }
+#endif
+    else if (value.is(OBJECT))
+    {
+        encode_varint(out, value.length());
+
+        value.as_object().foreach ([&](auto &key, auto &value) {
+            encode_string(out, key);
+            encode(out, value);
+
+            return Iteration::CONTINUE;
+        });
+    }
+    else if (value.is(ARRAY))
+    {
+        encode_varint(out, value.length());
+
+        for (size_t i = 0; i < value.length(); i++)
+        {
+            encode(out, value.get(i));
+        }
+    }
+}
+
+struct Decoder
+{
+    const uint8_t *data;
+    size_t size;
+    size_t offset = 0;
+    bool error = false;
+
+    bool ended() { return error || offset >= size; }
+
+    uint8_t next()
+    {
+        if (ended())
+        {
+            error = true;
+            return 0;
+        }
+
+        return data[offset++];
+    }
+
+    uint64_t varint()
+    {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64 && !ended(); shift += 7)
+        {
+            uint8_t byte = next();
+            value |= (uint64_t)(byte & 0x7f) << shift;
+
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+
+        error = true;
+        return 0;
+    }
+
+    String string()
+    {
+        size_t length = varint();
+
+        if (error || length > size - offset)
+        {
+            error = true;
+            return "";
+        }
+
+        String result{reinterpret_cast<const char *>(data + offset), length};
+        offset += length;
+
+        return result;
+    }
+};
+
+inline Value decode(Decoder &decoder)
+{
+    int type = decoder.next() - 1;
+
+    if (type == STRING)
+    {
+        return decoder.string();
+    }
+    else if (type == INTEGER)
+    {
+        uint64_t zigzag = decoder.varint();
+        return (int64_t)((zigzag >> 1) ^ -(zigzag & 1));
+    }
+#ifndef __KERNEL__
+    else if (type == DOUBLE)
+    {
+        double number = 0;
+
+        if (sizeof(number) > decoder.size - decoder.offset)
+        {
+            decoder.error = true;
+            return nullptr;
+        }
+
+        memcpy(&number, decoder.data + decoder.offset, sizeof(number));
+        decoder.offset += sizeof(number);
+
+        return number;
+    }
+#endif
+    else if (type == OBJECT)
+    {
+        Value::Object object{};
+        size_t count = decoder.varint();
+
+        for (size_t i = 0; i < count && !decoder.error; i++)
+        {
+            auto key = decoder.string();
+            object[key] = decode(decoder);
+        }
+
+        return object;
+    }
+    else if (type == ARRAY)
+    {
+        Value::Array array{};
+        size_t count = decoder.varint();
+
+        for (size_t i = 0; i < count && !decoder.error; i++)
+        {
+            array.push_back(decode(decoder));
+        }
+
+        return move(array);
+    }
+    else if (type == TRUE)
+    {
+        return true;
+    }
+    else if (type == FALSE)
+    {
+        return false;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+inline Value decode(const uint8_t *data, size_t size)
+{
+    Decoder decoder{data, size};
+    return decode(decoder);
+}
+
+} // namespace Json
@@ -5,13 +5,24 @@
 #include <libio/Scanner.h>
 #include <libio/ScopedReader.h>
 #include <libjson/Value.h>
+#include <libutils/Intern.h>
 #include <libutils/StringBuilder.h>
 #include <libutils/Strings.h>
 
 namespace Json
 {
 
-Value value(IO::Scanner &scan);
+// Parses object keys into interned strings. Interned strings are never
+// released, so only pass it for documents with a known set of keys, like
+// themes and configuration files.
+enum class InternKeysTag
+{
+    __value
+};
+
+constexpr auto INTERN_KEYS = InternKeysTag::__value;
+
+Value value(IO::Scanner &scan, bool intern_keys = false);
 
 inline void whitespace(IO::Scanner &scan)
 {
@@ -128,10 +139,8 @@ static inline const char *escape_sequence(IO::Scanner &scan)
     return buffer;
 }
 
-inline String string(IO::Scanner &scan)
+inline void string(IO::Scanner &scan, StringBuilder &builder)
 {
-    StringBuilder builder{};
-
     scan.skip('"');
 
     while (scan.current() != '"' && scan.do_continue())
@@ -148,11 +157,31 @@ inline String string(IO::Scanner &scan)
     }
 
     scan.skip('"');
+}
+
+inline String string(IO::Scanner &scan)
+{
+    StringBuilder builder{};
+    string(scan, builder);
+    return builder.finalize();
+}
+
+// Interned keys come straight from the builder, so a known key costs no
+// allocation at all.
+inline String key(IO::Scanner &scan, bool intern_keys)
+{
+    StringBuilder builder{};
+    string(scan, builder);
+
+    if (intern_keys)
+    {
+        return intern(builder.cstring(), builder.length());
+    }
 
     return builder.finalize();
 }
 
-inline Value array(IO::Scanner &scan)
+inline Value array(IO::Scanner &scan, bool intern_keys = false)
 {
     scan.skip('[');
 
@@ -170,7 +199,7 @@ inline Value array(IO::Scanner &scan)
     do
     {
         scan.skip(',');
-        array.push_back(value(scan));
+        array.push_back(value(scan, intern_keys));
         index++;
     } while (scan.current() == ',');
 
@@ -179,7 +208,7 @@ inline Value array(IO::Scanner &scan)
     return move(array);
 }
 
-inline Value object(IO::Scanner &scan)
+inline Value object(IO::Scanner &scan, bool intern_keys = false)
 {
     scan.skip('{');
 
@@ -194,12 +223,12 @@ inline Value object(IO::Scanner &scan)
 
     while (scan.current() != '}')
     {
-        auto k = string(scan);
+        auto k = key(scan, intern_keys);
         whitespace(scan);
 
         scan.skip(':');
 
-        object[k] = value(scan);
+        object[k] = value(scan, intern_keys);
 
         scan.skip(',');
 
@@ -237,7 +266,7 @@ inline Value keyword(IO::Scanner &scan)
     return nullptr;
 }
 
-inline Value value(IO::Scanner &scan)
+inline Value value(IO::Scanner &scan, bool intern_keys)
 {
     whitespace(scan);
 
@@ -254,11 +283,11 @@ inline Value value(IO::Scanner &scan)
     }
     else if (scan.current() == '{')
     {
-        value = object(scan);
+        value = object(scan, intern_keys);
     }
     else if (scan.current() == '[')
     {
-        value = array(scan);
+        value = array(scan, intern_keys);
     }
     else
     {
@@ -289,4 +318,17 @@ inline Value parse(String &str)
     return parse(memory);
 }
 
+inline Value parse(IO::Reader &reader, InternKeysTag)
+{
+    IO::Scanner scan{reader};
+    scan.skip_utf8bom();
+    return value(scan, true);
+}
+
+inline Value parse(const char *buffer, size_t size, InternKeysTag tag)
+{
+    IO::MemoryReader memory{buffer, size};
+    return parse(memory, tag);
+}
+
 } // namespace Json
\ No newline at end of file
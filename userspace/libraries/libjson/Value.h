@@ -59,6 +59,8 @@ private:
     };
 
 public:
+    inline Type type() const { return _type; }
+
     inline bool is(Type type) const { return _type == type; }
 
     inline String as_string() const
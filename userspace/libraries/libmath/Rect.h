@@ -446,7 +446,7 @@ public:
     bool contains(Rect other) const
     {
         return left() <= other.left() && right() >= other.right() &&
-               right() <= other.top() && bottom() >= other.bottom();
+               top() <= other.top() && bottom() >= other.bottom();
     }
 
     Border contains(Insets<Scalar> spacing, Vec2<Scalar> position) const
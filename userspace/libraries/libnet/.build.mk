@@ -0,0 +1,3 @@
+LIBS += NET
+
+NET_NAME = net
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <abi/Network.h>
+#include <libutils/Optional.h>
+
+namespace Net
+{
+
+static constexpr MacAddress MAC_BROADCAST = {{0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
+
+static constexpr Ipv4Address IPV4_ANY = {0};
+static constexpr Ipv4Address IPV4_BROADCAST = {0xffffffff};
+
+// Parses the dotted decimal form, "10.0.2.15".
+static inline Optional<Ipv4Address> parse_ipv4(const char *string)
+{
+    uint32_t value = 0;
+
+    for (int octet = 0; octet < 4; octet++)
+    {
+        if (octet > 0 && *string++ != '.')
+        {
+            return {};
+        }
+
+        if (*string < '0' || *string > '9')
+        {
+            return {};
+        }
+
+        uint32_t number = 0;
+
+        while (*string >= '0' && *string <= '9')
+        {
+            number = number * 10 + (*string++ - '0');
+
+            if (number > 255)
+            {
+                return {};
+            }
+        }
+
+        value = (value << 8) | number;
+    }
+
+    if (*string != '\0')
+    {
+        return {};
+    }
+
+    return Ipv4Address{value};
+}
+
+} // namespace Net
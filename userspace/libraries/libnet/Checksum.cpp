@@ -0,0 +1,39 @@
+#include <libnet/Checksum.h>
+
+namespace Net
+{
+
+void Checksum::add(const void *data, size_t size)
+{
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+
+    // Carries pile up in the upper bits and get folded back in finish().
+    uint64_t sum = _sum;
+    size_t i = 0;
+
+    for (; i + 1 < size; i += 2)
+    {
+        sum += (bytes[i] << 8) | bytes[i + 1];
+    }
+
+    if (i < size)
+    {
+        sum += bytes[i] << 8;
+    }
+
+    _sum = sum;
+}
+
+uint16_t Checksum::finish() const
+{
+    uint64_t sum = _sum;
+
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+    return ~sum & 0xffff;
+}
+
+} // namespace Net
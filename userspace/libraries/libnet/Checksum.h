@@ -0,0 +1,36 @@
+#pragma once
+
+#include <abi/Network.h>
+
+namespace Net
+{
+
+// The ones' complement sum shared by IPv4, ICMP, UDP and TCP. Data is added
+// as big endian 16 bits words, only the last chunk added may have an odd
+// size.
+class Checksum
+{
+private:
+    uint64_t _sum = 0;
+
+public:
+    void add(const void *data, size_t size);
+
+    void add(uint16_t value) { _sum += value; }
+
+    void add(uint32_t value) { _sum += (value >> 16) + (value & 0xffff); }
+
+    // Covers the addresses, protocol and length, what UDP and TCP call the
+    // pseudo header.
+    void add_pseudo_header(Ipv4Address source, Ipv4Address destination, uint8_t protocol, uint16_t length)
+    {
+        add(source.value);
+        add(destination.value);
+        add((uint16_t)protocol);
+        add(length);
+    }
+
+    uint16_t finish() const;
+};
+
+} // namespace Net
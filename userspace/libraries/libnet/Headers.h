@@ -0,0 +1,122 @@
+#pragma once
+
+#include <abi/Network.h>
+#include <libutils/Endian.h>
+
+namespace Net
+{
+
+/* --- Ethernet ------------------------------------------------------------- */
+
+static constexpr uint16_t ETHERNET_TYPE_IPV4 = 0x0800;
+static constexpr uint16_t ETHERNET_TYPE_ARP = 0x0806;
+
+struct PACKED EthernetHeader
+{
+    MacAddress destination;
+    MacAddress source;
+    be_uint16_t type;
+};
+
+/* --- ARP ------------------------------------------------------------------ */
+
+static constexpr uint16_t ARP_HARDWARE_ETHERNET = 1;
+static constexpr uint16_t ARP_REQUEST = 1;
+static constexpr uint16_t ARP_REPLY = 2;
+
+struct PACKED ArpPacket
+{
+    be_uint16_t hardware_type;
+    be_uint16_t protocol_type;
+    uint8_t hardware_size;
+    uint8_t protocol_size;
+    be_uint16_t operation;
+    MacAddress sender_mac;
+    be_uint32_t sender_address;
+    MacAddress target_mac;
+    be_uint32_t target_address;
+};
+
+/* --- IPv4 ----------------------------------------------------------------- */
+
+static constexpr uint8_t IPV4_PROTOCOL_ICMP = 1;
+static constexpr uint8_t IPV4_PROTOCOL_TCP = 6;
+static constexpr uint8_t IPV4_PROTOCOL_UDP = 17;
+
+static constexpr uint16_t IPV4_MORE_FRAGMENTS = 0x2000;
+static constexpr uint16_t IPV4_FRAGMENT_OFFSET = 0x1fff;
+static constexpr uint16_t IPV4_DONT_FRAGMENT = 0x4000;
+
+struct PACKED Ipv4Header
+{
+    uint8_t version_and_length;
+    uint8_t type_of_service;
+    be_uint16_t total_length;
+    be_uint16_t identification;
+    be_uint16_t fragment;
+    uint8_t time_to_live;
+    uint8_t protocol;
+    be_uint16_t checksum;
+    be_uint32_t source;
+    be_uint32_t destination;
+
+    size_t header_length() const { return (version_and_length & 0xf) * 4; }
+};
+
+/* --- ICMP ----------------------------------------------------------------- */
+
+static constexpr uint8_t ICMP_ECHO_REPLY = 0;
+static constexpr uint8_t ICMP_ECHO_REQUEST = 8;
+
+struct PACKED IcmpEchoHeader
+{
+    uint8_t type;
+    uint8_t code;
+    be_uint16_t checksum;
+    be_uint16_t identifier;
+    be_uint16_t sequence;
+};
+
+/* --- UDP ------------------------------------------------------------------ */
+
+struct PACKED UdpHeader
+{
+    be_uint16_t source_port;
+    be_uint16_t destination_port;
+    be_uint16_t length;
+    be_uint16_t checksum;
+};
+
+/* --- TCP ------------------------------------------------------------------ */
+
+static constexpr uint8_t TCP_FIN = 1 << 0;
+static constexpr uint8_t TCP_SYN = 1 << 1;
+static constexpr uint8_t TCP_RST = 1 << 2;
+static constexpr uint8_t TCP_PSH = 1 << 3;
+static constexpr uint8_t TCP_ACK = 1 << 4;
+
+static constexpr uint8_t TCP_OPTION_END = 0;
+static constexpr uint8_t TCP_OPTION_NOP = 1;
+static constexpr uint8_t TCP_OPTION_MSS = 2;
+
+struct PACKED TcpHeader
+{
+    be_uint16_t source_port;
+    be_uint16_t destination_port;
+    be_uint32_t sequence;
+    be_uint32_t acknowledgment;
+    uint8_t data_offset;
+    uint8_t flags;
+    be_uint16_t window;
+    be_uint16_t checksum;
+    be_uint16_t urgent;
+
+    size_t header_length() const { return (data_offset >> 4) * 4; }
+};
+
+static constexpr size_t FRAME_HEADERS_SIZE = sizeof(EthernetHeader) + sizeof(Ipv4Header);
+
+// Largest IPv4 packet in a standard ethernet frame.
+static constexpr size_t IPV4_MTU = 1500;
+
+} // namespace Net
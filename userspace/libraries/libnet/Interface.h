@@ -0,0 +1,25 @@
+#pragma once
+
+#include <abi/Network.h>
+
+namespace Net
+{
+
+// Where the stack sends its frames. Outgoing frames are built in place, in
+// buffers the interface hands out.
+class Interface
+{
+public:
+    virtual ~Interface() {}
+
+    virtual MacAddress mac_address() = 0;
+
+    // A buffer of NETWORK_FRAME_SIZE bytes for the next frame, or nullptr
+    // while the transmit queue is full.
+    virtual uint8_t *acquire() = 0;
+
+    // Sends the first `size` bytes of the buffer from the last acquire().
+    virtual void submit(size_t size) = 0;
+};
+
+} // namespace Net
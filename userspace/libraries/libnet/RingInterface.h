@@ -0,0 +1,66 @@
+#pragma once
+
+#include <libnet/Interface.h>
+
+namespace Net
+{
+
+// The stack's side of the NetworkRings shared with a driver. Frames are
+// received and built right in the ring buffers, the driver only gets told
+// when to look at them again (IOCALL_NETWORK_SYNC).
+class RingInterface : public Interface
+{
+private:
+    NetworkRings *_rings;
+    MacAddress _mac_address;
+
+public:
+    RingInterface(NetworkRings *rings, MacAddress mac_address)
+        : _rings{rings}, _mac_address{mac_address}
+    {
+    }
+
+    MacAddress mac_address() override { return _mac_address; }
+
+    uint8_t *acquire() override
+    {
+        NetworkRing &tx = _rings->tx;
+
+        if (tx.head - __atomic_load_n(&tx.tail, __ATOMIC_ACQUIRE) >= NETWORK_RING_SLOTS)
+        {
+            return nullptr;
+        }
+
+        return _rings->tx_frame(tx.head);
+    }
+
+    void submit(size_t size) override
+    {
+        NetworkRing &tx = _rings->tx;
+
+        tx.lengths[tx.head % NETWORK_RING_SLOTS] = size;
+        __atomic_store_n(&tx.head, tx.head + 1, __ATOMIC_RELEASE);
+    }
+
+    // Calls `callback(frame, size)` for every frame received since the last
+    // time, then gives all their buffers back at once.
+    template <typename TCallback>
+    size_t receive(TCallback callback)
+    {
+        NetworkRing &rx = _rings->rx;
+
+        uint32_t head = __atomic_load_n(&rx.head, __ATOMIC_ACQUIRE);
+        uint32_t tail = rx.tail;
+
+        for (uint32_t counter = tail; counter != head; counter++)
+        {
+            callback(_rings->rx_frame(counter), rx.lengths[counter % NETWORK_RING_SLOTS]);
+        }
+
+        __atomic_store_n(&rx.tail, head, __ATOMIC_RELEASE);
+
+        return head - tail;
+    }
+};
+
+} // namespace Net
@@ -0,0 +1,1276 @@
+#include <libmath/MinMax.h>
+#include <string.h>
+
+#include <libnet/Checksum.h>
+#include <libnet/Headers.h>
+#include <libnet/Stack.h>
+
+namespace Net
+{
+
+static constexpr uint8_t IPV4_TIME_TO_LIVE = 64;
+
+static constexpr uint16_t ICMP_IDENTIFIER = 0x534b;
+static constexpr size_t ICMP_PING_SIZE = 32;
+
+static constexpr uint16_t TCP_SEGMENT_SIZE = IPV4_MTU - sizeof(Ipv4Header) - sizeof(TcpHeader);
+static constexpr uint64_t TCP_INITIAL_TIMEOUT = 250;
+static constexpr uint64_t TCP_MAXIMUM_TIMEOUT = 8000;
+static constexpr int TCP_MAXIMUM_RETRANSMITS = 8;
+static constexpr uint64_t TCP_TIME_WAIT = 2000;
+
+Stack::Stack(Interface &interface, StackConfig config, uint64_t now)
+    : _interface{interface},
+      _config{config},
+      _now{now}
+{
+    auto mac_address = _interface.mac_address();
+    _next_sequence = (uint32_t)(now * 250) ^ (mac_address[2] << 24 | mac_address[3] << 16 | mac_address[4] << 8 | mac_address[5]);
+}
+
+void Stack::receive(const uint8_t *frame, size_t size)
+{
+    if (size < sizeof(EthernetHeader))
+    {
+        return;
+    }
+
+    auto &ethernet = *reinterpret_cast<const EthernetHeader *>(frame);
+
+    if (ethernet.destination != _interface.mac_address() &&
+        ethernet.destination != MAC_BROADCAST)
+    {
+        return;
+    }
+
+    auto packet = frame + sizeof(EthernetHeader);
+    size -= sizeof(EthernetHeader);
+
+    if (ethernet.type() == ETHERNET_TYPE_ARP)
+    {
+        handle_arp(packet, size);
+    }
+    else if (ethernet.type() == ETHERNET_TYPE_IPV4)
+    {
+        handle_ipv4(packet, size);
+    }
+}
+
+void Stack::poll(uint64_t now)
+{
+    _now = now;
+
+    _pending.remove_all_match([&](auto &pending) {
+        return _now - pending.since >= ARP_TIMEOUT;
+    });
+
+    if (_pending.count() > 0 && _now - _arp_requested >= ARP_RETRY)
+    {
+        for (size_t i = 0; i < _pending.count(); i++)
+        {
+            bool first = true;
+
+            for (size_t j = 0; j < i; j++)
+            {
+                first = first && _pending[j].next_hop != _pending[i].next_hop;
+            }
+
+            if (first)
+            {
+                arp_send(ARP_REQUEST, MAC_BROADCAST, _pending[i].next_hop);
+            }
+        }
+
+        _arp_requested = _now;
+    }
+
+    _udp_sockets.remove_all_match([](auto &socket) {
+        return socket->_closed;
+    });
+
+    _tcp_listeners.remove_all_match([](auto &listener) {
+        if (!listener->_closed)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < listener->_pending.count(); i++)
+        {
+            listener->_pending[i]->close();
+        }
+
+        return true;
+    });
+
+    for (size_t i = 0; i < _tcp_connections.count(); i++)
+    {
+        tcp_timers(*_tcp_connections[i]);
+        tcp_output(*_tcp_connections[i]);
+    }
+
+    _tcp_connections.remove_all_match([](auto &connection) {
+        return connection->_state == TcpState::CLOSED;
+    });
+}
+
+/* --- Ethernet and ARP ------------------------------------------------------- */
+
+Optional<MacAddress> Stack::arp_lookup(Ipv4Address address)
+{
+    if (address == IPV4_BROADCAST ||
+        address.value == (_config.address.value | ~_config.netmask.value))
+    {
+        return MAC_BROADCAST;
+    }
+
+    for (size_t i = 0; i < _arp_cache.count(); i++)
+    {
+        if (_arp_cache[i].address == address)
+        {
+            return _arp_cache[i].mac_address;
+        }
+    }
+
+    return {};
+}
+
+void Stack::arp_learn(Ipv4Address address, MacAddress mac_address)
+{
+    bool known = false;
+
+    for (size_t i = 0; i < _arp_cache.count(); i++)
+    {
+        if (_arp_cache[i].address == address)
+        {
+            _arp_cache[i].mac_address = mac_address;
+            known = true;
+        }
+    }
+
+    if (!known)
+    {
+        if (_arp_cache.count() >= ARP_CACHE_SIZE)
+        {
+            _arp_cache.remove_index(0);
+        }
+
+        _arp_cache.push_back({address, mac_address});
+    }
+
+    _pending.remove_all_match([&](auto &pending) {
+        if (pending.next_hop != address)
+        {
+            return false;
+        }
+
+        auto frame = _interface.acquire();
+
+        if (!frame)
+        {
+            return false;
+        }
+
+        memcpy(frame, pending.frame.raw_storage(), pending.frame.count());
+        reinterpret_cast<EthernetHeader *>(frame)->destination = mac_address;
+        _interface.submit(pending.frame.count());
+
+        return true;
+    });
+}
+
+bool Stack::arp_send(uint16_t operation, MacAddress destination, Ipv4Address target)
+{
+    auto frame = _interface.acquire();
+
+    if (!frame)
+    {
+        return false;
+    }
+
+    auto &ethernet = *reinterpret_cast<EthernetHeader *>(frame);
+    ethernet.destination = destination;
+    ethernet.source = _interface.mac_address();
+    ethernet.type = ETHERNET_TYPE_ARP;
+
+    auto &arp = *reinterpret_cast<ArpPacket *>(frame + sizeof(EthernetHeader));
+    arp.hardware_type = ARP_HARDWARE_ETHERNET;
+    arp.protocol_type = ETHERNET_TYPE_IPV4;
+    arp.hardware_size = sizeof(MacAddress);
+    arp.protocol_size = sizeof(Ipv4Address);
+    arp.operation = operation;
+    arp.sender_mac = _interface.mac_address();
+    arp.sender_address = _config.address.value;
+    arp.target_mac = operation == ARP_REPLY ? destination : MacAddress{};
+    arp.target_address = target.value;
+
+    _interface.submit(sizeof(EthernetHeader) + sizeof(ArpPacket));
+
+    return true;
+}
+
+void Stack::handle_arp(const uint8_t *packet, size_t size)
+{
+    if (size < sizeof(ArpPacket))
+    {
+        return;
+    }
+
+    auto &arp = *reinterpret_cast<const ArpPacket *>(packet);
+
+    if (arp.hardware_type() != ARP_HARDWARE_ETHERNET ||
+        arp.protocol_type() != ETHERNET_TYPE_IPV4 ||
+        Ipv4Address{arp.target_address()} != _config.address)
+    {
+        return;
+    }
+
+    Ipv4Address sender{arp.sender_address()};
+
+    arp_learn(sender, arp.sender_mac);
+
+    if (arp.operation() == ARP_REQUEST)
+    {
+        arp_send(ARP_REPLY, arp.sender_mac, sender);
+    }
+}
+
+/* --- IPv4 ------------------------------------------------------------------- */
+
+Ipv4Address Stack::next_hop(Ipv4Address destination)
+{
+    if (destination == IPV4_BROADCAST ||
+        (destination.value & _config.netmask.value) == (_config.address.value & _config.netmask.value))
+    {
+        return destination;
+    }
+
+    return _config.gateway;
+}
+
+bool Stack::is_local(Ipv4Address address)
+{
+    return address == _config.address ||
+           address == IPV4_BROADCAST ||
+           address.value == (_config.address.value | ~_config.netmask.value);
+}
+
+template <typename TFill>
+bool Stack::send_ipv4(Ipv4Address destination, uint8_t protocol, size_t payload_size, TFill fill)
+{
+    auto hop = next_hop(destination);
+    auto mac_address = arp_lookup(hop);
+
+    size_t size = FRAME_HEADERS_SIZE + payload_size;
+    uint8_t *frame = nullptr;
+    Vector<uint8_t> queued;
+
+    if (mac_address.present())
+    {
+        frame = _interface.acquire();
+    }
+    else if (_pending.count() < PENDING_LIMIT)
+    {
+        queued.resize(size);
+        frame = queued.raw_storage();
+    }
+
+    if (!frame)
+    {
+        return false;
+    }
+
+    auto &ethernet = *reinterpret_cast<EthernetHeader *>(frame);
+    ethernet.destination = mac_address.unwrap_or({});
+    ethernet.source = _interface.mac_address();
+    ethernet.type = ETHERNET_TYPE_IPV4;
+
+    auto &ip = *reinterpret_cast<Ipv4Header *>(frame + sizeof(EthernetHeader));
+    ip.version_and_length = (4 << 4) | (sizeof(Ipv4Header) / 4);
+    ip.type_of_service = 0;
+    ip.total_length = sizeof(Ipv4Header) + payload_size;
+    ip.identification = _identification++;
+    ip.fragment = IPV4_DONT_FRAGMENT;
+    ip.time_to_live = IPV4_TIME_TO_LIVE;
+    ip.protocol = protocol;
+    ip.checksum = 0;
+    ip.source = _config.address.value;
+    ip.destination = destination.value;
+
+    Checksum checksum;
+    checksum.add(&ip, sizeof(Ipv4Header));
+    ip.checksum = checksum.finish();
+
+    fill(frame + FRAME_HEADERS_SIZE);
+
+    if (mac_address.present())
+    {
+        _interface.submit(size);
+        return true;
+    }
+
+    bool resolving = false;
+
+    for (size_t i = 0; i < _pending.count(); i++)
+    {
+        resolving = resolving || _pending[i].next_hop == hop;
+    }
+
+    _pending.push_back({hop, _now, move(queued)});
+
+    if (!resolving)
+    {
+        arp_send(ARP_REQUEST, MAC_BROADCAST, hop);
+        _arp_requested = _now;
+    }
+
+    return true;
+}
+
+void Stack::handle_ipv4(const uint8_t *packet, size_t size)
+{
+    if (size < sizeof(Ipv4Header))
+    {
+        return;
+    }
+
+    auto &ip = *reinterpret_cast<const Ipv4Header *>(packet);
+
+    size_t header_length = ip.header_length();
+    size_t total_length = ip.total_length();
+
+    if ((ip.version_and_length >> 4) != 4 ||
+        header_length < sizeof(Ipv4Header) ||
+        total_length < header_length ||
+        total_length > size)
+    {
+        return;
+    }
+
+    Checksum checksum;
+    checksum.add(packet, header_length);
+
+    // There is no reassembly, fragments are dropped.
+    if (checksum.finish() != 0 ||
+        (ip.fragment() & (IPV4_MORE_FRAGMENTS | IPV4_FRAGMENT_OFFSET)) ||
+        !is_local(Ipv4Address{ip.destination()}))
+    {
+        return;
+    }
+
+    auto payload = packet + header_length;
+    size_t payload_size = total_length - header_length;
+
+    if (ip.protocol == IPV4_PROTOCOL_ICMP)
+    {
+        handle_icmp(ip, payload, payload_size);
+    }
+    else if (ip.protocol == IPV4_PROTOCOL_UDP)
+    {
+        handle_udp(ip, payload, payload_size);
+    }
+    else if (ip.protocol == IPV4_PROTOCOL_TCP)
+    {
+        handle_tcp(ip, payload, payload_size);
+    }
+}
+
+/* --- ICMP ------------------------------------------------------------------- */
+
+void Stack::handle_icmp(const Ipv4Header &ip, const uint8_t *packet, size_t size)
+{
+    if (size < sizeof(IcmpEchoHeader))
+    {
+        return;
+    }
+
+    Checksum checksum;
+    checksum.add(packet, size);
+
+    if (checksum.finish() != 0)
+    {
+        return;
+    }
+
+    auto &icmp = *reinterpret_cast<const IcmpEchoHeader *>(packet);
+    Ipv4Address source{ip.source()};
+
+    if (icmp.type == ICMP_ECHO_REQUEST && icmp.code == 0)
+    {
+        send_ipv4(source, IPV4_PROTOCOL_ICMP, size, [&](uint8_t *payload) {
+            memcpy(payload, packet, size);
+
+            auto &reply = *reinterpret_cast<IcmpEchoHeader *>(payload);
+            reply.type = ICMP_ECHO_REPLY;
+            reply.checksum = 0;
+
+            Checksum checksum;
+            checksum.add(payload, size);
+            reply.checksum = checksum.finish();
+        });
+    }
+    else if (icmp.type == ICMP_ECHO_REPLY && on_echo_reply)
+    {
+        on_echo_reply(source, icmp.sequence());
+    }
+}
+
+Result Stack::ping(Ipv4Address address, uint16_t sequence)
+{
+    size_t size = sizeof(IcmpEchoHeader) + ICMP_PING_SIZE;
+
+    bool sent = send_ipv4(address, IPV4_PROTOCOL_ICMP, size, [&](uint8_t *payload) {
+        auto &request = *reinterpret_cast<IcmpEchoHeader *>(payload);
+        request.type = ICMP_ECHO_REQUEST;
+        request.code = 0;
+        request.checksum = 0;
+        request.identifier = ICMP_IDENTIFIER;
+        request.sequence = sequence;
+
+        for (size_t i = 0; i < ICMP_PING_SIZE; i++)
+        {
+            payload[sizeof(IcmpEchoHeader) + i] = 'a' + i % 26;
+        }
+
+        Checksum checksum;
+        checksum.add(payload, size);
+        request.checksum = checksum.finish();
+    });
+
+    return sent ? SUCCESS : ERR_OUT_OF_MEMORY;
+}
+
+/* --- UDP -------------------------------------------------------------------- */
+
+void Stack::handle_udp(const Ipv4Header &ip, const uint8_t *packet, size_t size)
+{
+    if (size < sizeof(UdpHeader))
+    {
+        return;
+    }
+
+    auto &udp = *reinterpret_cast<const UdpHeader *>(packet);
+    size_t length = udp.length();
+
+    if (length < sizeof(UdpHeader) || length > size)
+    {
+        return;
+    }
+
+    Ipv4Address source{ip.source()};
+
+    // A zero checksum means the sender didn't compute one.
+    if (udp.checksum() != 0)
+    {
+        Checksum checksum;
+        checksum.add_pseudo_header(source, Ipv4Address{ip.destination()}, IPV4_PROTOCOL_UDP, length);
+        checksum.add(packet, length);
+
+        if (checksum.finish() != 0)
+        {
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < _udp_sockets.count(); i++)
+    {
+        auto &socket = *_udp_sockets[i];
+
+        if (socket._port != udp.destination_port() ||
+            socket._closed ||
+            socket._queue.count() >= UdpSocket::QUEUE_LIMIT)
+        {
+            continue;
+        }
+
+        Datagram datagram{{source, udp.source_port()}, {}};
+        datagram.data.push_back_many(packet + sizeof(UdpHeader), length - sizeof(UdpHeader));
+        socket._queue.push_back(move(datagram));
+
+        return;
+    }
+}
+
+ResultOr<RefPtr<UdpSocket>> Stack::udp_bind(uint16_t port)
+{
+    if (port == 0)
+    {
+        port = allocate_port();
+    }
+    else if (port_in_use(port))
+    {
+        return ERR_ADDRESS_IN_USE;
+    }
+
+    auto socket = make<UdpSocket>(port);
+    _udp_sockets.push_back(socket);
+
+    return socket;
+}
+
+Result Stack::udp_send(UdpSocket &socket, NetworkEndpoint destination, const void *buffer, size_t size)
+{
+    if (size > IPV4_MTU - sizeof(Ipv4Header) - sizeof(UdpHeader))
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    size_t length = sizeof(UdpHeader) + size;
+
+    bool sent = send_ipv4(destination.address, IPV4_PROTOCOL_UDP, length, [&](uint8_t *payload) {
+        auto &udp = *reinterpret_cast<UdpHeader *>(payload);
+        udp.source_port = socket._port;
+        udp.destination_port = destination.port;
+        udp.length = length;
+        udp.checksum = 0;
+
+        memcpy(payload + sizeof(UdpHeader), buffer, size);
+
+        Checksum checksum;
+        checksum.add_pseudo_header(_config.address, destination.address, IPV4_PROTOCOL_UDP, length);
+        checksum.add(payload, length);
+
+        // Zero would mean no checksum at all.
+        uint16_t sum = checksum.finish();
+        udp.checksum = sum ? sum : 0xffff;
+    });
+
+    return sent ? SUCCESS : ERR_OUT_OF_MEMORY;
+}
+
+/* --- TCP -------------------------------------------------------------------- */
+
+// UDP and TCP share a single port space, good enough for the few sockets
+// around.
+bool Stack::port_in_use(uint16_t port)
+{
+    for (size_t i = 0; i < _udp_sockets.count(); i++)
+    {
+        if (_udp_sockets[i]->_port == port)
+        {
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < _tcp_listeners.count(); i++)
+    {
+        if (_tcp_listeners[i]->_port == port)
+        {
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < _tcp_connections.count(); i++)
+    {
+        if (_tcp_connections[i]->_local.port == port)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint16_t Stack::allocate_port()
+{
+    while (port_in_use(_next_port))
+    {
+        _next_port = _next_port == 0xffff ? EPHEMERAL_PORT_FIRST : _next_port + 1;
+    }
+
+    uint16_t port = _next_port;
+    _next_port = _next_port == 0xffff ? EPHEMERAL_PORT_FIRST : _next_port + 1;
+
+    return port;
+}
+
+RefPtr<TcpConnection> Stack::tcp_lookup(NetworkEndpoint local, NetworkEndpoint remote)
+{
+    for (size_t i = 0; i < _tcp_connections.count(); i++)
+    {
+        auto &connection = *_tcp_connections[i];
+
+        if (connection._local.port == local.port &&
+            connection._remote.port == remote.port &&
+            connection._remote.address == remote.address)
+        {
+            return _tcp_connections[i];
+        }
+    }
+
+    return nullptr;
+}
+
+static void tcp_write_header(uint8_t *segment, uint16_t source_port, uint16_t destination_port, uint32_t sequence, uint32_t acknowledgment, uint8_t flags, uint16_t window, size_t header_length)
+{
+    auto &tcp = *reinterpret_cast<TcpHeader *>(segment);
+    tcp.source_port = source_port;
+    tcp.destination_port = destination_port;
+    tcp.sequence = sequence;
+    tcp.acknowledgment = acknowledgment;
+    tcp.data_offset = (header_length / 4) << 4;
+    tcp.flags = flags;
+    tcp.window = window;
+    tcp.checksum = 0;
+    tcp.urgent = 0;
+}
+
+static void tcp_write_checksum(uint8_t *segment, size_t size, Ipv4Address source, Ipv4Address destination)
+{
+    Checksum checksum;
+    checksum.add_pseudo_header(source, destination, IPV4_PROTOCOL_TCP, size);
+    checksum.add(segment, size);
+
+    reinterpret_cast<TcpHeader *>(segment)->checksum = checksum.finish();
+}
+
+static uint16_t tcp_segment_size(const TcpHeader &tcp, const uint8_t *packet)
+{
+    size_t i = sizeof(TcpHeader);
+
+    while (i < tcp.header_length() && packet[i] != TCP_OPTION_END)
+    {
+        if (packet[i] == TCP_OPTION_NOP)
+        {
+            i++;
+            continue;
+        }
+
+        if (i + 1 >= tcp.header_length() || packet[i + 1] < 2)
+        {
+            break;
+        }
+
+        if (packet[i] == TCP_OPTION_MSS && packet[i + 1] == 4 && i + 4 <= tcp.header_length())
+        {
+            return MIN((packet[i + 2] << 8) | packet[i + 3], TCP_SEGMENT_SIZE);
+        }
+
+        i += packet[i + 1];
+    }
+
+    // What every host has to accept when nothing is said.
+    return 536;
+}
+
+bool Stack::tcp_send(TcpConnection &connection, uint32_t sequence, uint8_t flags, size_t size)
+{
+    // The SYN announces the segment size we accept.
+    size_t header_length = sizeof(TcpHeader) + ((flags & TCP_SYN) ? 4 : 0);
+    uint32_t window = MIN(connection._receive_buffer.available(), 0xffff);
+
+    bool sent = send_ipv4(connection._remote.address, IPV4_PROTOCOL_TCP, header_length + size, [&](uint8_t *segment) {
+        tcp_write_header(
+            segment,
+            connection._local.port,
+            connection._remote.port,
+            sequence,
+            (flags & TCP_ACK) ? connection._receive_next : 0,
+            flags,
+            window,
+            header_length);
+
+        if (flags & TCP_SYN)
+        {
+            segment[sizeof(TcpHeader) + 0] = TCP_OPTION_MSS;
+            segment[sizeof(TcpHeader) + 1] = 4;
+            segment[sizeof(TcpHeader) + 2] = TCP_SEGMENT_SIZE >> 8;
+            segment[sizeof(TcpHeader) + 3] = TCP_SEGMENT_SIZE & 0xff;
+        }
+
+        connection._send_buffer.peek(sequence - connection.data_sequence(), segment + header_length, size);
+
+        tcp_write_checksum(segment, header_length + size, connection._local.address, connection._remote.address);
+    });
+
+    if (sent && (flags & TCP_ACK))
+    {
+        connection._ack_pending = false;
+        connection._advertised_window = window;
+    }
+
+    return sent;
+}
+
+void Stack::tcp_reset(const Ipv4Header &ip, const TcpHeader &tcp, size_t size)
+{
+    if (tcp.flags & TCP_RST)
+    {
+        return;
+    }
+
+    uint32_t sequence = 0;
+    uint32_t acknowledgment = 0;
+    uint8_t flags = TCP_RST;
+
+    if (tcp.flags & TCP_ACK)
+    {
+        sequence = tcp.acknowledgment();
+    }
+    else
+    {
+        acknowledgment = tcp.sequence() + size + ((tcp.flags & TCP_SYN) ? 1 : 0) + ((tcp.flags & TCP_FIN) ? 1 : 0);
+        flags |= TCP_ACK;
+    }
+
+    Ipv4Address destination{ip.source()};
+
+    send_ipv4(destination, IPV4_PROTOCOL_TCP, sizeof(TcpHeader), [&](uint8_t *segment) {
+        tcp_write_header(segment, tcp.destination_port(), tcp.source_port(), sequence, acknowledgment, flags, 0, sizeof(TcpHeader));
+        tcp_write_checksum(segment, sizeof(TcpHeader), _config.address, destination);
+    });
+}
+
+void Stack::tcp_accept(const Ipv4Header &ip, const TcpHeader &tcp, const uint8_t *packet)
+{
+    RefPtr<TcpListener> listener = nullptr;
+
+    for (size_t i = 0; i < _tcp_listeners.count(); i++)
+    {
+        if (_tcp_listeners[i]->_port == tcp.destination_port() && !_tcp_listeners[i]->_closed)
+        {
+            listener = _tcp_listeners[i];
+        }
+    }
+
+    if (!listener)
+    {
+        tcp_reset(ip, tcp, 0);
+        return;
+    }
+
+    size_t backlog = listener->_pending.count();
+
+    for (size_t i = 0; i < _tcp_connections.count(); i++)
+    {
+        if (_tcp_connections[i]->_state == TcpState::SYN_RECEIVED &&
+            _tcp_connections[i]->_local.port == listener->_port)
+        {
+            backlog++;
+        }
+    }
+
+    // Dropped, the other end will try again.
+    if (backlog >= TcpListener::BACKLOG)
+    {
+        return;
+    }
+
+    auto connection = make<TcpConnection>(
+        NetworkEndpoint{_config.address, tcp.destination_port()},
+        NetworkEndpoint{Ipv4Address{ip.source()}, tcp.source_port()});
+
+    connection->_state = TcpState::SYN_RECEIVED;
+    connection->_initial_sequence = _next_sequence + (uint32_t)(_now * 250);
+    connection->_send_unacknowledged = connection->_initial_sequence;
+    connection->_send_next = connection->_initial_sequence;
+    connection->_send_max = connection->_initial_sequence;
+    connection->_send_window = tcp.window();
+    connection->_segment_size = tcp_segment_size(tcp, packet);
+    connection->_receive_next = tcp.sequence() + 1;
+    connection->_retransmit_timeout = TCP_INITIAL_TIMEOUT;
+
+    _next_sequence += 64000;
+    _tcp_connections.push_back(connection);
+}
+
+ResultOr<RefPtr<TcpListener>> Stack::tcp_listen(uint16_t port)
+{
+    if (port == 0 || port_in_use(port))
+    {
+        return ERR_ADDRESS_IN_USE;
+    }
+
+    auto listener = make<TcpListener>(port);
+    _tcp_listeners.push_back(listener);
+
+    return listener;
+}
+
+ResultOr<RefPtr<TcpConnection>> Stack::tcp_connect(NetworkEndpoint remote)
+{
+    if (remote.port == 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    auto connection = make<TcpConnection>(NetworkEndpoint{_config.address, allocate_port()}, remote);
+
+    connection->_state = TcpState::SYN_SENT;
+    connection->_initial_sequence = _next_sequence + (uint32_t)(_now * 250);
+    connection->_send_unacknowledged = connection->_initial_sequence;
+    connection->_send_next = connection->_initial_sequence;
+    connection->_send_max = connection->_initial_sequence;
+    connection->_retransmit_timeout = TCP_INITIAL_TIMEOUT;
+
+    _next_sequence += 64000;
+    _tcp_connections.push_back(connection);
+
+    tcp_output(*connection);
+
+    return connection;
+}
+
+void Stack::tcp_acknowledge(TcpConnection &connection, const TcpHeader &tcp, size_t size)
+{
+    uint32_t acknowledgment = tcp.acknowledgment();
+
+    if (sequence_before(connection._send_max, acknowledgment))
+    {
+        // Acknowledges something that was never sent.
+        connection._ack_pending = true;
+        return;
+    }
+
+    if (connection._state == TcpState::SYN_RECEIVED)
+    {
+        if (acknowledgment != connection._initial_sequence + 1)
+        {
+            return;
+        }
+
+        connection._state = TcpState::ESTABLISHED;
+        connection._congestion_window = 10 * connection._segment_size;
+
+        bool accepted = false;
+
+        for (size_t i = 0; i < _tcp_listeners.count(); i++)
+        {
+            if (_tcp_listeners[i]->_port == connection._local.port && !_tcp_listeners[i]->_closed)
+            {
+                _tcp_listeners[i]->_pending.push_back(tcp_lookup(connection._local, connection._remote));
+                accepted = true;
+            }
+        }
+
+        if (!accepted)
+        {
+            tcp_closed(connection, ERR_CONNECTION_RESET);
+            return;
+        }
+    }
+
+    if (sequence_before(connection._send_unacknowledged, acknowledgment))
+    {
+        uint32_t acknowledged = acknowledgment - connection._send_unacknowledged;
+        uint32_t data_start = connection.data_sequence();
+        uint32_t data_end = data_start + connection._send_buffer.used();
+
+        if (sequence_before(data_start, acknowledgment))
+        {
+            connection._send_buffer.discard((sequence_before(data_end, acknowledgment) ? data_end : acknowledgment) - data_start);
+        }
+
+        connection._send_unacknowledged = acknowledgment;
+
+        if (sequence_before(connection._send_next, acknowledgment))
+        {
+            connection._send_next = acknowledgment;
+        }
+
+        // Slow start, then one more segment per round trip.
+        if (connection._congestion_window < connection._slow_start_threshold)
+        {
+            connection._congestion_window += MIN(acknowledged, connection._segment_size);
+        }
+        else
+        {
+            connection._congestion_window += MAX(connection._segment_size * connection._segment_size / connection._congestion_window, 1u);
+        }
+
+        connection._duplicate_acks = 0;
+        connection._retransmits = 0;
+        connection._retransmit_timeout = TCP_INITIAL_TIMEOUT;
+        connection._retransmit_at = connection._send_unacknowledged == connection._send_max ? 0 : _now + connection._retransmit_timeout;
+    }
+    else if (acknowledgment == connection._send_unacknowledged &&
+             size == 0 &&
+             tcp.window() == connection._send_window &&
+             connection._send_max != connection._send_unacknowledged)
+    {
+        // The third duplicate means a segment got lost, not just reordered.
+        if (++connection._duplicate_acks == 3)
+        {
+            uint32_t in_flight = connection._send_max - connection._send_unacknowledged;
+            connection._slow_start_threshold = MAX(in_flight / 2, 2u * connection._segment_size);
+            connection._congestion_window = connection._slow_start_threshold;
+            connection._send_next = connection._send_unacknowledged;
+        }
+    }
+
+    connection._send_window = tcp.window();
+
+    if (connection._fin_sent && acknowledgment == connection._fin_sequence + 1)
+    {
+        if (connection._state == TcpState::FIN_WAIT_1)
+        {
+            connection._state = TcpState::FIN_WAIT_2;
+        }
+        else if (connection._state == TcpState::CLOSING)
+        {
+            connection._state = TcpState::TIME_WAIT;
+            connection._time_wait_until = _now + TCP_TIME_WAIT;
+        }
+        else if (connection._state == TcpState::LAST_ACK)
+        {
+            tcp_closed(connection, SUCCESS);
+        }
+    }
+}
+
+void Stack::tcp_deliver(TcpConnection &connection, const TcpHeader &tcp, const uint8_t *payload, size_t size)
+{
+    bool fin = tcp.flags & TCP_FIN;
+
+    if (connection._state != TcpState::ESTABLISHED &&
+        connection._state != TcpState::FIN_WAIT_1 &&
+        connection._state != TcpState::FIN_WAIT_2)
+    {
+        // Their FIN was already received, they are sending it again because
+        // our acknowledgment got lost.
+        connection._ack_pending = connection._ack_pending || fin;
+        return;
+    }
+
+    if (size == 0 && !fin)
+    {
+        return;
+    }
+
+    uint32_t sequence = tcp.sequence();
+
+    if (sequence_before(sequence, connection._receive_next))
+    {
+        uint32_t duplicate = connection._receive_next - sequence;
+
+        if (duplicate > size)
+        {
+            connection._ack_pending = true;
+            return;
+        }
+
+        payload += duplicate;
+        size -= duplicate;
+        sequence = connection._receive_next;
+    }
+
+    connection._ack_pending = true;
+
+    // Out of order segments are dropped, acknowledging what we have right
+    // away lets the other end retransmit early.
+    if (sequence != connection._receive_next)
+    {
+        return;
+    }
+
+    size_t accepted = connection._receive_buffer.write(payload, size);
+    connection._receive_next += accepted;
+
+    if (!fin || accepted < size)
+    {
+        return;
+    }
+
+    connection._receive_next++;
+    connection._fin_received = true;
+
+    if (connection._state == TcpState::ESTABLISHED)
+    {
+        connection._state = TcpState::CLOSE_WAIT;
+    }
+    else if (connection._state == TcpState::FIN_WAIT_1)
+    {
+        connection._state = TcpState::CLOSING;
+    }
+    else if (connection._state == TcpState::FIN_WAIT_2)
+    {
+        connection._state = TcpState::TIME_WAIT;
+        connection._time_wait_until = _now + TCP_TIME_WAIT;
+        connection._retransmit_at = 0;
+    }
+}
+
+void Stack::tcp_output(TcpConnection &connection)
+{
+    if (connection._state == TcpState::CLOSED)
+    {
+        return;
+    }
+
+    if (connection._state == TcpState::TIME_WAIT)
+    {
+        if (connection._ack_pending)
+        {
+            tcp_send(connection, connection._send_next, TCP_ACK, 0);
+        }
+
+        return;
+    }
+
+    if (connection.connecting())
+    {
+        uint8_t flags = TCP_SYN | (connection._state == TcpState::SYN_RECEIVED ? TCP_ACK : 0);
+
+        if (connection._send_next == connection._initial_sequence &&
+            tcp_send(connection, connection._initial_sequence, flags, 0))
+        {
+            connection._send_next = connection._initial_sequence + 1;
+            connection._send_max = connection._send_next;
+            connection._retransmit_at = _now + connection._retransmit_timeout;
+        }
+
+        return;
+    }
+
+    uint32_t data_end = connection.data_sequence() + connection._send_buffer.used();
+    uint32_t window = MIN(connection._send_window, connection._congestion_window);
+
+    while (sequence_before(connection._send_next, data_end))
+    {
+        uint32_t in_flight = connection._send_next - connection._send_unacknowledged;
+        size_t usable = window > in_flight ? window - in_flight : 0;
+
+        // Nudges a closed window, the answer tells when it opens again.
+        if (usable == 0 && connection._probe && in_flight == 0)
+        {
+            usable = 1;
+        }
+
+        size_t size = MIN(MIN((size_t)(data_end - connection._send_next), usable), (size_t)connection._segment_size);
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        uint8_t flags = TCP_ACK | (connection._send_next + size == data_end ? TCP_PSH : 0);
+
+        if (!tcp_send(connection, connection._send_next, flags, size))
+        {
+            break;
+        }
+
+        connection._send_next += size;
+        connection._probe = false;
+
+        if (sequence_before(connection._send_max, connection._send_next))
+        {
+            connection._send_max = connection._send_next;
+        }
+    }
+
+    bool fin_due = connection._close_requested &&
+                   connection._send_next == data_end &&
+                   (!connection._fin_sent || connection._send_next == connection._fin_sequence);
+
+    if (fin_due && tcp_send(connection, connection._send_next, TCP_FIN | TCP_ACK, 0))
+    {
+        connection._fin_sent = true;
+        connection._fin_sequence = connection._send_next;
+        connection._send_next++;
+
+        if (sequence_before(connection._send_max, connection._send_next))
+        {
+            connection._send_max = connection._send_next;
+        }
+
+        if (connection._state == TcpState::ESTABLISHED)
+        {
+            connection._state = TcpState::FIN_WAIT_1;
+        }
+        else if (connection._state == TcpState::CLOSE_WAIT)
+        {
+            connection._state = TcpState::LAST_ACK;
+        }
+    }
+
+    bool waiting = connection._send_next != connection._send_unacknowledged ||
+                   (connection._send_window == 0 && sequence_before(connection._send_next, data_end));
+
+    if (waiting && connection._retransmit_at == 0)
+    {
+        connection._retransmit_at = _now + connection._retransmit_timeout;
+    }
+
+    // Tell the other end once reading made room for a couple more segments.
+    if (connection._receive_buffer.available() >= connection._advertised_window + 2 * TCP_SEGMENT_SIZE)
+    {
+        connection._ack_pending = true;
+    }
+
+    if (connection._ack_pending)
+    {
+        tcp_send(connection, connection._send_next, TCP_ACK, 0);
+    }
+}
+
+void Stack::tcp_timers(TcpConnection &connection)
+{
+    if (connection._state == TcpState::TIME_WAIT)
+    {
+        if (_now >= connection._time_wait_until)
+        {
+            tcp_closed(connection, SUCCESS);
+        }
+
+        return;
+    }
+
+    if (connection._retransmit_at == 0 || _now < connection._retransmit_at)
+    {
+        return;
+    }
+
+    if (++connection._retransmits > TCP_MAXIMUM_RETRANSMITS)
+    {
+        tcp_closed(connection, TIMEOUT);
+        return;
+    }
+
+    if (connection._send_next == connection._send_unacknowledged)
+    {
+        connection._probe = true;
+    }
+    else
+    {
+        // Go back to the oldest unacknowledged byte and start slow again.
+        uint32_t in_flight = connection._send_max - connection._send_unacknowledged;
+        connection._slow_start_threshold = MAX(in_flight / 2, 2u * connection._segment_size);
+        connection._congestion_window = connection._segment_size;
+        connection._send_next = connection._send_unacknowledged;
+    }
+
+    connection._retransmit_timeout = MIN(connection._retransmit_timeout * 2, TCP_MAXIMUM_TIMEOUT);
+    connection._retransmit_at = 0;
+}
+
+void Stack::tcp_closed(TcpConnection &connection, Result error)
+{
+    connection._state = TcpState::CLOSED;
+    connection._error = error;
+    connection._retransmit_at = 0;
+}
+
+void Stack::handle_tcp(const Ipv4Header &ip, const uint8_t *packet, size_t size)
+{
+    if (size < sizeof(TcpHeader))
+    {
+        return;
+    }
+
+    auto &tcp = *reinterpret_cast<const TcpHeader *>(packet);
+    Ipv4Address source{ip.source()};
+
+    if (tcp.header_length() < sizeof(TcpHeader) || tcp.header_length() > size)
+    {
+        return;
+    }
+
+    Checksum checksum;
+    checksum.add_pseudo_header(source, Ipv4Address{ip.destination()}, IPV4_PROTOCOL_TCP, size);
+    checksum.add(packet, size);
+
+    if (checksum.finish() != 0)
+    {
+        return;
+    }
+
+    auto payload = packet + tcp.header_length();
+    size_t payload_size = size - tcp.header_length();
+
+    auto connection_ptr = tcp_lookup({_config.address, tcp.destination_port()}, {source, tcp.source_port()});
+
+    if (!connection_ptr)
+    {
+        if ((tcp.flags & (TCP_SYN | TCP_ACK | TCP_RST)) == TCP_SYN)
+        {
+            tcp_accept(ip, tcp, packet);
+        }
+        else
+        {
+            tcp_reset(ip, tcp, payload_size);
+        }
+
+        return;
+    }
+
+    auto &connection = *connection_ptr;
+
+    if (connection._state == TcpState::SYN_SENT)
+    {
+        if ((tcp.flags & TCP_ACK) && tcp.acknowledgment() != connection._initial_sequence + 1)
+        {
+            tcp_reset(ip, tcp, payload_size);
+            return;
+        }
+
+        if (tcp.flags & TCP_RST)
+        {
+            if (tcp.flags & TCP_ACK)
+            {
+                tcp_closed(connection, ERR_CONNECTION_REFUSED);
+            }
+
+            return;
+        }
+
+        // Both ends opening at once isn't supported, only a SYN-ACK moves on.
+        if ((tcp.flags & (TCP_SYN | TCP_ACK)) != (TCP_SYN | TCP_ACK))
+        {
+            return;
+        }
+
+        connection._state = TcpState::ESTABLISHED;
+        connection._receive_next = tcp.sequence() + 1;
+        connection._send_unacknowledged = tcp.acknowledgment();
+        connection._send_window = tcp.window();
+        connection._segment_size = tcp_segment_size(tcp, packet);
+        connection._congestion_window = 10 * connection._segment_size;
+        connection._retransmit_at = 0;
+        connection._retransmits = 0;
+        connection._ack_pending = true;
+
+        return;
+    }
+
+    if (tcp.flags & TCP_RST)
+    {
+        uint32_t sequence = tcp.sequence();
+
+        if (sequence_before_or_equal(connection._receive_next, sequence) &&
+            sequence_before(sequence, connection._receive_next + MAX(connection._advertised_window, 1u)))
+        {
+            tcp_closed(connection, ERR_CONNECTION_RESET);
+        }
+
+        return;
+    }
+
+    if (tcp.flags & TCP_SYN)
+    {
+        // Our SYN-ACK got lost and they are asking again.
+        if (connection._state == TcpState::SYN_RECEIVED)
+        {
+            connection._send_next = connection._initial_sequence;
+        }
+        else
+        {
+            connection._ack_pending = true;
+        }
+
+        return;
+    }
+
+    if (!(tcp.flags & TCP_ACK))
+    {
+        return;
+    }
+
+    tcp_acknowledge(connection, tcp, payload_size);
+
+    if (connection._state != TcpState::CLOSED)
+    {
+        tcp_deliver(connection, tcp, payload, payload_size);
+    }
+}
+
+} // namespace Net
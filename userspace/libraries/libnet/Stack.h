@@ -0,0 +1,150 @@
+#pragma once
+
+#include <libnet/Address.h>
+#include <libnet/Interface.h>
+#include <libnet/Tcp.h>
+#include <libnet/Udp.h>
+#include <libutils/Callback.h>
+#include <libutils/ResultOr.h>
+
+namespace Net
+{
+
+struct Ipv4Header;
+struct TcpHeader;
+
+struct StackConfig
+{
+    Ipv4Address address;
+    Ipv4Address netmask;
+    Ipv4Address gateway;
+};
+
+// ARP, IPv4, ICMP, UDP and TCP over a single interface. The stack never
+// blocks or keeps time on its own: frames go in through receive(), and poll()
+// runs the timers and sends whatever is pending.
+class Stack
+{
+private:
+    struct ArpEntry
+    {
+        Ipv4Address address;
+        MacAddress mac_address;
+    };
+
+    // A packet waiting for its next hop to answer an ARP request.
+    struct PendingPacket
+    {
+        Ipv4Address next_hop;
+        uint64_t since;
+        Vector<uint8_t> frame;
+    };
+
+    static constexpr size_t ARP_CACHE_SIZE = 64;
+    static constexpr size_t PENDING_LIMIT = 32;
+    static constexpr uint64_t ARP_RETRY = 1000;
+    static constexpr uint64_t ARP_TIMEOUT = 3000;
+
+    static constexpr uint16_t EPHEMERAL_PORT_FIRST = 49152;
+
+    Interface &_interface;
+    StackConfig _config;
+    uint64_t _now = 0;
+
+    uint16_t _identification = 0;
+    uint16_t _next_port = EPHEMERAL_PORT_FIRST;
+    uint32_t _next_sequence;
+
+    Vector<ArpEntry> _arp_cache{};
+    Vector<PendingPacket> _pending{};
+    uint64_t _arp_requested = 0;
+
+    Vector<RefPtr<UdpSocket>> _udp_sockets{};
+    Vector<RefPtr<TcpListener>> _tcp_listeners{};
+    Vector<RefPtr<TcpConnection>> _tcp_connections{};
+
+    /* --- Ethernet and ARP ------------------------------------------------- */
+
+    Optional<MacAddress> arp_lookup(Ipv4Address address);
+
+    void arp_learn(Ipv4Address address, MacAddress mac_address);
+
+    bool arp_send(uint16_t operation, MacAddress destination, Ipv4Address target);
+
+    void handle_arp(const uint8_t *packet, size_t size);
+
+    /* --- IPv4 ------------------------------------------------------------- */
+
+    Ipv4Address next_hop(Ipv4Address destination);
+
+    bool is_local(Ipv4Address address);
+
+    // Builds an IPv4 packet around `payload_size` bytes written by
+    // `fill(uint8_t *payload)`, right in a transmit buffer when the next hop is
+    // known. Returns false when the packet couldn't be sent or queued.
+    template <typename TFill>
+    bool send_ipv4(Ipv4Address destination, uint8_t protocol, size_t payload_size, TFill fill);
+
+    void handle_ipv4(const uint8_t *packet, size_t size);
+
+    /* --- ICMP ------------------------------------------------------------- */
+
+    void handle_icmp(const Ipv4Header &ip, const uint8_t *packet, size_t size);
+
+    /* --- UDP -------------------------------------------------------------- */
+
+    void handle_udp(const Ipv4Header &ip, const uint8_t *packet, size_t size);
+
+    /* --- TCP -------------------------------------------------------------- */
+
+    bool port_in_use(uint16_t port);
+
+    uint16_t allocate_port();
+
+    RefPtr<TcpConnection> tcp_lookup(NetworkEndpoint local, NetworkEndpoint remote);
+
+    bool tcp_send(TcpConnection &connection, uint32_t sequence, uint8_t flags, size_t size);
+
+    void tcp_reset(const Ipv4Header &ip, const TcpHeader &tcp, size_t size);
+
+    void tcp_accept(const Ipv4Header &ip, const TcpHeader &tcp, const uint8_t *packet);
+
+    void tcp_acknowledge(TcpConnection &connection, const TcpHeader &tcp, size_t size);
+
+    void tcp_deliver(TcpConnection &connection, const TcpHeader &tcp, const uint8_t *payload, size_t size);
+
+    void tcp_output(TcpConnection &connection);
+
+    void tcp_timers(TcpConnection &connection);
+
+    void tcp_closed(TcpConnection &connection, Result error);
+
+    void handle_tcp(const Ipv4Header &ip, const uint8_t *packet, size_t size);
+
+public:
+    Callback<void(Ipv4Address address, uint16_t sequence)> on_echo_reply;
+
+    StackConfig config() { return _config; }
+
+    Stack(Interface &interface, StackConfig config, uint64_t now = 0);
+
+    // Parses a frame where it is, only what has to outlive the receive
+    // buffer is copied out (payloads for sockets).
+    void receive(const uint8_t *frame, size_t size);
+
+    // Runs the timers against `now`, in milliseconds, and sends everything
+    // pending: data, acknowledgments and retransmissions.
+    void poll(uint64_t now);
+
+    Result ping(Ipv4Address address, uint16_t sequence);
+
+    ResultOr<RefPtr<UdpSocket>> udp_bind(uint16_t port);
+
+    Result udp_send(UdpSocket &socket, NetworkEndpoint destination, const void *buffer, size_t size);
+
+    ResultOr<RefPtr<TcpListener>> tcp_listen(uint16_t port);
+
+    ResultOr<RefPtr<TcpConnection>> tcp_connect(NetworkEndpoint remote);
+};
+
+} // namespace Net
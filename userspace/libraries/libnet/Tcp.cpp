@@ -0,0 +1,79 @@
+#include <libmath/MinMax.h>
+#include <string.h>
+
+#include <libnet/Tcp.h>
+
+namespace Net
+{
+
+/* --- TcpBuffer ------------------------------------------------------------ */
+
+size_t TcpBuffer::write(const void *buffer, size_t size)
+{
+    size = MIN(size, available());
+
+    size_t end = (_start + _used) % _capacity;
+    size_t first = MIN(size, _capacity - end);
+
+    memcpy(_data + end, buffer, first);
+    memcpy(_data, reinterpret_cast<const uint8_t *>(buffer) + first, size - first);
+
+    _used += size;
+
+    return size;
+}
+
+size_t TcpBuffer::peek(size_t offset, void *buffer, size_t size) const
+{
+    if (offset >= _used)
+    {
+        return 0;
+    }
+
+    size = MIN(size, _used - offset);
+
+    size_t begin = (_start + offset) % _capacity;
+    size_t first = MIN(size, _capacity - begin);
+
+    memcpy(buffer, _data + begin, first);
+    memcpy(reinterpret_cast<uint8_t *>(buffer) + first, _data, size - first);
+
+    return size;
+}
+
+void TcpBuffer::discard(size_t size)
+{
+    size = MIN(size, _used);
+
+    _start = (_start + size) % _capacity;
+    _used -= size;
+}
+
+/* --- TcpConnection -------------------------------------------------------- */
+
+size_t TcpConnection::send(const void *buffer, size_t size)
+{
+    if (!writable())
+    {
+        return 0;
+    }
+
+    return _send_buffer.write(buffer, size);
+}
+
+size_t TcpConnection::receive(void *buffer, size_t size)
+{
+    return _receive_buffer.read(buffer, size);
+}
+
+void TcpConnection::close()
+{
+    _close_requested = true;
+
+    if (_state == TcpState::SYN_SENT)
+    {
+        _state = TcpState::CLOSED;
+    }
+}
+
+} // namespace Net
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <abi/Network.h>
+#include <libutils/RefCounted.h>
+#include <libutils/RefPtr.h>
+#include <libutils/Vector.h>
+
+namespace Net
+{
+
+// Sequence numbers wrap around, they compare through their difference.
+static inline bool sequence_before(uint32_t left, uint32_t right) { return (int32_t)(left - right) < 0; }
+
+static inline bool sequence_before_or_equal(uint32_t left, uint32_t right) { return (int32_t)(left - right) <= 0; }
+
+// A fixed size ring of bytes, moved in and out with at most two copies.
+class TcpBuffer
+{
+private:
+    uint8_t *_data;
+    size_t _capacity;
+    size_t _start = 0;
+    size_t _used = 0;
+
+    NONCOPYABLE(TcpBuffer);
+    NONMOVABLE(TcpBuffer);
+
+public:
+    size_t used() const { return _used; }
+
+    size_t available() const { return _capacity - _used; }
+
+    TcpBuffer(size_t capacity) : _data{new uint8_t[capacity]}, _capacity{capacity} {}
+
+    ~TcpBuffer() { delete[] _data; }
+
+    size_t write(const void *buffer, size_t size);
+
+    size_t peek(size_t offset, void *buffer, size_t size) const;
+
+    void discard(size_t size);
+
+    size_t read(void *buffer, size_t size)
+    {
+        size_t read = peek(0, buffer, size);
+        discard(read);
+        return read;
+    }
+};
+
+enum class TcpState
+{
+    CLOSED,
+    SYN_SENT,
+    SYN_RECEIVED,
+    ESTABLISHED,
+    FIN_WAIT_1,
+    FIN_WAIT_2,
+    CLOSE_WAIT,
+    CLOSING,
+    LAST_ACK,
+    TIME_WAIT,
+};
+
+class TcpConnection : public RefCounted<TcpConnection>
+{
+private:
+    friend class Stack;
+
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    NetworkEndpoint _local;
+    NetworkEndpoint _remote;
+
+    TcpState _state = TcpState::CLOSED;
+    Result _error = SUCCESS;
+
+    // Sending, the SYN takes _initial_sequence and the buffered data starts
+    // right after it, then comes the FIN.
+    uint32_t _initial_sequence = 0;
+    uint32_t _send_unacknowledged = 0;
+    uint32_t _send_next = 0;
+    uint32_t _send_max = 0;
+    uint32_t _send_window = 0;
+    uint16_t _segment_size = 536;
+    uint32_t _congestion_window = 0;
+    uint32_t _slow_start_threshold = 0xffff;
+    int _duplicate_acks = 0;
+    bool _close_requested = false;
+    bool _fin_sent = false;
+    uint32_t _fin_sequence = 0;
+
+    // Receiving, only in order segments are kept.
+    uint32_t _receive_next = 0;
+    bool _fin_received = false;
+    bool _ack_pending = false;
+    uint32_t _advertised_window = 0;
+
+    // Timers, in milliseconds on the stack's clock, zero when not armed.
+    uint64_t _retransmit_at = 0;
+    uint64_t _retransmit_timeout = 0;
+    int _retransmits = 0;
+    bool _probe = false;
+    uint64_t _time_wait_until = 0;
+
+    TcpBuffer _send_buffer{BUFFER_SIZE};
+    TcpBuffer _receive_buffer{BUFFER_SIZE};
+
+    uint32_t data_sequence() const { return _send_unacknowledged + (_send_unacknowledged == _initial_sequence ? 1 : 0); }
+
+public:
+    NetworkEndpoint local() const { return _local; }
+
+    NetworkEndpoint remote() const { return _remote; }
+
+    TcpState state() const { return _state; }
+
+    // Why the connection got closed, if it wasn't a clean close.
+    Result error() const { return _error; }
+
+    bool connecting() const { return _state == TcpState::SYN_SENT || _state == TcpState::SYN_RECEIVED; }
+
+    // True once there is something to read or the stream is over.
+    bool readable() const { return _receive_buffer.used() > 0 || _fin_received || _state == TcpState::CLOSED; }
+
+    bool writable() const { return _send_buffer.available() > 0 && !_close_requested && _state != TcpState::CLOSED; }
+
+    // Bytes still waiting to be acknowledged by the other end.
+    size_t unacknowledged() const { return _send_buffer.used(); }
+
+    TcpConnection(NetworkEndpoint local, NetworkEndpoint remote) : _local{local}, _remote{remote} {}
+
+    // Queues as much of `buffer` as fits, the stack sends it on its next
+    // poll.
+    size_t send(const void *buffer, size_t size);
+
+    size_t receive(void *buffer, size_t size);
+
+    // Sends a FIN once everything queued is out.
+    void close();
+};
+
+class TcpListener : public RefCounted<TcpListener>
+{
+private:
+    friend class Stack;
+
+    // Established connections wait in _pending for accept(), the ones still
+    // in their handshake count toward the backlog too.
+    static constexpr size_t BACKLOG = 16;
+
+    uint16_t _port;
+    Vector<RefPtr<TcpConnection>> _pending{};
+    bool _closed = false;
+
+public:
+    uint16_t port() const { return _port; }
+
+    bool readable() const { return _pending.count() > 0; }
+
+    bool closed() const { return _closed; }
+
+    TcpListener(uint16_t port) : _port{port} {}
+
+    RefPtr<TcpConnection> accept() { return _pending.take_at(0); }
+
+    void close() { _closed = true; }
+};
+
+} // namespace Net
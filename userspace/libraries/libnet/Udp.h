@@ -0,0 +1,41 @@
+#pragma once
+
+#include <abi/Network.h>
+#include <libutils/RefCounted.h>
+#include <libutils/Vector.h>
+
+namespace Net
+{
+
+struct Datagram
+{
+    NetworkEndpoint endpoint;
+    Vector<uint8_t> data;
+};
+
+class UdpSocket : public RefCounted<UdpSocket>
+{
+private:
+    friend class Stack;
+
+    // Datagrams past this are dropped until the owner catches up.
+    static constexpr size_t QUEUE_LIMIT = 64;
+
+    uint16_t _port;
+    Vector<Datagram> _queue{};
+    bool _closed = false;
+
+public:
+    uint16_t port() const { return _port; }
+
+    bool readable() const { return _queue.count() > 0; }
+
+    UdpSocket(uint16_t port) : _port{port} {}
+
+    Datagram receive() { return _queue.take_at(0); }
+
+    // The stack lets go of the port on its next poll.
+    void close() { _closed = true; }
+};
+
+} // namespace Net
@@ -10,6 +10,7 @@
     __ENTRY(ERR_BAD_IMAGE_FILE_FORMAT, "Bad image file format")                   \
     __ENTRY(ERR_CANNOT_ALLOCATE_MEMORY, "Cannot allocate memory")                 \
     __ENTRY(ERR_CONNECTION_REFUSED, "Connection refused")                         \
+    __ENTRY(ERR_CONNECTION_RESET, "Connection reset by peer")                     \
     __ENTRY(ERR_EXEC_FORMAT_ERROR, "Exec format error")                           \
     __ENTRY(ERR_FILE_EXISTS, "File exists")                                       \
     __ENTRY(ERR_NOT_IMPLEMENTED, "Function not implemented")                      \
@@ -37,6 +38,7 @@
     __ENTRY(ERR_DIRECTORY_NOT_EMPTY, "Directory not empty")                       \
     __ENTRY(ERR_EXTENSION, "Unrecognized file extension")                         \
     __ENTRY(ERR_ACCESS_DENIED, "Access denied")                                   \
+    __ENTRY(ERR_ADDRESS_IN_USE, "Address already in use")                         \
     __ENTRY(ERR_UNKNOWN, "Unknown failure")
 
 enum Result
@@ -36,6 +36,8 @@ TimeStamp __plug_system_get_time();
 
 Tick __plug_system_get_ticks();
 
+uint64_t __plug_system_get_monotonic_time();
+
 /* --- Processes ------------------------------------------------------------ */
 
 int __plug_process_this();
@@ -2,6 +2,7 @@
 
 #include <libsystem/Result.h>
 #include <libsystem/system/Memory.h>
+#include <string.h>
 
 Result memory_alloc(size_t size, uintptr_t *out_address)
 {
@@ -22,3 +23,8 @@ Result memory_get_handle(uintptr_t address, int *out_handle)
 {
     return hj_memory_get_handle(address, out_handle);
 }
+
+Result memory_map_file(const char *path, uintptr_t *out_address, size_t *out_size)
+{
+    return hj_memory_map_file(path, strlen(path), out_address, out_size);
+}
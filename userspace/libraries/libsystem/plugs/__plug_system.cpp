@@ -1,12 +1,46 @@
 
-#include <abi/Syscalls.h>
+#include <abi/Clock.h>
 
-#include <assert.h>
 #include <libsystem/core/Plugs.h>
 
+static inline uint64_t rdtsc()
+{
+    uint32_t low, high;
+    asm volatile("rdtsc"
+                 : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
 Tick __plug_system_get_ticks()
 {
-    Tick result = 0;
-    assert(hj_system_tick(&result) == SUCCESS);
-    return result;
+    return __plug_system_get_monotonic_time() / 1000000;
+}
+
+uint64_t __plug_system_get_monotonic_time()
+{
+    auto page = reinterpret_cast<volatile ClockPage *>(CLOCK_PAGE_ADDRESS);
+
+    while (true)
+    {
+        uint32_t sequence = __atomic_load_n(&page->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence & 1)
+        {
+            continue;
+        }
+
+        uint64_t time = page->coarse;
+
+        if (page->cycles_available)
+        {
+            time = clock_cycles_to_nanoseconds(rdtsc() - page->cycles_at_boot, page->nanoseconds_per_cycle);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&page->sequence, __ATOMIC_RELAXED) == sequence)
+        {
+            return time;
+        }
+    }
 }
@@ -29,8 +29,8 @@ Launchpad *launchpad_create(const char *name, const char *executable)
     launchpad_argument(launchpad, executable_path.basename().cstring());
 
 #ifndef __KERNEL__
-    auto env_copy = environment_copy();
-    launchpad_environment(launchpad, strdup(env_copy.cstring()));
+    auto block = environment_block();
+    launchpad_environment(launchpad, block.raw_storage(), block.count());
 #endif
 
     return launchpad;
@@ -105,15 +105,16 @@ void launchpad_handle(Launchpad *launchpad, Handle *handle_to_pass, int destinat
     launchpad->handles[destination] = handle_to_pass->id;
 }
 
-void launchpad_environment(Launchpad *launchpad, const char *buffer)
+void launchpad_environment(Launchpad *launchpad, const void *block, size_t size)
 {
     if (launchpad->env)
     {
         free(launchpad->env);
     }
 
-    launchpad->env = strdup(buffer);
-    launchpad->env_size = strlen(buffer);
+    launchpad->env = (char *)malloc(size);
+    memcpy(launchpad->env, block, size);
+    launchpad->env_size = size;
 }
 
 Result launchpad_launch(Launchpad *launchpad, int *pid)
@@ -17,7 +17,7 @@ void launchpad_argument(Launchpad *launchpad, const char *argument);
 
 void launchpad_arguments(Launchpad *launchpad, const Vector<String> &arguments);
 
-void launchpad_environment(Launchpad *launchpad, const char *buffer);
+void launchpad_environment(Launchpad *launchpad, const void *block, size_t size);
 
 void launchpad_handle(Launchpad *launchpad, IO::RawHandle &handle_to_pass, int destination);
 
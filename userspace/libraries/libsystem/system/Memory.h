@@ -18,3 +18,7 @@ Result memory_free(uintptr_t address);
 Result memory_include(int handle, uintptr_t *out_address, size_t *out_size);
 
 Result memory_get_handle(uintptr_t address, int *out_handle);
+
+// The mapping is read-only and shared with every other process mapping the
+// same file, it is released with memory_free().
+Result memory_map_file(const char *path, uintptr_t *out_address, size_t *out_size);
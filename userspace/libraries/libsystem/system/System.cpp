@@ -5,3 +5,8 @@ Tick system_get_ticks()
 {
     return __plug_system_get_ticks();
 }
+
+uint64_t system_get_monotonic_time()
+{
+    return __plug_system_get_monotonic_time();
+}
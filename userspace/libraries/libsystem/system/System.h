@@ -2,4 +2,8 @@
 
 #include <abi/System.h>
 
+// Milliseconds since boot.
 Tick system_get_ticks();
+
+// Nanoseconds since boot, read without entering the kernel.
+uint64_t system_get_monotonic_time();
@@ -0,0 +1,80 @@
+#include <abi/Syscalls.h>
+
+#include <libsystem/system/Memory.h>
+#include <libsystem/thread/Thread.h>
+
+static ThreadLocalStorage _main_storage{&_main_storage, nullptr, 0};
+
+Thread::Thread(Callback<void()> entry)
+    : _storage{&_storage, this, -1},
+      _entry(move(entry))
+{
+}
+
+Thread::~Thread()
+{
+    join();
+}
+
+void Thread::trampoline()
+{
+    Thread *thread = current();
+
+    thread->_entry();
+
+    hj_thread_exit(PROCESS_SUCCESS);
+    __builtin_unreachable();
+}
+
+ResultOr<OwnPtr<Thread>> Thread::spawn(Callback<void()> entry)
+{
+    if (!__thread_local_storage_ready)
+    {
+        TRY(hj_thread_tls((uintptr_t)&_main_storage));
+        __thread_local_storage_ready = true;
+    }
+
+    auto thread = own<Thread>(move(entry));
+
+    TRY(memory_alloc(STACK_SIZE, &thread->_stack));
+
+    // Lay the stack out as if trampoline() had just been called.
+    uintptr_t stack_pointer = ((thread->_stack + STACK_SIZE) & ~(uintptr_t)0xf) - sizeof(uintptr_t);
+    *(uintptr_t *)stack_pointer = 0;
+
+    Result result = hj_thread_create((uintptr_t)trampoline, stack_pointer, (uintptr_t)&thread->_storage, &thread->_storage.id);
+
+    if (result != SUCCESS)
+    {
+        memory_free(thread->_stack);
+        return result;
+    }
+
+    thread->_joined = false;
+
+    return thread;
+}
+
+Thread *Thread::current()
+{
+    ThreadLocalStorage *storage = thread_local_storage();
+
+    return storage ? storage->thread : nullptr;
+}
+
+Result Thread::join(int *exit_value)
+{
+    if (_joined)
+    {
+        return SUCCESS;
+    }
+
+    int dummy_exit_value;
+    Result result = hj_process_wait(_storage.id, exit_value ? exit_value : &dummy_exit_value);
+
+    _joined = true;
+    memory_free(_stack);
+    _stack = 0;
+
+    return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <libsystem/Result.h>
+#include <libutils/Callback.h>
+#include <libutils/OwnPtr.h>
+#include <libutils/ResultOr.h>
+#include <skift/ThreadLocal.h>
+
+class Thread
+{
+private:
+    static constexpr size_t STACK_SIZE = 256 * 1024;
+
+    bool _joined = true;
+    uintptr_t _stack = 0;
+
+    ThreadLocalStorage _storage;
+    Callback<void()> _entry;
+
+    NONCOPYABLE(Thread);
+    NONMOVABLE(Thread);
+
+    static void trampoline();
+
+public:
+    // Threads share everything with the rest of the process but their stack.
+    static ResultOr<OwnPtr<Thread>> spawn(Callback<void()> entry);
+
+    // The thread running the caller, or nullptr on the main thread.
+    static Thread *current();
+
+    int id() const { return _storage.id; }
+
+    Thread(Callback<void()> entry);
+
+    ~Thread();
+
+    Result join(int *exit_value = nullptr);
+};
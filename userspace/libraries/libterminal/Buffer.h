@@ -12,8 +12,17 @@ class Buffer
 private:
     int _width;
     int _height;
+
+    // Lines are stored as a ring, _top is the index of the line displayed at
+    // the top of the screen. Scrolling rotates the ring instead of moving cells.
+    int _top = 0;
     Vector<Cell> _buffer;
 
+    int convert_y(int y) const
+    {
+        return (_top + y) % _height;
+    }
+
 public:
     int width() const { return _width; }
 
@@ -25,11 +34,25 @@ public:
         _buffer.resize(_width * _height);
     }
 
+    const Cell *line(int y) const
+    {
+        assert(y >= 0 && y < _height);
+
+        return &_buffer[convert_y(y) * _width];
+    }
+
+    Cell *line(int y)
+    {
+        assert(y >= 0 && y < _height);
+
+        return &_buffer[convert_y(y) * _width];
+    }
+
     const Cell at(int x, int y) const
     {
         if (x >= 0 && x < _width && y >= 0 && y < _height)
         {
-            return _buffer[y * _width + x];
+            return line(y)[x];
         }
 
         return {U' ', {}, true};
@@ -40,13 +63,35 @@ public:
         if (x >= 0 && x < _width &&
             y >= 0 && y < _height)
         {
-            Cell old_cell = _buffer[y * _width + x];
+            Cell &old_cell = line(y)[x];
 
             if (old_cell.codepoint != cell.codepoint ||
                 old_cell.attributes != cell.attributes)
             {
-                _buffer[y * _width + x] = cell;
-                _buffer[y * _width + x].dirty = true;
+                old_cell = cell;
+                old_cell.dirty = true;
+            }
+        }
+    }
+
+    void write(int x, int y, const char *text, int size, Attributes attributes)
+    {
+        if (y < 0 || y >= _height || x < 0 || x >= _width)
+        {
+            return;
+        }
+
+        Cell *cells = line(y);
+        size = MIN(size, _width - x);
+
+        for (int i = 0; i < size; i++)
+        {
+            Cell &cell = cells[x + i];
+            Codepoint codepoint = static_cast<uint8_t>(text[i]);
+
+            if (cell.codepoint != codepoint || cell.attributes != attributes)
+            {
+                cell = {codepoint, attributes, true};
             }
         }
     }
@@ -55,7 +100,7 @@ public:
     {
         if (x >= 0 && x < _width && y >= 0 && y < _height)
         {
-            _buffer[y * _width + x].dirty = false;
+            line(y)[x].dirty = false;
         }
     }
 
@@ -101,8 +146,9 @@ public:
             }
         }
 
-        _buffer = new_buffer;
+        _buffer = move(new_buffer);
 
+        _top = 0;
         _width = width;
         _height = height;
     }
@@ -111,32 +157,18 @@ public:
     {
         if (how_many_line < 0)
         {
-            for (int line = 0; line < how_many_line; line++)
+            for (int line = 0; line < MIN(-how_many_line, _height); line++)
             {
-                for (int i = (width() * height()) - 1; i >= height(); i++)
-                {
-                    int x = i % width();
-                    int y = i / width();
-
-                    set(x, y, at(x, y - 1));
-                }
-
+                _top = (_top + _height - 1) % _height;
                 clear_line(0, attributes);
             }
         }
         else if (how_many_line > 0)
         {
-            for (int line = 0; line < how_many_line; line++)
+            for (int line = 0; line < MIN(how_many_line, _height); line++)
             {
-                for (int i = 0; i < width() * (height() - 1); i++)
-                {
-                    int x = i % width();
-                    int y = i / width();
-
-                    set(x, y, at(x, y + 1));
-                }
-
-                clear_line(height() - 1, attributes);
+                _top = (_top + 1) % _height;
+                clear_line(_height - 1, attributes);
             }
         }
     }
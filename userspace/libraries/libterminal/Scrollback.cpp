@@ -0,0 +1,119 @@
+#include <libterminal/Scrollback.h>
+
+namespace Terminal
+{
+
+void Scrollback::limit(size_t limit)
+{
+    clear();
+    _lines = {};
+    _limit = limit;
+}
+
+void Scrollback::clear()
+{
+    _head = 0;
+    _count = 0;
+}
+
+void Scrollback::push(const Cell *cells, int width)
+{
+    if (_limit == 0)
+    {
+        return;
+    }
+
+    if (_lines.count() < _limit)
+    {
+        _lines.push_back({});
+    }
+
+    Line &line = _lines[_head];
+    _head = (_head + 1) % _limit;
+    _count = MIN(_count + 1, _limit);
+
+    line.runs.clear();
+    line.text.clear();
+    line.ascii = true;
+
+    int length = width;
+
+    while (length > 0 &&
+           cells[length - 1].codepoint == U' ' &&
+           cells[length - 1].attributes == Attributes{})
+    {
+        length--;
+    }
+
+    line.length = length;
+
+    for (int x = 0; x < length; x++)
+    {
+        const Cell &cell = cells[x];
+
+        if (line.runs.any() && line.runs.peek_back().attributes == cell.attributes)
+        {
+            line.runs.peek_back().length++;
+        }
+        else
+        {
+            line.runs.push_back({cell.attributes, 1});
+        }
+
+        if (cell.codepoint < 0x80)
+        {
+            line.text.push_back(cell.codepoint);
+        }
+        else
+        {
+            uint8_t buffer[5];
+            int size = codepoint_to_utf8(cell.codepoint, buffer);
+            line.text.push_back_many(buffer, size);
+            line.ascii = false;
+        }
+    }
+}
+
+Cell Scrollback::at(int x, size_t index) const
+{
+    if (index >= _count || x < 0 || x >= line(index).length)
+    {
+        return {U' ', {}, true};
+    }
+
+    const Line &line = this->line(index);
+
+    Attributes attributes = {};
+
+    int offset = 0;
+    for (size_t i = 0; i < line.runs.count(); i++)
+    {
+        if (x < offset + line.runs[i].length)
+        {
+            attributes = line.runs[i].attributes;
+            break;
+        }
+
+        offset += line.runs[i].length;
+    }
+
+    Codepoint codepoint = U' ';
+
+    if (line.ascii)
+    {
+        codepoint = line.text[x];
+    }
+    else
+    {
+        size_t position = 0;
+
+        for (int i = 0; i <= x && position < line.text.count(); i++)
+        {
+            position += utf8_to_codepoint(&line.text[position], &codepoint);
+        }
+    }
+
+    return {codepoint, attributes, true};
+}
+
+} // namespace Terminal
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <libterminal/Cell.h>
+#include <libutils/Vector.h>
+
+namespace Terminal
+{
+
+class Scrollback
+{
+private:
+    // A line is stored as runs of cells sharing the same attributes, with its
+    // trailing blank cells trimmed. The text is kept as UTF-8 and only has to
+    // be decoded when the line contains something else than plain ASCII.
+    struct Run
+    {
+        Attributes attributes;
+        int length;
+    };
+
+    struct Line
+    {
+        Vector<Run> runs{};
+        Vector<uint8_t> text{};
+        bool ascii = true;
+        int length = 0;
+    };
+
+    // Fixed size ring of lines, slots are recycled once the limit is reached
+    // so pushing a line never has to move the rest of the history.
+    Vector<Line> _lines{};
+    size_t _head = 0;
+    size_t _count = 0;
+    size_t _limit;
+
+    const Line &line(size_t index) const
+    {
+        return _lines[(_head + _lines.count() - 1 - index) % _lines.count()];
+    }
+
+public:
+    static constexpr size_t DEFAULT_LIMIT = 1000;
+
+    size_t count() const { return _count; }
+
+    size_t limit() const { return _limit; }
+
+    Scrollback(size_t limit = DEFAULT_LIMIT)
+        : _limit{limit}
+    {
+    }
+
+    void limit(size_t limit);
+
+    void clear();
+
+    void push(const Cell *cells, int width);
+
+    // Index 0 is the most recent line.
+    Cell at(int x, size_t index) const;
+};
+
+} // namespace Terminal
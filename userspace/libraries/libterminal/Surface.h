@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libterminal/Buffer.h>
+#include <libterminal/Scrollback.h>
 
 namespace Terminal
 {
@@ -9,72 +10,79 @@ class Surface
 {
 private:
     Buffer _buffer;
+    Scrollback _scrollback;
 
-    int _height;
-    int _width;
+public:
+    int width() { return _buffer.width(); }
 
-    int _scrollback = 0;
+    int height() { return _buffer.height(); }
 
-    int convert_y(int y) const
-    {
-        return _buffer.height() - _height + y;
-    }
-
-public:
-    int width() { return _width; }
+    int scrollback() { return _scrollback.count(); }
 
-    int height() { return _height; }
+    size_t scrollback_limit() { return _scrollback.limit(); }
 
-    int scrollback() { return _scrollback; }
+    void scrollback_limit(size_t limit) { _scrollback.limit(limit); }
 
-    Surface(int width, int height)
-        : _buffer{width, 1000}
+    Surface(int width, int height, size_t scrollback_limit = Scrollback::DEFAULT_LIMIT)
+        : _buffer{width, height},
+          _scrollback{scrollback_limit}
     {
-        _width = width;
-        _height = height;
     }
 
+    // Negative lines are read from the scrollback, -1 being the most recent one.
     const Cell at(int x, int y) const
     {
-        return _buffer.at(x, convert_y(y));
+        if (y < 0)
+        {
+            return _scrollback.at(x, -y - 1);
+        }
+
+        return _buffer.at(x, y);
     }
 
     void set(int x, int y, Cell cell)
     {
-        _buffer.set(x, convert_y(y), cell);
+        _buffer.set(x, y, cell);
+    }
+
+    void write(int x, int y, const char *text, int size, Attributes attributes)
+    {
+        _buffer.write(x, y, text, size, attributes);
     }
 
     void undirty(int x, int y)
     {
-        _buffer.undirty(x, convert_y(y));
+        _buffer.undirty(x, y);
     }
 
     void clear(int fromx, int fromy, int tox, int toy, Attributes attributes)
     {
-        _buffer.clear(fromx, convert_y(fromy), tox, convert_y(toy), attributes);
+        _buffer.clear(fromx, fromy, tox, toy, attributes);
     }
 
     void clear_all(Attributes attributes)
     {
-        clear(0, 0, _width, _height, attributes);
+        clear(0, 0, width(), height(), attributes);
     }
 
     void clear_line(int line, Attributes attributes)
     {
-        _buffer.clear_line(convert_y(line), attributes);
+        _buffer.clear_line(line, attributes);
     }
 
     void resize(int width, int height)
     {
-        _buffer.resize(MAX(_buffer.width(), width), MAX(MAX(height, _height), 1000));
-        _width = width;
-        _height = height;
+        _buffer.resize(width, height);
     }
 
     void scroll(int how_many_line, Attributes attributes)
     {
+        for (int i = 0; i < MIN(how_many_line, height()); i++)
+        {
+            _scrollback.push(_buffer.line(i), width());
+        }
+
         _buffer.scroll(how_many_line, attributes);
-        _scrollback += how_many_line;
     }
 };
 
@@ -7,25 +7,91 @@
 namespace Terminal
 {
 
-Terminal::Terminal(int width, int height)
-    : _surface{width, height}
+// Codepoints outside of the ASCII range share the last column of the table.
+static constexpr size_t TRANSITION_CLASSES = 129;
+
+using TransitionTable = Transition[(size_t)State::__COUNT][TRANSITION_CLASSES];
+
+static constexpr size_t transition_class(Codepoint codepoint)
+{
+    return codepoint < 128 ? codepoint : 128;
+}
+
+static constexpr auto build_transitions()
+{
+    struct
+    {
+        TransitionTable table;
+    } transitions = {};
+
+    for (size_t c = 0; c < TRANSITION_CLASSES; c++)
+    {
+        auto &wait_esc = transitions.table[(size_t)State::WAIT_ESC][c];
+        auto &expect_bracket = transitions.table[(size_t)State::EXPECT_BRACKET][c];
+        auto &read_attribute = transitions.table[(size_t)State::READ_ATTRIBUTE][c];
+
+        wait_esc = {Action::APPEND, State::WAIT_ESC};
+        expect_bracket = {Action::APPEND, State::WAIT_ESC};
+
+        if (c >= '0' && c <= '9')
+        {
+            read_attribute = {Action::PARAMETER, State::READ_ATTRIBUTE};
+        }
+        else if (c == ';')
+        {
+            read_attribute = {Action::SEPARATOR, State::READ_ATTRIBUTE};
+        }
+        else
+        {
+            read_attribute = {Action::DISPATCH, State::WAIT_ESC};
+        }
+    }
+
+    transitions.table[(size_t)State::WAIT_ESC][(size_t)'\e'] = {Action::ESCAPE, State::EXPECT_BRACKET};
+    transitions.table[(size_t)State::EXPECT_BRACKET][(size_t)'['] = {Action::NONE, State::READ_ATTRIBUTE};
+    transitions.table[(size_t)State::EXPECT_BRACKET][(size_t)'c'] = {Action::RESET, State::WAIT_ESC};
+
+    return transitions;
+}
+
+static constexpr auto _transitions = build_transitions();
+
+static bool is_printable_ascii(char c)
+{
+    return c >= 0x20 && c < 0x7f;
+}
+
+Terminal::Terminal(int width, int height, size_t scrollback_limit)
+    : _surface{width, height, scrollback_limit}
 {
     _decoder.callback([this](auto codepoint) { write(codepoint); });
 
     _cursor = {0, 0, true};
     _saved_cursor = {0, 0, true};
 
-    _parameters_top = 0;
+    clear_parameters();
+}
 
+void Terminal::clear_parameters()
+{
     for (auto &_parameter : _parameters)
     {
         _parameter.empty = true;
         _parameter.value = 0;
     }
+
+    _parameters_top = 0;
 }
 
 void Terminal::resize(int width, int height)
 {
+    // Keep the cursor line on screen by pushing the lines above it to the scrollback.
+    if (_cursor.y >= height)
+    {
+        _surface.scroll(_cursor.y - height + 1, _attributes);
+        _cursor.y = height - 1;
+    }
+
     _surface.resize(width, height);
 
     _cursor.x = clamp(_cursor.x, 0, width - 1);
@@ -111,6 +177,20 @@ void Terminal::append(Codepoint codepoint)
     }
 }
 
+void Terminal::append(const char *text, size_t size)
+{
+    while (size > 0)
+    {
+        int count = MIN((int)size, width() - _cursor.x);
+
+        _surface.write(_cursor.x, _cursor.y, text, count, _attributes);
+        cursor_move(count, 0);
+
+        text += count;
+        size -= count;
+    }
+}
+
 void Terminal::do_ansi(Codepoint codepoint)
 {
     switch (codepoint)
@@ -328,70 +408,43 @@ void Terminal::do_ansi(Codepoint codepoint)
     }
 }
 
-void Terminal::write(Codepoint codepoint)
+void Terminal::do_action(Action action, Codepoint codepoint)
 {
-    switch (_state)
+    switch (action)
     {
-    case State::WAIT_ESC:
-        if (codepoint == U'\e')
-        {
-            for (auto &_parameter : _parameters)
-            {
-                _parameter.empty = true;
-                _parameter.value = 0;
-            }
+    case Action::NONE:
+        break;
 
-            _parameters_top = 0;
+    case Action::APPEND:
+        append(codepoint);
+        break;
 
-            _state = State::EXPECT_BRACKET;
-        }
-        else
-        {
-            _state = State::WAIT_ESC;
-            append(codepoint);
-        }
+    case Action::ESCAPE:
+        clear_parameters();
         break;
 
-    case State::EXPECT_BRACKET:
-        if (codepoint == U'[')
-        {
-            _state = State::READ_ATTRIBUTE;
-        }
-        else if (codepoint == U'c')
-        {
-            _attributes = {};
-            _state = State::WAIT_ESC;
+    case Action::RESET:
+        _attributes = {};
 
-            cursor_set(0, 0);
-            _surface.clear_all(_attributes);
-        }
-        else
-        {
-            _state = State::WAIT_ESC;
-            append(codepoint);
-        }
+        cursor_set(0, 0);
+        _surface.clear_all(_attributes);
         break;
 
-    case State::READ_ATTRIBUTE:
-        if (codepoint_is_digit(codepoint))
+    case Action::PARAMETER:
+        _parameters[_parameters_top].empty = false;
+        _parameters[_parameters_top].value *= 10;
+        _parameters[_parameters_top].value += codepoint_numeric_value(codepoint);
+        break;
+
+    case Action::SEPARATOR:
+        if (_parameters_top + 1 < MAX_PARAMETERS)
         {
-            _parameters[_parameters_top].empty = false;
-            _parameters[_parameters_top].value *= 10;
-            _parameters[_parameters_top].value += codepoint_numeric_value(codepoint);
+            _parameters_top++;
         }
-        else
-        {
-            if (codepoint == U';')
-            {
-                _parameters_top++;
-            }
-            else
-            {
-                _state = State::WAIT_ESC;
+        break;
 
-                do_ansi(codepoint);
-            }
-        }
+    case Action::DISPATCH:
+        do_ansi(codepoint);
         break;
 
     default:
@@ -399,6 +452,14 @@ void Terminal::write(Codepoint codepoint)
     }
 }
 
+void Terminal::write(Codepoint codepoint)
+{
+    auto transition = _transitions.table[(size_t)_state][transition_class(codepoint)];
+
+    _state = transition.state;
+    do_action(transition.action, codepoint);
+}
+
 void Terminal::write(char c)
 {
     _decoder.write(c);
@@ -406,9 +467,31 @@ void Terminal::write(char c)
 
 void Terminal::write(const char *buffer, size_t size)
 {
-    for (size_t i = 0; i < size; i++)
+    size_t i = 0;
+
+    while (i < size)
     {
+        // Fast path: runs of printable ASCII outside of an escape sequence go
+        // straight into the surface without being decoded one by one.
+        if (_state == State::WAIT_ESC && !_decoder.decoding())
+        {
+            size_t run = 0;
+
+            while (i + run < size && is_printable_ascii(buffer[i + run]))
+            {
+                run++;
+            }
+
+            if (run > 0)
+            {
+                append(buffer + i, run);
+                i += run;
+                continue;
+            }
+        }
+
         write(buffer[i]);
+        i++;
     }
 }
 
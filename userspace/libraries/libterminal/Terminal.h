@@ -9,11 +9,30 @@
 namespace Terminal
 {
 
-enum class State
+enum class State : uint8_t
 {
     WAIT_ESC,
     EXPECT_BRACKET,
     READ_ATTRIBUTE,
+
+    __COUNT,
+};
+
+enum class Action : uint8_t
+{
+    NONE,
+    APPEND,
+    ESCAPE,
+    RESET,
+    PARAMETER,
+    SEPARATOR,
+    DISPATCH,
+};
+
+struct Transition
+{
+    Action action;
+    State state;
 };
 
 struct Parameter
@@ -39,6 +58,10 @@ private:
     int _parameters_top;
     Parameter _parameters[MAX_PARAMETERS];
 
+    void clear_parameters();
+
+    void do_action(Action action, Codepoint codepoint);
+
 public:
     int width() { return _surface.width(); }
 
@@ -48,7 +71,7 @@ public:
 
     Cursor &cursor() { return _cursor; }
 
-    Terminal(int width, int height);
+    Terminal(int width, int height, size_t scrollback_limit = Scrollback::DEFAULT_LIMIT);
 
     void resize(int width, int height);
 
@@ -62,6 +85,8 @@ public:
 
     void append(Codepoint codepoint);
 
+    void append(const char *text, size_t size);
+
     void do_ansi(Codepoint codepoint);
 
     void write(Codepoint codepoint);
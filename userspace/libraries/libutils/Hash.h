@@ -27,6 +27,12 @@ inline uint32_t hash(const TObject &)
     return 0;
 }
 
+template <>
+inline uint32_t hash<int>(const int &value)
+{
+    return hash(&value, sizeof(value));
+}
+
 template <>
 inline uint32_t hash<uint32_t>(const uint32_t &value)
 {
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <skift/Lock.h>
+
+#include <libutils/Hash.h>
+#include <libutils/String.h>
+
+// Identifiers (keys, attribute names, ...) come back over and over, interning
+// them means they are allocated once and compared by pointer. Interned
+// strings are never released, so only use this for a bounded set of names.
+//
+// The table is shared by every thread of the process, it's constant
+// initialized so there is nothing to race on before the first intern().
+class InternTable
+{
+private:
+    Lock _lock{"intern-table"};
+
+    StringStorage **_slots = nullptr;
+    size_t _capacity = 0;
+    size_t _count = 0;
+
+    static InternTable _the;
+
+    static bool same(StringStorage *storage, const char *cstring, size_t length)
+    {
+        return storage->size() == length && memcmp(storage->cstring(), cstring, length) == 0;
+    }
+
+    void grow()
+    {
+        size_t old_capacity = _capacity;
+        StringStorage **old_slots = _slots;
+
+        _capacity = old_capacity ? old_capacity * 2 : 64;
+        _slots = new StringStorage *[_capacity];
+
+        for (size_t i = 0; i < _capacity; i++)
+        {
+            _slots[i] = nullptr;
+        }
+
+        for (size_t i = 0; i < old_capacity; i++)
+        {
+            if (old_slots[i])
+            {
+                size_t index = hash(old_slots[i]->cstring(), old_slots[i]->size()) & (_capacity - 1);
+
+                while (_slots[index])
+                {
+                    index = (index + 1) & (_capacity - 1);
+                }
+
+                _slots[index] = old_slots[i];
+            }
+        }
+
+        delete[] old_slots;
+    }
+
+public:
+    static InternTable &the() { return _the; }
+
+    constexpr InternTable() {}
+
+    size_t count() const { return _count; }
+
+    String intern(const char *cstring, size_t length)
+    {
+        if (length == 0)
+        {
+            return "";
+        }
+
+        LockHolder holder{_lock};
+
+        // Keep the load under 3/4 so probe sequences stay short.
+        if ((_count + 1) * 4 > _capacity * 3)
+        {
+            grow();
+        }
+
+        size_t index = hash(cstring, length) & (_capacity - 1);
+
+        while (_slots[index])
+        {
+            if (same(_slots[index], cstring, length))
+            {
+                return String(RefPtr<StringStorage>(*_slots[index]));
+            }
+
+            index = (index + 1) & (_capacity - 1);
+        }
+
+        // The table keeps the reference it's created with.
+        auto storage = new StringStorage(COPY, cstring, length);
+        storage->interned(true);
+
+        _slots[index] = storage;
+        _count++;
+
+        return String(RefPtr<StringStorage>(*storage));
+    }
+};
+
+constinit inline InternTable InternTable::_the{};
+
+static inline String intern(const char *cstring, size_t length)
+{
+    return InternTable::the().intern(cstring, length);
+}
+
+static inline String intern(const String &string)
+{
+    if (string.interned())
+    {
+        return string;
+    }
+
+    return InternTable::the().intern(string.cstring(), string.length());
+}
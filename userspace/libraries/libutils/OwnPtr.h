@@ -2,6 +2,8 @@
 
 #include <assert.h>
 
+#include <libutils/Traits.h>
+
 template <typename T>
 class OwnPtr
 {
@@ -150,3 +152,8 @@ inline OwnPtr<Type> own(Args &&... args)
 {
     return OwnPtr<Type>(new Type(forward<Args>(args)...));
 }
+
+template <typename T>
+struct IsTriviallyRelocatable<OwnPtr<T>> : public TrueType
+{
+};
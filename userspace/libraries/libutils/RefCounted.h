@@ -21,13 +21,16 @@ public:
 
     void ref()
     {
-        int refcount = __atomic_add_fetch(&_refcount, 1, __ATOMIC_SEQ_CST);
+        // Taking a reference only needs the count to be right, whoever hands
+        // us the object already made it visible.
+        int refcount = __atomic_add_fetch(&_refcount, 1, __ATOMIC_RELAXED);
         assert(refcount >= 0);
     }
 
     void deref()
     {
-        int refcount = __atomic_sub_fetch(&_refcount, 1, __ATOMIC_SEQ_CST);
+        // Releasing has to order our writes before whoever ends up deleting.
+        int refcount = __atomic_sub_fetch(&_refcount, 1, __ATOMIC_ACQ_REL);
         assert(refcount >= 0);
 
         if (refcount == 1)
@@ -206,3 +206,8 @@ template <typename T>
 struct IsRefPtr<RefPtr<T>> : public TrueType
 {
 };
+
+template <typename T>
+struct IsTriviallyRelocatable<RefPtr<T>> : public TrueType
+{
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <libutils/Vector.h>
+
+// A Vector keeping its first N elements inside the object itself, for the
+// short lived lists that rarely grow past a handful of items. It spills to
+// the heap like any other vector once it runs out of room.
+template <typename T, size_t N>
+class SmallVector : public Vector<T>
+{
+private:
+    alignas(T) char _inline[N * sizeof(T)];
+
+public:
+    SmallVector()
+        : Vector<T>(reinterpret_cast<T *>(_inline), N)
+    {
+    }
+
+    SmallVector(std::initializer_list<T> data)
+        : SmallVector()
+    {
+        for (const auto &el : data)
+        {
+            this->push_back(el);
+        }
+    }
+
+    SmallVector(const Vector<T> &other)
+        : SmallVector()
+    {
+        this->push_back_many(other);
+    }
+
+    SmallVector(const SmallVector &other)
+        : SmallVector()
+    {
+        this->push_back_many(other);
+    }
+
+    SmallVector(SmallVector &&other)
+        : SmallVector()
+    {
+        this->take(other);
+    }
+
+    SmallVector &operator=(const SmallVector &other)
+    {
+        Vector<T>::operator=(other);
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other)
+    {
+        Vector<T>::operator=(move(other));
+        return *this;
+    }
+};
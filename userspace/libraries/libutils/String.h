@@ -38,6 +38,11 @@ public:
         return _storage->cstring()[index];
     }
 
+    bool interned() const
+    {
+        return _storage && _storage->interned();
+    }
+
     bool null_or_empty() const
     {
         return _storage == nullptr || _storage->size() == 0;
@@ -58,12 +63,26 @@ public:
 
     String(const char *cstring = "")
     {
-        _storage = make<StringStorage>(COPY, cstring);
+        if (cstring[0] == '\0')
+        {
+            _storage = *StringStorage::empty();
+        }
+        else
+        {
+            _storage = make<StringStorage>(COPY, cstring);
+        }
     }
 
     String(const char *cstring, size_t length)
     {
-        _storage = make<StringStorage>(COPY, cstring, length);
+        if (length == 0)
+        {
+            _storage = *StringStorage::empty();
+        }
+        else
+        {
+            _storage = make<StringStorage>(COPY, cstring, length);
+        }
     }
 
     String(char c)
@@ -120,6 +139,12 @@ public:
             return true;
         }
 
+        // Interned strings are unique, different storages means different text.
+        if (interned() && other.interned())
+        {
+            return false;
+        }
+
         if (length() != other.length())
         {
             return false;
@@ -174,4 +199,9 @@ template <>
 inline uint32_t hash<String>(const String &value)
 {
     return hash(value.cstring(), value.length());
-}
\ No newline at end of file
+}
+
+template <>
+struct IsTriviallyRelocatable<String> : public TrueType
+{
+};
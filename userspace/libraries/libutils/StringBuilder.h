@@ -10,52 +10,89 @@
 class StringBuilder
 {
 private:
+    // Most strings built are short, they never leave the builder's own buffer.
+    static constexpr size_t INLINE_CAPACITY = 32;
+
     size_t _used = 0;
     size_t _size = 0;
     char *_buffer = nullptr;
+    char _inline[INLINE_CAPACITY];
 
     NONCOPYABLE(StringBuilder);
     NONMOVABLE(StringBuilder);
 
+    void reset()
+    {
+        _buffer = _inline;
+        _buffer[0] = '\0';
+        _size = INLINE_CAPACITY;
+        _used = 0;
+    }
+
+    void ensure(size_t extra)
+    {
+        if (_used + extra + 1 <= _size)
+        {
+            return;
+        }
+
+        auto new_size = MAX(_size + _size / 4, _used + extra + 1);
+        auto new_buffer = new char[new_size];
+        memcpy(new_buffer, _buffer, _used + 1);
+
+        if (_buffer != _inline)
+        {
+            delete[] _buffer;
+        }
+
+        _size = new_size;
+        _buffer = new_buffer;
+    }
+
 public:
     size_t length() const
     {
         return _used;
     }
 
-    StringBuilder() : StringBuilder(16)
+    const char *cstring() const
+    {
+        return _buffer;
+    }
+
+    StringBuilder() : StringBuilder(INLINE_CAPACITY)
     {
     }
 
     StringBuilder(size_t preallocated)
     {
-        preallocated = MAX(preallocated, 16);
+        reset();
 
-        _buffer = new char[preallocated];
-        _buffer[0] = '\0';
-        _size = preallocated;
-        _used = 0;
+        if (preallocated > INLINE_CAPACITY)
+        {
+            ensure(preallocated);
+        }
     }
 
     ~StringBuilder()
     {
-        if (_buffer)
+        if (_buffer != _inline)
             delete[] _buffer;
     }
 
     String finalize()
     {
-        if (!_buffer)
+        if (_buffer == _inline)
         {
-            return "";
+            String result{_buffer, _used};
+            reset();
+            return result;
         }
 
         char *result = _buffer;
         size_t size = _used;
 
-        _buffer = nullptr;
-        _used = 0;
-        _size = 0;
+        reset();
 
         return String(make<StringStorage>(ADOPT, result, size));
     }
@@ -67,45 +104,32 @@ public:
 
     StringBuilder &append(String string)
     {
-        for (size_t i = 0; i < string.length(); i++)
-        {
-            append(string[i]);
-        }
-
-        return *this;
+        return append(string.cstring(), string.length());
     }
 
     StringBuilder &append(const char *str)
     {
         if (!str)
         {
-            append("<null>");
-        }
-        else
-        {
-            for (size_t i = 0; str[i]; i++)
-            {
-                append(str[i]);
-            }
+            return append("<null>");
         }
 
-        return *this;
+        return append(str, strlen(str));
     }
 
     StringBuilder &append(const char *str, size_t size)
     {
         if (!str)
         {
-            append("<null>");
-        }
-        else
-        {
-            for (size_t i = 0; i < size; i++)
-            {
-                append(str[i]);
-            }
+            return append("<null>");
         }
 
+        ensure(size);
+
+        memcpy(_buffer + _used, str, size);
+        _used += size;
+        _buffer[_used] = '\0';
+
         return *this;
     }
 
@@ -120,23 +144,7 @@ public:
 
     StringBuilder &append(char chr)
     {
-        if (_size == 0)
-        {
-            _buffer = new char[16];
-            _size = 16;
-            _used = 0;
-        }
-
-        if (_used + 1 == _size)
-        {
-            auto new_size = _size + _size / 4;
-            auto new_buffer = new char[new_size];
-            memcpy(new_buffer, _buffer, _size);
-            delete[] _buffer;
-
-            _size = new_size;
-            _buffer = new_buffer;
-        }
+        ensure(1);
 
         _buffer[_used] = chr;
         _buffer[_used + 1] = '\0';
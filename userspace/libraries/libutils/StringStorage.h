@@ -1,4 +1,3 @@
-
 #pragma once
 
 #include <string.h>
@@ -9,16 +8,52 @@
 class StringStorage final :
     public Storage
 {
+public:
+    // Short strings are kept right after the header, so they only cost the
+    // one allocation of the storage itself.
+    static constexpr size_t INLINE_CAPACITY = 23;
+
 private:
     char *_buffer;
     size_t _length;
+    bool _interned = false;
+    char _inline[INLINE_CAPACITY + 1];
+
+    static inline StringStorage *_empty = nullptr;
 
 public:
     using Storage::end;
     using Storage::start;
 
+    // Every empty string shares this one, it's never released. Threads
+    // racing to create it agree on whichever one got published first.
+    static StringStorage *empty()
+    {
+        StringStorage *empty = __atomic_load_n(&_empty, __ATOMIC_ACQUIRE);
+
+        if (!empty)
+        {
+            auto candidate = new StringStorage(COPY, "", 0);
+
+            if (__atomic_compare_exchange_n(&_empty, &empty, candidate, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                empty = candidate;
+            }
+            else
+            {
+                candidate->deref();
+            }
+        }
+
+        return empty;
+    }
+
     const char *cstring() { return _buffer; }
 
+    bool interned() const { return _interned; }
+
+    void interned(bool interned) { _interned = interned; }
+
     void *start() override { return _buffer; }
 
     void *end() override { return reinterpret_cast<char *>(start()) + _length; }
@@ -31,7 +66,16 @@ public:
     StringStorage(CopyTag, const char *cstring, size_t length)
     {
         _length = strnlen(cstring, length);
-        _buffer = new char[_length + 1];
+
+        if (_length <= INLINE_CAPACITY)
+        {
+            _buffer = _inline;
+        }
+        else
+        {
+            _buffer = new char[_length + 1];
+        }
+
         memcpy(_buffer, cstring, _length);
         _buffer[_length] = '\0';
     }
@@ -49,6 +93,9 @@ public:
 
     ~StringStorage()
     {
-        delete[] _buffer;
+        if (_buffer != _inline)
+        {
+            delete[] _buffer;
+        }
     }
-};
\ No newline at end of file
+};
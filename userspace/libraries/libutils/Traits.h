@@ -550,3 +550,12 @@ struct Max<arg1, arg2, others...>
 {
     static constexpr size_t value = arg1 >= arg2 ? Max<arg1, others...>::value : Max<arg2, others...>::value;
 };
+
+// A type is trivially relocatable when moving it to a new address and
+// forgetting the old one is the same as copying its bytes. Containers use
+// this to grow with realloc()/memmove() instead of moving element by element.
+// Types owning a pointer to themselves must never opt in.
+template <typename T>
+struct IsTriviallyRelocatable : Constant<bool, __is_trivially_copyable(T)>
+{
+};
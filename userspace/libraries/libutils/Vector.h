@@ -12,7 +12,7 @@
 #include <libutils/RefPtr.h>
 
 template <typename T>
-void typed_copy(T *destination, T *source, size_t count)
+void typed_copy(T *destination, const T *source, size_t count)
 {
     if constexpr (std::is_trivially_copyable_v<T>)
     {
@@ -43,14 +43,155 @@ void typed_move(T *destination, T *source, size_t count)
     }
 }
 
+// Moves count elements to a new, non-overlapping location and ends the
+// lifetime of the originals.
+template <typename T>
+void typed_relocate(T *destination, T *source, size_t count)
+{
+    if constexpr (IsTriviallyRelocatable<T>::value)
+    {
+        memcpy((void *)destination, (const void *)source, sizeof(T) * count);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            new (&destination[i]) T(move(source[i]));
+            source[i].~T();
+        }
+    }
+}
+
 template <typename T>
 class Vector
 {
 private:
+    static constexpr size_t MIN_CAPACITY = 4;
+
     T *_storage = nullptr;
     size_t _count = 0;
     size_t _capacity = 0;
 
+    // Storage living inside a SmallVector, never realloc()'d nor free()'d.
+    T *_inline_storage = nullptr;
+    size_t _inline_capacity = 0;
+
+    bool is_inline() const { return _storage != nullptr && _storage == _inline_storage; }
+
+    void release_storage()
+    {
+        if (_storage && !is_inline())
+        {
+            free((void *)_storage);
+        }
+
+        _storage = _inline_storage;
+        _capacity = _inline_capacity;
+    }
+
+    void reallocate(size_t new_capacity)
+    {
+        assert(new_capacity >= _count);
+
+        if constexpr (IsTriviallyRelocatable<T>::value)
+        {
+            if (!is_inline())
+            {
+                _storage = reinterpret_cast<T *>(realloc((void *)_storage, new_capacity * sizeof(T)));
+                _capacity = new_capacity;
+
+                return;
+            }
+        }
+
+        T *new_storage = reinterpret_cast<T *>(malloc(new_capacity * sizeof(T)));
+
+        if (_storage)
+        {
+            typed_relocate(new_storage, _storage, _count);
+        }
+
+        release_storage();
+
+        _storage = new_storage;
+        _capacity = new_capacity;
+    }
+
+    // Leaves _storage[index] uninitialized, everything after it moved up by one.
+    void open_gap(size_t index)
+    {
+        assert(index <= _count);
+
+        grow();
+
+        if constexpr (IsTriviallyRelocatable<T>::value)
+        {
+            memmove((void *)&_storage[index + 1], (const void *)&_storage[index], (_count - 1 - index) * sizeof(T));
+        }
+        else
+        {
+            for (size_t j = _count - 1; j > index; j--)
+            {
+                new (&_storage[j]) T(move(_storage[j - 1]));
+                _storage[j - 1].~T();
+            }
+        }
+    }
+
+    // _storage[index] is already destroyed, move everything after it down by one.
+    void close_gap(size_t index)
+    {
+        if constexpr (IsTriviallyRelocatable<T>::value)
+        {
+            memmove((void *)&_storage[index], (const void *)&_storage[index + 1], (_count - 1 - index) * sizeof(T));
+        }
+        else
+        {
+            for (size_t i = index; i < _count - 1; ++i)
+            {
+                new (&_storage[i]) T(move(_storage[i + 1]));
+                _storage[i + 1].~T();
+            }
+        }
+
+        shrink();
+    }
+
+protected:
+    Vector(T *inline_storage, size_t inline_capacity)
+        : _storage(inline_storage),
+          _capacity(inline_capacity),
+          _inline_storage(inline_storage),
+          _inline_capacity(inline_capacity)
+    {
+    }
+
+    // Take the elements of other, stealing its block when it's on the heap.
+    void take(Vector &other)
+    {
+        clear();
+
+        if (other.is_inline())
+        {
+            ensure_capacity(other._count);
+            typed_relocate(_storage, other._storage, other._count);
+            _count = other._count;
+        }
+        else
+        {
+            release_storage();
+
+            _storage = other._storage;
+            _count = other._count;
+            _capacity = other._capacity;
+
+            other._storage = other._inline_storage;
+            other._capacity = other._inline_capacity;
+        }
+
+        other._count = 0;
+    }
+
 public:
     size_t count() const { return _count; }
 
@@ -73,7 +214,7 @@ public:
         return _storage[index];
     }
 
-    Vector() : Vector(16) {}
+    Vector() {}
 
     Vector(size_t capacity)
     {
@@ -107,17 +248,13 @@ public:
 
     Vector(Vector &&other)
     {
-        swap(_storage, other._storage);
-        swap(_count, other._count);
-        swap(_capacity, other._capacity);
+        take(other);
     }
 
     ~Vector()
     {
         clear();
-
-        if (_storage)
-            free(_storage);
+        release_storage();
     }
 
     Vector &operator=(const Vector &other)
@@ -138,9 +275,7 @@ public:
     {
         if (this != &other)
         {
-            swap(_storage, other._storage);
-            swap(_count, other._count);
-            swap(_capacity, other._capacity);
+            take(other);
         }
 
         return *this;
@@ -251,7 +386,10 @@ public:
 
     void resize(size_t new_count)
     {
-        ensure_capacity(new_count);
+        if (new_count > _capacity)
+        {
+            reallocate(MAX(new_count, _capacity * 2));
+        }
 
         if (_count < new_count)
         {
@@ -273,60 +411,17 @@ public:
 
     void ensure_capacity(size_t capacity)
     {
-        capacity = MAX(capacity, 16);
-
-        if (!_storage)
+        if (capacity > _capacity)
         {
-            _storage = reinterpret_cast<T *>(calloc(capacity, sizeof(T)));
-            _capacity = capacity;
-            _count = 0;
-
-            return;
+            reallocate(capacity);
         }
-
-        capacity = MAX(_count, capacity);
-
-        if (capacity <= _capacity)
-        {
-            return;
-        }
-
-        size_t new_capacity = _capacity;
-
-        while (new_capacity <= capacity)
-        {
-            new_capacity += new_capacity / 4;
-        }
-
-        T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
-
-        for (size_t i = 0; i < _count; i++)
-        {
-            new (&new_storage[i]) T(move(_storage[i]));
-        }
-
-        free(_storage);
-        _storage = new_storage;
-        _capacity = new_capacity;
-
-        _count++;
     }
 
     void grow()
     {
-        if (_count + 1 >= _capacity)
+        if (_count == _capacity)
         {
-            size_t new_capacity = _capacity + _capacity / 4;
-            T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
-
-            for (size_t i = 0; i < _count; i++)
-            {
-                new (&new_storage[i]) T(move(_storage[i]));
-            }
-
-            free(_storage);
-            _storage = new_storage;
-            _capacity = new_capacity;
+            reallocate(MAX(_capacity * 2, MIN_CAPACITY));
         }
 
         _count++;
@@ -336,21 +431,11 @@ public:
     {
         _count--;
 
-        size_t new_capacity = _capacity - _capacity / 4;
-
-        if (MAX(_count, 16) < new_capacity)
+        // Only give memory back once mostly empty, so a vector going up and
+        // down around a size doesn't reallocate every time.
+        if (!is_inline() && _capacity > MIN_CAPACITY * 4 && _count < _capacity / 4)
         {
-            T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
-
-            for (size_t i = 0; i < _count; i++)
-            {
-                new (&new_storage[i]) T(move(_storage[i]));
-                _storage[i].~T();
-            }
-
-            free(_storage);
-            _storage = new_storage;
-            _capacity = new_capacity;
+            reallocate(_capacity / 2);
         }
     }
 
@@ -361,15 +446,7 @@ public:
 
     T &insert(size_t index, T &&value)
     {
-        assert(index <= _count);
-
-        grow();
-
-        for (size_t j = _count - 1; j > index; j--)
-        {
-            new (&_storage[j]) T(move(_storage[j - 1]));
-            at(j - 1).~T();
-        }
+        open_gap(index);
 
         new (&_storage[index]) T(move(value));
 
@@ -421,13 +498,7 @@ public:
 
         _storage[index].~T();
 
-        for (size_t i = index; i < _count - 1; ++i)
-        {
-            new (&_storage[i]) T(move(_storage[i + 1]));
-            _storage[i + 1].~T();
-        }
-
-        shrink();
+        close_gap(index);
     }
 
     void remove_value(const T &value)
@@ -492,13 +563,7 @@ public:
     template <typename... Args>
     T &emplace(Args &&...args)
     {
-        grow();
-
-        for (size_t j = _count - 1; j > 0; j--)
-        {
-            new (&_storage[j]) T(move(_storage[j - 1]));
-            at(j - 1).~T();
-        }
+        open_gap(0);
 
         new (&_storage[0]) T(forward<Args>(args)...);
         return _storage[0];
@@ -525,18 +590,23 @@ public:
 
     void push_back_many(const Vector<T> &values)
     {
-        for (size_t i = 0; i < values.count(); i++)
-        {
-            push_back(values[i]);
-        }
+        push_back_many(values.raw_storage(), values.count());
     }
 
     void push_back_many(const T *data, size_t size)
     {
-        for (size_t i = 0; i < size; i++)
+        if (size == 0)
         {
-            push_back(data[i]);
+            return;
         }
+
+        if (_count + size > _capacity)
+        {
+            reallocate(MAX(_count + size, _capacity * 2));
+        }
+
+        typed_copy(_storage + _count, data, size);
+        _count += size;
     }
 
     T pop()
@@ -605,6 +675,11 @@ public:
     iterator end() const { return iterator(_storage + _count); }
 };
 
+template <typename T>
+struct IsTriviallyRelocatable<Vector<T>> : public TrueType
+{
+};
+
 template <typename T>
 struct IsVector : public FalseType
 {
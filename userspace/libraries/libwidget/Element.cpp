@@ -224,13 +224,15 @@ void Element::do_layout()
                 }
                 else
                 {
+                    int width = child->compute_size().x();
+
                     child->container(Math::Recti(
                         current,
                         content().y(),
-                        child->compute_size().x(),
+                        width,
                         content().height()));
 
-                    current += child->compute_size().x() + _layout.spacing.x();
+                    current += width + _layout.spacing.x();
                 }
             }
         }
@@ -292,14 +294,16 @@ void Element::do_layout()
                 }
                 else
                 {
+                    int height = child->compute_size().y();
+
                     child->container({
                         content().x(),
                         current,
                         content().width(),
-                        child->compute_size().y(),
+                        height,
                     });
 
-                    current += child->compute_size().y() + _layout.spacing.y();
+                    current += height + _layout.spacing.y();
                 }
             }
         }
@@ -313,13 +317,18 @@ void Element::do_layout()
 
 void Element::relayout()
 {
-    do_layout();
-
-    if (_childs.empty())
+    // Nothing changed below and the space given is the same as last time,
+    // the previous layout still holds.
+    if (!_layout_dirty && _container == _laid_out_container)
     {
         return;
     }
 
+    do_layout();
+
+    _layout_dirty = false;
+    _laid_out_container = _container;
+
     for (auto &child : _childs)
     {
         child->relayout();
@@ -328,6 +337,14 @@ void Element::relayout()
 
 void Element::should_relayout()
 {
+    // Don't stop at the first dirty ancestor, a size() override might not
+    // measure all its childs so clean elements can sit above dirty ones.
+    for (Element *element = this; element; element = element->_parent)
+    {
+        element->_size_dirty = true;
+        element->_layout_dirty = true;
+    }
+
     if (_window)
     {
         _window->should_relayout();
@@ -504,6 +521,7 @@ RefPtr<Element> Element::add(RefPtr<Element> child)
     Assert::equal(child->_parent, nullptr);
 
     _childs.push_back(child);
+    child->_parent = this;
 
     if (_window != nullptr)
     {
@@ -560,6 +578,11 @@ void Element::unmount()
 
 void Element::clear()
 {
+    for (auto &child : _childs)
+    {
+        child->unmount();
+    }
+
     _childs.clear();
 
     should_relayout();
@@ -675,6 +698,11 @@ void Element::dispatch_event(Event *event)
 
 Math::Vec2i Element::compute_size()
 {
+    if (!_size_dirty)
+    {
+        return _cached_size;
+    }
+
     Math::Vec2i size = this->size();
 
     int width = size.x();
@@ -706,7 +734,10 @@ Math::Vec2i Element::compute_size()
     width += _outsets.left() + _outsets.right();
     height += _outsets.top() + _outsets.bottom();
 
-    return Math::Vec2i(width, height);
+    _cached_size = Math::Vec2i(width, height);
+    _size_dirty = false;
+
+    return _cached_size;
 }
 
 } // namespace Widget
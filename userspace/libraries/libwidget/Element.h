@@ -122,6 +122,15 @@ private:
 
     Vector<RefPtr<Element>> _childs = {};
 
+    // Measuring and arranging are both cached, should_relayout() clears them
+    // on the element and every ancestor since their size and placement
+    // depend on it. A clean subtree given the same container is skipped.
+    bool _size_dirty = true;
+    Math::Vec2i _cached_size{};
+
+    bool _layout_dirty = true;
+    Math::Recti _laid_out_container{};
+
 public:
     static constexpr auto FILL = (1 << 0);
     static constexpr auto GREEDY = (1 << 1);
@@ -142,15 +151,24 @@ public:
     void font(RefPtr<Graphic::Font> font)
     {
         _font = font;
+        should_relayout();
     }
 
     Graphic::Color color(ThemeColorRole role);
 
     void color(ThemeColorRole role, Graphic::Color color);
 
-    void layout(Layout layout) { _layout = layout; }
+    void layout(Layout layout)
+    {
+        _layout = layout;
+        should_relayout();
+    }
 
-    void flags(int attributes) { _flags = attributes; }
+    void flags(int attributes)
+    {
+        _flags = attributes;
+        should_relayout();
+    }
 
     int flags() { return _flags; }
 
@@ -160,28 +178,50 @@ public:
         return _window;
     }
 
-    void min_height(int value) { _min_height = value; }
+    void min_height(int value)
+    {
+        _min_height = value;
+        should_relayout();
+    }
+
     int min_height() { return _min_height; }
 
-    void max_height(int value) { _max_height = value; }
+    void max_height(int value)
+    {
+        _max_height = value;
+        should_relayout();
+    }
+
     int max_height() { return _max_height; }
 
     void pin_height(int value)
     {
         _min_height = value;
         _max_height = value;
+        should_relayout();
+    }
+
+    void min_width(int value)
+    {
+        _min_width = value;
+        should_relayout();
     }
 
-    void min_width(int value) { _min_width = value; }
     int min_width() { return _min_width; }
 
-    void max_width(int value) { _max_width = value; }
+    void max_width(int value)
+    {
+        _max_width = value;
+        should_relayout();
+    }
+
     int max_width() { return _max_width; }
 
     void pin_width(int value)
     {
         _min_width = value;
         _max_width = value;
+        should_relayout();
     }
 
     CursorState cursor();
@@ -200,8 +240,11 @@ public:
 
     virtual void mounted() {}
 
+    // Arrange: place the childs within content().
     virtual void do_layout();
 
+    // Measure: the size wanted by the content, anything it depends on
+    // changing has to go through should_relayout().
     virtual Math::Vec2i size();
 
     /* --- Metrics ---------------------------------------------------------- */
@@ -45,13 +45,15 @@ Math::Recti Table::column_bound(int column) const
     };
 }
 
-Math::Recti Table::cell_bound(int row, int column) const
+Math::Recti Table::slot_bound(int row) const
 {
+    int slot = row % _rows_slots.count();
+
     return {
-        row_bound(row).x() + column * column_bound(column).width(),
-        row_bound(row).y(),
-        column_bound(column).width(),
-        row_bound(row).height(),
+        0,
+        slot * TABLE_ROW_HEIGHT,
+        _rows_layer->width(),
+        TABLE_ROW_HEIGHT,
     };
 }
 
@@ -74,9 +76,8 @@ int Table::row_at(Math::Vec2i position) const
     return row;
 }
 
-void Table::paint_cell(Graphic::Painter &painter, int row, int column)
+void Table::paint_cell(Graphic::Painter &painter, int row, int column, Math::Recti bound)
 {
-    Math::Recti bound = cell_bound(row, column);
     Variant data = _model->data(row, column);
 
     painter.push();
@@ -108,6 +109,132 @@ void Table::paint_cell(Graphic::Painter &painter, int row, int column)
     painter.pop();
 }
 
+void Table::paint_row(Graphic::Painter &painter, int row, Math::Recti bound)
+{
+    if (_selected == row)
+    {
+        painter.fill_rectangle_rounded(bound.shrinked(2), 4, color(THEME_ACCENT));
+    }
+
+    int column_count = _model->columns();
+    int column_width = bound.width() / column_count;
+
+    for (int column = 0; column < column_count; column++)
+    {
+        Math::Recti cell{
+            bound.x() + column * column_width,
+            bound.y(),
+            column_width,
+            bound.height(),
+        };
+
+        paint_cell(painter, row, column, cell);
+    }
+}
+
+void Table::paint_header(Graphic::Painter &painter, Math::Recti bound)
+{
+    int column_count = _model->columns();
+    int column_width = bound.width() / column_count;
+
+    for (int column = 0; column < column_count; column++)
+    {
+        Math::Recti cell{
+            bound.x() + column * column_width,
+            bound.y(),
+            column_width,
+            TABLE_ROW_HEIGHT,
+        };
+
+        if (column < column_count - 1)
+        {
+            painter.fill_rectangle(cell.take_right(1), color(THEME_BORDER));
+        }
+
+        // There is no bold font, the header is drawn twice with a one pixel
+        // offset instead, which is why it is worth keeping in a layer.
+        painter.draw_string(*font(), _model->header(column).cstring(), Math::Vec2i(cell.x() + 7, cell.y() + 20), color(THEME_FOREGROUND));
+        painter.draw_string(*font(), _model->header(column).cstring(), Math::Vec2i(cell.x() + 7 + 1, cell.y() + 20), color(THEME_FOREGROUND));
+    }
+}
+
+void Table::render_row(int row)
+{
+    Math::Recti bound = slot_bound(row);
+
+    Graphic::Painter painter{_rows_layer};
+    painter.clear(bound, Graphic::Colors::TRANSPARENT);
+    painter.clip(bound);
+    paint_row(painter, row, bound);
+
+    _rows_slots[row % _rows_slots.count()] = {row, _rows_revision};
+}
+
+void Table::render_header()
+{
+    Graphic::Painter painter{_header_layer};
+    painter.clear(_header_layer->bound(), Graphic::Colors::TRANSPARENT);
+    paint_header(painter, _header_layer->bound());
+
+    _header_dirty = false;
+}
+
+void Table::invalidate_row(int row)
+{
+    if (row < 0)
+    {
+        return;
+    }
+
+    if (_rows_slots.count() > 0)
+    {
+        auto &slot = _rows_slots[row % _rows_slots.count()];
+
+        if (slot.row == row)
+        {
+            slot.row = -1;
+        }
+    }
+
+    should_repaint(row_bound(row));
+}
+
+void Table::invalidate_all()
+{
+    _rows_revision++;
+    _header_dirty = true;
+
+    should_repaint();
+    should_relayout();
+}
+
+Table::RowsStyle Table::rows_style()
+{
+    return {
+        color(THEME_FOREGROUND),
+        color(THEME_ACCENT),
+        color(THEME_BORDER),
+        font().naked(),
+    };
+}
+
+void Table::model_updated(TableModel &model)
+{
+    if (model.changed_everything())
+    {
+        invalidate_all();
+        return;
+    }
+
+    int first = MAX(0, model.changed_row());
+    int last = MIN(model.rows(), model.changed_row() + model.changed_count());
+
+    for (int row = first; row < last; row++)
+    {
+        invalidate_row(row);
+    }
+}
+
 Table::Table()
 
 {
@@ -125,15 +252,21 @@ Table::Table(RefPtr<TableModel> model)
     this->model(model);
 }
 
-void Table::paint(Graphic::Painter &painter, const Math::Recti &)
+void Table::paint(Graphic::Painter &painter, const Math::Recti &dirty)
 {
     if (!_model)
     {
         return;
     }
 
-    int column_count = _model->columns();
-    int column_width = bound().width() / column_count;
+    RowsStyle style = rows_style();
+
+    if (style != _rows_style)
+    {
+        _rows_style = style;
+        _rows_revision++;
+        _header_dirty = true;
+    }
 
     if (_model->rows() == 0)
     {
@@ -150,39 +283,48 @@ void Table::paint(Graphic::Painter &painter, const Math::Recti &)
              row < MIN(_model->rows(), ((_scroll_offset + list_bound().height()) / TABLE_ROW_HEIGHT) + 1);
              row++)
         {
+            if (!row_bound(row).colide_with(dirty))
+            {
+                continue;
+            }
 
-            if (_selected == row)
+            if (!_rows_layer)
             {
-                painter.fill_rectangle_rounded(row_bound(row).shrinked(2), 4, color(THEME_ACCENT));
+                paint_row(painter, row, row_bound(row));
+                continue;
             }
 
-            for (int column = 0; column < column_count; column++)
+            auto &slot = _rows_slots[row % _rows_slots.count()];
+
+            if (slot.row != row || slot.revision != _rows_revision)
             {
-                paint_cell(painter, row, column);
+                render_row(row);
             }
+
+            painter.blit(*_rows_layer, slot_bound(row), row_bound(row));
         }
     }
 
+    if (!header_bound().colide_with(dirty))
+    {
+        return;
+    }
+
     painter.acrylic(header_bound());
     painter.fill_rectangle(header_bound(), color(THEME_BACKGROUND).with_alpha(0.5));
 
-    for (int column = 0; column < column_count; column++)
+    if (!_header_layer)
     {
-        Math::Recti header_bound_cell{
-            header_bound().x() + column * column_width,
-            header_bound().y(),
-            column_width,
-            TABLE_ROW_HEIGHT,
-        };
-
-        if (column < column_count - 1)
-        {
-            painter.fill_rectangle(header_bound_cell.take_right(1), color(THEME_BORDER));
-        }
+        paint_header(painter, header_bound());
+        return;
+    }
 
-        painter.draw_string(*font(), _model->header(column).cstring(), Math::Vec2i(header_bound_cell.x() + 7, header_bound_cell.y() + 20), color(THEME_FOREGROUND));
-        painter.draw_string(*font(), _model->header(column).cstring(), Math::Vec2i(header_bound_cell.x() + 7 + 1, header_bound_cell.y() + 20), color(THEME_FOREGROUND));
+    if (_header_dirty)
+    {
+        render_header();
     }
+
+    painter.blit(*_header_layer, _header_layer->bound(), header_bound());
 }
 
 void Table::event(Event *event)
@@ -235,6 +377,39 @@ void Table::do_layout()
 
     _scrollbar->container(scrollbar_bound());
     _scrollbar->update(TABLE_ROW_HEIGHT * _model->rows(), list_bound().height(), _scroll_offset);
+
+    // Enough slots for every row painted at once, counting the partially
+    // visible ones and the one peeking under the header.
+    int width = list_bound().width();
+    int slots = list_bound().height() / TABLE_ROW_HEIGHT + 3;
+
+    if (width <= 0 || list_bound().height() <= 0)
+    {
+        _rows_layer = nullptr;
+        _header_layer = nullptr;
+        _rows_slots.clear();
+        return;
+    }
+
+    if (!_rows_layer ||
+        _rows_layer->width() != width ||
+        _rows_layer->height() != slots * TABLE_ROW_HEIGHT)
+    {
+        _rows_layer = Graphic::Bitmap::create_shared(width, slots * TABLE_ROW_HEIGHT).unwrap_or(nullptr);
+
+        _rows_slots.clear();
+
+        for (int i = 0; i < slots; i++)
+        {
+            _rows_slots.push_back({});
+        }
+    }
+
+    if (!_header_layer || _header_layer->width() != header_bound().width())
+    {
+        _header_layer = Graphic::Bitmap::create_shared(header_bound().width(), TABLE_ROW_HEIGHT).unwrap_or(nullptr);
+        _header_dirty = true;
+    }
 }
 
 } // namespace Widget
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <libgraphic/Bitmap.h>
 #include <libutils/String.h>
 
 #include <libwidget/ScrollBar.h>
@@ -22,23 +23,72 @@ private:
 
     String _empty_message{"No data to display"};
 
+    // Rendered rows are kept in an offscreen layer used as a ring of slots, a
+    // row always lands in the slot row % slot count. Scrolling blits the rows
+    // already rendered and only renders the ones coming into view.
+    struct RowSlot
+    {
+        int row = -1;
+        uint32_t revision = 0;
+    };
+
+    // What rendered rows look like besides the model, a new theme, the window
+    // losing focus or another font make every cached row stale.
+    struct RowsStyle
+    {
+        Graphic::Color foreground;
+        Graphic::Color accent;
+        Graphic::Color border;
+        Graphic::Font *font;
+
+        bool operator==(const RowsStyle &other) const
+        {
+            return foreground == other.foreground &&
+                   accent == other.accent &&
+                   border == other.border &&
+                   font == other.font;
+        }
+
+        bool operator!=(const RowsStyle &other) const { return !(*this == other); }
+    };
+
+    RefPtr<Graphic::Bitmap> _rows_layer;
+    Vector<RowSlot> _rows_slots;
+    uint32_t _rows_revision = 0;
+    RowsStyle _rows_style{};
+
+    RefPtr<Graphic::Bitmap> _header_layer;
+    bool _header_dirty = true;
+
     Math::Recti scrollbar_bound() const;
     Math::Recti header_bound() const;
     Math::Recti list_bound() const;
     Math::Recti row_bound(int row) const;
     Math::Recti column_bound(int column) const;
-    Math::Recti cell_bound(int row, int column) const;
+    Math::Recti slot_bound(int row) const;
     int row_at(Math::Vec2i position) const;
-    void paint_cell(Graphic::Painter &painter, int row, int column);
+
+    void paint_cell(Graphic::Painter &painter, int row, int column, Math::Recti bound);
+    void paint_row(Graphic::Painter &painter, int row, Math::Recti bound);
+    void paint_header(Graphic::Painter &painter, Math::Recti bound);
+
+    void render_row(int row);
+    void render_header();
+
+    void invalidate_row(int row);
+    void invalidate_all();
+    RowsStyle rows_style();
+    void model_updated(TableModel &model);
 
 public:
     void model(RefPtr<TableModel> model)
     {
         _model = model;
-        _model_observer = model->observe([this](auto &) {
-            should_repaint();
-            should_relayout();
+        _model_observer = model->observe([this](auto &model) {
+            model_updated(model);
         });
+
+        invalidate_all();
     }
 
     void empty_message(String message)
@@ -60,8 +110,9 @@ public:
             return;
         }
 
+        invalidate_row(_selected);
         _selected = index;
-        should_repaint();
+        invalidate_row(_selected);
     }
 
     void scroll_to_top()
@@ -189,7 +189,17 @@ void TextEditor::event(Event *event)
 
         if (!_readonly)
         {
-            if (event->keyboard.key == KEYBOARD_KEY_BKSPC)
+            if (event->keyboard.key == KEYBOARD_KEY_Z && event->keyboard.modifiers & KEY_MODIFIER_CTRL)
+            {
+                _model->undo(_cursor);
+                scroll_to_cursor();
+            }
+            else if (event->keyboard.key == KEYBOARD_KEY_Y && event->keyboard.modifiers & KEY_MODIFIER_CTRL)
+            {
+                _model->redo(_cursor);
+                scroll_to_cursor();
+            }
+            else if (event->keyboard.key == KEYBOARD_KEY_BKSPC)
             {
                 _model->backspace_at(_cursor);
                 scroll_to_cursor();
@@ -11,6 +11,7 @@ TextField::TextField(RefPtr<TextModel> model)
         _cursor.clamp_within(*_model);
 
         scroll_to_cursor();
+        should_relayout();
         should_repaint();
     });
 }
@@ -123,7 +123,7 @@ void theme_load(String path)
         return;
     }
 
-    auto root = Json::parse(theme_file);
+    auto root = Json::parse(theme_file, Json::INTERN_KEYS);
 
     if (!root.has("colors"))
     {
@@ -19,6 +19,7 @@ void ImageElement::change_bitmap(RefPtr<Graphic::Bitmap> bitmap)
     if (_bitmap != bitmap)
     {
         _bitmap = bitmap;
+        should_relayout();
         should_repaint();
     }
 }
@@ -28,6 +29,7 @@ void ImageElement::scaling(Graphic::BitmapScaling scaling)
     if (_scaling != scaling)
     {
         _scaling = scaling;
+        should_relayout();
         should_repaint();
     }
 }
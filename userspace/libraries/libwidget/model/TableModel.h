@@ -11,6 +11,10 @@ class TableModel :
     public RefCounted<TableModel>,
     public Async::Observable<TableModel>
 {
+private:
+    int _changed_row = 0;
+    int _changed_count = -1;
+
 public:
     TableModel() {}
 
@@ -45,6 +49,33 @@ public:
     {
         ASSERT_NOT_REACHED();
     }
+
+    /* --- Change notifications --------------------------------------------- */
+
+    // Rows touched by the update being notified, everything including the
+    // number of rows and the headers might have changed when this is true,
+    // which is what a plain did_update() says.
+    bool changed_everything() { return _changed_count < 0; }
+
+    int changed_row() { return _changed_row; }
+
+    int changed_count() { return _changed_count; }
+
+    void did_update_rows(int row, int count)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+
+        _changed_row = row;
+        _changed_count = count;
+
+        did_update();
+
+        _changed_row = 0;
+        _changed_count = -1;
+    }
 };
 
 } // namespace Widget
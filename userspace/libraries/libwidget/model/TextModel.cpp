@@ -1,12 +1,309 @@
-#include <libio/BufReader.h>
 #include <libio/File.h>
-#include <libio/Scanner.h>
+#include <libio/Write.h>
+#include <libsystem/unicode/UTF8Decoder.h>
 #include <libutils/StringBuilder.h>
 #include <libwidget/model/TextModel.h>
 
 namespace Widget
 {
 
+/* --- TextModelLine -------------------------------------------------------- */
+
+Vector<TextPiece> &TextModelLine::pieces()
+{
+    if (!_pieces)
+    {
+        _pieces = own<Vector<TextPiece>>();
+
+        if (_piece.length > 0)
+        {
+            _pieces->push_back(_piece);
+        }
+    }
+
+    return *_pieces;
+}
+
+const Codepoint *TextModelLine::codepoint_at(size_t index)
+{
+    Assert::lower_than(index, length());
+
+    if (!_pieces)
+    {
+        return &_piece.codepoints[index];
+    }
+
+    for (size_t i = 0; i < _pieces->count(); i++)
+    {
+        auto &piece = (*_pieces)[i];
+
+        if (index < piece.length)
+        {
+            return &piece.codepoints[index];
+        }
+
+        index -= piece.length;
+    }
+
+    ASSERT_NOT_REACHED();
+}
+
+void TextModelLine::append(const TextModelLine &line)
+{
+    line.foreach_piece([&](TextPiece piece) {
+        insert(_length, piece);
+    });
+}
+
+void TextModelLine::insert(size_t index, TextPiece piece)
+{
+    Assert::lower_equal(index, length());
+
+    if (piece.length == 0)
+    {
+        return;
+    }
+
+    auto &pieces = this->pieces();
+
+    _length += piece.length;
+    _measured_font = nullptr;
+
+    size_t offset = 0;
+
+    for (size_t i = 0; i < pieces.count(); i++)
+    {
+        auto &current = pieces[i];
+
+        // Typing extends the piece it was typed right after, as long as the
+        // new text directly follows it in its block.
+        if (offset + current.length == index &&
+            current.codepoints + current.length == piece.codepoints)
+        {
+            current.length += piece.length;
+            return;
+        }
+
+        if (index == offset)
+        {
+            pieces.insert(i, piece);
+            return;
+        }
+
+        if (index < offset + current.length)
+        {
+            size_t split = index - offset;
+            TextPiece right{current.codepoints + split, current.length - split};
+            current.length = split;
+
+            pieces.insert(i + 1, piece);
+            pieces.insert(i + 2, right);
+            return;
+        }
+
+        offset += current.length;
+    }
+
+    pieces.push_back(piece);
+}
+
+TextPiece TextModelLine::remove(size_t index)
+{
+    Assert::lower_than(index, length());
+
+    TextPiece removed{codepoint_at(index), 1};
+    remove(index, 1);
+
+    return removed;
+}
+
+void TextModelLine::remove(size_t index, size_t length)
+{
+    Assert::lower_equal(index + length, this->length());
+
+    auto &pieces = this->pieces();
+
+    _length -= length;
+    _measured_font = nullptr;
+
+    size_t offset = 0;
+
+    for (size_t i = 0; i < pieces.count() && length > 0; i++)
+    {
+        auto &current = pieces[i];
+
+        if (index >= offset + current.length)
+        {
+            offset += current.length;
+            continue;
+        }
+
+        size_t start = index - offset;
+        size_t count = MIN(length, current.length - start);
+
+        if (start == 0 && count == current.length)
+        {
+            pieces.remove_index(i);
+            i--;
+        }
+        else if (start == 0)
+        {
+            current.codepoints += count;
+            current.length -= count;
+            offset += current.length;
+        }
+        else if (start + count == current.length)
+        {
+            current.length -= count;
+            offset += current.length;
+        }
+        else
+        {
+            TextPiece right{current.codepoints + start + count, current.length - start - count};
+            current.length = start;
+            pieces.insert(i + 1, right);
+            offset += current.length;
+        }
+
+        index = offset;
+        length -= count;
+    }
+}
+
+OwnPtr<TextModelLine> TextModelLine::split(size_t index)
+{
+    Assert::lower_equal(index, length());
+
+    auto right = own<TextModelLine>();
+
+    size_t offset = 0;
+
+    foreach_piece([&](TextPiece piece) {
+        if (offset + piece.length > index)
+        {
+            size_t start = index > offset ? index - offset : 0;
+            right->insert(right->length(), {piece.codepoints + start, piece.length - start});
+        }
+
+        offset += piece.length;
+    });
+
+    remove(index, length() - index);
+
+    return right;
+}
+
+Math::Recti TextModelLine::bound(const Graphic::Font &font)
+{
+    if (_measured_font != &font)
+    {
+        _measured_width = 0;
+
+        foreach_piece([&](TextPiece piece) {
+            for (size_t i = 0; i < piece.length; i++)
+            {
+                _measured_width += font.mesure(piece.codepoints[i]).width();
+            }
+        });
+
+        _measured_font = &font;
+    }
+
+    return {_measured_width, font.metrics().fulllineheight()};
+}
+
+/* --- TextModelLines ------------------------------------------------------- */
+
+void TextModelLines::locate(size_t index, size_t &chunk, size_t &offset)
+{
+    if (_cached_chunk >= _chunks.count() || index < _cached_start)
+    {
+        invalidate();
+    }
+
+    while (index - _cached_start >= _chunks[_cached_chunk]->lines.count())
+    {
+        _cached_start += _chunks[_cached_chunk]->lines.count();
+        _cached_chunk++;
+    }
+
+    chunk = _cached_chunk;
+    offset = index - _cached_start;
+}
+
+void TextModelLines::clear()
+{
+    _chunks.clear();
+    _count = 0;
+    invalidate();
+}
+
+void TextModelLines::push_back(OwnPtr<TextModelLine> line)
+{
+    if (_chunks.empty() || _chunks.peek_back()->lines.count() >= CHUNK_SIZE)
+    {
+        _chunks.push_back(own<Chunk>());
+    }
+
+    _chunks.peek_back()->lines.push_back(line);
+    _count++;
+}
+
+void TextModelLines::insert(size_t index, OwnPtr<TextModelLine> line)
+{
+    Assert::lower_equal(index, _count);
+
+    if (index == _count)
+    {
+        push_back(line);
+        return;
+    }
+
+    size_t chunk, offset;
+    locate(index, chunk, offset);
+
+    auto &lines = _chunks[chunk]->lines;
+    lines.insert(offset, line);
+    _count++;
+
+    if (lines.count() >= CHUNK_SIZE * 2)
+    {
+        auto next = own<Chunk>();
+
+        for (size_t i = CHUNK_SIZE; i < lines.count(); i++)
+        {
+            next->lines.push_back(lines[i]);
+        }
+
+        lines.resize(CHUNK_SIZE);
+        _chunks.insert(chunk + 1, next);
+    }
+
+    invalidate();
+}
+
+OwnPtr<TextModelLine> TextModelLines::take_at(size_t index)
+{
+    Assert::lower_than(index, _count);
+
+    size_t chunk, offset;
+    locate(index, chunk, offset);
+
+    auto line = _chunks[chunk]->lines.take_at(offset);
+    _count--;
+
+    if (_chunks[chunk]->lines.empty())
+    {
+        _chunks.remove_index(chunk);
+    }
+
+    invalidate();
+
+    return line;
+}
+
+/* --- TextModel ------------------------------------------------------------ */
+
 RefPtr<TextModel> TextModel::empty()
 {
     auto model = make<TextModel>();
@@ -19,26 +316,62 @@ RefPtr<TextModel> TextModel::open(String path)
     auto model = make<TextModel>();
 
     IO::File file{path, OPEN_READ};
-    IO::BufReader buf_reader{file, 512};
-    IO::Scanner scan{buf_reader};
 
-    // Skip the utf8 bom header if present.
-    scan.skip_word("\xEF\xBB\xBF");
+    // The file is decoded once into a single block sized after it, every line
+    // is then a piece of that block.
+    auto length = file.length();
 
-    while (scan.do_continue())
+    if (length.success() && length.unwrap() > 0)
     {
-        auto line = own<TextModelLine>();
+        auto block = own<TextBlock>(length.unwrap());
+        auto &original = *block;
+        model->_blocks.push_back(block);
+
+        UTF8Decoder decoder{[&](Codepoint codepoint) {
+            if (original.used < original.capacity)
+            {
+                original.codepoints[original.used++] = codepoint;
+            }
+        }};
+
+        char buffer[4096];
+
+        while (true)
+        {
+            auto read = file.read(buffer, 4096);
+
+            if (!read.success() || read.unwrap() == 0)
+            {
+                break;
+            }
+
+            for (size_t i = 0; i < read.unwrap(); i++)
+            {
+                decoder.write(buffer[i]);
+            }
+        }
+
+        size_t start = 0;
 
-        while (scan.do_continue() &&
-               scan.current_codepoint() != '\n')
+        // Skip the utf8 bom header if present.
+        if (original.used > 0 && original.codepoints[0] == 0xFEFF)
         {
-            line->append(scan.current_codepoint());
-            scan.forward_codepoint();
+            start = 1;
         }
 
-        scan.skip('\n'); // skip the \n
+        for (size_t i = start; i < original.used; i++)
+        {
+            if (original.codepoints[i] == U'\n')
+            {
+                model->append_line(own<TextModelLine>(TextPiece{original.codepoints + start, i - start}));
+                start = i + 1;
+            }
+        }
 
-        model->append_line(line);
+        if (start < original.used)
+        {
+            model->append_line(own<TextModelLine>(TextPiece{original.codepoints + start, original.used - start}));
+        }
     }
 
     if (model->line_count() == 0)
@@ -48,11 +381,6 @@ RefPtr<TextModel> TextModel::open(String path)
 
     model->span_add(TextModelSpan(0, 0, 10, THEME_ANSI_RED, THEME_ANSI_BLUE));
 
-    if (model->line_count() == 0)
-    {
-        model->append_line(own<TextModelLine>());
-    }
-
     return model;
 }
 
@@ -62,10 +390,12 @@ String TextModel::string()
 
     for (size_t i = 0; i < _lines.count(); i++)
     {
-        for (size_t j = 0; j < _lines[i]->length(); j++)
-        {
-            builder.append_codepoint(_lines[i]->operator[](j));
-        }
+        _lines.at(i).foreach_piece([&](TextPiece piece) {
+            for (size_t j = 0; j < piece.length; j++)
+            {
+                builder.append_codepoint(piece.codepoints[j]);
+            }
+        });
 
         if (i + 1 < _lines.count())
         {
@@ -82,100 +412,232 @@ ResultOr<size_t> TextModel::save(String path)
     return IO::write(file, string());
 }
 
-void TextModel::append_at(TextCursor &cursor, Codepoint codepoint)
+TextPiece TextModel::store(Codepoint codepoint)
 {
-    line(cursor.line()).append_at(cursor.column(), codepoint);
-    cursor.move_right_within(*this);
-    did_update();
+    if (_blocks.empty() || _blocks.peek_back()->used == _blocks.peek_back()->capacity)
+    {
+        _blocks.push_back(own<TextBlock>(BLOCK_SIZE));
+    }
+
+    auto &block = *_blocks.peek_back();
+    block.codepoints[block.used] = codepoint;
+
+    return {&block.codepoints[block.used++], 1};
 }
 
-void TextModel::backspace_at(TextCursor &cursor)
+void TextModel::record(TextEdit edit)
 {
-    if (cursor.line() > 0 &&
-        cursor.column() == 0)
+    _redo.clear();
+
+    if (_undo.any())
     {
-        int line_length = line(cursor.line() - 1).length();
-        line(cursor.line() - 1).append(line(cursor.line()));
+        auto &last = _undo.peek_back();
 
-        _lines.remove_index(cursor.line());
+        bool same_place = last.type == edit.type && last.line == edit.line;
 
-        cursor.move_up_within(*this);
-        cursor.move_to_within(line(cursor.line()), line_length);
+        // Merge consecutive typing and deleting so they are undone at once.
+        if (same_place && edit.type == TextEdit::INSERT &&
+            last.column + last.piece.length == edit.column &&
+            last.piece.codepoints + last.piece.length == edit.piece.codepoints)
+        {
+            last.piece.length += edit.piece.length;
+            return;
+        }
 
-        did_update();
+        if (same_place && edit.type == TextEdit::REMOVE &&
+            edit.column + edit.piece.length == last.column &&
+            edit.piece.codepoints + edit.piece.length == last.piece.codepoints)
+        {
+            last.column = edit.column;
+            last.piece.codepoints = edit.piece.codepoints;
+            last.piece.length += edit.piece.length;
+            return;
+        }
+
+        if (same_place && edit.type == TextEdit::REMOVE &&
+            edit.column == last.column &&
+            last.piece.codepoints + last.piece.length == edit.piece.codepoints)
+        {
+            last.piece.length += edit.piece.length;
+            return;
+        }
     }
-    else if (cursor.column() > 0 && line(cursor.line()).length() > 0)
-    {
-        line(cursor.line()).backspace_at(cursor.column());
-        cursor.move_left_within(*this);
 
-        did_update();
+    _undo.push_back(edit);
+}
+
+void TextModel::apply(TextEdit edit, TextCursor &cursor)
+{
+    switch (edit.type)
+    {
+    case TextEdit::INSERT:
+        line(edit.line).insert(edit.column, edit.piece);
+        cursor.move_to(*this, edit.line, edit.column + edit.piece.length);
+        break;
+
+    case TextEdit::REMOVE:
+        line(edit.line).remove(edit.column, edit.piece.length);
+        cursor.move_to(*this, edit.line, edit.column);
+        break;
+
+    case TextEdit::SPLIT:
+        _lines.insert(edit.line + 1, line(edit.line).split(edit.column));
+        cursor.move_to(*this, edit.line + 1, 0);
+        break;
+
+    case TextEdit::JOIN:
+        line(edit.line).append(line(edit.line + 1));
+        _lines.remove_index(edit.line + 1);
+        cursor.move_to(*this, edit.line, edit.column);
+        break;
+
+    case TextEdit::LINE_UP:
+        _lines.insert(edit.line - 1, _lines.take_at(edit.line));
+        cursor.move_to(*this, edit.line - 1, edit.column);
+        break;
+
+    case TextEdit::LINE_DOWN:
+        _lines.insert(edit.line, _lines.take_at(edit.line + 1));
+        cursor.move_to(*this, edit.line + 1, edit.column);
+        break;
+
+    default:
+        ASSERT_NOT_REACHED();
     }
+
+    did_edit();
 }
 
-void TextModel::delete_at(TextCursor &cursor)
+void TextModel::revert(TextEdit edit, TextCursor &cursor)
 {
-    if (cursor.line() < line_count() - 1 && cursor.column() == line(cursor.line()).length())
+    switch (edit.type)
     {
-        line(cursor.line()).append(line(cursor.line() + 1));
+    case TextEdit::INSERT:
+        apply({TextEdit::REMOVE, edit.line, edit.column, edit.piece}, cursor);
+        break;
+
+    case TextEdit::REMOVE:
+        apply({TextEdit::INSERT, edit.line, edit.column, edit.piece}, cursor);
+        break;
+
+    case TextEdit::SPLIT:
+        apply({TextEdit::JOIN, edit.line, edit.column, {}}, cursor);
+        break;
+
+    case TextEdit::JOIN:
+        apply({TextEdit::SPLIT, edit.line, edit.column, {}}, cursor);
+        break;
 
-        _lines.remove_index(cursor.line() + 1);
+    case TextEdit::LINE_UP:
+        apply({TextEdit::LINE_DOWN, edit.line - 1, edit.column, {}}, cursor);
+        break;
 
-        did_update();
+    case TextEdit::LINE_DOWN:
+        apply({TextEdit::LINE_UP, edit.line + 1, edit.column, {}}, cursor);
+        break;
+
+    default:
+        ASSERT_NOT_REACHED();
     }
-    else if (cursor.column() < line(cursor.line()).length() && line(cursor.line()).length() > 0)
+}
+
+void TextModel::undo(TextCursor &cursor)
+{
+    if (_undo.any())
     {
-        line(cursor.line()).delete_at(cursor.column());
+        auto edit = _undo.pop_back();
+        revert(edit, cursor);
+        _redo.push_back(edit);
+    }
+}
 
-        did_update();
+void TextModel::redo(TextCursor &cursor)
+{
+    if (_redo.any())
+    {
+        auto edit = _redo.pop_back();
+        apply(edit, cursor);
+        _undo.push_back(edit);
     }
 }
 
-void TextModel::newline_at(TextCursor &cursor)
+void TextModel::append_at(TextCursor &cursor, Codepoint codepoint)
+{
+    TextEdit edit{TextEdit::INSERT, cursor.line(), cursor.column(), store(codepoint)};
+
+    record(edit);
+    apply(edit, cursor);
+}
+
+void TextModel::backspace_at(TextCursor &cursor)
 {
-    auto left_side_line = own<TextModelLine>();
-    auto right_side_line = own<TextModelLine>();
+    if (cursor.line() > 0 &&
+        cursor.column() == 0)
+    {
+        TextEdit edit{TextEdit::JOIN, cursor.line() - 1, line(cursor.line() - 1).length(), {}};
 
-    for (size_t i = 0; i < cursor.column(); i++)
+        record(edit);
+        apply(edit, cursor);
+    }
+    else if (cursor.column() > 0 && line(cursor.line()).length() > 0)
     {
-        left_side_line->append(line(cursor.line())[i]);
+        auto piece = line(cursor.line()).remove(cursor.column() - 1);
+        TextEdit edit{TextEdit::REMOVE, cursor.line(), cursor.column() - 1, piece};
+
+        record(edit);
+        cursor.move_left_within(*this);
+
+        did_edit();
     }
+}
 
-    for (size_t i = cursor.column(); i < line(cursor.line()).length(); i++)
+void TextModel::delete_at(TextCursor &cursor)
+{
+    if (cursor.line() < line_count() - 1 && cursor.column() == line(cursor.line()).length())
     {
-        right_side_line->append(line(cursor.line())[i]);
+        TextEdit edit{TextEdit::JOIN, cursor.line(), cursor.column(), {}};
+
+        record(edit);
+        apply(edit, cursor);
     }
+    else if (cursor.column() < line(cursor.line()).length() && line(cursor.line()).length() > 0)
+    {
+        auto piece = line(cursor.line()).remove(cursor.column());
+        TextEdit edit{TextEdit::REMOVE, cursor.line(), cursor.column(), piece};
 
-    _lines.remove_index(cursor.line());
+        record(edit);
 
-    _lines.insert(cursor.line(), left_side_line);
-    _lines.insert(cursor.line() + 1, right_side_line);
+        did_edit();
+    }
+}
 
-    cursor.move_down_within(*this);
-    cursor.move_to_beginning_of_the_line();
+void TextModel::newline_at(TextCursor &cursor)
+{
+    TextEdit edit{TextEdit::SPLIT, cursor.line(), cursor.column(), {}};
 
-    did_update();
+    record(edit);
+    apply(edit, cursor);
 }
 
 void TextModel::move_line_up_at(TextCursor &cursor)
 {
     if (cursor.line() > 0)
     {
-        _lines.insert(cursor.line() - 1, _lines.take_at(cursor.line()));
-        cursor.move_up_within(*this);
+        TextEdit edit{TextEdit::LINE_UP, cursor.line(), cursor.column(), {}};
 
-        did_update();
+        record(edit);
+        apply(edit, cursor);
     }
 }
 
 void TextModel::move_line_down_at(TextCursor &cursor)
 {
-    if (cursor.line() < line_count())
+    if (cursor.line() + 1 < line_count())
     {
-        _lines.insert(cursor.line() + 1, _lines.take_at(cursor.line()));
-        cursor.move_down_within(*this);
+        TextEdit edit{TextEdit::LINE_DOWN, cursor.line(), cursor.column(), {}};
 
-        did_update();
+        record(edit);
+        apply(edit, cursor);
     }
 }
 
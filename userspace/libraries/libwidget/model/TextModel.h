@@ -14,68 +14,80 @@ namespace Widget
 
 struct TextCursor;
 
+struct TextPiece
+{
+    const Codepoint *codepoints;
+    size_t length;
+};
+
 class TextModelLine
 {
 private:
-    Vector<Codepoint> _codepoints{};
+    // Lines loaded from a file are a single piece of the original text, the
+    // piece list is only allocated the first time the line is edited.
+    TextPiece _piece{nullptr, 0};
+    OwnPtr<Vector<TextPiece>> _pieces = nullptr;
+    size_t _length = 0;
+
+    const Graphic::Font *_measured_font = nullptr;
+    int _measured_width = 0;
+
+    Vector<TextPiece> &pieces();
+
+    const Codepoint *codepoint_at(size_t index);
 
 public:
     TextModelLine()
     {
     }
 
-    ~TextModelLine()
+    TextModelLine(TextPiece piece)
+        : _piece(piece),
+          _length(piece.length)
     {
     }
 
-    Codepoint operator[](size_t index)
+    ~TextModelLine()
     {
-        Assert::lower_than(index, length());
-
-        return _codepoints[index];
     }
 
+    Codepoint operator[](size_t index) { return *codepoint_at(index); }
+
     size_t length()
     {
-        return _codepoints.count();
+        return _length;
     }
 
-    void append(Codepoint codepoint)
+    template <typename Callback>
+    void foreach_piece(Callback callback) const
     {
-        _codepoints.push_back(codepoint);
-    }
+        if (!_pieces)
+        {
+            if (_piece.length > 0)
+            {
+                callback(_piece);
+            }
 
-    void append(const TextModelLine &line)
-    {
-        _codepoints.push_back_many(line._codepoints);
-    }
+            return;
+        }
 
-    void append_at(size_t index, Codepoint codepoint)
-    {
-        _codepoints.insert(index, codepoint);
+        for (size_t i = 0; i < _pieces->count(); i++)
+        {
+            callback((*_pieces)[i]);
+        }
     }
 
-    void backspace_at(size_t index)
-    {
-        _codepoints.remove_index(index - 1);
-    }
+    void append(const TextModelLine &line);
 
-    void delete_at(size_t index)
-    {
-        _codepoints.remove_index(index);
-    }
+    void insert(size_t index, TextPiece piece);
 
-    Math::Recti bound(const Graphic::Font &font)
-    {
-        int width = 0;
+    TextPiece remove(size_t index);
 
-        for (size_t i = 0; i < _codepoints.count(); i++)
-        {
-            width += font.mesure(_codepoints[i]).width();
-        }
+    void remove(size_t index, size_t length);
 
-        return {width, font.metrics().fulllineheight()};
-    }
+    OwnPtr<TextModelLine> split(size_t index);
+
+    Math::Recti bound(const Graphic::Font &font);
 };
 
 class TextModelSpan
@@ -117,14 +129,128 @@ public:
     }
 };
 
+// Lines are kept in chunks so inserting or removing one only moves the
+// pointers of its own chunk instead of every line after it.
+class TextModelLines
+{
+private:
+    static constexpr size_t CHUNK_SIZE = 512;
+
+    struct Chunk
+    {
+        Vector<OwnPtr<TextModelLine>> lines{};
+    };
+
+    Vector<OwnPtr<Chunk>> _chunks{};
+    size_t _count = 0;
+
+    // Painting walks lines in order, so remember where the last lookup landed.
+    size_t _cached_chunk = 0;
+    size_t _cached_start = 0;
+
+    void locate(size_t index, size_t &chunk, size_t &offset);
+
+    void invalidate()
+    {
+        _cached_chunk = 0;
+        _cached_start = 0;
+    }
+
+public:
+    size_t count() const { return _count; }
+
+    TextModelLine &at(size_t index)
+    {
+        Assert::lower_than(index, _count);
+
+        size_t chunk, offset;
+        locate(index, chunk, offset);
+        return *_chunks[chunk]->lines[offset];
+    }
+
+    void clear();
+
+    void push_back(OwnPtr<TextModelLine> line);
+
+    void insert(size_t index, OwnPtr<TextModelLine> line);
+
+    OwnPtr<TextModelLine> take_at(size_t index);
+
+    void remove_index(size_t index) { take_at(index); }
+};
+
 class TextModel :
     public RefCounted<TextModel>,
     public Async::Observable<TextModel>
 {
 private:
-    Vector<OwnPtr<TextModelLine>> _lines{1024};
+    // Text is never modified in place: the content of the file and everything
+    // typed afterward live in append-only blocks that the lines point into.
+    struct TextBlock
+    {
+        Codepoint *codepoints;
+        size_t used;
+        size_t capacity;
+
+        TextBlock(size_t capacity)
+            : codepoints(new Codepoint[capacity]),
+              used(0),
+              capacity(capacity)
+        {
+        }
+
+        ~TextBlock()
+        {
+            delete[] codepoints;
+        }
+    };
+
+    struct TextEdit
+    {
+        enum Type
+        {
+            INSERT,
+            REMOVE,
+            SPLIT,
+            JOIN,
+            // The line at `line` trades places with the one above or below
+            // it, the cursor follows it to `column`.
+            LINE_UP,
+            LINE_DOWN,
+        };
+
+        Type type;
+        size_t line;
+        size_t column;
+        TextPiece piece;
+    };
+
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    Vector<OwnPtr<TextBlock>> _blocks{};
+    TextModelLines _lines{};
     Vector<TextModelSpan> _spans{1024};
 
+    Vector<TextEdit> _undo{};
+    Vector<TextEdit> _redo{};
+
+    const Graphic::Font *_measured_font = nullptr;
+    Math::Recti _measured_bound{};
+
+    TextPiece store(Codepoint codepoint);
+
+    void record(TextEdit edit);
+
+    void apply(TextEdit edit, TextCursor &cursor);
+
+    void revert(TextEdit edit, TextCursor &cursor);
+
+    void did_edit()
+    {
+        _measured_font = nullptr;
+        did_update();
+    }
+
 public:
     static RefPtr<TextModel> empty();
 
@@ -136,17 +262,25 @@ public:
 
     Math::Recti bound(const Graphic::Font &font)
     {
+        if (_measured_font == &font)
+        {
+            return _measured_bound;
+        }
+
         int width = 0;
         int height = 0;
 
         for (size_t i = 0; i < _lines.count(); i++)
         {
-            auto line_bound = _lines[i]->bound(font);
+            auto line_bound = _lines.at(i).bound(font);
             width = MAX(width, line_bound.width());
             height += line_bound.height();
         }
 
-        return {width, height};
+        _measured_font = &font;
+        _measured_bound = {width, height};
+
+        return _measured_bound;
     }
 
     String string();
@@ -157,19 +291,25 @@ public:
     {
         _lines.clear();
         _spans.clear();
+        _undo.clear();
+        _redo.clear();
 
         append_line(own<TextModelLine>());
 
-        did_update();
+        did_edit();
     }
 
     /* --- Editing ---------------------------------------------------------- */
 
-    TextModelLine &line(int index) { return *_lines[index]; }
+    TextModelLine &line(int index) { return _lines.at(index); }
 
     size_t line_count() const { return _lines.count(); }
 
-    void append_line(OwnPtr<TextModelLine> line) { _lines.push_back(line); }
+    void append_line(OwnPtr<TextModelLine> line)
+    {
+        _lines.push_back(line);
+        _measured_font = nullptr;
+    }
 
     void append_at(TextCursor &cursor, Codepoint codepoint);
 
@@ -183,6 +323,16 @@ public:
 
     void move_line_down_at(TextCursor &cursor);
 
+    /* --- History ---------------------------------------------------------- */
+
+    bool can_undo() const { return _undo.any(); }
+
+    bool can_redo() const { return _redo.any(); }
+
+    void undo(TextCursor &cursor);
+
+    void redo(TextCursor &cursor);
+
     /* --- Coloration ------------------------------------------------------- */
 
     void span_add(TextModelSpan span)
@@ -225,6 +375,13 @@ public:
     size_t line() { return _line; }
     size_t column() { return _column; }
 
+    void move_to(TextModel &model, size_t line, size_t column)
+    {
+        _line = clamp(line, 0, model.line_count() - 1);
+        _column = clamp(column, 0, model.line(_line).length());
+        _prefered_column = _column;
+    }
+
     void move_to_within(TextModel &model, size_t line)
     {
         if (line < model.line_count())
@@ -1,6 +1,7 @@
 #include <libio/NumberScanner.h>
 #include <libio/Streams.h>
 #include <libutils/HashMap.h>
+#include <libutils/Intern.h>
 #include <libxml/Parser.h>
 
 //See https://www.w3.org/TR/xml/#NT-Comment
@@ -34,7 +35,8 @@ Result read_attribute(IO::Scanner &scan, String &name, String &value)
         builder.append(scan.current());
         scan.forward();
     }
-    name = builder.finalize();
+    name = intern(builder.cstring(), builder.length());
+    builder.rewind(builder.length());
 
     // Attribute equal
     if (!scan.skip('='))
@@ -120,7 +122,8 @@ ResultOr<String> read_tag(IO::Scanner &scan, HashMap<String, String> &attributes
         scan.forward();
     }
 
-    return builder.finalize();
+    // Tag and attribute names come from a small vocabulary, share them.
+    return intern(builder.cstring(), builder.length());
 }
 
 // See https://www.w3.org/TR/xml/#dt-etag
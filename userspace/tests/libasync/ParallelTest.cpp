@@ -0,0 +1,83 @@
+#include <libasync/Parallel.h>
+
+#include "tests/Driver.h"
+
+TEST(parallel_for_covers_the_whole_range_once)
+{
+    Async::Runtime runtime{4};
+
+    Vector<int> hits;
+    hits.resize(1000);
+
+    Async::parallel_for(0, hits.count(), 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            __atomic_add_fetch(&hits[i], 1, __ATOMIC_SEQ_CST);
+        }
+    }, runtime);
+
+    for (size_t i = 0; i < hits.count(); i++)
+    {
+        Assert::equal(hits[i], 1);
+    }
+}
+
+TEST(parallel_for_can_be_nested)
+{
+    Async::Runtime runtime{4};
+
+    int total = 0;
+
+    Async::parallel_for(0, 8, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            Async::parallel_for(0, 100, 10, [&](size_t inner_begin, size_t inner_end) {
+                __atomic_add_fetch(&total, inner_end - inner_begin, __ATOMIC_SEQ_CST);
+            }, runtime);
+        }
+    }, runtime);
+
+    Assert::equal(total, 800);
+}
+
+TEST(future_returns_the_value_of_its_job)
+{
+    Async::Runtime runtime{2};
+
+    auto future = Async::run<int>([]() { return 6 * 7; }, runtime);
+
+    Assert::equal(future.get(), 42);
+    Assert::is_true(future.done());
+}
+
+TEST(task_graph_runs_dependencies_first)
+{
+    Async::Runtime runtime{4};
+    Async::TaskGraph graph;
+
+    Lock lock{"order"};
+    Vector<size_t> order;
+
+    auto record = [&](size_t node) {
+        return [&, node]() {
+            LockHolder holder{lock};
+            order.push_back(node);
+        };
+    };
+
+    size_t a = graph.add(record(0));
+    size_t b = graph.add(record(1));
+    size_t c = graph.add(record(2));
+    size_t d = graph.add(record(3));
+
+    graph.depend(b, a);
+    graph.depend(c, a);
+    graph.depend(d, b);
+    graph.depend(d, c);
+
+    graph.run(runtime);
+
+    Assert::equal(order.count(), 4);
+    Assert::equal(order[0], 0);
+    Assert::equal(order[3], 3);
+}
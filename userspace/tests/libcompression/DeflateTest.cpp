@@ -0,0 +1,85 @@
+#include <libcompression/Deflate.h>
+#include <libcompression/Inflate.h>
+#include <libio/MemoryReader.h>
+#include <libio/MemoryWriter.h>
+
+#include <string.h>
+
+#include "tests/Driver.h"
+
+static void deflate_then_inflate(const uint8_t *data, size_t size, unsigned int level)
+{
+    IO::MemoryReader uncompressed{data, size};
+    IO::MemoryWriter compressed;
+
+    Compression::Deflate deflate{level};
+    Assert::equal(deflate.perform(uncompressed, compressed), Result::SUCCESS);
+
+    IO::MemoryReader compressed_reader{compressed.buffer(), compressed.length().unwrap()};
+    IO::MemoryWriter decompressed;
+
+    Compression::Inflate inflate;
+    Assert::equal(inflate.perform(compressed_reader, decompressed).result(), Result::SUCCESS);
+
+    Assert::equal(decompressed.length().unwrap(), size);
+    Assert::is_true(memcmp(decompressed.buffer(), data, size) == 0);
+}
+
+TEST(deflate_empty)
+{
+    uint8_t data[1] = {};
+
+    for (unsigned int level = 0; level <= Compression::Deflate::MAX_COMPRESSION_LEVEL; level++)
+    {
+        deflate_then_inflate(data, 0, level);
+    }
+}
+
+TEST(deflate_repeated)
+{
+    static uint8_t data[100000];
+
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = "deflate "[i % 8];
+    }
+
+    IO::MemoryReader uncompressed{data, sizeof(data)};
+    IO::MemoryWriter compressed;
+
+    Compression::Deflate deflate{5};
+    Assert::equal(deflate.perform(uncompressed, compressed), Result::SUCCESS);
+    Assert::lower_than(compressed.length().unwrap(), sizeof(data) / 100);
+
+    for (unsigned int level = 0; level <= Compression::Deflate::MAX_COMPRESSION_LEVEL; level++)
+    {
+        deflate_then_inflate(data, sizeof(data), level);
+    }
+}
+
+TEST(deflate_noise)
+{
+    // More than a window and a block worth of symbols, with both literals
+    // and matches of every length and distance.
+    static uint8_t data[200000];
+    uint32_t state = 42;
+
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        state = state * 1103515245 + 12345;
+
+        if ((state >> 16) % 4 == 0 && i > 300)
+        {
+            data[i] = data[i - 1 - (state >> 8) % 300];
+        }
+        else
+        {
+            data[i] = state >> 24;
+        }
+    }
+
+    for (unsigned int level = 0; level <= Compression::Deflate::MAX_COMPRESSION_LEVEL; level += 3)
+    {
+        deflate_then_inflate(data, sizeof(data), level);
+    }
+}
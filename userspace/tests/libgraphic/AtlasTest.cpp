@@ -0,0 +1,100 @@
+#include <libgraphic/Atlas.h>
+#include <libio/MemoryWriter.h>
+
+#include "tests/Driver.h"
+
+static Graphic::Color red_pixels[4] = {
+    Graphic::Colors::RED,
+    Graphic::Colors::RED,
+    Graphic::Colors::RED,
+    Graphic::Colors::RED,
+};
+
+static Graphic::Color blue_pixels[9] = {
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+    Graphic::Colors::BLUE,
+};
+
+static Slice make_atlas()
+{
+    Graphic::AtlasBuilder builder;
+
+    RefPtr<Graphic::Bitmap> red[Graphic::__ICON_SIZE_COUNT] = {};
+    red[Graphic::ICON_18PX] = Graphic::Bitmap::create_static(2, 2, red_pixels);
+
+    RefPtr<Graphic::Bitmap> blue[Graphic::__ICON_SIZE_COUNT] = {};
+    blue[Graphic::ICON_18PX] = Graphic::Bitmap::create_static(2, 2, red_pixels);
+    blue[Graphic::ICON_24PX] = Graphic::Bitmap::create_static(3, 3, blue_pixels);
+
+    // Out of order, the builder sorts them for lookups.
+    Assert::equal(builder.add_icon("red", red), SUCCESS);
+    Assert::equal(builder.add_icon("blue", blue), SUCCESS);
+    Assert::equal(builder.add_icon("this-name-is-way-too-long-for-an-atlas", red), ERR_INVALID_ARGUMENT);
+
+    Vector<Graphic::Glyph> glyphs;
+    glyphs.push_back({U'?', {0, 0, 2, 2}, {}, 3});
+    glyphs.push_back({U'a', {0, 0, 2, 2}, {}, 7});
+    glyphs.push_back({0, {}, {}, 0});
+
+    Assert::equal(builder.add_font("sans", Graphic::Bitmap::create_static(3, 3, blue_pixels), glyphs), SUCCESS);
+
+    IO::MemoryWriter writer;
+    Assert::equal(builder.write(writer), SUCCESS);
+
+    return Slice{writer.slice()};
+}
+
+TEST(atlas_icon_lookup)
+{
+    Graphic::Atlas atlas{make_atlas()};
+
+    Assert::is_true(atlas.valid());
+    Assert::is_true(atlas.has_icon("red"));
+    Assert::is_true(atlas.has_icon("blue"));
+    Assert::is_false(atlas.has_icon("green"));
+
+    auto red = atlas.icon("red", Graphic::ICON_18PX);
+    Assert::not_null(red);
+    Assert::equal(red->width(), 2);
+    Assert::equal(red->pixels()[3].red(), 0xff);
+
+    Assert::is_true(atlas.icon("red", Graphic::ICON_24PX) == nullptr);
+
+    auto blue = atlas.icon("blue", Graphic::ICON_24PX);
+    Assert::not_null(blue);
+    Assert::equal(blue->height(), 3);
+    Assert::equal(blue->pixels()[8].blue(), 0xff);
+}
+
+TEST(atlas_font_lookup)
+{
+    Graphic::Atlas atlas{make_atlas()};
+
+    auto font = atlas.font("sans");
+    Assert::is_true(font.success());
+    Assert::equal(font.unwrap()->glyph(U'a').advance, 7);
+    Assert::equal(font.unwrap()->bitmap().width(), 3);
+
+    Assert::equal(atlas.font("mono").result(), ERR_NO_SUCH_FILE_OR_DIRECTORY);
+}
+
+TEST(atlas_reject_truncated_file)
+{
+    auto data = make_atlas();
+
+    Assert::is_false(Graphic::Atlas{Slice{data.start(), 8}}.valid());
+    Assert::is_false(Graphic::Atlas{Slice{data.start(), sizeof(Graphic::Atlas::Header) + 16}}.valid());
+
+    // Entries are there but not the pixels they point to.
+    Graphic::Atlas truncated{Slice{data.start(), data.size() - 64}};
+    Assert::is_true(truncated.valid());
+    Assert::is_true(truncated.icon("red", Graphic::ICON_18PX) != nullptr);
+    Assert::is_false(truncated.font("sans").success());
+}
@@ -0,0 +1,55 @@
+#include <libgraphic/Font.h>
+
+#include "tests/Driver.h"
+
+static RefPtr<Graphic::Font> make_font(Vector<Codepoint> codepoints)
+{
+    static Graphic::Color pixels[4] = {};
+
+    Vector<Graphic::Glyph> glyphs;
+
+    for (size_t i = 0; i < codepoints.count(); i++)
+    {
+        glyphs.push_back({codepoints[i], {}, {}, (int)i + 1});
+    }
+
+    glyphs.push_back({0, {}, {}, 0});
+
+    return make<Graphic::Font>(Graphic::Bitmap::create_static(2, 2, pixels), glyphs);
+}
+
+TEST(font_glyph_lookup_latin_and_beyond)
+{
+    auto font = make_font({U'?', U'a', 0x3A9, U'é', 0x1F600, 0x2603});
+
+    Assert::is_true(font->has(U'a'));
+    Assert::is_true(font->has(U'é'));
+    Assert::is_true(font->has(0x3A9));
+    Assert::is_true(font->has(0x2603));
+    Assert::is_true(font->has(0x1F600));
+    Assert::is_false(font->has(U'b'));
+    Assert::is_false(font->has(0x2604));
+
+    Assert::equal(font->glyph(U'a').advance, 2);
+    Assert::equal(font->glyph(0x2603).advance, 6);
+    Assert::equal(font->glyph(0x1F600).advance, 5);
+}
+
+TEST(font_missing_glyph_falls_back_to_default)
+{
+    auto font = make_font({U'?', U'a'});
+
+    Assert::equal(font->glyph(U'z').codepoint, U'?');
+    Assert::equal(font->glyph(0x10000).codepoint, U'?');
+}
+
+TEST(font_mesure_string_is_stable)
+{
+    auto font = make_font({U'?', U'a', U'b'});
+
+    Assert::equal(font->mesure("ab").width(), 5);
+    Assert::equal(font->mesure("ab").width(), 5);
+    Assert::equal(font->mesure("ba").width(), 5);
+    Assert::equal(font->mesure("aab").width(), 7);
+    Assert::equal(font->mesure("").width(), 0);
+}
@@ -0,0 +1,158 @@
+#include <libgraphic/Painter.h>
+#include <libgraphic/Scaling.h>
+
+#include "tests/Driver.h"
+
+static RefPtr<Graphic::Bitmap> make_gradient(int width, int height)
+{
+    auto bitmap = Graphic::Bitmap::create_shared(width, height).unwrap();
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            bitmap->set_pixel({x, y}, Graphic::Color::from_rgb_byte(x * 255 / width, y * 255 / height, (x + y) % 256));
+        }
+    }
+
+    return bitmap;
+}
+
+static void assert_same_pixels(Graphic::Bitmap &left, Graphic::Bitmap &right)
+{
+    Assert::equal(left.width(), right.width());
+    Assert::equal(left.height(), right.height());
+
+    for (int i = 0; i < left.width() * left.height(); i++)
+    {
+        Assert::equal(left.pixels()[i].red(), right.pixels()[i].red());
+        Assert::equal(left.pixels()[i].green(), right.pixels()[i].green());
+        Assert::equal(left.pixels()[i].blue(), right.pixels()[i].blue());
+        Assert::equal(left.pixels()[i].alpha(), right.pixels()[i].alpha());
+    }
+}
+
+TEST(scaling_same_size_is_a_copy)
+{
+    auto source = make_gradient(37, 23);
+    auto destination = Graphic::Bitmap::create_shared(37, 23).unwrap();
+
+    Graphic::scale(*source, source->bound(), *destination, destination->bound(), destination->bound(), Graphic::ScalingBlending::COPY);
+
+    assert_same_pixels(*source, *destination);
+}
+
+TEST(scaling_down_averages_covered_pixels)
+{
+    auto source = Graphic::Bitmap::create_shared(4, 2).unwrap();
+
+    source->set_pixel({0, 0}, Graphic::Color::from_rgb_byte(0, 0, 0));
+    source->set_pixel({1, 0}, Graphic::Color::from_rgb_byte(100, 0, 0));
+    source->set_pixel({0, 1}, Graphic::Color::from_rgb_byte(100, 0, 0));
+    source->set_pixel({1, 1}, Graphic::Color::from_rgb_byte(200, 0, 0));
+    source->set_pixel({2, 0}, Graphic::Colors::WHITE);
+    source->set_pixel({3, 0}, Graphic::Colors::WHITE);
+    source->set_pixel({2, 1}, Graphic::Colors::WHITE);
+    source->set_pixel({3, 1}, Graphic::Colors::WHITE);
+
+    auto destination = Graphic::Bitmap::create_shared(2, 1).unwrap();
+    Graphic::scale(*source, source->bound(), *destination, destination->bound(), destination->bound(), Graphic::ScalingBlending::COPY);
+
+    Assert::equal(destination->pixels()[0].red(), 100);
+    Assert::equal(destination->pixels()[0].green(), 0);
+    Assert::equal(destination->pixels()[1].red(), 255);
+    Assert::equal(destination->pixels()[1].blue(), 255);
+    Assert::equal(destination->pixels()[1].alpha(), 255);
+}
+
+TEST(scaling_up_keeps_flat_colors_flat)
+{
+    auto color = Graphic::Color::from_rgb_byte(12, 34, 56);
+
+    auto source = Graphic::Bitmap::create_shared(3, 3).unwrap();
+    source->clear(color);
+
+    auto destination = Graphic::Bitmap::create_shared(50, 17).unwrap();
+    Graphic::scale(*source, source->bound(), *destination, destination->bound(), destination->bound(), Graphic::ScalingBlending::COPY);
+
+    for (int i = 0; i < 50 * 17; i++)
+    {
+        Assert::equal(destination->pixels()[i].red(), 12);
+        Assert::equal(destination->pixels()[i].green(), 34);
+        Assert::equal(destination->pixels()[i].blue(), 56);
+        Assert::equal(destination->pixels()[i].alpha(), 255);
+    }
+}
+
+TEST(scaling_transparent_pixels_dont_bleed)
+{
+    auto source = Graphic::Bitmap::create_shared(2, 1).unwrap();
+    source->set_pixel({0, 0}, Graphic::Colors::RED);
+    source->set_pixel({1, 0}, Graphic::Color::from_rgba_byte(0, 255, 0, 0));
+
+    auto destination = Graphic::Bitmap::create_shared(1, 1).unwrap();
+    Graphic::scale(*source, source->bound(), *destination, destination->bound(), destination->bound(), Graphic::ScalingBlending::COPY);
+
+    Assert::equal(destination->pixels()[0].red(), 255);
+    Assert::equal(destination->pixels()[0].green(), 0);
+    Assert::equal(destination->pixels()[0].alpha(), 128);
+}
+
+TEST(scaling_nearest_picks_pixels)
+{
+    auto source = make_gradient(8, 8);
+    source->filtering(Graphic::BitmapFiltering::NEAREST);
+
+    auto destination = Graphic::Bitmap::create_shared(24, 4).unwrap();
+    Graphic::scale(*source, source->bound(), *destination, destination->bound(), destination->bound(), Graphic::ScalingBlending::COPY);
+
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 24; x++)
+        {
+            auto expected = source->get_pixel({x / 3, y * 2 + 1});
+            auto actual = destination->get_pixel({x, y});
+
+            Assert::equal(actual.red(), expected.red());
+            Assert::equal(actual.green(), expected.green());
+            Assert::equal(actual.blue(), expected.blue());
+        }
+    }
+}
+
+TEST(scaling_clipped_matches_whole)
+{
+    auto source = make_gradient(301, 157);
+
+    auto whole = Graphic::Bitmap::create_shared(97, 61).unwrap();
+    Graphic::scale(*source, source->bound(), *whole, whole->bound(), whole->bound(), Graphic::ScalingBlending::COPY);
+
+    auto clipped = Graphic::Bitmap::create_shared(97, 61).unwrap();
+    Graphic::scale(*source, source->bound(), *clipped, clipped->bound(), {0, 0, 40, 61}, Graphic::ScalingBlending::COPY);
+    Graphic::scale(*source, source->bound(), *clipped, clipped->bound(), {40, 0, 57, 30}, Graphic::ScalingBlending::COPY);
+    Graphic::scale(*source, source->bound(), *clipped, clipped->bound(), {40, 30, 57, 31}, Graphic::ScalingBlending::COPY);
+
+    assert_same_pixels(*whole, *clipped);
+}
+
+TEST(scaling_result_is_cached_until_painted_on)
+{
+    auto source = make_gradient(64, 64);
+
+    auto scaled = source->scaled(source->bound(), {16, 16});
+    Assert::not_null(scaled);
+    Assert::is_true(source->scaled(source->bound(), {16, 16}) == scaled);
+    Assert::is_true(source->scaled(source->bound(), {16, 17}) != scaled);
+
+    // Painters live as long as what they draw on, only drawing counts.
+    Graphic::Painter painter{source};
+    scaled = source->scaled(source->bound(), {16, 16});
+    Assert::is_true(source->scaled(source->bound(), {16, 16}) == scaled);
+
+    painter.fill_rectangle({0, 0, 1, 1}, Graphic::Colors::RED);
+    Assert::is_true(source->scaled(source->bound(), {16, 16}) != scaled);
+
+    scaled = source->scaled(source->bound(), {16, 16});
+    painter.plot({8, 8}, Graphic::Colors::RED);
+    Assert::is_true(source->scaled(source->bound(), {16, 16}) != scaled);
+}
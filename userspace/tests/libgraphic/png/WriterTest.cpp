@@ -0,0 +1,56 @@
+#include <libgraphic/png/PngReader.h>
+#include <libgraphic/png/PngWriter.h>
+#include <libio/MemoryReader.h>
+#include <libio/MemoryWriter.h>
+
+#include "tests/Driver.h"
+
+static void write_then_read(Graphic::Color *pixels, int width, int height)
+{
+    auto bitmap = Graphic::Bitmap::create_static(width, height, pixels);
+
+    IO::MemoryWriter mem_writer;
+    Graphic::PngWriter png_writer{mem_writer};
+    Assert::equal(png_writer.write(*bitmap), Result::SUCCESS);
+
+    IO::MemoryReader mem_reader{mem_writer.buffer(), mem_writer.length().unwrap()};
+    Graphic::PngReader png_reader{mem_reader};
+    Assert::is_true(png_reader.valid());
+    Assert::equal(png_reader.width(), width);
+    Assert::equal(png_reader.height(), height);
+
+    for (int i = 0; i < width * height; i++)
+    {
+        Assert::equal(png_reader.bitmap()->pixels()[i].red(), pixels[i].red());
+        Assert::equal(png_reader.bitmap()->pixels()[i].green(), pixels[i].green());
+        Assert::equal(png_reader.bitmap()->pixels()[i].blue(), pixels[i].blue());
+        Assert::equal(png_reader.bitmap()->pixels()[i].alpha(), pixels[i].alpha());
+    }
+}
+
+TEST(pngwriter_opaque)
+{
+    static Graphic::Color pixels[64 * 48];
+
+    for (int y = 0; y < 48; y++)
+    {
+        for (int x = 0; x < 64; x++)
+        {
+            pixels[y * 64 + x] = Graphic::Color::from_rgb_byte(x * 4, y * 5, (x ^ y) * 3);
+        }
+    }
+
+    write_then_read(pixels, 64, 48);
+}
+
+TEST(pngwriter_transparent)
+{
+    static Graphic::Color pixels[33 * 17];
+
+    for (int i = 0; i < 33 * 17; i++)
+    {
+        pixels[i] = Graphic::Color::from_rgba_byte(i * 7, i * 11, i * 13, i * 17);
+    }
+
+    write_then_read(pixels, 33, 17);
+}
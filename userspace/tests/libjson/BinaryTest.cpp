@@ -0,0 +1,45 @@
+#include <libjson/Binary.h>
+#include <libjson/Json.h>
+
+#include "tests/Driver.h"
+
+TEST(json_binary_round_trip)
+{
+    const char *text = R"({"POSIX": {"PWD": "/User", "PATH": ["/System/Utilities", "/Applications"]}, "depth": -42, "ok": true, "none": null})";
+    auto value = Json::parse(text, strlen(text));
+
+    Vector<uint8_t> block;
+    Json::encode(block, value);
+
+    auto decoded = Json::decode(block.raw_storage(), block.count());
+
+    Assert::equal(decoded.get("POSIX").get("PWD").as_string(), "/User");
+    Assert::equal(decoded.get("POSIX").get("PATH").length(), 2);
+    Assert::equal(decoded.get("POSIX").get("PATH").get(1).as_string(), "/Applications");
+    Assert::equal(decoded.get("depth").as_integer(), -42);
+    Assert::is_true(decoded.get("ok").is(Json::TRUE));
+    Assert::is_true(decoded.get("none").is(Json::NIL));
+}
+
+TEST(json_binary_strings_are_not_escaped)
+{
+    Json::Value value{"quote \" and\nnewline"};
+
+    Vector<uint8_t> block;
+    Json::encode(block, value);
+
+    Assert::equal(Json::decode(block.raw_storage(), block.count()).as_string(), "quote \" and\nnewline");
+}
+
+TEST(json_binary_truncated_input_does_not_overrun)
+{
+    const char *text = R"({"key": "a rather long string value"})";
+    auto value = Json::parse(text, strlen(text));
+
+    Vector<uint8_t> block;
+    Json::encode(block, value);
+
+    auto decoded = Json::decode(block.raw_storage(), block.count() / 2);
+
+    Assert::is_true(decoded.is(Json::OBJECT));
+}
@@ -0,0 +1,34 @@
+#include <libjson/Json.h>
+
+#include "tests/Driver.h"
+
+TEST(json_parse_copies_keys)
+{
+    const char *text = R"({"untrusted": 1})";
+    auto value = Json::parse(text, strlen(text));
+
+    value.as_object().foreach ([](auto &key, auto &) {
+        Assert::is_false(key.interned());
+        return Iteration::CONTINUE;
+    });
+
+    Assert::equal(value.get("untrusted").as_integer(), 1);
+}
+
+TEST(json_parse_interns_keys_on_request)
+{
+    const char *text = R"({"colors": {"background": "#000000"}})";
+    auto value = Json::parse(text, strlen(text), Json::INTERN_KEYS);
+
+    value.as_object().foreach ([](auto &key, auto &) {
+        Assert::is_true(key.interned());
+        return Iteration::CONTINUE;
+    });
+
+    value.get("colors").as_object().foreach ([](auto &key, auto &) {
+        Assert::is_true(key.interned());
+        return Iteration::CONTINUE;
+    });
+
+    Assert::equal(value.get("colors").get("background").as_string(), "#000000");
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <libnet/Stack.h>
+#include <libutils/Vector.h>
+
+// Two stacks wired back to back, frames only move when exchange() is called.
+struct LoopbackInterface : public Net::Interface
+{
+    MacAddress address;
+    Vector<Vector<uint8_t>> outgoing{};
+    uint8_t buffer[NETWORK_FRAME_SIZE];
+
+    LoopbackInterface(uint8_t id) : address{{0x52, 0x54, 0x00, 0x12, 0x34, id}} {}
+
+    MacAddress mac_address() override { return address; }
+
+    uint8_t *acquire() override { return buffer; }
+
+    void submit(size_t size) override
+    {
+        Vector<uint8_t> frame;
+        frame.push_back_many(buffer, size);
+        outgoing.push_back(move(frame));
+    }
+};
+
+struct Loopback
+{
+    LoopbackInterface left_interface{1};
+    LoopbackInterface right_interface{2};
+
+    Net::Stack left{left_interface, {Ipv4Address::from_octets(10, 0, 2, 15), Ipv4Address::from_octets(255, 255, 255, 0), Ipv4Address::from_octets(10, 0, 2, 2)}};
+    Net::Stack right{right_interface, {Ipv4Address::from_octets(10, 0, 2, 2), Ipv4Address::from_octets(255, 255, 255, 0), Ipv4Address::from_octets(10, 0, 2, 2)}};
+
+    uint64_t now = 0;
+    size_t frames = 0;
+
+    // Frames for which this returns true never make it to the other side.
+    bool (*drop)(size_t index) = nullptr;
+
+    void deliver(LoopbackInterface &from, Net::Stack &to)
+    {
+        auto outgoing = move(from.outgoing);
+
+        for (size_t i = 0; i < outgoing.count(); i++)
+        {
+            if (!drop || !drop(frames))
+            {
+                to.receive(outgoing[i].raw_storage(), outgoing[i].count());
+            }
+
+            frames++;
+        }
+    }
+
+    // One round: both stacks run their timers, then whatever they sent gets
+    // delivered. Each round is 10ms.
+    void exchange()
+    {
+        now += 10;
+
+        left.poll(now);
+        right.poll(now);
+
+        deliver(left_interface, right);
+        deliver(right_interface, left);
+    }
+
+    template <typename TPredicate>
+    bool exchange_until(TPredicate predicate, int rounds = 10000)
+    {
+        for (int i = 0; i < rounds && !predicate(); i++)
+        {
+            exchange();
+        }
+
+        return predicate();
+    }
+};
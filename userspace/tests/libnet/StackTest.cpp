@@ -0,0 +1,140 @@
+#include <libnet/Checksum.h>
+#include <libnet/Headers.h>
+#include <libnet/RingInterface.h>
+#include <string.h>
+
+#include "tests/Driver.h"
+#include "tests/libnet/Loopback.h"
+
+TEST(net_checksum_rfc1071_example)
+{
+    uint8_t data[] = {0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7};
+
+    Net::Checksum checksum;
+    checksum.add(data, sizeof(data));
+
+    Assert::equal(checksum.finish(), (uint16_t)~0xddf2);
+
+    // Odd sizes are padded with a zero.
+    Net::Checksum odd;
+    odd.add(data, 3);
+
+    Assert::equal(odd.finish(), (uint16_t)~(0x0001 + 0xf200));
+}
+
+TEST(net_parse_ipv4)
+{
+    auto address = Net::parse_ipv4("10.0.2.15");
+
+    Assert::is_true(address.present());
+    Assert::is_true(address.unwrap() == Ipv4Address::from_octets(10, 0, 2, 15));
+    Assert::equal(address.unwrap()[3], 15);
+
+    Assert::is_false(Net::parse_ipv4("10.0.2").present());
+    Assert::is_false(Net::parse_ipv4("10.0.2.256").present());
+    Assert::is_false(Net::parse_ipv4("10.0.2.15.").present());
+    Assert::is_false(Net::parse_ipv4("").present());
+}
+
+TEST(net_ring_interface_batches_frames)
+{
+    auto rings = reinterpret_cast<NetworkRings *>(new uint8_t[NetworkRings::SIZE]{});
+    Net::RingInterface interface{rings, {}};
+
+    for (size_t i = 0; i < NETWORK_RING_SLOTS; i++)
+    {
+        auto frame = interface.acquire();
+        Assert::not_null(frame);
+        Assert::is_true(frame == rings->tx_frame(i));
+
+        frame[0] = i;
+        interface.submit(60 + i);
+    }
+
+    Assert::is_true(interface.acquire() == nullptr);
+    Assert::equal(rings->tx.head, NETWORK_RING_SLOTS);
+    Assert::equal(rings->tx.lengths[5], 65);
+
+    // What the driver does once the hardware is done with them.
+    rings->tx.tail = 2;
+    Assert::is_true(interface.acquire() == rings->tx_frame(0));
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        rings->rx_frame(i)[0] = 0x40 + i;
+        rings->rx.lengths[i] = 100 + i;
+    }
+
+    rings->rx.head = 3;
+
+    size_t total = 0;
+
+    auto received = interface.receive([&](const uint8_t *frame, size_t size) {
+        Assert::equal(frame[0], 0x40 + total);
+        Assert::equal(size, 100 + total);
+        total++;
+    });
+
+    Assert::equal(received, 3u);
+    Assert::equal(rings->rx.tail, 3u);
+    Assert::equal(interface.receive([](auto, auto) {}), 0u);
+
+    delete[] reinterpret_cast<uint8_t *>(rings);
+}
+
+TEST(net_ping_resolves_the_address_first)
+{
+    Loopback loopback;
+
+    bool replied = false;
+
+    loopback.left.on_echo_reply = [&](Ipv4Address address, uint16_t sequence) {
+        Assert::is_true(address == Ipv4Address::from_octets(10, 0, 2, 2));
+        Assert::equal(sequence, 7);
+        replied = true;
+    };
+
+    Assert::equal(loopback.left.ping(Ipv4Address::from_octets(10, 0, 2, 2), 7), SUCCESS);
+
+    // Nothing is known about the other end yet, only an ARP request went out.
+    Assert::equal(loopback.left_interface.outgoing.count(), 1u);
+
+    auto &ethernet = *reinterpret_cast<Net::EthernetHeader *>(loopback.left_interface.outgoing[0].raw_storage());
+    Assert::is_true(ethernet.destination == Net::MAC_BROADCAST);
+    Assert::equal(ethernet.type(), Net::ETHERNET_TYPE_ARP);
+
+    Assert::is_true(loopback.exchange_until([&]() { return replied; }, 10));
+
+    // Both ends know each other now, the next ping goes straight out.
+    Assert::equal(loopback.left.ping(Ipv4Address::from_octets(10, 0, 2, 2), 8), SUCCESS);
+    Assert::equal(loopback.left_interface.outgoing.count(), 1u);
+
+    auto &next = *reinterpret_cast<Net::EthernetHeader *>(loopback.left_interface.outgoing[0].raw_storage());
+    Assert::is_true(next.destination == loopback.right_interface.address);
+    Assert::equal(next.type(), Net::ETHERNET_TYPE_IPV4);
+}
+
+TEST(net_udp_roundtrip)
+{
+    Loopback loopback;
+
+    auto server = loopback.right.udp_bind(7).unwrap();
+    auto client = loopback.left.udp_bind(0).unwrap();
+
+    Assert::equal(loopback.right.udp_bind(7).result(), ERR_ADDRESS_IN_USE);
+
+    const char *message = "hello, world";
+    Assert::equal(loopback.left.udp_send(*client, {Ipv4Address::from_octets(10, 0, 2, 2), 7}, message, strlen(message)), SUCCESS);
+
+    Assert::is_true(loopback.exchange_until([&]() { return server->readable(); }, 10));
+
+    auto datagram = server->receive();
+    Assert::equal(datagram.data.count(), strlen(message));
+    Assert::equal(memcmp(datagram.data.raw_storage(), message, strlen(message)), 0);
+    Assert::is_true(datagram.endpoint.address == Ipv4Address::from_octets(10, 0, 2, 15));
+    Assert::equal(datagram.endpoint.port, client->port());
+
+    Assert::equal(loopback.right.udp_send(*server, datagram.endpoint, "olleh", 5), SUCCESS);
+    Assert::is_true(loopback.exchange_until([&]() { return client->readable(); }, 10));
+    Assert::equal(client->receive().data.count(), 5u);
+}
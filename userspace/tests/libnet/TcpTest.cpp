@@ -0,0 +1,119 @@
+#include <string.h>
+
+#include "tests/Driver.h"
+#include "tests/libnet/Loopback.h"
+
+static NetworkEndpoint right_endpoint(uint16_t port)
+{
+    return {Ipv4Address::from_octets(10, 0, 2, 2), port};
+}
+
+static bool pump(Loopback &loopback, Net::TcpConnection &from, Net::TcpConnection &to, const uint8_t *data, size_t size, Vector<uint8_t> &received)
+{
+    size_t sent = 0;
+
+    return loopback.exchange_until([&]() {
+        sent += from.send(data + sent, size - sent);
+
+        uint8_t buffer[4096];
+        size_t read = 0;
+
+        while ((read = to.receive(buffer, sizeof(buffer))) > 0)
+        {
+            received.push_back_many(buffer, read);
+        }
+
+        return received.count() == size;
+    });
+}
+
+TEST(net_tcp_handshake_transfer_and_close)
+{
+    Loopback loopback;
+
+    auto listener = loopback.right.tcp_listen(7).unwrap();
+    auto client = loopback.left.tcp_connect(right_endpoint(7)).unwrap();
+
+    Assert::is_true(loopback.exchange_until([&]() { return listener->readable(); }, 50));
+
+    auto server = listener->accept();
+    Assert::is_true(client->state() == Net::TcpState::ESTABLISHED);
+    Assert::is_true(server->state() == Net::TcpState::ESTABLISHED);
+    Assert::equal(server->remote().port, client->local().port);
+
+    // Bigger than both the window and the buffers, so it has to wait for
+    // the reader.
+    Vector<uint8_t> data;
+    for (size_t i = 0; i < 300 * 1024; i++)
+    {
+        data.push_back(i * 7 + i / 251);
+    }
+
+    Vector<uint8_t> received;
+    Assert::is_true(pump(loopback, *client, *server, data.raw_storage(), data.count(), received));
+    Assert::equal(memcmp(received.raw_storage(), data.raw_storage(), data.count()), 0);
+
+    Vector<uint8_t> echoed;
+    Assert::is_true(pump(loopback, *server, *client, data.raw_storage(), 1000, echoed));
+
+    client->close();
+    Assert::is_true(loopback.exchange_until([&]() { return server->readable() && server->state() == Net::TcpState::CLOSE_WAIT; }, 50));
+
+    uint8_t buffer[16];
+    Assert::equal(server->receive(buffer, sizeof(buffer)), 0u);
+
+    server->close();
+    Assert::is_true(loopback.exchange_until([&]() { return server->state() == Net::TcpState::CLOSED; }, 50));
+    Assert::is_true(client->state() == Net::TcpState::TIME_WAIT);
+    Assert::is_true(loopback.exchange_until([&]() { return client->state() == Net::TcpState::CLOSED; }, 500));
+    Assert::equal(client->error(), SUCCESS);
+}
+
+TEST(net_tcp_recovers_lost_segments)
+{
+    Loopback loopback;
+
+    loopback.drop = [](size_t index) {
+        return index % 7 == 3;
+    };
+
+    auto listener = loopback.right.tcp_listen(7).unwrap();
+    auto client = loopback.left.tcp_connect(right_endpoint(7)).unwrap();
+
+    Assert::is_true(loopback.exchange_until([&]() { return listener->readable(); }, 500));
+    auto server = listener->accept();
+
+    Vector<uint8_t> data;
+    for (size_t i = 0; i < 200 * 1024; i++)
+    {
+        data.push_back(i ^ (i >> 8));
+    }
+
+    Vector<uint8_t> received;
+    Assert::is_true(pump(loopback, *client, *server, data.raw_storage(), data.count(), received));
+    Assert::equal(memcmp(received.raw_storage(), data.raw_storage(), data.count()), 0);
+}
+
+TEST(net_tcp_connection_refused)
+{
+    Loopback loopback;
+
+    auto client = loopback.left.tcp_connect(right_endpoint(9)).unwrap();
+
+    Assert::is_true(loopback.exchange_until([&]() { return client->state() == Net::TcpState::CLOSED; }, 50));
+    Assert::equal(client->error(), ERR_CONNECTION_REFUSED);
+}
+
+TEST(net_tcp_gives_up_on_a_silent_peer)
+{
+    Loopback loopback;
+
+    loopback.drop = [](size_t index) {
+        return index > 1;
+    };
+
+    auto client = loopback.left.tcp_connect(right_endpoint(9)).unwrap();
+
+    Assert::is_true(loopback.exchange_until([&]() { return client->state() == Net::TcpState::CLOSED; }));
+    Assert::equal(client->error(), TIMEOUT);
+}
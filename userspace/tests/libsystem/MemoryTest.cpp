@@ -0,0 +1,54 @@
+#include <libsystem/system/Memory.h>
+#include <libutils/Vector.h>
+
+#include "tests/Driver.h"
+
+static constexpr size_t FRAGMENTS = 256;
+static constexpr size_t FRAGMENT_SIZE = 4096;
+
+// Big enough for a 1920x1080 RGBA window.
+static constexpr size_t WINDOW_SIZE = 1920 * 1080 * 4;
+
+TEST(memory_alloc_large_buffers_on_fragmented_memory)
+{
+    Vector<uintptr_t> fragments;
+
+    for (size_t i = 0; i < FRAGMENTS; i++)
+    {
+        uintptr_t address = 0;
+        Assert::equal(memory_alloc(FRAGMENT_SIZE, &address), SUCCESS);
+        fragments.push_back(address);
+    }
+
+    // Leave holes everywhere so no large contiguous range is left behind.
+    for (size_t i = 0; i < FRAGMENTS; i += 2)
+    {
+        Assert::equal(memory_free(fragments[i]), SUCCESS);
+    }
+
+    for (int round = 0; round < 16; round++)
+    {
+        uintptr_t address = 0;
+        Assert::equal(memory_alloc(WINDOW_SIZE, &address), SUCCESS);
+
+        auto pixels = reinterpret_cast<uint32_t *>(address);
+
+        // Fresh memory has to read as zero, even pages committed on first touch.
+        Assert::equal(pixels[0], 0u);
+        Assert::equal(pixels[WINDOW_SIZE / 4 - 1], 0u);
+
+        for (size_t i = 0; i < WINDOW_SIZE / 4; i += 1024)
+        {
+            pixels[i] = round;
+        }
+
+        Assert::equal(pixels[WINDOW_SIZE / 4 - 1024], (uint32_t)round);
+
+        Assert::equal(memory_free(address), SUCCESS);
+    }
+
+    for (size_t i = 1; i < FRAGMENTS; i += 2)
+    {
+        Assert::equal(memory_free(fragments[i]), SUCCESS);
+    }
+}
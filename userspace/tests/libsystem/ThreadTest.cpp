@@ -0,0 +1,162 @@
+#include <abi/Syscalls.h>
+
+#include <libasync/ThreadPool.h>
+#include <libsystem/thread/Thread.h>
+#include <skift/Condition.h>
+#include <skift/Lock.h>
+
+#include "tests/Driver.h"
+
+TEST(thread_runs_and_can_be_joined)
+{
+    int value = 0;
+
+    auto thread = Thread::spawn([&]() { value = 42; }).unwrap();
+
+    Assert::equal(thread->join(), SUCCESS);
+    Assert::equal(value, 42);
+}
+
+TEST(thread_current_is_the_running_thread)
+{
+    Thread *seen = nullptr;
+
+    auto thread = Thread::spawn([&]() { seen = Thread::current(); }).unwrap();
+    thread->join();
+
+    Assert::equal(seen, thread.naked());
+    Assert::equal(Thread::current(), (Thread *)nullptr);
+}
+
+TEST(lock_protects_shared_counter)
+{
+    static constexpr int THREADS = 4;
+    static constexpr int INCREMENTS = 10000;
+
+    Lock lock{"counter"};
+    int counter = 0;
+
+    Vector<OwnPtr<Thread>> threads;
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        threads.push_back(Thread::spawn([&]() {
+                              for (int j = 0; j < INCREMENTS; j++)
+                              {
+                                  LockHolder holder{lock};
+                                  counter++;
+                              }
+                          }).unwrap());
+    }
+
+    threads.clear();
+
+    Assert::equal(counter, THREADS * INCREMENTS);
+}
+
+TEST(lock_holder_is_the_thread_not_the_process)
+{
+    Lock lock{"holder"};
+    int holder = -1;
+
+    auto thread = Thread::spawn([&]() {
+                      LockHolder holder_of_lock{lock};
+                      holder = lock.holder();
+                  }).unwrap();
+
+    thread->join();
+
+    Assert::equal(holder, thread->id());
+
+    lock.acquire();
+    Assert::not_equal(lock.holder(), thread->id());
+    lock.release();
+}
+
+static constexpr uintptr_t BAD_TLS[] = {
+#ifdef __x86_64__
+    0x8000000000000000, // Not canonical
+#endif
+    ~(uintptr_t)0xfff, // Kernel memory
+    0x1000,            // Below user memory
+};
+
+static void never_started()
+{
+    hj_thread_exit(PROCESS_FAILURE);
+}
+
+TEST(thread_tls_outside_user_memory_is_rejected)
+{
+    // Makes sure the main thread has its block before trying to replace it.
+    Thread::spawn([]() {}).unwrap()->join();
+
+    ThreadLocalStorage *storage = thread_local_storage();
+
+    for (uintptr_t tls : BAD_TLS)
+    {
+        Assert::equal(hj_thread_tls(tls), ERR_BAD_ADDRESS);
+    }
+
+    // Had any reached the base register, reading through it would fault.
+    Assert::equal(thread_local_storage(), storage);
+    Assert::equal(storage->self, storage);
+}
+
+TEST(thread_create_with_tls_outside_user_memory_is_rejected)
+{
+    alignas(16) static uintptr_t stack[64];
+    uintptr_t stack_pointer = (uintptr_t)&stack[63];
+
+    for (uintptr_t tls : BAD_TLS)
+    {
+        int tid = -1;
+
+        Assert::equal(hj_thread_create((uintptr_t)never_started, stack_pointer, tls, &tid), ERR_BAD_ADDRESS);
+        Assert::equal(tid, -1);
+    }
+}
+
+TEST(condition_wakes_up_waiter)
+{
+    Lock lock{"condition"};
+    Condition condition;
+    bool ready = false;
+
+    auto thread = Thread::spawn([&]() {
+                      LockHolder holder{lock};
+                      ready = true;
+                      condition.signal();
+                  }).unwrap();
+
+    lock.acquire();
+
+    while (!ready)
+    {
+        condition.wait(lock);
+    }
+
+    lock.release();
+
+    Assert::is_true(ready);
+}
+
+TEST(thread_pool_runs_every_job)
+{
+    Async::ThreadPool pool{4};
+
+    Lock lock{"jobs"};
+    int done = 0;
+
+    for (int i = 0; i < 64; i++)
+    {
+        pool.submit([&]() {
+            LockHolder holder{lock};
+            done++;
+        });
+    }
+
+    pool.wait();
+
+    Assert::equal(done, 64);
+}
@@ -0,0 +1,44 @@
+#include <libterminal/Terminal.h>
+
+#include "tests/Driver.h"
+
+static void write(Terminal::Terminal &terminal, const char *text)
+{
+    terminal.write(text, strlen(text));
+}
+
+TEST(terminal_write_wraps_lines)
+{
+    Terminal::Terminal terminal{4, 2};
+
+    write(terminal, "abcdef");
+
+    Assert::equal(terminal.surface().at(3, 0).codepoint, U'd');
+    Assert::equal(terminal.surface().at(1, 1).codepoint, U'f');
+    Assert::equal(terminal.cursor().x, 2);
+    Assert::equal(terminal.cursor().y, 1);
+}
+
+TEST(terminal_escape_sequences_set_attributes)
+{
+    Terminal::Terminal terminal{8, 2};
+
+    write(terminal, "a\e[1;31mb\e[0mc");
+
+    Assert::is_false(terminal.surface().at(0, 0).attributes.bold);
+    Assert::is_true(terminal.surface().at(1, 0).attributes.bold);
+    Assert::equal((int)terminal.surface().at(1, 0).attributes.foreground, (int)Terminal::RED);
+    Assert::equal((int)terminal.surface().at(2, 0).attributes.foreground, (int)Terminal::FOREGROUND);
+}
+
+TEST(terminal_scrollback_keeps_history_up_to_its_limit)
+{
+    Terminal::Terminal terminal{8, 2, 3};
+
+    write(terminal, "1\n2\n3\n4\n5\n6");
+
+    Assert::equal(terminal.surface().scrollback(), 3);
+    Assert::equal(terminal.surface().at(0, -1).codepoint, U'4');
+    Assert::equal(terminal.surface().at(0, -3).codepoint, U'2');
+    Assert::equal(terminal.surface().at(0, 0).codepoint, U'5');
+}
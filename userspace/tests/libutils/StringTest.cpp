@@ -1,4 +1,6 @@
+#include <libutils/Intern.h>
 #include <libutils/String.h>
+#include <libutils/StringBuilder.h>
 
 #include "tests/Driver.h"
 
@@ -30,3 +32,47 @@ TEST(string_move_operator)
     Assert::equal(first, "second");
     Assert::equal(second, "first");
 }
+
+TEST(string_long_and_short_content)
+{
+    String small = "tiny";
+    String large = "this one does not fit inside the storage header";
+
+    Assert::equal(small.length(), 4);
+    Assert::equal(small, "tiny");
+    Assert::equal(large.length(), 47);
+    Assert::equal(large, "this one does not fit inside the storage header");
+}
+
+TEST(string_interned_are_shared)
+{
+    String first = intern("background", 10);
+    String second = intern(String{"background"});
+
+    Assert::is_true(first.interned());
+    Assert::equal(first.string_storage().naked(), second.string_storage().naked());
+    Assert::equal(first, second);
+    Assert::not_equal(first, intern("foreground", 10));
+    Assert::equal(first, "background");
+}
+
+TEST(string_builder_bulk_append)
+{
+    StringBuilder builder{};
+
+    for (int i = 0; i < 16; i++)
+    {
+        builder.append("0123456789", 10);
+    }
+
+    builder.append(String{"!"});
+
+    auto result = builder.finalize();
+
+    Assert::equal(result.length(), 161);
+    Assert::equal(result[150], '0');
+    Assert::equal(result[160], '!');
+
+    builder.append("again");
+    Assert::equal(builder.finalize(), "again");
+}
@@ -0,0 +1,88 @@
+#include <libutils/SmallVector.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#include "tests/Driver.h"
+
+TEST(vector_keeps_elements_when_growing)
+{
+    Vector<String> strings;
+
+    for (int i = 0; i < 100; i++)
+    {
+        strings.push_back(i % 2 ? "odd" : "a string way too long to be stored inline");
+    }
+
+    Assert::equal(strings.count(), 100);
+    Assert::equal(strings[0], "a string way too long to be stored inline");
+    Assert::equal(strings[99], "odd");
+}
+
+TEST(vector_insert_and_remove_in_the_middle)
+{
+    Vector<int> numbers;
+
+    for (int i = 0; i < 64; i++)
+    {
+        numbers.push_back(i);
+    }
+
+    numbers.insert(10, -1);
+    Assert::equal(numbers[10], -1);
+    Assert::equal(numbers[11], 10);
+    Assert::equal(numbers[64], 63);
+
+    numbers.remove_index(10);
+    Assert::equal(numbers[10], 10);
+
+    while (numbers.count() > 1)
+    {
+        numbers.remove_index(0);
+    }
+
+    Assert::equal(numbers[0], 63);
+}
+
+TEST(vector_push_back_many)
+{
+    Vector<uint8_t> bytes;
+    uint8_t data[] = {1, 2, 3, 4, 5};
+
+    for (int i = 0; i < 10; i++)
+    {
+        bytes.push_back_many(data, 5);
+    }
+
+    Assert::equal(bytes.count(), 50);
+    Assert::equal(bytes[47], 3);
+}
+
+TEST(small_vector_spills_to_the_heap)
+{
+    SmallVector<String, 4> strings;
+
+    for (int i = 0; i < 3; i++)
+    {
+        strings.push_back("inline");
+    }
+
+    SmallVector<String, 4> moved{move(strings)};
+
+    Assert::equal(moved.count(), 3);
+    Assert::equal(strings.count(), 0);
+
+    for (int i = 0; i < 8; i++)
+    {
+        moved.push_back("heap");
+    }
+
+    Vector<String> stolen{move(moved)};
+
+    Assert::equal(stolen.count(), 11);
+    Assert::equal(stolen[2], "inline");
+    Assert::equal(stolen[10], "heap");
+    Assert::equal(moved.count(), 0);
+
+    moved.push_back("again");
+    Assert::equal(moved[0], "again");
+}
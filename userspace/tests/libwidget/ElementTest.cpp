@@ -0,0 +1,77 @@
+#include <libwidget/Element.h>
+
+#include "tests/Driver.h"
+
+using namespace Widget;
+
+struct CountingElement : public Element
+{
+    int layouts = 0;
+
+    void do_layout() override
+    {
+        layouts++;
+        Element::do_layout();
+    }
+};
+
+TEST(element_relayout_skips_clean_subtrees)
+{
+    auto root = make<CountingElement>();
+    auto middle = make<CountingElement>();
+    auto leaf = make<CountingElement>();
+
+    root->layout(VFLOW(0));
+    middle->layout(VFLOW(0));
+    root->add(middle);
+    middle->add(leaf);
+
+    root->container({0, 0, 100, 100});
+    root->relayout();
+    root->relayout();
+
+    Assert::equal(root->layouts, 1);
+    Assert::equal(middle->layouts, 1);
+    Assert::equal(leaf->layouts, 1);
+}
+
+TEST(element_should_relayout_propagates_to_ancestors)
+{
+    auto root = make<CountingElement>();
+    auto middle = make<CountingElement>();
+    auto sibling = make<CountingElement>();
+    auto leaf = make<CountingElement>();
+
+    root->layout(STACK());
+    middle->layout(VFLOW(0));
+    root->add(middle);
+    root->add(sibling);
+    middle->add(leaf);
+
+    root->container({0, 0, 100, 100});
+    root->relayout();
+
+    leaf->min_height(10);
+    root->relayout();
+
+    Assert::equal(root->layouts, 2);
+    Assert::equal(middle->layouts, 2);
+    Assert::equal(leaf->layouts, 2);
+
+    // Stacked, the sibling's place didn't change so it's left alone.
+    Assert::equal(sibling->layouts, 1);
+}
+
+TEST(element_clear_lets_childs_be_added_again)
+{
+    auto first = make<Element>();
+    auto second = make<Element>();
+    auto child = make<Element>();
+
+    first->add(child);
+    first->clear();
+    second->add(child);
+
+    // Asserts the child knows its new parent.
+    second->del(child);
+}
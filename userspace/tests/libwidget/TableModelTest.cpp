@@ -0,0 +1,78 @@
+#include <libwidget/model/TableModel.h>
+
+#include "tests/Driver.h"
+
+using namespace Widget;
+
+// What a view sees each time it is notified.
+struct Notification
+{
+    bool everything;
+    int row;
+    int count;
+};
+
+struct Recorder
+{
+    Vector<Notification> notifications;
+    OwnPtr<Async::Observer<TableModel>> observer;
+
+    Recorder(TableModel &model)
+    {
+        observer = model.observe([this](TableModel &model) {
+            notifications.push_back({model.changed_everything(), model.changed_row(), model.changed_count()});
+        });
+    }
+};
+
+TEST(table_model_did_update_changes_everything)
+{
+    auto model = make<TableModel>();
+    Recorder recorder{*model};
+
+    model->did_update();
+
+    Assert::equal(recorder.notifications.count(), 1);
+    Assert::is_true(recorder.notifications[0].everything);
+}
+
+TEST(table_model_did_update_through_the_observable_changes_everything)
+{
+    auto model = make<TableModel>();
+    Recorder recorder{*model};
+
+    model->did_update_rows(3, 2);
+
+    Async::Observable<TableModel> &observable = *model;
+    observable.did_update();
+
+    Assert::equal(recorder.notifications.count(), 2);
+    Assert::is_true(recorder.notifications[1].everything);
+}
+
+TEST(table_model_did_update_rows_reports_the_rows)
+{
+    auto model = make<TableModel>();
+    Recorder recorder{*model};
+
+    model->did_update_rows(3, 2);
+
+    Assert::equal(recorder.notifications.count(), 1);
+    Assert::is_false(recorder.notifications[0].everything);
+    Assert::equal(recorder.notifications[0].row, 3);
+    Assert::equal(recorder.notifications[0].count, 2);
+
+    // Outside of a notification the model doesn't claim anything specific.
+    Assert::is_true(model->changed_everything());
+}
+
+TEST(table_model_did_update_rows_ignores_empty_ranges)
+{
+    auto model = make<TableModel>();
+    Recorder recorder{*model};
+
+    model->did_update_rows(3, 0);
+    model->did_update_rows(3, -1);
+
+    Assert::equal(recorder.notifications.count(), 0);
+}
@@ -0,0 +1,134 @@
+#include <libwidget/model/TextModel.h>
+
+#include "tests/Driver.h"
+
+using namespace Widget;
+
+static void type(TextModel &model, TextCursor &cursor, const char *text)
+{
+    for (size_t i = 0; text[i]; i++)
+    {
+        if (text[i] == '\n')
+        {
+            model.newline_at(cursor);
+        }
+        else
+        {
+            model.append_at(cursor, text[i]);
+        }
+    }
+}
+
+TEST(text_model_insert)
+{
+    auto model = TextModel::empty();
+    TextCursor cursor;
+
+    type(*model, cursor, "hello\nworld");
+
+    Assert::equal(model->line_count(), 2);
+    Assert::equal(model->string(), "hello\nworld");
+    Assert::equal(cursor.line(), 1);
+    Assert::equal(cursor.column(), 5);
+
+    cursor.move_to(*model, 0, 2);
+    type(*model, cursor, "--");
+
+    Assert::equal(model->string(), "he--llo\nworld");
+}
+
+TEST(text_model_delete)
+{
+    auto model = TextModel::empty();
+    TextCursor cursor;
+
+    type(*model, cursor, "abc\ndef");
+
+    model->backspace_at(cursor);
+    Assert::equal(model->string(), "abc\nde");
+
+    cursor.move_to(*model, 1, 0);
+    model->backspace_at(cursor);
+    Assert::equal(model->string(), "abcde");
+    Assert::equal(cursor.line(), 0);
+    Assert::equal(cursor.column(), 3);
+
+    cursor.move_to(*model, 0, 0);
+    model->delete_at(cursor);
+    Assert::equal(model->string(), "bcde");
+}
+
+TEST(text_model_undo_redo)
+{
+    auto model = TextModel::empty();
+    TextCursor cursor;
+
+    type(*model, cursor, "one\ntwo");
+    model->backspace_at(cursor);
+
+    Assert::equal(model->string(), "one\ntw");
+
+    model->undo(cursor);
+    Assert::equal(model->string(), "one\ntwo");
+
+    // Consecutive typing on a line is undone at once.
+    model->undo(cursor);
+    Assert::equal(model->string(), "one\n");
+
+    model->undo(cursor);
+    Assert::equal(model->string(), "one");
+
+    model->redo(cursor);
+    model->redo(cursor);
+    Assert::equal(model->string(), "one\ntwo");
+    Assert::equal(cursor.line(), 1);
+    Assert::equal(cursor.column(), 3);
+
+    Assert::is_true(model->can_redo());
+    type(*model, cursor, "!");
+    Assert::is_false(model->can_redo());
+}
+
+TEST(text_model_move_line_up)
+{
+    auto model = TextModel::empty();
+    TextCursor cursor;
+
+    type(*model, cursor, "a\nb\nc");
+    cursor.move_to(*model, 2, 1);
+
+    model->move_line_up_at(cursor);
+    Assert::equal(model->string(), "a\nc\nb");
+    Assert::equal(cursor.line(), 1);
+
+    model->undo(cursor);
+    Assert::equal(model->string(), "a\nb\nc");
+    Assert::equal(cursor.line(), 2);
+
+    model->redo(cursor);
+    Assert::equal(model->string(), "a\nc\nb");
+    Assert::equal(cursor.line(), 1);
+    Assert::equal(cursor.column(), 1);
+}
+
+TEST(text_model_move_line_down)
+{
+    auto model = TextModel::empty();
+    TextCursor cursor;
+
+    type(*model, cursor, "a\nb\nc");
+    cursor.move_to(*model, 0, 1);
+
+    model->move_line_down_at(cursor);
+    Assert::equal(model->string(), "b\na\nc");
+    Assert::equal(cursor.line(), 1);
+
+    model->undo(cursor);
+    Assert::equal(model->string(), "a\nb\nc");
+    Assert::equal(cursor.line(), 0);
+
+    model->redo(cursor);
+    Assert::equal(model->string(), "b\na\nc");
+    Assert::equal(cursor.line(), 1);
+    Assert::equal(cursor.column(), 1);
+}
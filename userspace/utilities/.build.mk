@@ -20,16 +20,22 @@ UTILITIES = \
 	LS \
 	MKDIR \
 	MV \
+	NETBENCH \
 	NETCTL\
 	NOW \
 	OPEN \
+	OPENBENCH \
 	PANIC \
+	PARALLELBENCH \
 	PIANO \
 	PLAY \
+	POLLBENCH \
 	POWERCTL \
+	PROFILE \
 	PWD	\
 	RMDIR \
 	SETTINGSCTL \
+	STRACE \
 	SYSFETCH \
 	TAC \
 	TOUCH \
@@ -38,6 +44,7 @@ UTILITIES = \
 	UNLINK \
 	UNZIP \
 	UPTIME \
+	WIDGETBENCH \
 	YES \
 	ZIP
 
@@ -149,22 +156,43 @@ DISPLAYCTL_NAME = displayctl
 KEYBOARDCTL_LIBS = system io
 KEYBOARDCTL_NAME = keyboardctl
 
+NETBENCH_LIBS = system io
+NETBENCH_NAME = netbench
+
+OPENBENCH_LIBS = system io
+OPENBENCH_NAME = openbench
+
+PARALLELBENCH_LIBS = async system io
+PARALLELBENCH_NAME = parallelbench
+
+POLLBENCH_LIBS = system io
+POLLBENCH_NAME = pollbench
+
+WIDGETBENCH_LIBS = widget settings graphic async xml system io compression
+WIDGETBENCH_NAME = widgetbench
+
 NETCTL_LIBS = system io
 NETCTL_NAME = netctl
 
 POWERCTL_LIBS = system io
 POWERCTL_NAME = powerctl
 
+PROFILE_LIBS = system io
+PROFILE_NAME = profile
+
 SETTINGSCTL_LIBS = settings async system io
 SETTINGSCTL_NAME = settingsctl
 
-WALLPAPERCTL_LIBS = graphic system io
+STRACE_LIBS = system io
+STRACE_NAME = strace
+
+WALLPAPERCTL_LIBS = graphic async system io
 WALLPAPERCTL_NAME = wallpaperctl
 
-ZIP_LIBS = file system io compression
+ZIP_LIBS = file async system io compression
 ZIP_NAME = zip
 
-UNZIP_LIBS = file system io compression
+UNZIP_LIBS = file async system io compression
 UNZIP_NAME = unzip
 
 define UTIL_TEMPLATE =
@@ -1,3 +1,4 @@
+#include <abi/Network.h>
 #include <abi/Syscalls.h>
 #include <skift/Environment.h>
 
@@ -18,12 +19,21 @@ void start_service(const char *command, const char *socket)
     }
 }
 
+void start_network()
+{
+    if (filesystem_exist(NETWORK_DEVICE_PATH, FILE_TYPE_DEVICE))
+    {
+        start_service("network-service", NETWORK_SERVICE_PATH);
+    }
+}
+
 void start_desktop()
 {
     int splash_screen_pid;
     process_run("splash-screen", &splash_screen_pid, 0);
 
     start_service("settings-service", "/Session/settings.ipc");
+    start_network();
     start_service("compositor", "/Session/compositor.ipc");
     process_run("panel", nullptr, 0);
 
@@ -44,7 +54,7 @@ void start_desktop()
 void start_test()
 {
     int test_pid;
-    process_run("tests", &test_pid, TASK_WAITABLE);
+    process_run(__CONFIG_PROFILE__ ? "profile tests" : "tests", &test_pid, TASK_WAITABLE);
     int test_result;
     process_wait(test_pid, &test_result);
     hj_system_shutdown();
@@ -52,6 +62,8 @@ void start_test()
 
 void start_headless()
 {
+    start_network();
+
     int shell_pid = -1;
     process_run("shell", &shell_pid, TASK_WAITABLE);
     process_wait(shell_pid, nullptr);
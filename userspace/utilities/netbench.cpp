@@ -0,0 +1,138 @@
+#include <libio/Socket.h>
+#include <libio/Streams.h>
+#include <libnet/Address.h>
+#include <libsystem/system/System.h>
+#include <libutils/ArgParse.h>
+#include <libutils/NumberParser.h>
+
+static int option_megabytes = 16;
+
+// Two chunks stay in flight, one going out while the other comes back.
+static constexpr size_t IN_FLIGHT = 2;
+
+static uint8_t pattern(size_t offset)
+{
+    return (offset * 7 + offset / 251) & 0xff;
+}
+
+Result netbench(NetworkEndpoint remote, size_t total)
+{
+    auto socket = TRY(IO::TcpSocket::connect(remote));
+
+    static uint8_t chunk[NETWORK_SERVICE_CHUNK];
+    static uint8_t echo[NETWORK_SERVICE_CHUNK];
+
+    size_t written = 0;
+    size_t received = 0;
+
+    auto write_chunk = [&]() -> Result {
+        size_t size = MIN(total - written, NETWORK_SERVICE_CHUNK);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            chunk[i] = pattern(written + i);
+        }
+
+        TRY(socket.write(chunk, size));
+        written += size;
+
+        return SUCCESS;
+    };
+
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t i = 0; i < IN_FLIGHT && written < total; i++)
+    {
+        TRY(write_chunk());
+    }
+
+    while (received < total)
+    {
+        size_t read = TRY(socket.read(echo, MIN(total - received, NETWORK_SERVICE_CHUNK)));
+
+        if (read == 0)
+        {
+            IO::errln("netbench: The server closed the connection after {} bytes", received);
+            return ERR_STREAM_CLOSED;
+        }
+
+        for (size_t i = 0; i < read; i++)
+        {
+            if (echo[i] != pattern(received + i))
+            {
+                IO::errln("netbench: The echo differs at byte {}", received + i);
+                return ERR_INVALID_DATA;
+            }
+        }
+
+        received += read;
+
+        while (written < total && written - received < IN_FLIGHT * NETWORK_SERVICE_CHUNK)
+        {
+            TRY(write_chunk());
+        }
+    }
+
+    uint64_t elapsed = system_get_monotonic_time() - start;
+    uint64_t milliseconds = MAX(elapsed / 1000000, 1);
+
+    IO::outln("{} KiB echoed in {} ms, {} KiB/s", total / 1024, milliseconds, total / 1024 * 1000 / milliseconds);
+
+    socket.close();
+
+    return SUCCESS;
+}
+
+int main(int argc, const char *argv[])
+{
+    ArgParse args;
+
+    args.show_help_if_no_operand_given();
+    args.should_abort_on_failure();
+
+    args.usage("ADDRESS PORT");
+    args.usage("[OPTION]... ADDRESS PORT");
+
+    args.prologue("Send data to a TCP echo server and measure how fast it comes back.");
+
+    args.option_int(
+        's',
+        "size",
+        "Number of MiB to send, 16 by default.",
+        [](int value) {
+            option_megabytes = value;
+            return ArgParseResult::SHOULD_CONTINUE;
+        });
+
+    args.epiloge("From QEMU's user mode networking, the host is 10.0.2.2 (see meta/utils/echo-server.py).");
+
+    auto parse_result = args.eval(argc, argv);
+    if (parse_result != ArgParseResult::SHOULD_CONTINUE)
+    {
+        return parse_result == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    if (args.argc() != 2)
+    {
+        return args.usage() == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    auto address = Net::parse_ipv4(args.argv()[0].cstring());
+    int port = parse_uint_inline(PARSER_DECIMAL, args.argv()[1].cstring(), -1);
+
+    if (!address.present() || port <= 0 || port > 0xffff || option_megabytes <= 0)
+    {
+        IO::errln("netbench: Invalid address, port or size");
+        return PROCESS_FAILURE;
+    }
+
+    auto result = netbench({address.unwrap(), (uint16_t)port}, (size_t)option_megabytes * 1024 * 1024);
+
+    if (result != SUCCESS)
+    {
+        IO::errln("netbench: {}", get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
@@ -3,6 +3,17 @@
 #include <libio/File.h>
 #include <libio/Streams.h>
 
+void print_queue_stats(const char *name, const NetworkQueueStats &stats)
+{
+    IO::outln("{}: {} packets, {} bytes, {} dropped, {} per batch on average, {} at most",
+              name,
+              stats.packets,
+              stats.bytes,
+              stats.drops,
+              stats.batches > 0 ? stats.packets / stats.batches : 0,
+              stats.largest_batch);
+}
+
 int main(int argc, char **argv)
 {
     UNUSED(argc);
@@ -25,5 +36,16 @@ int main(int argc, char **argv)
                   state.mac_address[5]);
     }
 
+    if (argc == 2 && strcmp(argv[1], "-s") == 0)
+    {
+        IOCallNetworkStatsArgs stats = {};
+
+        network_device.handle()->call(IOCALL_NETWORK_GET_STATS, &stats);
+
+        print_queue_stats("RX", stats.rx);
+        print_queue_stats("TX", stats.tx);
+        IO::outln("Interrupts: {}", stats.interrupts);
+    }
+
     return 0;
 }
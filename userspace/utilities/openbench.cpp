@@ -0,0 +1,92 @@
+#include <abi/Syscalls.h>
+
+#include <libio/Streams.h>
+#include <libsystem/system/System.h>
+#include <libutils/ArgParse.h>
+#include <string.h>
+
+// The path cache and the directory index live in the kernel, which can't be
+// built on the host, so this runs on the target and goes through the syscalls
+// like any program opening files would.
+static constexpr size_t ROUNDS = 10000;
+
+struct OpenCase
+{
+    const char *name;
+    const char *path;
+    OpenFlag flags;
+};
+
+static constexpr OpenCase CASES[] = {
+    {"open_file", "/Files/Fonts/sans.png", OPEN_READ},
+    {"open_in_large_directory", "/System/Utilities/openbench", OPEN_READ},
+    {"open_directory", "/System/Utilities", OPEN_READ | OPEN_DIRECTORY},
+    {"open_missing", "/Files/Fonts/missing.png", OPEN_READ},
+};
+
+static void bench(const OpenCase &open_case)
+{
+    size_t length = strlen(open_case.path);
+    Result expected = SUCCESS;
+    size_t failures = 0;
+
+    // Once to know what to expect, and to fill the cache like any earlier
+    // open of the same path would have.
+    int handle = -1;
+    expected = hj_handle_open(&handle, open_case.path, length, open_case.flags);
+
+    if (expected == SUCCESS)
+    {
+        hj_handle_close(handle);
+    }
+
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        Result result = hj_handle_open(&handle, open_case.path, length, open_case.flags);
+
+        if (result == SUCCESS)
+        {
+            hj_handle_close(handle);
+        }
+
+        if (result != expected)
+        {
+            failures++;
+        }
+    }
+
+    uint64_t elapsed = system_get_monotonic_time() - start;
+
+    IO::outln("{}: {} ns per open and close ({})", open_case.name, elapsed / ROUNDS, get_result_description(expected));
+
+    if (failures)
+    {
+        IO::errln("openbench: {} opens of {} didn't return the same result", failures, open_case.path);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    ArgParse args;
+
+    args.should_abort_on_failure();
+
+    args.usage("");
+
+    args.prologue("Measure how long opening and closing a path takes, for files, directories and missing paths.");
+
+    auto parse_result = args.eval(argc, argv);
+    if (parse_result != ArgParseResult::SHOULD_CONTINUE)
+    {
+        return parse_result == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    for (auto &open_case : CASES)
+    {
+        bench(open_case);
+    }
+
+    return PROCESS_SUCCESS;
+}
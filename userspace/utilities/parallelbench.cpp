@@ -0,0 +1,128 @@
+#include <libasync/Parallel.h>
+#include <libio/Streams.h>
+#include <libsystem/system/System.h>
+#include <libutils/ArgParse.h>
+
+static constexpr size_t ROUNDS = 10;
+static constexpr size_t WORKERS[] = {1, 2, 4, 8};
+
+/* --- Workloads ------------------------------------------------------------ */
+
+static constexpr size_t MANDELBROT_WIDTH = 640;
+static constexpr size_t MANDELBROT_HEIGHT = 480;
+
+static uint8_t mandelbrot_pixels[MANDELBROT_WIDTH * MANDELBROT_HEIGHT];
+
+// Rows through the set cost a lot more than the ones around it, so the work
+// is uneven and idle workers have to steal to keep up.
+static void mandelbrot(Async::Runtime &runtime)
+{
+    auto rows = [](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++)
+        {
+            for (size_t x = 0; x < MANDELBROT_WIDTH; x++)
+            {
+                double cr = x * 3.0 / MANDELBROT_WIDTH - 2.0;
+                double ci = y * 2.0 / MANDELBROT_HEIGHT - 1.0;
+                double zr = 0;
+                double zi = 0;
+
+                int iteration = 0;
+
+                while (iteration < 255 && zr * zr + zi * zi < 4)
+                {
+                    double t = zr * zr - zi * zi + cr;
+                    zi = 2 * zr * zi + ci;
+                    zr = t;
+                    iteration++;
+                }
+
+                mandelbrot_pixels[y * MANDELBROT_WIDTH + x] = iteration;
+            }
+        }
+    };
+
+    Async::parallel_for(0, MANDELBROT_HEIGHT, 4, move(rows), runtime);
+}
+
+static constexpr size_t SMALL_JOBS_COUNT = 1 << 20;
+
+static uint32_t small_jobs_values[SMALL_JOBS_COUNT];
+
+// Lots of pieces doing next to nothing, mostly what splitting, scheduling and
+// stealing cost.
+static void small_jobs(Async::Runtime &runtime)
+{
+    auto values = [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            small_jobs_values[i] = i * 2654435761u;
+        }
+    };
+
+    Async::parallel_for(0, SMALL_JOBS_COUNT, 256, move(values), runtime);
+}
+
+/* --- Driver --------------------------------------------------------------- */
+
+static uint64_t measure(Async::Runtime &runtime, void (*workload)(Async::Runtime &))
+{
+    // Once to wake the workers up and fault the pages in.
+    workload(runtime);
+
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        workload(runtime);
+    }
+
+    return (system_get_monotonic_time() - start) / ROUNDS;
+}
+
+static void bench(const char *name, void (*workload)(Async::Runtime &))
+{
+    uint64_t baseline = 0;
+
+    for (size_t workers : WORKERS)
+    {
+        Async::Runtime runtime{workers};
+
+        if (runtime.workers() != workers)
+        {
+            IO::errln("parallelbench: only {} of {} workers started", runtime.workers(), workers);
+            continue;
+        }
+
+        uint64_t elapsed = measure(runtime, workload);
+
+        if (baseline == 0)
+        {
+            baseline = elapsed;
+        }
+
+        IO::outln("{} with {} workers: {} ns per round, {}.{}x", name, workers, elapsed, baseline / elapsed, (baseline * 10 / elapsed) % 10);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    ArgParse args;
+
+    args.should_abort_on_failure();
+
+    args.usage("");
+
+    args.prologue("Measure how the parallel runtime scales from 1 to 8 workers.");
+
+    auto parse_result = args.eval(argc, argv);
+    if (parse_result != ArgParseResult::SHOULD_CONTINUE)
+    {
+        return parse_result == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    bench("mandelbrot", mandelbrot);
+    bench("small_jobs", small_jobs);
+
+    return PROCESS_SUCCESS;
+}
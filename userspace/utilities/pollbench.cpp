@@ -0,0 +1,196 @@
+#include <abi/Syscalls.h>
+
+#include <libio/Streams.h>
+#include <libsystem/system/System.h>
+#include <libutils/ArgParse.h>
+
+static constexpr size_t HANDLES = 100;
+static constexpr size_t ROUNDS = 10000;
+
+// How many events a wait takes at most, less than the number of handles so
+// the queue has to pick.
+static constexpr size_t CAPACITY = 16;
+
+// A process only has PROCESS_HANDLE_COUNT handles, so one pipe does the
+// work and the idle handles are all reopened from a second one.
+static int readers[HANDLES];
+static int active_writer;
+static int idle_writer;
+
+static void wake(int writer)
+{
+    char byte = 0;
+    size_t written = 0;
+    hj_handle_write(writer, &byte, 1, &written);
+}
+
+static void drain(int handle)
+{
+    char byte = 0;
+    size_t read = 0;
+    hj_handle_read(handle, &byte, 1, &read);
+}
+
+static void report(const char *name, uint64_t elapsed)
+{
+    IO::outln("{}: {} ns per wakeup", name, elapsed / ROUNDS);
+}
+
+// Every round the first handle becomes ready while the others stay idle, what
+// an Async::Loop with many connections spends most of its time doing.
+static Result bench_handle_poll()
+{
+    static HandlePoll polls[HANDLES];
+
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        wake(active_writer);
+
+        for (size_t i = 0; i < HANDLES; i++)
+        {
+            polls[i] = {readers[i], POLL_READ, 0};
+        }
+
+        TRY(hj_handle_poll(polls, HANDLES, -1));
+
+        for (size_t i = 0; i < HANDLES; i++)
+        {
+            if (polls[i].result & POLL_READ)
+            {
+                drain(polls[i].handle);
+            }
+        }
+    }
+
+    report("hj_handle_poll", system_get_monotonic_time() - start);
+
+    return SUCCESS;
+}
+
+static Result bench_event_queue(int queue)
+{
+    HandlePoll events[CAPACITY];
+
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        wake(active_writer);
+
+        size_t count = 0;
+        TRY(hj_event_queue_wait(queue, events, CAPACITY, &count, -1));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            drain(events[i].handle);
+        }
+    }
+
+    report("hj_event_queue_wait", system_get_monotonic_time() - start);
+
+    return SUCCESS;
+}
+
+// With every handle ready and only room for some of them per wait, each one
+// should still come up within a few waits.
+static Result check_fairness(int queue)
+{
+    wake(active_writer);
+    wake(idle_writer);
+
+    bool seen[HANDLES] = {};
+    size_t seen_count = 0;
+    size_t waits = 0;
+
+    HandlePoll events[CAPACITY];
+
+    while (seen_count < HANDLES && waits < HANDLES)
+    {
+        size_t count = 0;
+        TRY(hj_event_queue_wait(queue, events, CAPACITY, &count, -1));
+        waits++;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            for (size_t j = 0; j < HANDLES; j++)
+            {
+                if (readers[j] == events[i].handle && !seen[j])
+                {
+                    seen[j] = true;
+                    seen_count++;
+                }
+            }
+        }
+    }
+
+    IO::outln("{} of {} always ready handles reported in {} waits", seen_count, HANDLES, waits);
+
+    drain(readers[0]);
+    drain(readers[1]);
+
+    return seen_count == HANDLES ? SUCCESS : TIMEOUT;
+}
+
+Result pollbench()
+{
+    TRY(hj_create_pipe(&readers[0], &active_writer));
+    TRY(hj_create_pipe(&readers[1], &idle_writer));
+
+    for (size_t i = 2; i < HANDLES; i++)
+    {
+        TRY(hj_handle_reopen(readers[1], &readers[i]));
+    }
+
+    int queue;
+    TRY(hj_create_event_queue(&queue));
+
+    for (size_t i = 0; i < HANDLES; i++)
+    {
+        TRY(hj_event_queue_update(queue, readers[i], POLL_READ));
+    }
+
+    TRY(bench_handle_poll());
+    TRY(bench_event_queue(queue));
+    TRY(check_fairness(queue));
+
+    hj_handle_close(queue);
+
+    for (size_t i = 0; i < HANDLES; i++)
+    {
+        hj_handle_close(readers[i]);
+    }
+
+    hj_handle_close(active_writer);
+    hj_handle_close(idle_writer);
+
+    return SUCCESS;
+}
+
+int main(int argc, const char *argv[])
+{
+    ArgParse args;
+
+    args.should_abort_on_failure();
+
+    args.usage("");
+
+    args.prologue("Measure how long waiting on 100 mostly idle handles takes, with hj_handle_poll and with an event queue.");
+
+    auto parse_result = args.eval(argc, argv);
+    if (parse_result != ArgParseResult::SHOULD_CONTINUE)
+    {
+        return parse_result == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    auto result = pollbench();
+
+    if (result != SUCCESS)
+    {
+        IO::errln("pollbench: {}", get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
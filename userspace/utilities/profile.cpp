@@ -0,0 +1,130 @@
+#include <abi/Paths.h>
+#include <abi/Profiler.h>
+
+#include <libio/BufLine.h>
+#include <libio/File.h>
+#include <libio/Streams.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/thread/Thread.h>
+#include <libutils/NumberFormat.h>
+#include <libutils/StringBuilder.h>
+
+// Runs a command with the kernel sampling every timer tick and dumps the
+// samples to the system log, one per line:
+//
+//   profile: <task id> <task name> <kernel frames> <user frames> <hex frames...>
+//
+// meta/utils/profile-symbolize.py turns them back into stacks on the host.
+
+static bool _profiling = true;
+
+static size_t drain(IO::File &device)
+{
+    size_t total = 0;
+    ProfilerSample samples[32];
+
+    while (true)
+    {
+        auto read_or_result = device.read(samples, sizeof(samples));
+
+        if (!read_or_result.success() || read_or_result.unwrap() == 0)
+        {
+            return total;
+        }
+
+        size_t count = read_or_result.unwrap() / sizeof(ProfilerSample);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            auto &sample = samples[i];
+
+            IO::BufLine line{IO::log()};
+
+            IO::print(line, "profile: {} {} {} {}", sample.task, sample.name, sample.kernel_frames, sample.user_frames);
+
+            for (size_t j = 0; j < (size_t)(sample.kernel_frames + sample.user_frames); j++)
+            {
+                IO::write(line, ' ');
+                NumberFormat::hexadecimal().format(line, (uint64_t)sample.frames[j]);
+            }
+
+            IO::write(line, '\n');
+        }
+
+        total += count;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        IO::errln("Usage: profile COMMAND [ARGS...]");
+        return PROCESS_FAILURE;
+    }
+
+    IO::File device{PROFILER_DEVICE_PATH, OPEN_READ};
+
+    if (!device.exist())
+    {
+        IO::errln("profile: The kernel doesn't expose a profiler at " PROFILER_DEVICE_PATH);
+        return PROCESS_FAILURE;
+    }
+
+    StringBuilder command;
+
+    for (int i = 1; i < argc; i++)
+    {
+        command.append(argv[i]);
+
+        if (i + 1 < argc)
+        {
+            command.append(' ');
+        }
+    }
+
+    size_t samples = 0;
+
+    // The ring in the kernel only holds a few seconds worth of samples, it is
+    // emptied in the background while the command runs.
+    auto drainer_or_result = Thread::spawn([&]() {
+        while (__atomic_load_n(&_profiling, __ATOMIC_ACQUIRE))
+        {
+            samples += drain(device);
+            process_sleep(100);
+        }
+    });
+
+    device.handle()->call(IOCALL_PROFILER_START, nullptr);
+
+    int pid = -1;
+    int exit_value = PROCESS_FAILURE;
+
+    auto result = process_run(command.finalize().cstring(), &pid, TASK_WAITABLE);
+
+    if (result == SUCCESS)
+    {
+        process_wait(pid, &exit_value);
+    }
+
+    device.handle()->call(IOCALL_PROFILER_STOP, nullptr);
+
+    __atomic_store_n(&_profiling, false, __ATOMIC_RELEASE);
+
+    if (drainer_or_result.success())
+    {
+        drainer_or_result.unwrap()->join();
+    }
+
+    samples += drain(device);
+
+    if (result != SUCCESS)
+    {
+        IO::errln("profile: Failed to run the command: {}", get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    IO::logln("profile: done, {} samples", samples);
+
+    return exit_value;
+}
@@ -0,0 +1,262 @@
+#include <abi/Paths.h>
+#include <abi/Syscalls.h>
+
+#include <libio/File.h>
+#include <libio/Streams.h>
+#include <libjson/Json.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/thread/Thread.h>
+#include <libutils/NumberFormat.h>
+#include <libutils/StringBuilder.h>
+#include <libutils/Vector.h>
+
+#include <string.h>
+
+#define SYSCALL_NAMES_ENTRY(__entry) #__entry,
+static const char *syscall_names[] = {SYSCALL_LIST(SYSCALL_NAMES_ENTRY)};
+
+static bool _tracing = true;
+
+/* --- Tracing -------------------------------------------------------------- */
+
+static void print_event(SyscallTraceEvent &event)
+{
+    IO::err("[{}] {}(", event.task, syscall_names[event.syscall]);
+
+    for (size_t i = 0; i < 5; i++)
+    {
+        IO::err(i == 0 ? "0x" : ", 0x");
+        NumberFormat::hexadecimal().format(IO::err(), (uint64_t)event.arguments[i]);
+    }
+
+    IO::errln(") = {} <{}us>", result_to_string(event.result), (event.exit - event.entry) / 1000);
+}
+
+static void drain(IO::File &device)
+{
+    SyscallTraceEvent events[64];
+
+    while (true)
+    {
+        auto read_or_result = device.read(events, sizeof(events));
+
+        if (!read_or_result.success() || read_or_result.unwrap() == 0)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < read_or_result.unwrap() / sizeof(SyscallTraceEvent); i++)
+        {
+            print_event(events[i]);
+        }
+    }
+}
+
+/* --- Statistics ----------------------------------------------------------- */
+
+struct SyscallSummary
+{
+    String name;
+    uint64_t count;
+    uint64_t total;
+    uint64_t histogram[SYSCALL_HISTOGRAM_BUCKETS];
+};
+
+static Vector<SyscallSummary> load_stats()
+{
+    Vector<SyscallSummary> summaries;
+
+    IO::File file{"/System/syscalls", OPEN_READ};
+
+    if (!file.exist())
+    {
+        return summaries;
+    }
+
+    auto root = Json::parse(file);
+
+    for (size_t i = 0; i < root.length(); i++)
+    {
+        auto &syscall = root.get(i);
+
+        SyscallSummary summary{
+            syscall.get("name").as_string(),
+            (uint64_t)syscall.get("count").as_integer(),
+            (uint64_t)syscall.get("total").as_integer(),
+            {},
+        };
+
+        auto &histogram = syscall.get("histogram");
+
+        for (size_t bucket = 0; bucket < SYSCALL_HISTOGRAM_BUCKETS && bucket < histogram.length(); bucket++)
+        {
+            summary.histogram[bucket] = histogram.get(bucket).as_integer();
+        }
+
+        summaries.push_back(summary);
+    }
+
+    return summaries;
+}
+
+// The smallest latency under which at least `percent` of the calls returned.
+static uint64_t percentile(SyscallSummary &summary, uint64_t percent)
+{
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < SYSCALL_HISTOGRAM_BUCKETS; bucket++)
+    {
+        seen += summary.histogram[bucket];
+
+        if (seen * 100 >= summary.count * percent)
+        {
+            return syscall_histogram_limit(bucket);
+        }
+    }
+
+    return syscall_histogram_limit(SYSCALL_HISTOGRAM_BUCKETS - 1);
+}
+
+static void column(String text, size_t width, bool right = true)
+{
+    for (size_t i = text.length(); right && i < width; i++)
+    {
+        IO::err(" ");
+    }
+
+    IO::err("{}", text);
+
+    for (size_t i = text.length(); !right && i < width; i++)
+    {
+        IO::err(" ");
+    }
+}
+
+// The counters are system wide, what the command did is the difference
+// between before and after it ran.
+static void print_summary(Vector<SyscallSummary> &before, Vector<SyscallSummary> &after)
+{
+    column("syscall", 24, false);
+    column("calls", 10);
+    column("total us", 12);
+    column("avg us", 10);
+    column("p50 us <", 10);
+    column("p99 us <", 10);
+    IO::errln("");
+
+    for (size_t i = 0; i < after.count() && i < before.count(); i++)
+    {
+        SyscallSummary delta = after[i];
+
+        delta.count -= before[i].count;
+        delta.total -= before[i].total;
+
+        for (size_t bucket = 0; bucket < SYSCALL_HISTOGRAM_BUCKETS; bucket++)
+        {
+            delta.histogram[bucket] -= before[i].histogram[bucket];
+        }
+
+        if (delta.count == 0)
+        {
+            continue;
+        }
+
+        column(delta.name, 24, false);
+        column(IO::format("{}", delta.count), 10);
+        column(IO::format("{}", delta.total / 1000), 12);
+        column(IO::format("{}", delta.total / delta.count / 1000), 10);
+        column(IO::format("{}", percentile(delta, 50) / 1000), 10);
+        column(IO::format("{}", percentile(delta, 99) / 1000), 10);
+        IO::errln("");
+    }
+}
+
+/* --- Main ----------------------------------------------------------------- */
+
+int main(int argc, char const *argv[])
+{
+    bool summary = argc > 1 && strcmp(argv[1], "-c") == 0;
+    int first = summary ? 2 : 1;
+
+    if (argc <= first)
+    {
+        IO::errln("Usage: strace [-c] COMMAND [ARGS...]");
+        IO::errln("Print the syscalls made by the command, or with -c, how many and how long they took.");
+        return PROCESS_FAILURE;
+    }
+
+    StringBuilder command;
+
+    for (int i = first; i < argc; i++)
+    {
+        command.append(argv[i]);
+
+        if (i + 1 < argc)
+        {
+            command.append(' ');
+        }
+    }
+
+    auto before = load_stats();
+
+    IO::File device{TRACE_DEVICE_PATH, OPEN_READ};
+    OwnPtr<Thread> drainer;
+
+    if (!summary)
+    {
+        if (!device.exist())
+        {
+            IO::errln("strace: The kernel doesn't expose syscall traces at " TRACE_DEVICE_PATH);
+            return PROCESS_FAILURE;
+        }
+
+        auto drainer_or_result = Thread::spawn([&]() {
+            while (__atomic_load_n(&_tracing, __ATOMIC_ACQUIRE))
+            {
+                drain(device);
+                process_sleep(50);
+            }
+        });
+
+        if (drainer_or_result.success())
+        {
+            drainer = drainer_or_result.unwrap();
+        }
+    }
+
+    int pid = -1;
+    int exit_value = PROCESS_FAILURE;
+
+    auto result = process_run(command.finalize().cstring(), &pid, TASK_WAITABLE | (summary ? 0 : TASK_TRACED));
+
+    if (result == SUCCESS)
+    {
+        process_wait(pid, &exit_value);
+    }
+
+    __atomic_store_n(&_tracing, false, __ATOMIC_RELEASE);
+
+    if (drainer)
+    {
+        drainer->join();
+    }
+
+    if (!summary)
+    {
+        drain(device);
+    }
+
+    if (result != SUCCESS)
+    {
+        IO::errln("strace: Failed to run the command: {}", get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    if (summary)
+    {
+        auto after = load_stats();
+        print_summary(before, after);
+    }
+
+    return exit_value;
+}
@@ -43,21 +43,21 @@ int main(int argc, char const *argv[])
             return Iteration::STOP;
         }
 
-        unsigned int i = 0;
         for (const auto &entry : archive->entries())
         {
             IO::outln("{}: Entry: {} is being extracted...", argv[0], entry.name);
-            IO::File dest_file(entry.name, OPEN_WRITE | OPEN_CREATE);
+        }
 
-            auto result = archive->extract(i, dest_file);
-            if (result != Result::SUCCESS)
-            {
-                IO::errln("{}: Failed to extract entry '{}' with error '{}'", argv[0], entry.name, get_result_description(result));
-                process_exit(PROCESS_FAILURE);
-            }
+        auto result = archive->extract_all([](const Archive::Entry &entry) -> OwnPtr<IO::Writer> {
+            return own<IO::File>(entry.name, OPEN_WRITE | OPEN_CREATE);
+        });
 
-            i++;
+        if (result != Result::SUCCESS)
+        {
+            IO::errln("{}: Failed to extract '{}' with error '{}'", argv[0], path, get_result_description(result));
+            process_exit(PROCESS_FAILURE);
         }
+
         return Iteration::CONTINUE;
     });
 
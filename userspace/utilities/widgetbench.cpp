@@ -0,0 +1,137 @@
+#include <libio/Streams.h>
+#include <libsystem/system/System.h>
+#include <libutils/ArgParse.h>
+#include <libgraphic/Painter.h>
+#include <libwidget/Element.h>
+#include <libwidget/Table.h>
+
+static constexpr size_t ROUNDS = 100;
+
+static void report(const char *name, uint64_t elapsed, size_t rounds = ROUNDS)
+{
+    IO::outln("{}: {} ns per round", name, elapsed / rounds);
+}
+
+/* --- Layout --------------------------------------------------------------- */
+
+// 100 rows of 50 elements, about what a settings page or a file list holds.
+static constexpr int LAYOUT_ROWS = 100;
+static constexpr int LAYOUT_COLUMNS = 50;
+
+static void bench_layout()
+{
+    auto root = make<Widget::Element>();
+    root->layout(VFLOW(4));
+
+    RefPtr<Widget::Element> last;
+
+    for (int row = 0; row < LAYOUT_ROWS; row++)
+    {
+        auto line = root->add(make<Widget::Element>());
+        line->layout(HFLOW(4));
+
+        for (int column = 0; column < LAYOUT_COLUMNS; column++)
+        {
+            last = line->add(make<Widget::Element>());
+            last->pin_width(16);
+            last->pin_height(16);
+        }
+    }
+
+    // The window was resized, every element moves.
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        root->container({0, 0, 1024 + (int)(round % 2), 2048});
+        root->relayout();
+    }
+
+    report("layout_5000_elements_resize", system_get_monotonic_time() - start);
+
+    // One element changed, only its row and the root are laid out again.
+    start = system_get_monotonic_time();
+
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        last->pin_width(16 + (round % 2));
+        root->relayout();
+    }
+
+    report("layout_5000_elements_one_changed", system_get_monotonic_time() - start);
+}
+
+/* --- Table ---------------------------------------------------------------- */
+
+static constexpr int TABLE_ROWS = 100000;
+static constexpr size_t TABLE_FRAMES = 1000;
+
+struct LargeTableModel : public Widget::TableModel
+{
+    int rows() override { return TABLE_ROWS; }
+
+    int columns() override { return 3; }
+
+    String header(int column) override
+    {
+        return IO::format("Column {}", column);
+    }
+
+    Widget::Variant data(int row, int column) override
+    {
+        if (column == 0)
+        {
+            return Widget::Variant(row);
+        }
+
+        return Widget::Variant("Row %d column %d", row, column);
+    }
+};
+
+// One frame per step of the mouse wheel, every frame paints the whole table
+// like the window does when scrolling.
+static void bench_table()
+{
+    auto table = make<Widget::Table>(make<LargeTableModel>());
+    table->container({0, 0, 800, 600});
+    table->relayout();
+
+    auto bitmap = Graphic::Bitmap::create_shared(800, 600).unwrap();
+    Graphic::Painter painter{bitmap};
+
+    uint64_t start = system_get_monotonic_time();
+
+    for (size_t frame = 0; frame < TABLE_FRAMES; frame++)
+    {
+        Widget::Event scroll = {};
+        scroll.type = Widget::Event::MOUSE_SCROLL;
+        scroll.mouse.scroll = 1;
+        table->dispatch_event(&scroll);
+
+        table->paint(painter, table->bound());
+    }
+
+    report("table_100k_rows_scroll", system_get_monotonic_time() - start, TABLE_FRAMES);
+}
+
+int main(int argc, const char *argv[])
+{
+    ArgParse args;
+
+    args.should_abort_on_failure();
+
+    args.usage("");
+
+    args.prologue("Measure the layout and painting of large widget trees, without a window.");
+
+    auto parse_result = args.eval(argc, argv);
+    if (parse_result != ArgParseResult::SHOULD_CONTINUE)
+    {
+        return parse_result == ArgParseResult::SHOULD_FINISH ? PROCESS_SUCCESS : PROCESS_FAILURE;
+    }
+
+    bench_layout();
+    bench_table();
+
+    return PROCESS_SUCCESS;
+}